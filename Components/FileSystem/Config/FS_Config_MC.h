@@ -4,7 +4,7 @@
  *------------------------------------------------------------------------------
  * Name:    FS_Config_MC_%Instance%.h
  * Purpose: File System Configuration for Memory Card Drive
- * Rev.:    V6.3.0
+ * Rev.:    V6.4.0
  *----------------------------------------------------------------------------*/
 
 //-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
@@ -26,6 +26,11 @@
 //   <i>Native uses a SD Bus with up to 8 data lines, CLK, and CMD
 //   <i>SPI uses 2 data lines (MOSI and MISO), SCLK and CS
 #define MC%Instance%_SPI                 0
+
+//   <q>Use Data CRC in SPI Mode
+//   <i>Protect data blocks transferred in SPI mode with CRC16.
+//   <i>CRC of a received block is checked while the next block is transferred.
+#define MC%Instance%_SPI_CRC             0
           
 //   <o>Drive Cache Size <0=>OFF <1=>1 KB <2=>2 KB <4=>4 KB
 //                       <8=>8 KB <16=>16 KB <32=>32 KB
@@ -36,6 +41,7 @@
 //   <e>Locate Drive Cache and Drive Buffer
 //   <i>Some microcontrollers support DMA only in specific memory areas and
 //   <i>require to locate the drive buffers at a fixed address.
+//   <i>File data is then transferred through the drive cache.
 #define MC%Instance%_CACHE_RELOC         0
 
 //     <s>Section Name
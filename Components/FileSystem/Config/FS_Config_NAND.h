@@ -4,7 +4,7 @@
  *------------------------------------------------------------------------------
  * Name:    FS_Config_NAND_%Instance%.h
  * Purpose: File System Configuration for NAND Flash Drive
- * Rev.:    V6.4.0
+ * Rev.:    V6.7.0
  *----------------------------------------------------------------------------*/
 
 //-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
@@ -53,10 +53,33 @@
 //   <i>Increase number of indexed blocks for better performance (default: 16 blocks).
 #define NAND%Instance%_BLOCK_CACHE       16
 
+//   <q>Translation Table in RAM
+//   <i>Keep complete block translation table in RAM to avoid reading
+//   <i>table pages when logical block is accessed.
+//   <i>4 bytes of RAM is required for each device block.
+#define NAND%Instance%_BTT_RAM           0
+
+//   <h>Background Reclaim
+//   <i>Work performed on this drive by function freclaim.
+//     <o>Fold Threshold [%] <0-100>
+//     <i>Fold primary and replacement block pair into an erased block
+//     <i>when replacement block is filled at least to this level.
+//     <i>Value 0 disables folding (default: 75%).
+#define NAND%Instance%_GC_THRESHOLD      75
+
+//     <o>Wear Leveling Interval <0-65535>
+//     <i>Number of block erases after which a rarely written block
+//     <i>is moved to another location (static wear leveling).
+//     <i>Value 0 disables static wear leveling (default: 256).
+#define NAND%Instance%_WL_INTERVAL       256
+//   </h>
+
 //   <h>ECC Configuration
-//     <o>Algorithm <0=>None <1=>Software 1-bit <2=>On-Chip <3=>Hardware
+//     <o>Algorithm <0=>None <1=>Software 1-bit <4=>Software 4-bit <5=>Software 8-bit <2=>On-Chip <3=>Hardware
 //     <i> - None: ECC not used
 //     <i> - Software 1-bit: 1-bit Hamming calculation in software
+//     <i> - Software 4-bit: 4-bit BCH calculation in software (7 bytes of spare per sector)
+//     <i> - Software 8-bit: 8-bit BCH calculation in software (13 bytes of spare per sector)
 //     <i> - On-Chip: EZ NAND compliant on-chip ECC calculation
 //     <i> - Hardware: ECC calculation in hardware driver
 #define NAND%Instance%_SW_ECC            1
@@ -132,6 +155,7 @@
 //   <e>Locate Drive Cache and Drive Buffer
 //   <i>Some microcontrollers support DMA only in specific memory areas and
 //   <i>require to locate the drive buffers at a fixed address.
+//   <i>File data is then transferred through the drive cache.
 #define NAND%Instance%_CACHE_RELOC       0
 
 //     <s>Section Name
@@ -56,6 +56,10 @@
 #define FS_FSEEK_CUR           1        ///< Seek from the current location
 #define FS_FSEEK_END           2        ///< Seek from the end of the file
 
+/// File Allocate Flag bit masks.
+#define FS_FALLOC_KEEP         0x0000   ///< Keep preallocated space when file is closed
+#define FS_FALLOC_RELEASE      0x0001   ///< Release unused preallocated space when file is closed
+
 #ifdef __cplusplus
 extern "C"  {
 #endif
@@ -100,7 +104,9 @@ typedef enum _fsDevCtrlCode {
   fsDevCtrlCodeSerial,                  ///< Return device serial number
   fsDevCtrlCodeGetCID,                  ///< Read Memory Card CID Register
   fsDevCtrlCodeLockUnlock,              ///< Manage device password protection
-  fsDevCtrlCodeHealthStatus             ///< Access device health status (S.M.A.R.T)
+  fsDevCtrlCodeHealthStatus,            ///< Access device health status (S.M.A.R.T)
+  fsDevCtrlCodeReclaim,                 ///< Reclaim invalidated space in one step
+  fsDevCtrlCodeDiscard                  ///< Discard a range of unused sectors
 } fsDevCtrlCode;
 
 /// Media information.
@@ -145,6 +151,12 @@ typedef struct {
   uint32_t buf_sz;                      ///< Data buffer size in bytes
 } fsHealthStatus;
 
+/// Sector range discard structure.
+typedef struct {
+  uint32_t sect;                        ///< First sector to discard
+  uint32_t cnt;                         ///< Number of sectors to discard
+} fsDiscardRange;
+
 /// File System Time structure.
 typedef struct _fsTime {
   uint8_t  hr;                          ///< Hours    [0..23]
@@ -192,6 +204,7 @@ extern fsStatus finit (const char *drive);
 ///               - fsOK               = Operation successful.
 ///               - fsInvalidParameter = Input parameter invalid.
 ///               - fsInvalidDrive     = Nonexistent drive letter specified.
+///               - fsAccessDenied     = File transfer in progress on the drive.
 ///               - fsError            = System resource delete failed.
 extern fsStatus funinit (const char *drive);
 
@@ -214,6 +227,7 @@ extern fsStatus fmount (const char *drive);
 ///               - fsOK               = Operation successful.
 ///               - fsInvalidParameter = Input parameter invalid.
 ///               - fsInvalidDrive     = Nonexistent drive letter specified.
+///               - fsAccessDenied     = File transfer in progress on the drive.
 extern fsStatus funmount (const char *drive);
 
 /// \brief Retrieve the File System component version.
@@ -334,6 +348,25 @@ extern fsStatus fcheck (const char *drive);
 /// \note       This function supports EFS drives only.
 extern fsStatus fdefrag (const char *drive);
 
+/// \brief Reclaim invalidated space on Embedded Flash or NAND Flash drive in one step.
+/// \param[in]  drive                    a string specifying the \ref drive "memory or storage device".
+/// \return     number of erased blocks or execution status
+///               - value >= 0: number of erased blocks on drive.
+///               - value < 0:  error occurred, -value is execution status as defined with \ref fsStatus
+/// \note       This function supports EFS and NAND drives only.
+extern int32_t freclaim (const char *drive);
+
+/// \brief Discard free space on FAT drive.
+/// \param[in]  drive                    a string specifying the \ref drive "memory or storage device".
+/// \return     execution status \ref fsStatus
+///               - fsOK               = Operation successful.
+///               - fsInvalidDrive     = Nonexistent drive letter specified.
+///               - fsAccessDenied     = Drive is write protected.
+///               - fsUnsupported      = Unsupported drive or media does not support discard.
+///               - fsError            = Discard failed due to media error.
+/// \note       This function supports FAT drives only.
+extern fsStatus ftrim (const char *drive);
+
 /// \brief Check if media present on removable drive.
 /// \param[in]  drive                    a string specifying the \ref drive "memory or storage device".
 /// \return     execution status \ref fsStatus
@@ -560,6 +593,14 @@ extern int64_t fs_fseek (int32_t handle, int64_t offset, int32_t whence);
 ///             or negative \ref fsStatus return code on failure
 extern int64_t fs_fsize (int32_t handle);
 
+/// \brief Preallocate file space.
+/// \param[in]  handle                   File handle of an opened file.
+/// \param[in]  size                     Number of bytes to reserve from the start of the file.
+/// \param[in]  flags                    Integer bitmap specifying the allocate flags.
+/// \return     zero on success,
+///             or negative \ref fsStatus return code on failure
+extern int32_t fs_fallocate (int32_t handle, int64_t size, uint32_t flags);
+
 #ifdef __cplusplus
 }
 #endif
@@ -155,6 +155,15 @@
                  USB0_ENABLE  * USB0_FAT_JOURNAL  +  \
                  USB1_ENABLE  * USB1_FAT_JOURNAL)
 
+/* ---------------------------------------------------------------------------*/
+/* Check memory card SPI mode data CRC usage */
+#ifndef MC0_SPI_CRC
+  #define MC0_SPI_CRC   0
+#endif
+#ifndef MC1_SPI_CRC
+  #define MC1_SPI_CRC   0
+#endif
+
 /* ---------------------------------------------------------------------------*/
 /* Check name cache usage */
 #ifndef MC0_NAME_CACHE_SIZE
@@ -169,6 +178,24 @@
 #ifndef NAND1_NAME_CACHE_SIZE
   #define NAND1_NAME_CACHE_SIZE 0
 #endif
+#ifndef NAND0_BTT_RAM
+  #define NAND0_BTT_RAM 0
+#endif
+#ifndef NAND1_BTT_RAM
+  #define NAND1_BTT_RAM 0
+#endif
+#ifndef NAND0_GC_THRESHOLD
+  #define NAND0_GC_THRESHOLD 75
+#endif
+#ifndef NAND1_GC_THRESHOLD
+  #define NAND1_GC_THRESHOLD 75
+#endif
+#ifndef NAND0_WL_INTERVAL
+  #define NAND0_WL_INTERVAL 256
+#endif
+#ifndef NAND1_WL_INTERVAL
+  #define NAND1_WL_INTERVAL 256
+#endif
 #ifndef USB0_NAME_CACHE_SIZE
   #define USB0_NAME_CACHE_SIZE 0
 #endif
@@ -246,9 +273,11 @@
 /* File Control Blocks for the FAT File System */
 #if (FAT_USE == 0 || FAT_MAX_OPEN_FILES == 0)
 fsFAT_Handle  fs_fat_fh[1];
+FS_MUTEX      fs_fat_fh_mtx[1];
 uint8_t const fs_fat_fh_cnt = 0;
 #else
 fsFAT_Handle  fs_fat_fh[FAT_MAX_OPEN_FILES];
+FS_MUTEX      fs_fat_fh_mtx[FAT_MAX_OPEN_FILES];
 uint8_t const fs_fat_fh_cnt = FAT_MAX_OPEN_FILES;
 #endif
 
@@ -269,6 +298,111 @@ uint8_t const fs_ndrv = FS_NDRV;
 #define FAT_NCACHE_STAT_SZ  (20)
 #define FAT_NCACHE_USED_SZ  (8)
 
+/* FAT Sector Size definitions */
+#ifndef FAT_MAX_SECTOR_SIZE
+  #define FAT_MAX_SECTOR_SIZE   512
+#endif
+#if ((FAT_MAX_SECTOR_SIZE != 512)  && (FAT_MAX_SECTOR_SIZE != 1024) && \
+     (FAT_MAX_SECTOR_SIZE != 2048) && (FAT_MAX_SECTOR_SIZE != 4096))
+  #error "FAT Maximum Sector Size invalid in FS_Config.h"
+#endif
+/* Sector buffer size (in words) */
+#define FAT_SECT_BUF_SZ     (FAT_MAX_SECTOR_SIZE / 4)
+/* Drive cache buffer size (in words): FAT sector, working sector and data cache */
+#define FAT_CACHE_BUF_SZ(n) ((n) * 256 + 2 * FAT_SECT_BUF_SZ)
+/* Largest sector size supported on FAT drives */
+uint16_t const fs_fat_sect_max = FAT_MAX_SECTOR_SIZE;
+
+/* FAT Table Cache definitions */
+#ifndef FAT_TABLE_CACHE_SIZE
+  #define FAT_TABLE_CACHE_SIZE  1
+#endif
+#if ((FAT_TABLE_CACHE_SIZE < 1) || (FAT_TABLE_CACHE_SIZE > 16))
+  #error "FAT Table Cache Size invalid in FS_Config.h"
+#endif
+/* Additional FAT table cache buffer size (in words), first sector is in drive cache */
+#define FAT_FCACHE_BUF_SZ   ((FAT_TABLE_CACHE_SIZE - 1) * FAT_SECT_BUF_SZ)
+
+/* FAT Free Cluster Map definitions */
+#ifndef FAT_FREE_MAP_SIZE
+  #define FAT_FREE_MAP_SIZE     0
+#endif
+#if ((FAT_FREE_MAP_SIZE % 4) != 0)
+  #error "FAT Free Cluster Map Size must be a multiple of 4 in FS_Config.h"
+#endif
+
+/* FAT Directory Index definitions */
+#ifndef FAT_DIR_INDEX_SIZE
+  #define FAT_DIR_INDEX_SIZE    0
+#endif
+#if ((FAT_DIR_INDEX_SIZE % 4) != 0)
+  #error "FAT Directory Index Size must be a multiple of 4 in FS_Config.h"
+#endif
+
+#ifndef FAT_JOURNAL_GROUP
+  #define FAT_JOURNAL_GROUP     0
+#endif
+#if (FAT_JOURNAL_GROUP > 32)
+  #error "FAT Journal Group Size must be in range 0 to 32 in FS_Config.h"
+#endif
+
+/* FAT Background I/O Worker definitions */
+#if (FAT_IO_WORKER_ENABLE)
+  #ifndef FAT_IO_WORKER_WMARK
+    #define FAT_IO_WORKER_WMARK 50
+  #endif
+  #if ((FAT_IO_WORKER_WMARK < 10) || (FAT_IO_WORKER_WMARK > 100))
+    #error "FAT Background I/O Worker Write-behind Watermark invalid in FS_Config.h"
+  #endif
+  /* Write-behind watermark in percent of data cache size */
+  uint8_t const fs_fat_io_wmark = FAT_IO_WORKER_WMARK;
+#else
+  uint8_t const fs_fat_io_wmark = 0;
+#endif
+
+/* FAT File Transfer Chunk definitions */
+#ifndef FAT_TRANSFER_CHUNK
+  #define FAT_TRANSFER_CHUNK    0
+#endif
+#if (FAT_TRANSFER_CHUNK > 64)
+  #error "FAT File Transfer Chunk Size invalid in FS_Config.h"
+#endif
+/* Number of clusters transferred under volume lock */
+uint8_t const fs_fat_xfer_chunk = FAT_TRANSFER_CHUNK;
+
+/* FAT Discard definitions */
+#ifndef FAT_DISCARD_ENABLE
+  #define FAT_DISCARD_ENABLE    0
+#endif
+/* Discard clusters freed on the media */
+uint8_t const fs_fat_discard = FAT_DISCARD_ENABLE;
+
+/* EFS File Index definitions */
+#ifndef EFS_FILE_INDEX_SIZE
+  #define EFS_FILE_INDEX_SIZE   0
+#endif
+#if ((EFS_FILE_INDEX_SIZE % 4) != 0)
+  #error "EFS File Index Size must be a multiple of 4 in FS_Config.h"
+#endif
+
+/* EFS Write Buffer definitions */
+#ifndef EFS_WRITE_BUFFER_SIZE
+  #define EFS_WRITE_BUFFER_SIZE 0
+#endif
+#if ((EFS_WRITE_BUFFER_SIZE % 4) != 0)
+  #error "EFS Write Buffer Size must be a multiple of 4 in FS_Config.h"
+#endif
+
+/* EFS Reclaim definitions */
+#ifndef EFS_RECLAIM_RESERVE
+  #define EFS_RECLAIM_RESERVE   2
+#endif
+#if ((EFS_RECLAIM_RESERVE < 1) || (EFS_RECLAIM_RESERVE > 16))
+  #error "EFS Reclaim Reserve Blocks invalid in FS_Config.h"
+#endif
+/* Number of erased blocks kept by reclaim */
+uint8_t const fs_efs_reclaim_rsv = EFS_RECLAIM_RESERVE;
+
 /* Expansion macro used to create CMSIS Driver references */
 #define EXPAND_SYMBOL(name, port) name##port
 #define CREATE_SYMBOL(name, port) EXPAND_SYMBOL(name, port)
@@ -281,6 +415,12 @@ uint8_t const fs_ndrv = FS_NDRV;
   extern NOR_MEDIA fs_nor0;
   #endif
   static fsEFS_Volume  fs_nor0_vol;
+  #if (EFS_FILE_INDEX_SIZE > 0)
+  static uint32_t      fs_nor0_fidx[EFS_FILE_INDEX_SIZE/4];
+  #endif
+  #if (EFS_WRITE_BUFFER_SIZE > 0)
+  static uint32_t      fs_nor0_wbuf[EFS_WRITE_BUFFER_SIZE/4];
+  #endif
 
   static FLASH_TIMEOUT fs_nor0_flash_tout = {
     NOR0_TOUT_ERASE_CHIP,
@@ -349,6 +489,12 @@ uint8_t const fs_ndrv = FS_NDRV;
   extern NOR_MEDIA fs_nor1;
   #endif
   static fsEFS_Volume  fs_nor1_vol;
+  #if (EFS_FILE_INDEX_SIZE > 0)
+  static uint32_t      fs_nor1_fidx[EFS_FILE_INDEX_SIZE/4];
+  #endif
+  #if (EFS_WRITE_BUFFER_SIZE > 0)
+  static uint32_t      fs_nor1_wbuf[EFS_WRITE_BUFFER_SIZE/4];
+  #endif
 
   static FLASH_TIMEOUT fs_nor1_flash_tout = {
     NOR1_TOUT_ERASE_CHIP,
@@ -420,6 +566,9 @@ uint8_t const fs_ndrv = FS_NDRV;
 
   #if (MC0_FAT_JOURNAL)
   static FSJOUR       fs_mc0_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_mc0_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   #if (MC0_SPI == 0)
@@ -447,7 +596,20 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* MC0 Cache Buffer for Data and FAT Caching */
-  static uint32_t mc0_cache[(MC0_CACHE_SIZE+1) * 256 + MC0_FAT_JOURNAL * 128] __ALIGNED(32) __SECTION_MC0;
+  static uint32_t mc0_cache[FAT_CACHE_BUF_SZ(MC0_CACHE_SIZE) + MC0_FAT_JOURNAL * FAT_SECT_BUF_SZ + FAT_FCACHE_BUF_SZ] __ALIGNED(32) __SECTION_MC0;
+
+  /* MC0 FAT Table Cache entries */
+  static FCACHE_ENT mc0_fcache[FAT_TABLE_CACHE_SIZE];
+
+  /* MC0 FAT Free Cluster Map */
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t mc0_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+
+  /* MC0 FAT Directory Index */
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t mc0_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
 
   #if (MC0_NAME_CACHE_SIZE > 0)
     #define MC0_NAME_CACHE_MAX_DEPTH 8
@@ -541,6 +703,9 @@ uint8_t const fs_ndrv = FS_NDRV;
 
   #if (MC1_FAT_JOURNAL)
   static FSJOUR       fs_mc1_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_mc1_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   #if (MC1_SPI == 0)
@@ -568,7 +733,20 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* MC1 Cache Buffer for Data and FAT Caching */
-  static uint32_t mc1_cache[(MC1_CACHE_SIZE+1) * 256 + MC1_FAT_JOURNAL * 128] __ALIGNED(32) __SECTION_MC1;
+  static uint32_t mc1_cache[FAT_CACHE_BUF_SZ(MC1_CACHE_SIZE) + MC1_FAT_JOURNAL * FAT_SECT_BUF_SZ + FAT_FCACHE_BUF_SZ] __ALIGNED(32) __SECTION_MC1;
+
+  /* MC1 FAT Table Cache entries */
+  static FCACHE_ENT mc1_fcache[FAT_TABLE_CACHE_SIZE];
+
+  /* MC1 FAT Free Cluster Map */
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t mc1_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+
+  /* MC1 FAT Directory Index */
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t mc1_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
 
   #if (MC1_NAME_CACHE_SIZE > 0)
     #define MC1_NAME_CACHE_MAX_DEPTH 8
@@ -784,19 +962,32 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* NAND Cache Buffer for FAT, Page and Block Caching */
-  #define NAND0_CSZ   ((NAND0_CACHE_SIZE  + 1) * 1024             + \
+  #define NAND0_CSZ   (FAT_CACHE_BUF_SZ(NAND0_CACHE_SIZE) * 4     + \
                        (NAND0_PAGE_CACHE  + 2) * NAND0_PAGE_SIZE  + \
                        (NAND0_BLOCK_CACHE + 2) * NAND0_PAGE_COUNT)
-  #define NAND0_FSJBUF (NAND0_FAT_JOURNAL      * 512)
+  #define NAND0_FSJBUF (NAND0_FAT_JOURNAL      * FAT_MAX_SECTOR_SIZE)
 
-  static uint32_t     nand0_cache[NAND0_CSZ/4 + NAND0_FSJBUF/4] __ALIGNED(32) __SECTION_NAND0;
+  static uint32_t     nand0_cache[NAND0_CSZ/4 + NAND0_FSJBUF/4 + FAT_FCACHE_BUF_SZ] __ALIGNED(32) __SECTION_NAND0;
+  static FCACHE_ENT   nand0_fcache[FAT_TABLE_CACHE_SIZE];
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t     nand0_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t     nand0_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
   static PAGE_CACHE   nand0_capg [NAND0_PAGE_CACHE  + 1];
   static BLOCK_CACHE  nand0_cabl [NAND0_BLOCK_CACHE + 2];
   static uint32_t     nand0_ttsn [NAND_TSN_SIZE(NAND0_BLOCK_COUNT, NAND0_PAGE_SIZE)];
+  #if (NAND0_BTT_RAM)
+  static uint32_t     nand0_btt  [NAND_BTT_RAM_SIZE(NAND0_BLOCK_COUNT, NAND0_BTT_RAM)];
+  #endif
 
   static fsFAT_Volume fs_nand0_vol;
   #if (NAND0_FAT_JOURNAL)
   static FSJOUR       fs_nand0_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_nand0_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   #if (NAND0_NAME_CACHE_SIZE > 0)
@@ -877,15 +1068,24 @@ uint8_t const fs_ndrv = FS_NDRV;
     NAND0_BLOCK_CACHE + 2,
     NAND0_PAGE_CACHE  + 1,
     NAND_TSN_SIZE(NAND0_BLOCK_COUNT, NAND0_PAGE_SIZE),
-    { 0, 0 },
+    NAND_BTT_RAM_SIZE(NAND0_BLOCK_COUNT, NAND0_BTT_RAM),
+
+    /* Background reclaim */
+    NAND0_GC_THRESHOLD,
+    NAND0_WL_INTERVAL,
 
     /* Page buffer & Caches */
-    (uint8_t *)&nand0_cache[(NAND0_CACHE_SIZE+1)*256],
+    (uint8_t *)&nand0_cache[FAT_CACHE_BUF_SZ(NAND0_CACHE_SIZE)],
     &nand0_cabl[0],
-    (uint8_t *)&nand0_cache[(NAND0_CACHE_SIZE+1)*256+(NAND0_PAGE_CACHE+2)*NAND0_PAGE_SIZE/4],
+    (uint8_t *)&nand0_cache[FAT_CACHE_BUF_SZ(NAND0_CACHE_SIZE)+(NAND0_PAGE_CACHE+2)*NAND0_PAGE_SIZE/4],
     &nand0_capg[0],
-    (uint8_t *)&nand0_cache[(NAND0_CACHE_SIZE+1)*256+NAND0_PAGE_SIZE/4],
-    &nand0_ttsn[0]
+    (uint8_t *)&nand0_cache[FAT_CACHE_BUF_SZ(NAND0_CACHE_SIZE)+NAND0_PAGE_SIZE/4],
+    &nand0_ttsn[0],
+  #if (NAND0_BTT_RAM)
+    &nand0_btt[0]
+  #else
+    NULL
+  #endif
   };
 
   /* NAND0 wrapper functions */
@@ -937,19 +1137,32 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* NAND Cache Buffer for FAT, Page and Block Caching */
-  #define NAND1_CSZ   ((NAND1_CACHE_SIZE  + 1) * 1024             + \
+  #define NAND1_CSZ   (FAT_CACHE_BUF_SZ(NAND1_CACHE_SIZE) * 4     + \
                        (NAND1_PAGE_CACHE  + 2) * NAND1_PAGE_SIZE  + \
                        (NAND1_BLOCK_CACHE + 2) * NAND1_PAGE_COUNT)
-  #define NAND1_FSJBUF (NAND1_FAT_JOURNAL      * 512)
+  #define NAND1_FSJBUF (NAND1_FAT_JOURNAL      * FAT_MAX_SECTOR_SIZE)
  
-  static uint32_t     nand1_cache[NAND1_CSZ/4 + NAND1_FSJBUF/4] __ALIGNED(32) __SECTION_NAND1;
+  static uint32_t     nand1_cache[NAND1_CSZ/4 + NAND1_FSJBUF/4 + FAT_FCACHE_BUF_SZ] __ALIGNED(32) __SECTION_NAND1;
+  static FCACHE_ENT   nand1_fcache[FAT_TABLE_CACHE_SIZE];
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t     nand1_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t     nand1_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
   static PAGE_CACHE   nand1_capg [NAND1_PAGE_CACHE  + 1];
   static BLOCK_CACHE  nand1_cabl [NAND1_BLOCK_CACHE + 2];
   static uint32_t     nand1_ttsn [NAND_TSN_SIZE(NAND1_BLOCK_COUNT, NAND1_PAGE_SIZE)];
+  #if (NAND1_BTT_RAM)
+  static uint32_t     nand1_btt  [NAND_BTT_RAM_SIZE(NAND1_BLOCK_COUNT, NAND1_BTT_RAM)];
+  #endif
 
   static fsFAT_Volume fs_nand1_vol;
   #if (NAND1_FAT_JOURNAL)
   static FSJOUR       fs_nand1_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_nand1_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   #if (NAND1_NAME_CACHE_SIZE > 0)
@@ -1030,15 +1243,24 @@ uint8_t const fs_ndrv = FS_NDRV;
     NAND1_BLOCK_CACHE + 2,
     NAND1_PAGE_CACHE  + 1,
     NAND_TSN_SIZE(NAND1_BLOCK_COUNT, NAND1_PAGE_SIZE),
-    { 0, 0 },
+    NAND_BTT_RAM_SIZE(NAND1_BLOCK_COUNT, NAND1_BTT_RAM),
+
+    /* Background reclaim */
+    NAND1_GC_THRESHOLD,
+    NAND1_WL_INTERVAL,
 
     /* Page buffer & Caches */
-    (uint8_t *)&nand1_cache[(NAND1_CACHE_SIZE+1)*256],
+    (uint8_t *)&nand1_cache[FAT_CACHE_BUF_SZ(NAND1_CACHE_SIZE)],
     &nand1_cabl[0],
-    (uint8_t *)&nand1_cache[(NAND1_CACHE_SIZE+1)*256+(NAND1_PAGE_CACHE+2)*NAND1_PAGE_SIZE/4],
+    (uint8_t *)&nand1_cache[FAT_CACHE_BUF_SZ(NAND1_CACHE_SIZE)+(NAND1_PAGE_CACHE+2)*NAND1_PAGE_SIZE/4],
     &nand1_capg[0],
-    (uint8_t *)&nand1_cache[(NAND1_CACHE_SIZE+1)*256+NAND1_PAGE_SIZE/4],
+    (uint8_t *)&nand1_cache[FAT_CACHE_BUF_SZ(NAND1_CACHE_SIZE)+NAND1_PAGE_SIZE/4],
     &nand1_ttsn[0],
+  #if (NAND1_BTT_RAM)
+    &nand1_btt[0]
+  #else
+    NULL
+  #endif
   };
 
   /* NAND1 wrapper functions */
@@ -1095,14 +1317,17 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* RAM0 Device data buffer */
-  static uint32_t ram0_buf[256 + (RAM0_SIZE/4)] __SECTION_RAM0;
+  static uint32_t ram0_buf[2 * FAT_SECT_BUF_SZ + (RAM0_SIZE/4)] __SECTION_RAM0;
+
+  /* RAM0 FAT Table Cache entry */
+  static FCACHE_ENT ram0_fcache[1];
 
   /* RAM0 device info */
   #ifndef FS_DEBUG
   static
   #endif
   RAM_DEV fs_ram0_dev = {
-    (uint8_t *)&ram0_buf[256],
+    (uint8_t *)&ram0_buf[2 * FAT_SECT_BUF_SZ],
     RAM0_SIZE
   };
 
@@ -1157,14 +1382,17 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* RAM1 Device data buffer */
-  static uint32_t ram1_buf[256 + (RAM1_SIZE/4)] __SECTION_RAM1;
+  static uint32_t ram1_buf[2 * FAT_SECT_BUF_SZ + (RAM1_SIZE/4)] __SECTION_RAM1;
+
+  /* RAM1 FAT Table Cache entry */
+  static FCACHE_ENT ram1_fcache[1];
 
   /* RAM1 device info */
   #ifndef FS_DEBUG
   static
   #endif
   RAM_DEV fs_ram1_dev = {
-    (uint8_t *)&ram1_buf[256],
+    (uint8_t *)&ram1_buf[2 * FAT_SECT_BUF_SZ],
     RAM1_SIZE
   };
 
@@ -1207,6 +1435,9 @@ uint8_t const fs_ndrv = FS_NDRV;
 
   #if (USB0_FAT_JOURNAL)
   static FSJOUR       fs_usb0_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_usb0_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   #if (USB0_NAME_CACHE_SIZE > 0)
@@ -1225,7 +1456,20 @@ uint8_t const fs_ndrv = FS_NDRV;
   #endif
 
   /* USB Cache Buffer for Data and FAT Caching */
-  static uint32_t usb0_cache[(USB0_CACHE_SIZE+1) * 256 + USB0_FAT_JOURNAL * 128];
+  static uint32_t usb0_cache[FAT_CACHE_BUF_SZ(USB0_CACHE_SIZE) + USB0_FAT_JOURNAL * FAT_SECT_BUF_SZ + FAT_FCACHE_BUF_SZ];
+
+  /* USB0 FAT Table Cache entries */
+  static FCACHE_ENT usb0_fcache[FAT_TABLE_CACHE_SIZE];
+
+  /* USB0 FAT Free Cluster Map */
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t usb0_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+
+  /* USB0 FAT Directory Index */
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t usb0_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
 
   /* USB0 wrapper functions */
   static uint32_t usb0_Init (uint32_t mode) {
@@ -1265,10 +1509,26 @@ uint8_t const fs_ndrv = FS_NDRV;
 
   #if (USB1_FAT_JOURNAL)
   static FSJOUR       fs_usb1_fsj;
+   #if (FAT_JOURNAL_GROUP > 0)
+  static uint32_t     fs_usb1_fsj_grp[2*FAT_JOURNAL_GROUP];
+   #endif
   #endif
 
   /* USB Cache Buffer for Data and FAT Caching */
-  static uint32_t usb1_cache[(USB1_CACHE_SIZE+1) * 256 + USB1_FAT_JOURNAL * 128];
+  static uint32_t usb1_cache[FAT_CACHE_BUF_SZ(USB1_CACHE_SIZE) + USB1_FAT_JOURNAL * FAT_SECT_BUF_SZ + FAT_FCACHE_BUF_SZ];
+
+  /* USB1 FAT Table Cache entries */
+  static FCACHE_ENT usb1_fcache[FAT_TABLE_CACHE_SIZE];
+
+  /* USB1 FAT Free Cluster Map */
+  #if (FAT_FREE_MAP_SIZE > 0)
+  static uint32_t usb1_fmap[FAT_FREE_MAP_SIZE/4];
+  #endif
+
+  /* USB1 FAT Directory Index */
+  #if (FAT_DIR_INDEX_SIZE > 0)
+  static uint32_t usb1_didx[FAT_DIR_INDEX_SIZE/4];
+  #endif
 
   #if (USB1_NAME_CACHE_SIZE > 0)
     #define USB1_NAME_CACHE_MAX_DEPTH 8
@@ -1363,6 +1623,14 @@ __STATIC_INLINE void fs_config_flash (char num) {
     case '0':
       fs_nor0_vol.Mutex       = fs_mutex_new ("F0");
       fs_nor0_vol.Drv         = &fs_nor0_drv;
+     #if (EFS_FILE_INDEX_SIZE > 0)
+      fs_nor0_vol.fidx.buf    = fs_nor0_fidx;
+      fs_nor0_vol.fidx.size   = EFS_FILE_INDEX_SIZE / 4;
+     #endif
+     #if (EFS_WRITE_BUFFER_SIZE > 0)
+      fs_nor0_vol.wbuf.buf    = fs_nor0_wbuf;
+      fs_nor0_vol.wbuf.size   = EFS_WRITE_BUFFER_SIZE / 4;
+     #endif
 
       fs_nor0.Driver          = &CREATE_SYMBOL (Driver_Flash, NOR0_DRIVER);
       fs_nor0.Callback        = &NOR0_Flash_SignalEvent;
@@ -1374,6 +1642,14 @@ __STATIC_INLINE void fs_config_flash (char num) {
     case '1':
       fs_nor1_vol.Mutex       = fs_mutex_new ("F1");
       fs_nor1_vol.Drv         = &fs_nor1_drv;
+     #if (EFS_FILE_INDEX_SIZE > 0)
+      fs_nor1_vol.fidx.buf    = fs_nor1_fidx;
+      fs_nor1_vol.fidx.size   = EFS_FILE_INDEX_SIZE / 4;
+     #endif
+     #if (EFS_WRITE_BUFFER_SIZE > 0)
+      fs_nor1_vol.wbuf.buf    = fs_nor1_wbuf;
+      fs_nor1_vol.wbuf.size   = EFS_WRITE_BUFFER_SIZE / 4;
+     #endif
 
       fs_nor1.Driver          = &CREATE_SYMBOL (Driver_Flash, NOR1_DRIVER);
       fs_nor1.Callback        = &NOR1_Flash_SignalEvent;
@@ -1393,6 +1669,17 @@ __STATIC_INLINE void fs_config_mc (char num) {
       fs_mc0_vol.Drv           = &fs_mc0_drv;
       fs_mc0_vol.CaBuf         = mc0_cache;
       fs_mc0_vol.CaSize        = MC0_CACHE_SIZE * 2;
+      fs_mc0_vol.FatCaBuf      = &mc0_cache[FAT_CACHE_BUF_SZ(MC0_CACHE_SIZE) + MC0_FAT_JOURNAL * FAT_SECT_BUF_SZ];
+      fs_mc0_vol.fat.ent       = mc0_fcache;
+      fs_mc0_vol.fat.cnt       = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_mc0_vol.fmap.map      = mc0_fmap;
+      fs_mc0_vol.fmap.size     = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_mc0_vol.didx.buf      = mc0_didx;
+      fs_mc0_vol.didx.size     = FAT_DIR_INDEX_SIZE / 4;
+     #endif
      #if (MC0_NAME_CACHE_SIZE)
       fs_mc0_vol.ncache        = &mc0_ncache;
      #else
@@ -1411,19 +1698,26 @@ __STATIC_INLINE void fs_config_mc (char num) {
       fs_mc0_spi.ExtCSD        = (uint8_t *)mc0_cache;
       fs_mc0_spi.Driver        = &CREATE_SYMBOL (Driver_SPI, MC0_SPI_DRIVER);
       fs_mc0_spi.Callback      = MC0_SPI_SignalEvent;
+      fs_mc0_spi.Config        = (MC0_SPI_CRC != 0) ? MC_SPI_CFG_CRC : 0U;
      #else
       #error "Memory Card Interface Mode Invalid in FS_Config_MC_0.h"
      #endif
 
      #if (MC0_FAT_JOURNAL)
       /* Register file system journal */
-      fs_mc0_fsj.buf           = (uint8_t *)&mc0_cache[(MC0_CACHE_SIZE+1) * 256];
+      fs_mc0_fsj.buf           = (uint8_t *)&mc0_cache[FAT_CACHE_BUF_SZ(MC0_CACHE_SIZE)];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_mc0_fsj.Grp           = fs_mc0_fsj_grp;
+      fs_mc0_fsj.GrpMax        = FAT_JOURNAL_GROUP;
+     #endif
       fs_mc0_vol.fsj           = &fs_mc0_fsj;
       fs_mc0_vol.RsvdS         = FAT_SECT_RSVD;
      #else
       fs_mc0_vol.fsj           = NULL;
       fs_mc0_vol.RsvdS         = 0;
      #endif
+      /* Transfer file data through the drive cache when it is located for DMA */
+      fs_mc0_vol.DirectIO      = (MC0_CACHE_RELOC == 0) ? 1U : 0U;
       break;
 #endif /* MC0_ENABLE */
 
@@ -1433,6 +1727,17 @@ __STATIC_INLINE void fs_config_mc (char num) {
       fs_mc1_vol.Drv           = &fs_mc1_drv;
       fs_mc1_vol.CaBuf         = mc1_cache;
       fs_mc1_vol.CaSize        = MC1_CACHE_SIZE * 2;
+      fs_mc1_vol.FatCaBuf      = &mc1_cache[FAT_CACHE_BUF_SZ(MC1_CACHE_SIZE) + MC1_FAT_JOURNAL * FAT_SECT_BUF_SZ];
+      fs_mc1_vol.fat.ent       = mc1_fcache;
+      fs_mc1_vol.fat.cnt       = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_mc1_vol.fmap.map      = mc1_fmap;
+      fs_mc1_vol.fmap.size     = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_mc1_vol.didx.buf      = mc1_didx;
+      fs_mc1_vol.didx.size     = FAT_DIR_INDEX_SIZE / 4;
+     #endif
      #if (MC1_NAME_CACHE_SIZE)
       fs_mc1_vol.ncache        = &mc1_ncache;
      #else
@@ -1451,19 +1756,26 @@ __STATIC_INLINE void fs_config_mc (char num) {
       fs_mc1_spi.ExtCSD        = (uint8_t *)mc1_cache;
       fs_mc1_spi.Driver        = &CREATE_SYMBOL (Driver_SPI, MC1_SPI_DRIVER);
       fs_mc1_spi.Callback      = MC1_SPI_SignalEvent;
+      fs_mc1_spi.Config        = (MC1_SPI_CRC != 0) ? MC_SPI_CFG_CRC : 0U;
      #else
       #error "Memory Card Interface Mode Invalid in FS_Config_MC_1.h"
      #endif
 
      #if (MC1_FAT_JOURNAL)
       /* Register file system journal */
-      fs_mc1_fsj.buf           = (uint8_t *)&mc1_cache[(MC1_CACHE_SIZE+1) * 256];
+      fs_mc1_fsj.buf           = (uint8_t *)&mc1_cache[FAT_CACHE_BUF_SZ(MC1_CACHE_SIZE)];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_mc1_fsj.Grp           = fs_mc1_fsj_grp;
+      fs_mc1_fsj.GrpMax        = FAT_JOURNAL_GROUP;
+     #endif
       fs_mc1_vol.fsj           = &fs_mc1_fsj;
       fs_mc1_vol.RsvdS         = FAT_SECT_RSVD;
      #else
       fs_mc1_vol.fsj           = NULL;
       fs_mc1_vol.RsvdS         = 0;
      #endif
+      /* Transfer file data through the drive cache when it is located for DMA */
+      fs_mc1_vol.DirectIO      = (MC1_CACHE_RELOC == 0) ? 1U : 0U;
       break;
 #endif /* MC1_ENABLE */
   }
@@ -1479,6 +1791,17 @@ __STATIC_INLINE void fs_config_nand (char num) {
       fs_nand0_vol.Drv               = &fs_nand0_drv;
       fs_nand0_vol.CaBuf             = nand0_cache;
       fs_nand0_vol.CaSize            = NAND0_CACHE_SIZE * 2;
+      fs_nand0_vol.FatCaBuf          = &nand0_cache[NAND0_CSZ/4 + NAND0_FSJBUF/4];
+      fs_nand0_vol.fat.ent           = nand0_fcache;
+      fs_nand0_vol.fat.cnt           = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_nand0_vol.fmap.map          = nand0_fmap;
+      fs_nand0_vol.fmap.size         = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_nand0_vol.didx.buf          = nand0_didx;
+      fs_nand0_vol.didx.size         = FAT_DIR_INDEX_SIZE / 4;
+     #endif
      #if (NAND0_NAME_CACHE_SIZE)
       fs_nand0_vol.ncache            = &nand0_ncache;
      #else
@@ -1501,12 +1824,18 @@ __STATIC_INLINE void fs_config_nand (char num) {
      #if (NAND0_FAT_JOURNAL)
       /* Register file system journal */
       fs_nand0_fsj.buf               = (uint8_t *)&nand0_cache[NAND0_CSZ/4];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_nand0_fsj.Grp               = fs_nand0_fsj_grp;
+      fs_nand0_fsj.GrpMax            = FAT_JOURNAL_GROUP;
+     #endif
       fs_nand0_vol.fsj               = &fs_nand0_fsj;
       fs_nand0_vol.RsvdS             = FAT_SECT_RSVD;
      #else
       fs_nand0_vol.fsj               = NULL;
       fs_nand0_vol.RsvdS             = 0;
      #endif
+      /* Transfer file data through the drive cache when it is located for DMA */
+      fs_nand0_vol.DirectIO          = (NAND0_CACHE_RELOC == 0) ? 1U : 0U;
       break;
 #endif /* NAND0_ENABLE */
 
@@ -1516,6 +1845,17 @@ __STATIC_INLINE void fs_config_nand (char num) {
       fs_nand1_vol.Drv               = &fs_nand1_drv;
       fs_nand1_vol.CaBuf             = nand1_cache;
       fs_nand1_vol.CaSize            = NAND1_CACHE_SIZE * 2;
+      fs_nand1_vol.FatCaBuf          = &nand1_cache[NAND1_CSZ/4 + NAND1_FSJBUF/4];
+      fs_nand1_vol.fat.ent           = nand1_fcache;
+      fs_nand1_vol.fat.cnt           = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_nand1_vol.fmap.map          = nand1_fmap;
+      fs_nand1_vol.fmap.size         = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_nand1_vol.didx.buf          = nand1_didx;
+      fs_nand1_vol.didx.size         = FAT_DIR_INDEX_SIZE / 4;
+     #endif
      #if (NAND1_NAME_CACHE_SIZE)
       fs_nand1_vol.ncache            = &nand1_ncache;
      #else
@@ -1540,12 +1880,18 @@ __STATIC_INLINE void fs_config_nand (char num) {
      #if (NAND1_FAT_JOURNAL)
       /* Register file system journal */
       fs_nand1_fsj.buf               = (uint8_t *)&nand1_cache[NAND1_CSZ/4];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_nand1_fsj.Grp               = fs_nand1_fsj_grp;
+      fs_nand1_fsj.GrpMax            = FAT_JOURNAL_GROUP;
+     #endif
       fs_nand1_vol.fsj               = &fs_nand1_fsj;
       fs_nand1_vol.RsvdS             = FAT_SECT_RSVD;
      #else
       fs_nand1_vol.fsj               = NULL;
       fs_nand1_vol.RsvdS             = 0;
      #endif
+      /* Transfer file data through the drive cache when it is located for DMA */
+      fs_nand1_vol.DirectIO          = (NAND1_CACHE_RELOC == 0) ? 1U : 0U;
       break;
 #endif /* NAND1_ENABLE */
   }
@@ -1561,8 +1907,12 @@ __STATIC_INLINE void fs_config_ram (char num) {
       fs_ram0_vol.Drv      = &fs_ram0_drv;
       fs_ram0_vol.CaBuf    = ram0_buf;
       fs_ram0_vol.CaSize   = 0;
+      fs_ram0_vol.FatCaBuf = NULL;
+      fs_ram0_vol.fat.ent  = ram0_fcache;
+      fs_ram0_vol.fat.cnt  = 1;
       fs_ram0_vol.RsvdS    = 0;
       fs_ram0_vol.fsj      = NULL;
+      fs_ram0_vol.DirectIO = 1U;
       break;
 #endif /* RAM0_ENABLE */
 
@@ -1572,8 +1922,12 @@ __STATIC_INLINE void fs_config_ram (char num) {
       fs_ram1_vol.Drv      = &fs_ram1_drv;
       fs_ram1_vol.CaBuf    = ram1_buf;
       fs_ram1_vol.CaSize   = 0;
+      fs_ram1_vol.FatCaBuf = NULL;
+      fs_ram1_vol.fat.ent  = ram1_fcache;
+      fs_ram1_vol.fat.cnt  = 1;
       fs_ram1_vol.RsvdS    = 0;
       fs_ram1_vol.fsj      = NULL;
+      fs_ram1_vol.DirectIO = 1U;
       break;
 #endif /* RAM1_ENABLE */
   }
@@ -1589,6 +1943,17 @@ __STATIC_INLINE void fs_config_usb (char num) {
       fs_usb0_vol.Drv      = &fs_usb0_drv;
       fs_usb0_vol.CaBuf    = usb0_cache;
       fs_usb0_vol.CaSize   = USB0_CACHE_SIZE * 2;
+      fs_usb0_vol.FatCaBuf = &usb0_cache[FAT_CACHE_BUF_SZ(USB0_CACHE_SIZE) + USB0_FAT_JOURNAL * FAT_SECT_BUF_SZ];
+      fs_usb0_vol.fat.ent  = usb0_fcache;
+      fs_usb0_vol.fat.cnt  = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_usb0_vol.fmap.map = usb0_fmap;
+      fs_usb0_vol.fmap.size = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_usb0_vol.didx.buf = usb0_didx;
+      fs_usb0_vol.didx.size = FAT_DIR_INDEX_SIZE / 4;
+     #endif
      #if (USB0_NAME_CACHE_SIZE)
       fs_usb0_vol.ncache   = &usb0_ncache;
      #else
@@ -1597,13 +1962,18 @@ __STATIC_INLINE void fs_config_usb (char num) {
 
      #if (USB0_FAT_JOURNAL)
       /* Register file system journal */
-      fs_usb0_fsj.buf      = (uint8_t *)&usb0_cache[(USB0_CACHE_SIZE+1) * 256];
+      fs_usb0_fsj.buf      = (uint8_t *)&usb0_cache[FAT_CACHE_BUF_SZ(USB0_CACHE_SIZE)];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_usb0_fsj.Grp      = fs_usb0_fsj_grp;
+      fs_usb0_fsj.GrpMax   = FAT_JOURNAL_GROUP;
+     #endif
       fs_usb0_vol.fsj      = &fs_usb0_fsj;
       fs_usb0_vol.RsvdS    = FAT_SECT_RSVD;
      #else
       fs_usb0_vol.fsj      = NULL;
       fs_usb0_vol.RsvdS    = 0;
      #endif
+      fs_usb0_vol.DirectIO = 1U;
       break;
 #endif /* USB0_ENABLE */
 
@@ -1612,6 +1982,17 @@ __STATIC_INLINE void fs_config_usb (char num) {
       fs_usb1_vol.Mutex    = fs_mutex_new ("U1");
       fs_usb1_vol.Drv      = &fs_usb1_drv;
       fs_usb1_vol.CaSize   = USB1_CACHE_SIZE * 2;
+      fs_usb1_vol.FatCaBuf = &usb1_cache[FAT_CACHE_BUF_SZ(USB1_CACHE_SIZE) + USB1_FAT_JOURNAL * FAT_SECT_BUF_SZ];
+      fs_usb1_vol.fat.ent  = usb1_fcache;
+      fs_usb1_vol.fat.cnt  = FAT_TABLE_CACHE_SIZE;
+     #if (FAT_FREE_MAP_SIZE > 0)
+      fs_usb1_vol.fmap.map = usb1_fmap;
+      fs_usb1_vol.fmap.size = FAT_FREE_MAP_SIZE / 4;
+     #endif
+     #if (FAT_DIR_INDEX_SIZE > 0)
+      fs_usb1_vol.didx.buf = usb1_didx;
+      fs_usb1_vol.didx.size = FAT_DIR_INDEX_SIZE / 4;
+     #endif
       fs_usb1_vol.CaBuf    = usb1_cache;
      #if (USB1_NAME_CACHE_SIZE)
       fs_usb1_vol.ncache   = &usb1_ncache;
@@ -1621,13 +2002,18 @@ __STATIC_INLINE void fs_config_usb (char num) {
 
      #if (USB1_FAT_JOURNAL)
       /* Register file system journal */
-      fs_usb1_fsj.buf      = (uint8_t *)&usb1_cache[(USB1_CACHE_SIZE+1) * 256];
+      fs_usb1_fsj.buf      = (uint8_t *)&usb1_cache[FAT_CACHE_BUF_SZ(USB1_CACHE_SIZE)];
+     #if (FAT_JOURNAL_GROUP > 0)
+      fs_usb1_fsj.Grp      = fs_usb1_fsj_grp;
+      fs_usb1_fsj.GrpMax   = FAT_JOURNAL_GROUP;
+     #endif
       fs_usb1_vol.fsj      = &fs_usb1_fsj;
       fs_usb1_vol.RsvdS    = FAT_SECT_RSVD;
      #else
       fs_usb1_vol.fsj      = NULL;
       fs_usb1_vol.RsvdS    = 0;
      #endif
+      fs_usb1_vol.DirectIO = 1U;
       break;
 #endif /* USB1_ENABLE */
   }
@@ -1752,6 +2138,7 @@ int __wrap_fflush (FILE *stream) {
  fsStatus efs_format (fsEFS_Volume *v)                             { (void)v;                   return (fsError); }
  int64_t  efs_free   (fsEFS_Volume *v)                             { (void)v;                   return (-1);      }
  fsStatus efs_defrag (fsEFS_Volume *v)                             { (void)v;                   return (fsError); }
+ int32_t  efs_reclaim(fsEFS_Volume *v)                             { (void)v;                   return (-1);      }
  fsStatus efs_info   (fsDriveInfo *i, fsEFS_Volume *v)             { (void)i; (void)v;          return (fsError); }
 #endif /* EFS_USE */
 
@@ -1768,6 +2155,8 @@ int __wrap_fflush (FILE *stream) {
  fsStatus fat_flush(int32_t h)                                       { (void)h;                   return (fsError); }
  int32_t  fat_flen (int32_t h)                                       { (void)h;                   return (-1);      }
  int64_t  fat_seek (int32_t h, int64_t o, int32_t w)                 { (void)h; (void)o; (void)w; return (fsError); }
+ fsStatus fat_allocate (int32_t h, uint32_t s, uint32_t f)           { (void)h; (void)s; (void)f; return (fsError); }
+ void     fat_io_run (void)                                          {                                              }
  fsStatus fat_ffind  (const char *p, fsFileInfo *i, fsFAT_Volume *v) { (void)p; (void)i; (void)v; return (fsError); }
  fsStatus fat_delete  (const char *p, const char *o, fsFAT_Volume *v){ (void)p; (void)o; (void)v; return (fsError); }
  fsStatus fat_rename (const char *p, const char *n, fsFAT_Volume *v) { (void)p; (void)n; (void)v; return (fsError); }
@@ -1778,6 +2167,8 @@ int __wrap_fflush (FILE *stream) {
  fsStatus fat_pwd (char *p, uint32_t l, fsFAT_Volume *v)             { (void)p; (void)l; (void)v; return (fsError); }
  fsStatus fat_media (fsFAT_Volume *v)                                { (void)v;                   return (fsError); }
  fsStatus fat_info (fsDriveInfo *i, fsFAT_Volume *v)                 { (void)i; (void)v;          return (fsError); }
+ int32_t  fat_reclaim (fsFAT_Volume *v)                              { (void)v;                   return (-1);      }
+ fsStatus fat_trim (fsFAT_Volume *v)                                 { (void)v;                   return (fsError); }
  fsStatus fat_chdir (const char *p, fsFAT_Volume *v)                 { (void)p; (void)v;          return (fsError); }
  fsStatus fat_mkdir (const char *p, fsFAT_Volume *v)                 { (void)p; (void)v;          return (fsError); }
  fsStatus fat_rmdir (const char *p, const char *o, fsFAT_Volume *v)  { (void)p; (void)o; (void)v; return (fsError); }
@@ -1793,6 +2184,8 @@ int __wrap_fflush (FILE *stream) {
   uint32_t fsj_set_space (FSJOUR *p, uint32_t s, uint32_t c)             { (void)p; (void)s; (void)c;          return (false); }
   uint32_t fsj_write     (FSJOUR *p, uint32_t s, uint32_t c, uint8_t *b) { (void)p; (void)s; (void)c; (void)b; return (false); }
   uint32_t fsj_init      (FSJOUR *p, FAT_DRV *d)                         { (void)p; (void)d;                   return (false); }
+  uint32_t fsj_find      (FSJOUR *p, uint32_t s)                         { (void)p; (void)s;                   return (0);     }
+  uint32_t fsj_commit    (FSJOUR *p)                                     { (void)p;                            return (true);  }
  #endif
 #endif /* FAT_USE */
 
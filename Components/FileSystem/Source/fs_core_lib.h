@@ -45,6 +45,7 @@
 #define fsDevCtrlCodeBlockCount    255  /* Retrieve total number of blocks on the volume */
 #define fsDevCtrlCodeErasedValue   254  /* Retrieve the value of erased memory content   */
 #define fsDevCtrlCodeProgramUnit   253  /* Retrieve smallest programmable unit in bytes  */
+#define fsDevCtrlCodePageSize      252  /* Retrieve optimal programming page size        */
 
 #ifdef __cplusplus
 extern "C"  {
@@ -74,13 +75,32 @@ typedef struct fat_nca_cfg {
   uint32_t *NameMemPool;                /* Name cache memory pool             */
 } const FAT_NCACHE_CFG;
 
+/* FAT Sector Cache entry */
+typedef struct fcache_ent {
+  uint32_t sect;                        /* Cached FAT sector number           */
+  uint8_t  *buf;                        /* FAT sector buffer                  */
+  uint32_t age;                         /* Last access tick (LRU replacement) */
+  uint8_t  dirty;                       /* Sector content modified            */
+  uint8_t  rsvd[3];                     /* Reserved for future use            */
+} FCACHE_ENT;
+
+/* FAT sector run not yet written to copy of FAT */
+typedef struct fmirr_run {
+  uint32_t sect;                        /* First FAT sector of the run        */
+  uint32_t cnt;                         /* Number of sectors (0=unused)       */
+} FMIRR_RUN;
+
 /* FAT Sector Caching structure */
 typedef struct fcache {
   uint32_t sect;                        /* Cached FAT sector number           */
   uint8_t  *buf;                        /* FAT sector cache buffer            */
   uint8_t  dirty;                       /* FAT table content modified         */
   uint8_t  cfat;                        /* Current FAT                        */
-  uint8_t  rsvd[2];                     /* Reserved for future use            */
+  uint8_t  cnt;                         /* Number of cache entries            */
+  uint8_t  idx;                         /* Current cache entry index          */
+  uint32_t tick;                        /* Cache access tick counter          */
+  FMIRR_RUN mrun[4];                    /* Runs of sectors not mirrored       */
+  FCACHE_ENT *ent;                      /* Cache entries                      */
 } FCACHE;
 
 /* Data Sector Caching structure */
@@ -91,9 +111,67 @@ typedef struct dcache {
   uint8_t  *cbuf;                       /* Data Cache sector buffer           */
   uint8_t  nwr;                         /* Number of buffered write sectors   */
   uint8_t  nrd;                         /* Number of cached read sectors      */
-  uint8_t  rsvd[2];                     /* Reserved for future use            */
+  uint8_t  nra;                         /* Number of read-ahead sectors       */
+  uint8_t  wmark;                       /* Write-behind watermark (0=off)     */
+  uint32_t rasect;                      /* Read-ahead starting sector number  */
+  uint32_t cbsz;                        /* Data Cache buffer size in bytes    */
 } DCACHE;
 
+/* Free Cluster Map structure */
+typedef struct fmap {
+  uint32_t *map;                        /* Map of fully allocated groups      */
+  uint32_t  size;                       /* Map size in 32-bit words           */
+  uint32_t  shift;                      /* Group size (log2 of cluster count) */
+} FMAP;
+
+/* Pending Discard cluster run */
+typedef struct fdisc_run {
+  uint32_t Clus;                        /* First freed cluster                */
+  uint32_t Cnt;                         /* Number of freed clusters (0=unused)*/
+} FDISC_RUN;
+
+/* Pending Discard structure */
+typedef struct fdisc {
+  FDISC_RUN run[4];                     /* Freed runs not yet discarded       */
+} FDISC;
+
+/* Directory Index entry (20 bytes) */
+typedef struct dindex_ent {
+  uint32_t NameH;                       /* Long name hash or short name hash  */
+  uint32_t ShortH;                      /* Short name hash                    */
+  uint32_t Clus;                        /* First entry cluster                */
+  uint16_t Offs;                        /* First entry offset within dir      */
+  uint8_t  Cnt;                         /* Number of entries (0=unused)       */
+  uint8_t  Rsvd;                        /* Reserved (padding)                 */
+  uint16_t NextN;                       /* Next entry in name hash chain      */
+  uint16_t NextS;                       /* Next entry in short hash chain     */
+} DINDEX_ENT;
+
+/* Directory Index free entry run */
+typedef struct dindex_run {
+  uint32_t Clus;                        /* First free entry cluster           */
+  uint16_t Offs;                        /* First free entry offset within dir */
+  uint16_t Len;                         /* Number of free entries (0=unused)  */
+} DINDEX_RUN;
+
+/* Directory Index structure */
+typedef struct dindex {
+  uint32_t   *buf;                      /* Index memory pool                  */
+  uint32_t    size;                     /* Index memory pool size in words    */
+  uint32_t    dir;                      /* First cluster of indexed directory */
+  uint16_t   *bkt;                      /* Name and short name hash buckets   */
+  DINDEX_ENT *ent;                      /* Index entries                      */
+  uint16_t    nbkt;                     /* Number of hash buckets             */
+  uint16_t    max;                      /* Maximum number of entries          */
+  uint16_t    top;                      /* Number of entries ever used        */
+  uint16_t    free;                     /* First unused entry (free chain)    */
+  uint32_t    tClus;                    /* Last record cluster                */
+  uint16_t    tOffs;                    /* Last record offset within dir      */
+  uint8_t     state;                    /* Index state                        */
+  uint8_t     lost;                     /* Some free entry runs not tracked   */
+  DINDEX_RUN  run[4];                   /* Longest runs of free entries       */
+} DINDEX;
+
 /* Name Caching structure */
 typedef struct ncache {
   uint32_t  max_path_depth;             /* Maximum path depth                 */
@@ -145,7 +223,11 @@ typedef struct fsjour {
   uint32_t TrSect;                      /* Transaction sector                 */
   uint8_t  State;                       /* Journal state                      */
   uint8_t  Status;                      /* Journal status                     */
-  uint8_t  Reserved[2];                 /* Reserved for future use            */
+  uint16_t SectSize;                    /* Sector size in bytes               */
+  uint32_t *Grp;                        /* Group sector list (sect, rsec)     */
+  uint8_t  GrpMax;                      /* Max number of sectors in a group   */
+  uint8_t  GrpCnt;                      /* Number of sectors in open group    */
+  uint16_t Reserved;                    /* Reserved for future use            */
 } FSJOUR;
 
 /* FAT Volume Description */
@@ -156,6 +238,7 @@ typedef struct _fsFAT_Volume {
   uint32_t    Status;                   /* Volume Status                      */
   uint32_t   *CaBuf;                    /* Cache Buffer (FAT + Data)          */
   uint32_t    CaSize;                   /* Cache Buffer size                  */
+  uint32_t   *FatCaBuf;                 /* Additional FAT Cache sector buffer */
   uint32_t    free_clus_cnt;            /* FAT32: Number of free clusters     */
   uint32_t    free_clus;                /* FAT32: First free cluster          */
   uint32_t    cdir_clus;                /* Current directory cluster          */
@@ -164,10 +247,23 @@ typedef struct _fsFAT_Volume {
   FATINFO     cfg;                      /* FAT Volume configuration           */
   FCACHE      fat;                      /* FAT table cache control            */
   DCACHE      ca;                       /* Data cache control                 */
+  FMAP        fmap;                     /* Free cluster map                   */
+  DINDEX      didx;                     /* Directory index                    */
+  FDISC       disc;                     /* Pending discard runs               */
   uint16_t    RsvdS;                    /* Reserved sectors used by journal   */
-  uint8_t     Reserved[2];              /* Reserved for future use            */
+  uint8_t     DirectIO;                 /* Direct transfers to user buffers   */
+  uint8_t     Reserved;                 /* Reserved for future use            */
 } fsFAT_Volume;
 
+/* FAT File Cluster Extent */
+#define FAT_EXT_CNT  8                  /* Number of extents per file handle  */
+
+typedef struct fat_ext {
+  uint32_t fclus;                       /* File cluster index                 */
+  uint32_t clus;                        /* First data cluster of the extent   */
+  uint32_t cnt;                         /* Number of contiguous clusters      */
+} FAT_EXT;
+
 /* FAT File Handle Description */
 typedef struct _fsFAT_Handle {
   fsFAT_Volume *vol;                    /* FAT volume pointer                 */
@@ -180,7 +276,9 @@ typedef struct _fsFAT_Handle {
   uint32_t  first_clus;                 /* First data cluster                 */
   uint32_t  current_clus;               /* Current data cluster               */
   uint8_t   current_sect;               /* Current data sector                */
-  uint8_t   rsvd[3];                    /* Reserved for future use            */
+  uint8_t   ext_cnt;                    /* Number of used cluster extents     */
+  uint8_t   rsvd[2];                    /* Reserved for future use            */
+  FAT_EXT   ext[FAT_EXT_CNT];           /* File cluster extent map            */
 } fsFAT_Handle;
 
 /* EFS File System driver */
@@ -195,6 +293,53 @@ typedef struct _EFS_DRV {
   fsStatus (*DeviceCtrl)       (fsDevCtrlCode code, void *p);
 } const EFS_DRV;
 
+/* EFS File Index entry (24 bytes) */
+typedef struct efs_fidx_ent {
+  uint32_t Hash;                        /* File name hash (name chunk)        */
+  uint32_t Start;                       /* Chunk start offset within block    */
+  uint32_t End;                         /* Chunk end offset within block      */
+  uint16_t FileID;                      /* FALLOC file ID (0=unused entry)    */
+  uint16_t Index;                       /* FALLOC chunk index                 */
+  uint16_t Block;                       /* Block containing the chunk         */
+  uint16_t NextI;                       /* Next entry in file ID hash chain   */
+  uint16_t NextN;                       /* Next entry in name hash chain      */
+  uint16_t Rsvd;                        /* Reserved (padding)                 */
+} EFS_FIDX_ENT;
+
+/* EFS File Index structure */
+typedef struct efs_fidx {
+  uint32_t     *buf;                    /* Index memory pool                  */
+  uint32_t      size;                   /* Index memory pool size in words    */
+  uint16_t     *bkt;                    /* File ID and name hash buckets      */
+  EFS_FIDX_ENT *ent;                    /* Index entries                      */
+  uint16_t      nbkt;                   /* Number of hash buckets             */
+  uint16_t      max;                    /* Maximum number of entries          */
+  uint16_t      top;                    /* Number of entries ever used        */
+  uint16_t      free;                   /* First unused entry (free chain)    */
+  uint16_t      cnt;                    /* Number of used entries             */
+  uint8_t       state;                  /* Index state                        */
+  uint8_t       rsvd;                   /* Reserved (padding)                 */
+} EFS_FIDX;
+
+/* EFS Write Combining Buffer */
+typedef struct efs_wbuf {
+  uint32_t *buf;                        /* Buffer memory                      */
+  uint32_t  size;                       /* Buffer size in words               */
+  uint32_t  page;                       /* Program page size in bytes (0=off) */
+  uint32_t  addr;                       /* Flash address of buffered data     */
+  uint32_t  cnt;                        /* Number of buffered bytes           */
+  struct _fsEFS_Handle *owner;          /* File handle owning buffered data   */
+} EFS_WBUF;
+
+/* EFS Reclaim Cursor */
+typedef struct efs_rclm {
+  uint32_t  max;                        /* Invalidated data in victim block   */
+  uint16_t  block;                      /* Next block to examine              */
+  uint16_t  victim;                     /* Block with most invalidated data   */
+  uint16_t  empty;                      /* Erased blocks counted in this pass */
+  uint16_t  cnt;                        /* Erased blocks counted in last pass */
+} EFS_RCLM;
+
 /* EFS Volume Description */
 typedef struct _fsEFS_Volume {
   uint32_t  DrvLet;                     /* 4-byte encoded drive letter string */
@@ -205,6 +350,9 @@ typedef struct _fsEFS_Volume {
   uint32_t  ErasedValue;                /* Erased memory value (0xFF or 0x00) */
   uint16_t  SectorCount;                /* Number of available memory sectors */
   uint16_t  TopID;                      /* Top used FileID                    */
+  EFS_FIDX  fidx;                       /* File index                         */
+  EFS_WBUF  wbuf;                       /* Write combining buffer             */
+  EFS_RCLM  rclm;                       /* Reclaim cursor                     */
 } fsEFS_Volume;
 
 /* EFS File Handle Description */
@@ -244,6 +392,8 @@ extern fsStatus usbh_msc_DevCtrl    (fsDevCtrlCode code, void *p, uint32_t insta
 extern uint32_t fsj_init      (FSJOUR *fsj, FAT_DRV *drv);
 extern uint32_t fsj_set_space (FSJOUR *fsj, uint32_t start_sect, uint32_t cnt);
 extern uint32_t fsj_write     (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *buf);
+extern uint32_t fsj_find      (FSJOUR *fsj, uint32_t sect);
+extern uint32_t fsj_commit    (FSJOUR *fsj);
 
 /* Embedded File System interface functions */
 extern int32_t  efs_handle_get(fsEFS_Volume *vol);
@@ -270,6 +420,7 @@ extern fsStatus efs_format    (fsEFS_Volume *vol);
 extern int32_t  efs_analyse   (fsEFS_Volume *vol);
 extern fsStatus efs_check     (fsEFS_Volume *vol);
 extern fsStatus efs_defrag    (fsEFS_Volume *vol);
+extern int32_t  efs_reclaim   (fsEFS_Volume *vol);
 extern fsStatus efs_info      (fsDriveInfo *info, fsEFS_Volume *vol);
 
 /* FAT File System interface functions */
@@ -285,6 +436,10 @@ extern int32_t  fat_write     (int32_t handle, const uint8_t *buf, uint32_t len)
 extern fsStatus fat_flush     (int32_t handle);
 extern int32_t  fat_flen      (int32_t handle);
 extern int64_t  fat_seek      (int32_t handle, int64_t offset, int32_t whence);
+extern fsStatus fat_allocate  (int32_t handle, uint32_t size, uint32_t flags);
+
+/* FAT Background I/O Routines */
+extern void     fat_io_run    (void);
 
 /* FAT File Maintenance Routines */
 extern fsStatus fat_delete    (const char *fn, const char *options, fsFAT_Volume *vol);
@@ -308,6 +463,8 @@ extern int64_t  fat_free      (fsFAT_Volume *vol);
 extern fsStatus fat_format    (fsFAT_Volume *vol, const char *param);
 extern fsStatus fat_media     (fsFAT_Volume *vol);
 extern fsStatus fat_info      (fsDriveInfo *info, fsFAT_Volume *vol);
+extern int32_t  fat_reclaim   (fsFAT_Volume *vol);
+extern fsStatus fat_trim      (fsFAT_Volume *vol);
 
 /* FAT Journal System Routines */
 extern uint32_t fat_jour_init (fsFAT_Volume *vol);
@@ -327,6 +484,10 @@ extern FS_MUTEX fs_mutex_new     (const void *arg);
 extern uint32_t fs_mutex_acquire (FS_MUTEX mutex);
 extern uint32_t fs_mutex_release (FS_MUTEX mutex);
 extern uint32_t fs_mutex_delete  (FS_MUTEX mutex);
+extern FS_MUTEX fs_fh_mutex_new  (uint32_t idx);
+
+extern uint32_t fs_io_thread_new    (void);
+extern void     fs_io_thread_signal (void);
 
 extern uint32_t fs_ms_rtos_tick;
 extern uint32_t fs_get_rtos_tick_freq (void);
@@ -334,8 +495,24 @@ extern uint32_t fs_set_rtos_delay (uint32_t millisec);
 extern uint32_t fs_get_sys_tick (void);
 extern uint32_t fs_get_sys_tick_us (uint32_t microsec);
 
+/* FAT Background I/O Worker write-behind watermark */
+extern uint8_t const fs_fat_io_wmark;
+
+/* FAT File Transfer Chunk size in clusters */
+extern uint8_t const fs_fat_xfer_chunk;
+
+/* FAT discard of freed clusters enabled */
+extern uint8_t const fs_fat_discard;
+
+/* FAT largest supported sector size in bytes */
+extern uint16_t const fs_fat_sect_max;
+
+/* EFS number of erased blocks kept by reclaim */
+extern uint8_t const fs_efs_reclaim_rsv;
+
 /* FAT File Handle array definition */
 extern fsFAT_Handle  fs_fat_fh[];
+extern FS_MUTEX      fs_fat_fh_mtx[];
 extern uint8_t const fs_fat_fh_cnt;
 
 /* EFS File Handle array definition */
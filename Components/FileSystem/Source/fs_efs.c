@@ -29,6 +29,14 @@ static uint32_t ed_copy          (fsEFS_Handle *fh_s, fsEFS_Handle *fh_d);
 static int32_t  efs_wr           (fsEFS_Handle *fh, const uint8_t *buf, uint32_t len);
 static int32_t  efs_rd           (fsEFS_Handle *fh,       uint8_t *buf, uint32_t len);
 
+static void     fidx_insert      (fsEFS_Volume *vol, uint32_t block, uint32_t prev, const FALLOC *fa);
+static void     fidx_del_block   (fsEFS_Volume *vol, uint32_t block);
+
+static fsStatus wbuf_flush       (fsEFS_Volume *vol, uint32_t block);
+static void     wbuf_drop        (fsEFS_Volume *vol, uint32_t block);
+
+static void     rclm_init        (fsEFS_Volume *vol);
+
 
 /**
   Check EFS volume for valid status flags.
@@ -93,6 +101,10 @@ static void efs_handles_reset (fsEFS_Volume *vol) {
   fsEFS_Handle *fh;
   uint32_t i;
 
+  /* Discard buffered data */
+  vol->wbuf.cnt   = 0U;
+  vol->wbuf.owner = NULL;
+
   /* Reset any opened files for this drive. */
   for (i = 0; i < fs_efs_fh_cnt; i++) {
     fh = &fs_efs_fh[i];
@@ -211,11 +223,18 @@ static uint32_t addr_of_sign (fsEFS_Volume *vol, uint32_t block) {
 static fsStatus block_erase (fsEFS_Volume *vol, uint32_t block) {
   fsStatus status;
 
+  /* Buffered data within erased block is not needed anymore */
+  wbuf_drop (vol, block);
+
   status = vol->Drv->SectorErase (block);
 
   if (status != fsOK) {
     EvrFsEFS_FlashEraseFailed (vol->DrvLet, block, vol->Drv->GetSectorAddress (block));
   }
+  else {
+    /* Remove chunks of erased block from the file index */
+    fidx_del_block (vol, block);
+  }
 
   return (status);
 }
@@ -269,6 +288,223 @@ static fsStatus block_read (fsEFS_Volume *vol, uint32_t addr, void *buf, uint32_
 }
 
 
+/**
+  Initialize write combining buffer.
+
+  Buffered data is programmed in pieces which end at program page boundary.
+  Page size is retrieved from the media driver and limited to buffer size.
+
+  \param[in]  vol                       volume description structure
+*/
+static void wbuf_init (fsEFS_Volume *vol) {
+  EFS_WBUF *wb = &vol->wbuf;
+  uint32_t  page;
+
+  wb->page  = 0U;
+  wb->cnt   = 0U;
+  wb->owner = NULL;
+
+  if ((wb->buf != NULL) && (wb->size != 0U)) {
+    page = wb->size * 4U;
+
+    if (vol->Drv->DeviceCtrl ((fsDevCtrlCode)fsDevCtrlCodePageSize, &wb->page) == fsOK) {
+      if ((wb->page >= EFS_PROG_UNIT) && (wb->page < page)) {
+        /* Program pages are aligned to EFS program unit */
+        page = wb->page & ~(EFS_PROG_UNIT - 1U);
+      }
+    }
+    wb->page = page;
+  }
+}
+
+
+/**
+  Check if buffered data belongs to given block.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     true/false
+*/
+static uint32_t wbuf_in_block (fsEFS_Volume *vol, uint32_t block) {
+  uint32_t addr;
+
+  if (vol->wbuf.cnt == 0U) {
+    return (false);
+  }
+
+  addr = addr_of_block (vol, block);
+
+  if ((vol->wbuf.addr < addr) || (vol->wbuf.addr >= (addr + vol->Drv->GetSectorSize (block)))) {
+    return (false);
+  }
+
+  return (true);
+}
+
+
+/**
+  Program buffered data.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  cnt                       number of bytes to program
+  \return     execution status \ref fsStatus
+*/
+static fsStatus wbuf_program (fsEFS_Volume *vol, uint32_t cnt) {
+  EFS_WBUF *wb = &vol->wbuf;
+  fsStatus  stat;
+
+  stat = block_write (vol, wb->addr, wb->buf, cnt);
+
+  if (stat == fsOK) {
+    /* Keep the remaining data at the buffer start */
+    wb->cnt  -= cnt;
+    wb->addr += cnt;
+
+    memmove (wb->buf, (uint8_t *)wb->buf + cnt, wb->cnt);
+  }
+  else {
+    /* Drop data that could not be programmed */
+    wb->cnt = 0U;
+  }
+
+  if (wb->cnt == 0U) {
+    wb->owner = NULL;
+  }
+
+  return (stat);
+}
+
+
+/**
+  Program all buffered data within given block.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     execution status \ref fsStatus
+*/
+static fsStatus wbuf_flush (fsEFS_Volume *vol, uint32_t block) {
+
+  if (wbuf_in_block (vol, block) == false) {
+    return (fsOK);
+  }
+
+  return (wbuf_program (vol, vol->wbuf.cnt));
+}
+
+
+/**
+  Discard buffered data within given block.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+*/
+static void wbuf_drop (fsEFS_Volume *vol, uint32_t block) {
+
+  if (wbuf_in_block (vol, block) == true) {
+    vol->wbuf.cnt   = 0U;
+    vol->wbuf.owner = NULL;
+  }
+}
+
+
+/**
+  Check if file data can be written through the write combining buffer.
+
+  Buffer is used by one file at a time, data of other files is programmed
+  directly.
+
+  \param[in]  fh                        file handle
+  \return     true/false
+*/
+static uint32_t wbuf_claim (fsEFS_Handle *fh) {
+  EFS_WBUF *wb = &fh->vol->wbuf;
+
+  if (wb->page == 0U) {
+    return (false);
+  }
+
+  if ((wb->cnt != 0U) && (wb->owner != fh)) {
+    /* Buffer is in use */
+    return (false);
+  }
+
+  wb->owner = fh;
+
+  return (true);
+}
+
+
+/**
+  Write file data through the write combining buffer.
+
+  Data is collected until it reaches program page boundary. Data that ends
+  unaligned is kept in buffer until it is continued or flushed.
+
+  \param[in]  fh                        file handle
+  \param[in]  addr                      flash address
+  \param[in]  buf                       data buffer
+  \param[in]  cnt                       number of bytes to write
+  \return     execution status \ref fsStatus
+*/
+static fsStatus wbuf_write (fsEFS_Handle *fh, uint32_t addr, const uint8_t *buf, uint32_t cnt) {
+  fsEFS_Volume *vol = fh->vol;
+  EFS_WBUF     *wb  = &vol->wbuf;
+  fsStatus      stat;
+  uint32_t      n, end;
+
+  stat = fsOK;
+
+  if ((wb->cnt != 0U) && (addr != (wb->addr + wb->cnt))) {
+    /* Data is not contiguous, program buffered data */
+    stat = wbuf_program (vol, wb->cnt);
+  }
+
+  if (wb->cnt == 0U) {
+    wb->addr = addr;
+  }
+
+  while ((stat == fsOK) && (cnt != 0U)) {
+    n = (wb->size * 4U) - wb->cnt;
+
+    if (n > cnt) {
+      n = cnt;
+    }
+
+    memcpy ((uint8_t *)wb->buf + wb->cnt, buf, n);
+
+    wb->cnt += n;
+    buf     += n;
+    cnt     -= n;
+
+    /* Program data up to the last page boundary */
+    end = wb->addr + wb->cnt;
+    end = end - (end % wb->page);
+
+    if (end > wb->addr) {
+      n = end - wb->addr;
+    }
+    else if (wb->cnt == (wb->size * 4U)) {
+      /* Buffer is full, program aligned part */
+      n = wb->cnt & ~(EFS_PROG_UNIT - 1U);
+    }
+    else {
+      n = 0U;
+    }
+
+    if (n != 0U) {
+      stat = wbuf_program (vol, n);
+    }
+  }
+
+  if (wb->cnt != 0U) {
+    /* Remaining data belongs to this file */
+    wb->owner = fh;
+  }
+
+  return (stat);
+}
+
+
 /**
   Read block signature (usage information).
 
@@ -366,8 +602,16 @@ static fsStatus falloc_read (fsEFS_Volume *vol, uint32_t addr, FALLOC *fa, uint3
 */
 static fsStatus falloc_write (fsEFS_Volume *vol, uint32_t block, uint32_t offs, FALLOC *fa) {
   fsStatus status;
+  FALLOC   pa;
   uint32_t addr;
 
+  /* Chunk data must be programmed before its allocation record */
+  status = wbuf_flush (vol, block);
+
+  if (status != fsOK) {
+    return (status);
+  }
+
   addr  = vol->Drv->GetSectorAddress (block);
   addr += offs;
 
@@ -376,461 +620,569 @@ static fsStatus falloc_write (fsEFS_Volume *vol, uint32_t block, uint32_t offs,
   if (status != fsOK) {
     EvrFsEFS_FlashWriteFailed (vol->DrvLet, addr, fa, sizeof(FALLOC));
   }
+  else if (vol->fidx.state == EFS_FIDX_STATE_READY) {
+    /* Chunk starts at the end of previous chunk */
+    pa.end = 0U;
+
+    if ((addr + sizeof(FALLOC)) < addr_of_sign (vol, block)) {
+      if (falloc_read (vol, addr + sizeof(FALLOC), &pa, NULL) != fsOK) {
+        /* Chunk cannot be indexed, fall back to media scan */
+        vol->fidx.state = EFS_FIDX_STATE_NONE;
+        return (status);
+      }
+    }
+    fidx_insert (vol, block, pa.end, fa);
+  }
 
   return (status);
 }
 
 
 /**
-  Search for free/unused file identification number.
+  Compute hash of an EFS file name.
 
-  \param[in]  vol                       volume description structure
-  \return     File identification number
+  \param[in]  fn                        file name
+  \return     name hash value
 */
-static uint16_t file_id_alloc (fsEFS_Volume *vol) {
-  FALLOC fa;
-  uint32_t bl, fid, addr;
+static uint32_t fidx_hash (const char *fn) {
+  uint32_t h, i;
 
-  for (fid = (vol->TopID + 1) | 0x8000; fid < 0xFFFF;  ) {
-    /* Scan all blocks for a given 'fid' */
-    for (bl = 0; bl < vol->SectorCount; bl++) {
-      /* Set address of first allocation record */
-      addr = addr_of_sign (vol, bl) - 8;
+  h = 2166136261U;
 
-      for (;;) {
-        if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
-          return (0U);
-        }
-        /* If this fileID is used, go and check next one. */
-        if (fa.fileID == fid) goto next;
-        if (fa.end == vol->ErasedValue) break;
-      }
-    }
-    vol->TopID = fid & 0x7FFF;
-    return (vol->TopID);
-next:
-    fid++;
+  for (i = 0U; (i < 31U) && (fn[i] != '\0'); i++) {
+    h = (h ^ (uint8_t)fn[i]) * 16777619U;
   }
-  /* Error */
-  return (0U);
+
+  return (h);
 }
 
 
 /**
-  Check if given name is EFS valid.
+  Initialize file index. Index memory pool is split into hash buckets
+  and index entries, one file ID and one name bucket per two entries.
 
-  \param[in]  path                      file path
-  \return    - true if given path is EFS valid
-             - false if given path is to long or contains invalid characters
+  \param[in]  vol                       volume description structure
 */
-static const char *file_name_validate (const char *path) {
-  const char *fn;
-  uint32_t len;
-#ifdef FS_DEBUG
-  const char *p = path;
-#endif
+static void fidx_init (fsEFS_Volume *vol) {
+  EFS_FIDX *fx = &vol->fidx;
+  uint32_t  n;
 
-  if (path) {
-    /* Skip slashes at the beginning */
-    if ((*path == '\\') || (*path == '/')) { path++; }
+  fx->state = EFS_FIDX_STATE_NONE;
+  fx->max   = 0U;
 
-    fn = path;
+  if (fx->buf != NULL) {
+    n = (fx->size * 4U) / (sizeof(EFS_FIDX_ENT) + 4U);
 
-    len = 0;
-    while (len < 32) {
-      if (*path == '\0') {
-        if (len) {
-          /* Valid path */
-          return (fn);
-        }
-        break;
-      }
-      else if ((*path == '\\') || (*path == '/')) { break; }
+    fx->nbkt = 1U;
+    while ((fx->nbkt * 2U) <= n) {
+      fx->nbkt <<= 1;
+    }
+    fx->bkt = (uint16_t *)fx->buf;
+    fx->ent = (EFS_FIDX_ENT *)&fx->buf[fx->nbkt];
 
-      len++;
-      path++;
+    n = ((fx->size - fx->nbkt) * 4U) / sizeof(EFS_FIDX_ENT);
+    if (n > (EFS_FIDX_NIL - 1U)) {
+      n = EFS_FIDX_NIL - 1U;
     }
+    fx->max = (uint16_t)n;
   }
-  /* Path is not valid */
-  EvrFsEFS_FileNameInvalid (p, fs_strlen(p));
-  return (NULL);
 }
 
 
 /**
-  Store file name into flash memory.
+  Clear file index.
 
-  \param[in]  handle                    file handle
-  \param[in]  fname                     file name
-  \return     execution status \ref fsStatus
+  \param[in]  fx                        file index
 */
-static fsStatus file_name_write (fsEFS_Handle *fh, const char *fname) {
-  fsStatus stat;
-  FALLOC fa;
-  uint32_t i, addr;
-  uint8_t  fn[32];
+static void fidx_clear (EFS_FIDX *fx) {
 
-  /* Determine file name length and store it zero terminated */
-  for (i = 0U; i < 31U; i++) {
-    if (fname[i] == '\0') {
-      break;
-    }
-    fn[i] = fname[i];
-  }
-  /* Add zero terminator (safety) */
-  fn[i++] = '\0';
+  /* Empty file ID and name hash chains */
+  memset (fx->bkt, 0xFF, (uint32_t)fx->nbkt * 4U);
 
-  /* Align fname length and remember the value */
-  addr = (i + 3U) & ~3U;
+  fx->top  = 0U;
+  fx->free = EFS_FIDX_NIL;
+  fx->cnt  = 0U;
+}
 
-  /* Clear remaining part of fn buffer */
-  while (i < addr) {
-    fn[i++] = 0U;
+
+/**
+  Add file chunk to the file index.
+
+  \param[in]  fx                        file index
+  \param[in]  block                     block number
+  \param[in]  start                     chunk start offset within block
+  \param[in]  fa                        file allocation record of the chunk
+  \param[in]  hash                      file name hash (name chunk only)
+  \return     true if added, false when index is full
+*/
+static uint32_t fidx_add (EFS_FIDX *fx, uint32_t block, uint32_t start, const FALLOC *fa, uint32_t hash) {
+  EFS_FIDX_ENT *e;
+  uint32_t      b;
+  uint16_t      i;
+
+  if (fx->free != EFS_FIDX_NIL) {
+    /* Reuse entry of a removed chunk */
+    i = fx->free;
+    fx->free = fx->ent[i].NextN;
+  }
+  else if (fx->top < fx->max) {
+    i = fx->top++;
+  }
+  else {
+    /* Index is full */
+    return (false);
   }
-  /* Set the actual length of file name */
-  i = addr;
 
-  /* Get flash sector address */
-  addr = addr_of_block (fh->vol, fh->fblock);
+  e = &fx->ent[i];
+  e->Hash   = hash;
+  e->Start  = start;
+  e->End    = fa->end;
+  e->FileID = fa->fileID;
+  e->Index  = fa->index;
+  e->Block  = (uint16_t)block;
+
+  /* Link name and data chunks of a file into the same file ID chain */
+  b = (fa->fileID & 0x7FFFU) & (fx->nbkt - 1U);
+  e->NextI = fx->bkt[b];
+  fx->bkt[b] = i;
+
+  if ((fa->fileID & 0x8000U) != 0U) {
+    /* Link name chunk into name hash chain */
+    b = fx->nbkt + (hash & (fx->nbkt - 1U));
+    e->NextN = fx->bkt[b];
+    fx->bkt[b] = i;
+  }
 
-  stat = block_write (fh->vol, addr + fh->fbot, fn, i);
+  fx->cnt++;
 
-  if (stat == fsOK) {
-    /* Increment bottom address by file name length */
-    fh->fbot += i;
+  return (true);
+}
 
-    /* Write allocation info, flag 0x8000 is added to FALLOC associated with file name */
-    fa.end    = fh->fbot;
-    fa.fileID = fh->fileID | 0x8000;
-    fa.index  = 0;
 
-    stat = falloc_write (fh->vol, fh->fblock, fh->ftop, &fa);
+/**
+  Unlink entry from the hash chains and put it into the free chain.
 
-    if (stat == fsOK) {
-      /* Adjust top address to next FALLOC */
-      fh->ftop -= sizeof(FALLOC);
+  \param[in]  fx                        file index
+  \param[in]  i                         entry index
+*/
+static void fidx_unlink (EFS_FIDX *fx, uint16_t i) {
+  EFS_FIDX_ENT *e;
+  uint16_t     *p;
 
-      /* Realign bottom address to 4 bytes */
-      fh->fbot = (fh->fbot + 3U) & ~3U;
+  e = &fx->ent[i];
+
+  p = &fx->bkt[(e->FileID & 0x7FFFU) & (fx->nbkt - 1U)];
+  while (*p != i) {
+    p = &fx->ent[*p].NextI;
+  }
+  *p = e->NextI;
+
+  if ((e->FileID & 0x8000U) != 0U) {
+    p = &fx->bkt[fx->nbkt + (e->Hash & (fx->nbkt - 1U))];
+    while (*p != i) {
+      p = &fx->ent[*p].NextN;
     }
+    *p = e->NextN;
   }
 
-  return (stat);
+  e->FileID = 0U;
+  e->NextN  = fx->free;
+  fx->free  = i;
+  fx->cnt--;
 }
 
 
 /**
-  Low level file create function.
+  Add file allocation record to the file index.
 
-  \param[in]  handle                    file handle
-  \param[in]  fname                     file name
-  \return     execution status \ref fsStatus
-*/
-static fsStatus file_create (fsEFS_Handle *fh, const char *fname) {
-  fsStatus stat;
-  FALLOC fa;
-  uint16_t bl;
-  uint32_t free, fn_len;
+  Index is disabled when it is full or when the file name cannot be read,
+  file operations then fall back to scanning the media.
 
-  if (fh->fileID == 0) {
-    fh->fileID = file_id_alloc (fh->vol);
-    if (fh->fileID == 0) {
-      /* All file IDs used, reset TopID */
-      fh->vol->TopID = 0;
-      fh->fileID = file_id_alloc (fh->vol);
-      if (fh->fileID == 0) {
-        /* All available fileIDs are used */
-        return (fsError);
-      }
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \param[in]  prev                      end offset of the previous chunk in block
+  \param[in]  fa                        file allocation record
+*/
+static void fidx_insert (fsEFS_Volume *vol, uint32_t block, uint32_t prev, const FALLOC *fa) {
+  uint32_t start, hash;
+  char     fn[32];
+
+  /* All chunks are 4-byte aligned */
+  start = (prev + 3U) & ~3U;
+  hash  = 0U;
+
+  if ((fa->fileID & 0x8000U) != 0U) {
+    /* Name chunk, hash the file name */
+    if (block_read (vol, addr_of_block (vol, block) + start, fn, sizeof(fn)) != fsOK) {
+      vol->fidx.state = EFS_FIDX_STATE_NONE;
+      return;
     }
-  }
+    fn[31] = '\0';
 
-  /* Determine amount of free space required to store file name */
-  fn_len = fs_strlen (fname) + 1U;
+    hash = fidx_hash (fn);
+  }
 
-  /* Align file name length */
-  fn_len = (fn_len + 3U) & ~3U;
+  if (fidx_add (&vol->fidx, block, start, fa, hash) == false) {
+    /* Too many chunks, disable the index */
+    vol->fidx.state = EFS_FIDX_STATE_NONE;
 
-  /* Find flash sector with enough free space */
-  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
-    free = 0U;
+    EvrFsEFS_FileIndexOverflow (vol->DrvLet, vol->fidx.max);
+  }
+}
 
-    /* Read sector signature */
-    stat = sign_read (fh->vol, bl, &fa.end, NULL);
 
-    if (stat != fsOK) {
-      return (stat);
-    }
+/**
+  Remove invalidated file allocation record from the file index.
 
-    if (fa.end == (fh->vol->ErasedValue ^ BlockUSED)) {
-      /* Used sector found, check if any file opened for write is using it */
-      if (efs_is_busy (fh, bl) == false) {
-        /* Not in use, determine free space */
-        free = efs_get_freeMem (fh->vol, bl);
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \param[in]  fa                        file allocation record
+*/
+static void fidx_del (fsEFS_Volume *vol, uint32_t block, const FALLOC *fa) {
+  EFS_FIDX     *fx = &vol->fidx;
+  EFS_FIDX_ENT *e;
+  uint16_t      i;
 
-        if (free == 0) {
-          /* Out of free space, mark sector as full */
-          stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockFULL);
+  if (fx->state == EFS_FIDX_STATE_READY) {
+    for (i = fx->bkt[(fa->fileID & 0x7FFFU) & (fx->nbkt - 1U)]; i != EFS_FIDX_NIL; i = e->NextI) {
+      e = &fx->ent[i];
 
-          if (stat != fsOK) {
-            return (stat);
-          }
-        }
+      if ((e->FileID == fa->fileID) && (e->Index == fa->index) && (e->Block == block)) {
+        fidx_unlink (fx, i);
+        break;
       }
     }
-    else {
-      if (fa.end == fh->vol->ErasedValue) {
-        /* Empty sector found, mark it as used */
-        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockUSED);
+  }
+}
 
-        if (stat != fsOK) {
-          return (stat);
-        }
 
-        /* Determine free space */
-        free = efs_get_freeMem (fh->vol, bl);
-      }
-    }
+/**
+  Remove all chunks within erased block from the file index.
 
-    if (free >= fn_len) {
-      /* Enough free space, break the search */
-      break;
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+*/
+static void fidx_del_block (fsEFS_Volume *vol, uint32_t block) {
+  EFS_FIDX *fx = &vol->fidx;
+  uint16_t  i;
+
+  if (fx->state == EFS_FIDX_STATE_READY) {
+    for (i = 0U; i < fx->top; i++) {
+      if ((fx->ent[i].FileID != 0U) && (fx->ent[i].Block == block)) {
+        fidx_unlink (fx, i);
+      }
     }
   }
-
-  if (bl == fh->vol->SectorCount) {
-    /* Out of free space */
-    EvrFsEFS_DiskFull (fh->vol->DrvLet);
-    return (fsError);
-  }
-
-  /* Store sector number */
-  fh->fblock = bl;
-
-  /* Determine free space area */
-  efs_mark_freeMem (fh);
-
-  stat = file_name_write(fh, fname);
-
-  return (stat);
 }
 
 
 /**
-  Low level File Find.
+  Build file index from allocation records of all used blocks.
 
-  \param[in]  handle                    file handle
-  \param[in]  fname                     file name
-  \return     execution status \ref fsStatus
+  \param[in]  vol                       volume description structure
 */
-static fsStatus file_find (fsEFS_Handle *fh, const char *fname) {
-  fsStatus stat;
-  FALLOC fa;
-  uint8_t buf[32];
-  uint16_t bl;
-  uint32_t addr, prev, fn_addr;
-  
-  /* Search all allocated File Blocks for a given fname */
-  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
+static void fidx_build (fsEFS_Volume *vol) {
+  EFS_FIDX *fx = &vol->fidx;
+  FALLOC    fa;
+  uint32_t  bl, addr, prev;
+
+  if (fx->max == 0U) {
+    /* Index not configured */
+    return;
+  }
+
+  fidx_clear (fx);
+  fx->state = EFS_FIDX_STATE_READY;
+
+  for (bl = 0U; (bl < vol->SectorCount) && (fx->state == EFS_FIDX_STATE_READY); bl++) {
     /* Read block signature */
     addr = 0U;
 
-    stat = sign_read (fh->vol, bl, &fa.end, &addr);
-
-    if (stat != fsOK) {
-      return (stat);
+    if (sign_read (vol, bl, &fa.end, &addr) != fsOK) {
+      fx->state = EFS_FIDX_STATE_NONE;
+      break;
     }
-    else {
-      if (fa.end != fh->vol->ErasedValue) {
-        /* Scan allocation records within current block */
-        for (prev = 0; ; prev = fa.end) {
-          stat = falloc_read (fh->vol, addr, &fa, &addr);
 
-          if (stat != fsOK) {
-            return (stat);
-          }
-          else {
-            if ((fa.fileID > 0x8000) && (fa.fileID < 0xFFFF)) {
-              /* Set 4-byte aligned file name address (block.start + fa.end) */
-              fn_addr = addr_of_block (fh->vol, bl) + prev;
-              fn_addr = (fn_addr + 3U) & ~3U;
+    if (fa.end != vol->ErasedValue) {
+      /* Scan allocation records within current block */
+      for (prev = 0U; ; prev = fa.end) {
+        if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
+          fx->state = EFS_FIDX_STATE_NONE;
+          break;
+        }
 
-              block_read (fh->vol, fn_addr, &buf[0], sizeof (buf));
-              buf[31] = 0;
+        if (fa.end == vol->ErasedValue) { break; }
 
-              if (strcmp (fname, (char *)&buf[0]) == 0) {
-                /* File name match */
-                fh->fileID = fa.fileID & 0x7FFF;
-                fh->fblock = bl;
+        if (((fa.fileID & 0x7FFFU) != 0U) && (fa.fileID != 0xFFFFU)) {
+          /* Valid name or data chunk */
+          fidx_insert (vol, bl, prev, &fa);
 
-                return (fsOK);
-              }
-            }
-            if (fa.end == fh->vol->ErasedValue) { break; }
-          }
+          if (fx->state != EFS_FIDX_STATE_READY) { break; }
         }
       }
     }
   }
 
-  /* File not found */
-  return (fsError);
+  if (fx->state == EFS_FIDX_STATE_READY) {
+    EvrFsEFS_FileIndexBuild (vol->DrvLet, fx->cnt);
+  }
 }
 
 
 /**
-  Delete a file.
+  Check if block is a temporary block owned by defragmenter.
 
-  \param[in]  handle                    file handle
-  \return     execution status \ref fsStatus
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     true when block is temporary or its signature cannot be read
 */
-static fsStatus file_delete (fsEFS_Handle *fh) {
-  fsStatus stat;
-  FALLOC fa;
-  uint32_t i, bl, addr, invalid, del;
+static uint32_t fidx_block_temp (fsEFS_Volume *vol, uint32_t block) {
+  uint32_t sign;
 
-  stat = fsError;
-  invalid = ~fh->vol->ErasedValue;
-  bl = fh->fblock;
+  if (sign_read (vol, block, &sign, NULL) != fsOK) {
+    return (true);
+  }
 
-  /* Search for file chunks identified with 'fileID' */
-  for (i = 0; i < fh->vol->SectorCount; i++) {
-    /* Read block signature */
-    addr = 0U;
+  return ((sign ^ BlockTEMP) == vol->ErasedValue);
+}
 
-    stat = sign_read (fh->vol, bl, &fa.end, &addr);
 
-    if (stat != fsOK) {
-      break;
-    }
+/**
+  Find file data chunk in the file index.
 
-    if (fa.end != fh->vol->ErasedValue) {
-      /* Non empty sector found, set delete flag */
-      del = 1U;
+  When the same chunk exists in several blocks, the one found first when
+  scanning blocks from the given block onward is returned, as with media scan.
 
-      if (fa.end == (fh->vol->ErasedValue ^ BlockTEMP)) {
-        /* This is temp sector (defrag in progress) */
-        if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
-          /* File not owned by defrag, no delete inside temp sectors */
-          del = 0U;
-        }
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block where the scan starts
+  \param[in]  id                        file identification number
+  \param[in]  index                     chunk index
+  \param[in]  skip_temp                 ignore chunks within temporary blocks
+  \return     index entry or NULL when chunk does not exist
+*/
+static EFS_FIDX_ENT *fidx_chunk (fsEFS_Volume *vol, uint32_t block, uint32_t id, uint32_t index, uint32_t skip_temp) {
+  EFS_FIDX     *fx = &vol->fidx;
+  EFS_FIDX_ENT *e, *sel;
+  uint32_t      dist, min;
+  uint16_t      i;
+
+  sel = NULL;
+  min = vol->SectorCount - 1U;
+
+  for (i = fx->bkt[id & (fx->nbkt - 1U)]; i != EFS_FIDX_NIL; i = e->NextI) {
+    e = &fx->ent[i];
+
+    if ((e->FileID == id) && (e->Index == index)) {
+      if (e->Block >= block) {
+        dist = e->Block - block;
+      } else {
+        dist = (e->Block + vol->SectorCount) - block;
       }
-      else {
-        /* This is used or full sector */
-        if ((fh->flags & EFS_HANDLE_DEFRAG) != 0U) {
-          /* File owned by defrag, no delete outside of temp sectors */
-          del = 0U;
+
+      if (dist <= min) {
+        /* Hash chain is in reverse scan order, last match was found first */
+        if ((skip_temp == false) || (fidx_block_temp (vol, e->Block) == false)) {
+          min = dist;
+          sel = e;
         }
       }
+    }
+  }
 
-      if (del != 0U) {
-        /* Invalidate all file chunks identified with fileID */
-        do {
-          stat = falloc_read (fh->vol, addr, &fa, &addr);
-          
-          if (stat == fsOK) {
-            if ((fa.fileID & 0x7FFF) == fh->fileID) {
-              /* Clear the fileID & index values */
-              stat = block_write (fh->vol, addr + 12, &invalid, 4);
-            }
-          }
+  return (sel);
+}
 
-          if (stat != fsOK) {
-            break;
-          }
-        } while (fa.end != fh->vol->ErasedValue);
 
-        if (stat == fsOK) {
-          /* Check if current block is invalidated */
-          if (efs_BlockInvalid (fh->vol, bl) == true) {
-            /* All file fragments are invalid */
-            stat = block_erase (fh->vol, bl);
-          }
-        }
+/**
+  Find name chunk with the lowest file ID not below the given one.
 
-        if (stat != fsOK) {
-          break;
-        }
+  \param[in]  vol                       volume description structure
+  \param[in]  nid                       lowest file ID (with name chunk flag)
+  \param[in]  skip_temp                 ignore chunks within temporary blocks
+  \return     index entry or NULL when there is no such file
+*/
+static EFS_FIDX_ENT *fidx_next (fsEFS_Volume *vol, uint32_t nid, uint32_t skip_temp) {
+  EFS_FIDX     *fx = &vol->fidx;
+  EFS_FIDX_ENT *e, *sel;
+  uint32_t      id;
+  uint16_t      i;
+
+  sel = NULL;
+  id  = 0xFFFFU;
+
+  for (i = 0U; i < fx->top; i++) {
+    e = &fx->ent[i];
+
+    if (((e->FileID & 0x8000U) != 0U) && (e->FileID >= nid) && (e->FileID < id)) {
+      if ((skip_temp == false) || (fidx_block_temp (vol, e->Block) == false)) {
+        id  = e->FileID;
+        sel = e;
+
+        if (id == nid) { break; }
       }
     }
-    bl++;
-    if (bl == fh->vol->SectorCount) {
-      bl = 0U;
-    }
   }
 
-  /* Re-set top used fileID */
-  fh->vol->TopID = fh->fileID - 1U;
-
-  /* Return execution status */
-  return (stat);
+  return (sel);
 }
 
 
 /**
-  Low level file rename function.
-  
-  - Mark old filename chunk as invalid by invalidating the fileID value
-  - Create new filename chunk containing the new name
+  Check if file ID is used by a file name chunk in the file index.
 
-  \param[in]  handle                    file handle
-  \param[in]  fname                     new name
-  \return     execution status \ref fsStatus
+  \param[in]  fx                        file index
+  \param[in]  fid                       file ID (with name chunk flag)
+  \return     true/false
 */
-static fsStatus file_rename (fsEFS_Handle *fh, const char *fname) {
-  fsStatus stat;
-  FALLOC fa;
-  uint32_t addr;
+static uint32_t fidx_id_used (EFS_FIDX *fx, uint32_t fid) {
+  EFS_FIDX_ENT *e;
+  uint16_t      i;
 
-  stat = fsOK;
+  for (i = fx->bkt[(fid & 0x7FFFU) & (fx->nbkt - 1U)]; i != EFS_FIDX_NIL; i = e->NextI) {
+    e = &fx->ent[i];
 
-  /* Set address to the first allocation info */
-  addr = addr_of_sign (fh->vol, fh->fblock) - 8;
+    if (e->FileID == fid) {
+      return (true);
+    }
+  }
 
-  do {
-    /* Read allocation info */
-    stat = falloc_read (fh->vol, addr, &fa, &addr);
-    if (stat != fsOK) {
-      break;
+  return (false);
+}
+
+
+/**
+  Search for free/unused file identification number.
+
+  \param[in]  vol                       volume description structure
+  \return     File identification number
+*/
+static uint16_t file_id_alloc (fsEFS_Volume *vol) {
+  FALLOC fa;
+  uint32_t bl, fid, addr;
+
+  if (vol->fidx.state == EFS_FIDX_STATE_READY) {
+    /* Search file index for unused fileID */
+    for (fid = (vol->TopID + 1) | 0x8000; fid < 0xFFFF; fid++) {
+      if (fidx_id_used (&vol->fidx, fid) == false) {
+        vol->TopID = fid & 0x7FFF;
+        return (vol->TopID);
+      }
     }
+    return (0U);
+  }
 
-    if (fa.fileID == (fh->fileID | 0x8000)) {
-      /* Found the file chunk containing fileID */
-      fa.end = ~fh->vol->ErasedValue;
+  for (fid = (vol->TopID + 1) | 0x8000; fid < 0xFFFF;  ) {
+    /* Scan all blocks for a given 'fid' */
+    for (bl = 0; bl < vol->SectorCount; bl++) {
+      /* Set address of first allocation record */
+      addr = addr_of_sign (vol, bl) - 8;
 
-      /* Clear the fileID value */
-      stat = block_write (fh->vol, addr + 12, &fa.end, 4);
-      break;
+      for (;;) {
+        if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
+          return (0U);
+        }
+        /* If this fileID is used, go and check next one. */
+        if (fa.fileID == fid) goto next;
+        if (fa.end == vol->ErasedValue) break;
+      }
     }
-  } while (fa.end != fh->vol->ErasedValue);
-  
-  if (stat == fsOK) {
-    /* Create new name for an existing file */
-    stat = file_create (fh, fname);
+    vol->TopID = fid & 0x7FFF;
+    return (vol->TopID);
+next:
+    fid++;
   }
+  /* Error */
+  return (0U);
+}
 
-  /* Return execution status */
-  return (stat);
+
+/**
+  Check if given name is EFS valid.
+
+  \param[in]  path                      file path
+  \return    - true if given path is EFS valid
+             - false if given path is to long or contains invalid characters
+*/
+static const char *file_name_validate (const char *path) {
+  const char *fn;
+  uint32_t len;
+#ifdef FS_DEBUG
+  const char *p = path;
+#endif
+
+  if (path) {
+    /* Skip slashes at the beginning */
+    if ((*path == '\\') || (*path == '/')) { path++; }
+
+    fn = path;
+
+    len = 0;
+    while (len < 32) {
+      if (*path == '\0') {
+        if (len) {
+          /* Valid path */
+          return (fn);
+        }
+        break;
+      }
+      else if ((*path == '\\') || (*path == '/')) { break; }
+
+      len++;
+      path++;
+    }
+  }
+  /* Path is not valid */
+  EvrFsEFS_FileNameInvalid (p, fs_strlen(p));
+  return (NULL);
 }
 
 
 /**
-  Low level file close function.
+  Store file name into flash memory.
 
   \param[in]  handle                    file handle
+  \param[in]  fname                     file name
   \return     execution status \ref fsStatus
 */
-static fsStatus file_close (fsEFS_Handle *fh) {
-  FALLOC fa;
+static fsStatus file_name_write (fsEFS_Handle *fh, const char *fname) {
   fsStatus stat;
+  FALLOC fa;
+  uint32_t i, addr;
+  uint8_t  fn[32];
 
-  stat = fsOK;
+  /* Determine file name length and store it zero terminated */
+  for (i = 0U; i < 31U; i++) {
+    if (fname[i] == '\0') {
+      break;
+    }
+    fn[i] = fname[i];
+  }
+  /* Add zero terminator (safety) */
+  fn[i++] = '\0';
 
-  if ((fh->flags & EFS_HANDLE_WALLOC) != 0) {
-    /* Write File Allocation Information */
+  /* Align fname length and remember the value */
+  addr = (i + 3U) & ~3U;
+
+  /* Clear remaining part of fn buffer */
+  while (i < addr) {
+    fn[i++] = 0U;
+  }
+  /* Set the actual length of file name */
+  i = addr;
+
+  /* Get flash sector address */
+  addr = addr_of_block (fh->vol, fh->fblock);
+
+  stat = block_write (fh->vol, addr + fh->fbot, fn, i);
+
+  if (stat == fsOK) {
+    /* Increment bottom address by file name length */
+    fh->fbot += i;
+
+    /* Write allocation info, flag 0x8000 is added to FALLOC associated with file name */
     fa.end    = fh->fbot;
-    fa.fileID = fh->fileID;
-    fa.index  = fh->fidx;
+    fa.fileID = fh->fileID | 0x8000;
+    fa.index  = 0;
 
     stat = falloc_write (fh->vol, fh->fblock, fh->ftop, &fa);
 
@@ -840,14 +1192,6 @@ static fsStatus file_close (fsEFS_Handle *fh) {
 
       /* Realign bottom address to 4 bytes */
       fh->fbot = (fh->fbot + 3U) & ~3U;
-
-      if (fh->fbot >= (fh->ftop - sizeof(FALLOC))) {
-        /* Block is full */
-        if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
-          /* Update signature */
-          stat = sign_write (fh->vol, fh->fblock, fh->vol->ErasedValue ^ BlockFULL);
-        }
-      }
     }
   }
 
@@ -856,452 +1200,1311 @@ static fsStatus file_close (fsEFS_Handle *fh) {
 
 
 /**
-  Determine size of a file with a given id.
+  Low level file create function.
 
-  \param[in]  vol
-  \param[in]  id
+  \param[in]  handle                    file handle
+  \param[in]  fname                     file name
   \return     execution status \ref fsStatus
 */
-static uint32_t file_size_get (fsEFS_Volume *vol, uint32_t block, uint32_t id) {
+static fsStatus file_create (fsEFS_Handle *fh, const char *fname) {
+  fsStatus stat;
   FALLOC fa;
-  uint32_t addr, prev;
-  uint32_t i, size;
+  uint16_t bl;
+  uint32_t free, fn_len;
 
-  size = 0;
+  if (fh->fileID == 0) {
+    fh->fileID = file_id_alloc (fh->vol);
+    if (fh->fileID == 0) {
+      /* All file IDs used, reset TopID */
+      fh->vol->TopID = 0;
+      fh->fileID = file_id_alloc (fh->vol);
+      if (fh->fileID == 0) {
+        /* All available fileIDs are used */
+        return (fsError);
+      }
+    }
+  }
 
-  /* Search for data blocks identified with 'fileID'. */
-  for (i = 0; i < vol->SectorCount; i++) {
-    /* Read block signature */
-    addr = 0U;
+  /* Determine amount of free space required to store file name */
+  fn_len = fs_strlen (fname) + 1U;
 
-    if (sign_read (vol, block, &fa.end, &addr) != fsOK) {
-      return (0U);
+  /* Align file name length */
+  fn_len = (fn_len + 3U) & ~3U;
+
+  /* Find flash sector with enough free space */
+  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
+    free = 0U;
+
+    /* Read sector signature */
+    stat = sign_read (fh->vol, bl, &fa.end, NULL);
+
+    if (stat != fsOK) {
+      return (stat);
     }
 
-    if (fa.end != vol->ErasedValue) {
-      /* Scan allocation records within current block */
-      for (prev = 0; ; prev = fa.end) {
-        if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
-          return (0U);
-        }
+    if (fa.end == (fh->vol->ErasedValue ^ BlockUSED)) {
+      /* Used sector found, check if any file opened for write is using it */
+      if (efs_is_busy (fh, bl) == false) {
+        /* Not in use, determine free space */
+        free = efs_get_freeMem (fh->vol, bl);
 
-        if (fa.fileID == id) {
-          /* All file blocks are 4-byte aligned. */
-          size += (fa.end - ((prev + 3U) & ~3U));
+        if (free == 0) {
+          /* Out of free space, mark sector as full */
+          stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockFULL);
+
+          if (stat != fsOK) {
+            return (stat);
+          }
         }
+      }
+    }
+    else {
+      if (fa.end == fh->vol->ErasedValue) {
+        /* Empty sector found, mark it as used */
+        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockUSED);
 
-        if (fa.end == vol->ErasedValue) {
-          /* Free space - end of file */
-          break;
+        if (stat != fsOK) {
+          return (stat);
         }
+
+        /* Determine free space */
+        free = efs_get_freeMem (fh->vol, bl);
       }
     }
-    /* Go to next block */
-    block++;
 
-    if (block == vol->SectorCount) {
-      block = 0;
+    if (free >= fn_len) {
+      /* Enough free space, break the search */
+      break;
     }
   }
 
-  return (size);
+  if (bl == fh->vol->SectorCount) {
+    /* Out of free space */
+    EvrFsEFS_DiskFull (fh->vol->DrvLet);
+    return (fsError);
+  }
+
+  /* Store sector number */
+  fh->fblock = bl;
+
+  /* Determine free space area */
+  efs_mark_freeMem (fh);
+
+  stat = file_name_write(fh, fname);
+
+  return (stat);
 }
 
 
 /**
-  Defragmenter file copy function.
+  Low level File Find.
 
-  \param[in]  fh_s                    source file handle
-  \param[in]  fh_d                    destination file handle
-  \return     - true  = success
-              - false = file copy failed
+  \param[in]  handle                    file handle
+  \param[in]  fname                     file name
+  \return     execution status \ref fsStatus
+*/
+static fsStatus file_find (fsEFS_Handle *fh, const char *fname) {
+  fsStatus stat;
+  FALLOC fa;
+  EFS_FIDX_ENT *e;
+  uint8_t buf[32];
+  uint16_t bl, i;
+  uint32_t addr, prev, fn_addr, hash;
+
+  if (fh->vol->fidx.state == EFS_FIDX_STATE_READY) {
+    /* Compare names of indexed files with matching name hash */
+    hash = fidx_hash (fname);
+
+    i = fh->vol->fidx.bkt[fh->vol->fidx.nbkt + (hash & (fh->vol->fidx.nbkt - 1U))];
+
+    for ( ; i != EFS_FIDX_NIL; i = e->NextN) {
+      e = &fh->vol->fidx.ent[i];
+
+      if (e->Hash == hash) {
+        stat = block_read (fh->vol, addr_of_block (fh->vol, e->Block) + e->Start, &buf[0], sizeof (buf));
+
+        if (stat != fsOK) {
+          return (stat);
+        }
+        buf[31] = 0;
+
+        if (strcmp (fname, (char *)&buf[0]) == 0) {
+          /* File name match */
+          fh->fileID = e->FileID & 0x7FFF;
+          fh->fblock = e->Block;
+
+          return (fsOK);
+        }
+      }
+    }
+    /* File not found */
+    return (fsError);
+  }
+
+  /* Search all allocated File Blocks for a given fname */
+  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
+    /* Read block signature */
+    addr = 0U;
+
+    stat = sign_read (fh->vol, bl, &fa.end, &addr);
+
+    if (stat != fsOK) {
+      return (stat);
+    }
+    else {
+      if (fa.end != fh->vol->ErasedValue) {
+        /* Scan allocation records within current block */
+        for (prev = 0; ; prev = fa.end) {
+          stat = falloc_read (fh->vol, addr, &fa, &addr);
+
+          if (stat != fsOK) {
+            return (stat);
+          }
+          else {
+            if ((fa.fileID > 0x8000) && (fa.fileID < 0xFFFF)) {
+              /* Set 4-byte aligned file name address (block.start + fa.end) */
+              fn_addr = addr_of_block (fh->vol, bl) + prev;
+              fn_addr = (fn_addr + 3U) & ~3U;
+
+              block_read (fh->vol, fn_addr, &buf[0], sizeof (buf));
+              buf[31] = 0;
+
+              if (strcmp (fname, (char *)&buf[0]) == 0) {
+                /* File name match */
+                fh->fileID = fa.fileID & 0x7FFF;
+                fh->fblock = bl;
+
+                return (fsOK);
+              }
+            }
+            if (fa.end == fh->vol->ErasedValue) { break; }
+          }
+        }
+      }
+    }
+  }
+
+  /* File not found */
+  return (fsError);
+}
+
+
+/**
+  Delete a file.
+
+  \param[in]  handle                    file handle
+  \return     execution status \ref fsStatus
+*/
+static fsStatus file_delete (fsEFS_Handle *fh) {
+  fsStatus stat;
+  FALLOC fa;
+  uint32_t i, bl, addr, invalid, del;
+
+  stat = fsError;
+  invalid = ~fh->vol->ErasedValue;
+  bl = fh->fblock;
+
+  /* Search for file chunks identified with 'fileID' */
+  for (i = 0; i < fh->vol->SectorCount; i++) {
+    /* Read block signature */
+    addr = 0U;
+
+    stat = sign_read (fh->vol, bl, &fa.end, &addr);
+
+    if (stat != fsOK) {
+      break;
+    }
+
+    if (fa.end != fh->vol->ErasedValue) {
+      /* Non empty sector found, set delete flag */
+      del = 1U;
+
+      if (fa.end == (fh->vol->ErasedValue ^ BlockTEMP)) {
+        /* This is temp sector (defrag in progress) */
+        if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
+          /* File not owned by defrag, no delete inside temp sectors */
+          del = 0U;
+        }
+      }
+      else {
+        /* This is used or full sector */
+        if ((fh->flags & EFS_HANDLE_DEFRAG) != 0U) {
+          /* File owned by defrag, no delete outside of temp sectors */
+          del = 0U;
+        }
+      }
+
+      if (del != 0U) {
+        /* Invalidate all file chunks identified with fileID */
+        do {
+          stat = falloc_read (fh->vol, addr, &fa, &addr);
+          
+          if (stat == fsOK) {
+            if ((fa.fileID & 0x7FFF) == fh->fileID) {
+              /* Clear the fileID & index values */
+              stat = block_write (fh->vol, addr + 12, &invalid, 4);
+
+              if (stat == fsOK) {
+                fidx_del (fh->vol, bl, &fa);
+              }
+            }
+          }
+
+          if (stat != fsOK) {
+            break;
+          }
+        } while (fa.end != fh->vol->ErasedValue);
+
+        if (stat == fsOK) {
+          /* Check if current block is invalidated */
+          if (efs_BlockInvalid (fh->vol, bl) == true) {
+            /* All file fragments are invalid */
+            stat = block_erase (fh->vol, bl);
+          }
+        }
+
+        if (stat != fsOK) {
+          break;
+        }
+      }
+    }
+    bl++;
+    if (bl == fh->vol->SectorCount) {
+      bl = 0U;
+    }
+  }
+
+  /* Re-set top used fileID */
+  fh->vol->TopID = fh->fileID - 1U;
+
+  /* Return execution status */
+  return (stat);
+}
+
+
+/**
+  Low level file rename function.
+  
+  - Mark old filename chunk as invalid by invalidating the fileID value
+  - Create new filename chunk containing the new name
+
+  \param[in]  handle                    file handle
+  \param[in]  fname                     new name
+  \return     execution status \ref fsStatus
+*/
+static fsStatus file_rename (fsEFS_Handle *fh, const char *fname) {
+  fsStatus stat;
+  FALLOC fa;
+  uint32_t addr;
+
+  stat = fsOK;
+
+  /* Set address to the first allocation info */
+  addr = addr_of_sign (fh->vol, fh->fblock) - 8;
+
+  do {
+    /* Read allocation info */
+    stat = falloc_read (fh->vol, addr, &fa, &addr);
+    if (stat != fsOK) {
+      break;
+    }
+
+    if (fa.fileID == (fh->fileID | 0x8000)) {
+      /* Found the file chunk containing fileID */
+      fa.end = ~fh->vol->ErasedValue;
+
+      /* Clear the fileID value */
+      stat = block_write (fh->vol, addr + 12, &fa.end, 4);
+
+      if (stat == fsOK) {
+        fidx_del (fh->vol, fh->fblock, &fa);
+      }
+      break;
+    }
+  } while (fa.end != fh->vol->ErasedValue);
+  
+  if (stat == fsOK) {
+    /* Create new name for an existing file */
+    stat = file_create (fh, fname);
+  }
+
+  /* Return execution status */
+  return (stat);
+}
+
+
+/**
+  Low level file close function.
+
+  \param[in]  handle                    file handle
+  \return     execution status \ref fsStatus
+*/
+static fsStatus file_close (fsEFS_Handle *fh) {
+  FALLOC fa;
+  fsStatus stat;
+
+  stat = fsOK;
+
+  if (fh->vol->wbuf.owner == fh) {
+    /* Program data buffered for this file */
+    stat = wbuf_flush (fh->vol, fh->fblock);
+  }
+
+  if ((stat == fsOK) && ((fh->flags & EFS_HANDLE_WALLOC) != 0)) {
+    /* Write File Allocation Information */
+    fa.end    = fh->fbot;
+    fa.fileID = fh->fileID;
+    fa.index  = fh->fidx;
+
+    stat = falloc_write (fh->vol, fh->fblock, fh->ftop, &fa);
+
+    if (stat == fsOK) {
+      /* Adjust top address to next FALLOC */
+      fh->ftop -= sizeof(FALLOC);
+
+      /* Realign bottom address to 4 bytes */
+      fh->fbot = (fh->fbot + 3U) & ~3U;
+
+      if (fh->fbot >= (fh->ftop - sizeof(FALLOC))) {
+        /* Block is full */
+        if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
+          /* Update signature */
+          stat = sign_write (fh->vol, fh->fblock, fh->vol->ErasedValue ^ BlockFULL);
+        }
+      }
+    }
+  }
+
+  return (stat);
+}
+
+
+/**
+  Determine size of a file with a given id.
+
+  \param[in]  vol
+  \param[in]  id
+  \return     execution status \ref fsStatus
+*/
+static uint32_t file_size_get (fsEFS_Volume *vol, uint32_t block, uint32_t id) {
+  FALLOC fa;
+  EFS_FIDX_ENT *e;
+  uint32_t addr, prev;
+  uint32_t i, size;
+
+  size = 0;
+
+  if (vol->fidx.state == EFS_FIDX_STATE_READY) {
+    /* Sum sizes of indexed data chunks */
+    for (i = vol->fidx.bkt[id & (vol->fidx.nbkt - 1U)]; i != EFS_FIDX_NIL; i = e->NextI) {
+      e = &vol->fidx.ent[i];
+
+      if (e->FileID == id) {
+        size += (e->End - e->Start);
+      }
+    }
+    return (size);
+  }
+
+  /* Search for data blocks identified with 'fileID'. */
+  for (i = 0; i < vol->SectorCount; i++) {
+    /* Read block signature */
+    addr = 0U;
+
+    if (sign_read (vol, block, &fa.end, &addr) != fsOK) {
+      return (0U);
+    }
+
+    if (fa.end != vol->ErasedValue) {
+      /* Scan allocation records within current block */
+      for (prev = 0; ; prev = fa.end) {
+        if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
+          return (0U);
+        }
+
+        if (fa.fileID == id) {
+          /* All file blocks are 4-byte aligned. */
+          size += (fa.end - ((prev + 3U) & ~3U));
+        }
+
+        if (fa.end == vol->ErasedValue) {
+          /* Free space - end of file */
+          break;
+        }
+      }
+    }
+    /* Go to next block */
+    block++;
+
+    if (block == vol->SectorCount) {
+      block = 0;
+    }
+  }
+
+  return (size);
+}
+
+
+/**
+  Defragmenter file copy function.
+
+  \param[in]  fh_s                    source file handle
+  \param[in]  fh_d                    destination file handle
+  \return     - true  = success
+              - false = file copy failed
+*/
+static uint32_t ed_copy (fsEFS_Handle *fh_s, fsEFS_Handle *fh_d) {
+  FALLOC fa;
+  uint32_t addr, n, nr, sz;
+
+  /* Initialize destination file handle */
+  fh_d->fileID = fh_s->fileID;
+  fh_d->fsize  = 0U;
+  fh_d->fpos   = 0U;
+  fh_d->fidx   = 0U;
+
+  if (fh_d->fbot >= (fh_d->ftop - sizeof(FALLOC))) {
+    /* Block is full */
+    if (efs_AllocBlock(fh_d) != fsOK) {
+      /* Out of memory */
+      return (false);
+    }
+  }
+
+  /* Set file name length */
+  n = fh_s->ftop - fh_s->fbot;
+
+  /* Set source block start address */
+  addr = addr_of_block (fh_s->vol, fh_s->fblock);
+
+  /* Read file name */
+  if (block_read (fh_s->vol, addr + fh_s->fbot, &cbuf, n) != fsOK) {
+    return (false);
+  }
+
+  /* Set destination block start address */
+  addr = addr_of_block (fh_d->vol, fh_d->fblock);
+
+  /* Write file name */
+  if (block_write (fh_d->vol, addr + fh_d->fbot, &cbuf, n) != fsOK) {
+    return (false);
+  }
+
+  fh_d->fbot += n;
+
+  fa.end    = fh_d->fbot;
+  fa.fileID = fh_d->fileID | 0x8000;
+  fa.index  = 0;
+
+  if (falloc_write (fh_d->vol, fh_d->fblock, fh_d->ftop, &fa) != fsOK) {
+    return false;
+  }
+
+  /* Adjust top address to next FALLOC */
+  fh_d->ftop -= sizeof(FALLOC);
+
+  /* Realign bottom address to 4 bytes */
+  fh_d->fbot = (fh_d->fbot + 3U) & ~3U;
+
+  /* Copy source file content to destination */
+  fh_s->ftop  = 0;
+  fh_s->fbot  = 0;
+  fh_s->fidx  = 0;
+  fh_s->fsize = file_size_get (fh_s->vol, fh_s->fblock, fh_s->fileID);
+
+  sz = fh_s->fsize;
+
+  while (sz) {
+    nr = sz;
+
+    if (nr > CBUFLEN) {
+      nr = CBUFLEN;
+    }
+
+    if (efs_rd (fh_s, (uint8_t *)cbuf, nr) != 0) {
+      return (false);
+    }
+
+    if (efs_wr (fh_d, (uint8_t *)cbuf, nr) != 0) {
+      return (false);
+    }
+    if (nr < CBUFLEN) {
+      break;
+    }
+
+    sz -= nr;
+  }
+
+  file_close (fh_d);
+
+  return (true);
+}
+
+
+/**
+  Defragmenter get next file function.
+
+  \param[in]  fh                        file handle
+  \return     - true  = Found next file
+              - false = Next file not found
+*/
+static uint32_t ed_get_next (fsEFS_Handle *fh) {
+  FALLOC fa;
+  EFS_FIDX_ENT *e;
+  uint16_t bl;
+  uint32_t addr, prev;
+  uint32_t fid, nid;
+
+  /* Search for file with next higher fileID. */
+  fid = 0x8000 | fh->fileID;
+  nid = 0xFFFF;
+
+  if (fh->vol->fidx.state == EFS_FIDX_STATE_READY) {
+    e = fidx_next (fh->vol, fid + 1U, true);
+
+    if (e == NULL) {
+      /* Next file not found. */
+      return (false);
+    }
+
+    /* Set handle pointers to file name chunk */
+    nid        = e->FileID;
+    fh->fblock = e->Block;
+    fh->fbot   = e->Start;
+    fh->ftop   = e->End;
+
+    goto x;
+  }
+
+  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
+    /* Read block signature */
+    addr = 0U;
+
+    if (sign_read (fh->vol, bl, &fa.end, &addr) != fsOK) {
+      return (false);
+    }
+
+    if ((fa.end != fh->vol->ErasedValue) && (fa.end != (fh->vol->ErasedValue ^ BlockTEMP))) {
+      /* Block is used and is not temporary */
+      for (prev = 0; ; prev = fa.end) {
+        if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
+          return (false);
+        }
+
+        if (fa.end == fh->vol->ErasedValue) { break; }
+
+        if ((fa.fileID > fid) && (fa.fileID < nid)) {
+          /* Store next higher fileID */
+          nid = fa.fileID;
+
+          /* Set handle pointers to file name chunk */
+          fh->fblock = bl;
+          fh->fbot   = (prev + 3U) & ~3U;
+          fh->ftop   = fa.end;
+
+          if (nid == fid+1) {
+            goto x;
+          }
+        }
+      }
+    }
+  }
+  if (nid == 0xFFFF) {
+    /* Next file not found. */
+    return (false);
+  }
+
+x:fh->fileID = nid & 0x7FFF;
+  fh->fidx   = 0;
+  fh->fpos   = 0;
+
+  return (true);
+}
+
+
+/**
+  Allocate next available Block.
+
+  \param[in]  fh                        file handle
+  \return     - true  = block allocated
+              - false = failed to allocate the block
+*/
+static fsStatus efs_AllocBlock (fsEFS_Handle *fh) {
+  fsStatus stat;
+  uint16_t bl;
+  uint32_t i, addr, sign;
+
+  bl = fh->fblock;
+
+  /* Search for file blocks identified with 'fileID' */
+  for (i = 0; i < fh->vol->SectorCount; i++) {
+    /* Read block signature */
+    addr = 0U;
+
+    stat = sign_read (fh->vol, bl, &sign, &addr);
+
+    if (stat != fsOK) {
+      return (stat);
+    }
+
+    if (sign == fh->vol->ErasedValue) {
+      /* Allocate empty block */
+      if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
+        /* Application owned files reside in regular blocks */
+        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockUSED);
+      }
+      else {
+        /* Defragmenter owned files reside in temp blocks */
+        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockTEMP);
+      }
+
+      fh->fblock = bl;
+      fh->ftop = addr - addr_of_block (fh->vol, bl);
+      fh->fbot = 0;
+
+      return (stat);
+    }
+
+    if ((sign ^ BlockUSED) == fh->vol->ErasedValue) {
+      /* Used block found */
+      if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
+        /* Only application is allowed to allocate used block (defrag allocates empty blocks) */
+        if (efs_is_busy (fh, bl) == false) {
+          /* Block not busy, retrieve free space */
+          if (efs_get_freeMem (fh->vol, bl) == 0) {
+            /* No free space, mark block as full */
+            stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockFULL);
+
+            if (stat != fsOK) {
+              return (stat);
+            }
+          }
+          else {
+            fh->fblock = bl;
+            efs_mark_freeMem (fh);
+            return (fsOK);
+          }
+        }
+      }
+    }
+    /* Go to next block */
+    bl++;
+    if (bl == fh->vol->SectorCount) {
+      bl = 0;
+    }
+  }
+  /* Block allocation failed, out of free space */
+  EvrFsEFS_DiskFull (fh->vol->DrvLet);
+  return (fsNoFreeSpace);
+}
+
+
+/**
+  Find data chunk associated with the current file state.
+  Sets the bottom, top address and increases index of opened file.
+
+  \param[in]  fh                        file handle
+  \return     true/false
+*/
+static uint32_t efs_mark_fileMem (fsEFS_Handle *fh) {
+  FALLOC fa;
+  EFS_FIDX_ENT *e;
+  uint16_t bl;
+  uint32_t i, addr, prev;
+
+  bl = fh->fblock;
+
+  if (fh->vol->fidx.state == EFS_FIDX_STATE_READY) {
+    e = fidx_chunk (fh->vol, bl, fh->fileID, fh->fidx, true);
+
+    if (e == NULL) {
+      return (false);
+    }
+
+    /* Set Current File Block parameters */
+    fh->fblock = e->Block;
+    fh->fbot   = e->Start;
+    fh->ftop   = e->End;
+    fh->fidx++;
+
+    return (true);
+  }
+
+  /* Search for file blocks identified with 'fileID' */
+  for (i = 0; i < fh->vol->SectorCount; i++) {
+    /* Read block signature */
+    addr = 0U;
+
+    if (sign_read (fh->vol, bl, &fa.end, &addr) != fsOK) {
+      return (false);
+    }
+
+    if ((fa.end != fh->vol->ErasedValue) && (fa.end != (fh->vol->ErasedValue ^ BlockTEMP))) {
+      /* Used block found */
+      for (prev = 0; ; prev = fa.end) {
+        if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
+          return (false);
+        }
+
+        if ((fa.fileID == fh->fileID) && (fa.index == fh->fidx)) {
+          /* Set Current File Block parameters */
+          fh->fblock = bl;
+          fh->fbot   = (prev + 3U) & ~3U;
+          fh->ftop   = fa.end;
+          fh->fidx++;
+
+          return (true);
+        }
+        if (fa.end == fh->vol->ErasedValue) break;
+      }
+    }
+    /* Go to next block */
+    bl++;
+    if (bl == fh->vol->SectorCount) {
+      bl = 0;
+    }
+  }
+  return (false);
+}
+
+
+/**
+  Sets the top and bottom addresses of block free memory region.
+
+  Top address is hi address within block where FALLOC is placed.
+  Bottom address is lo address where file names and data is stored.
+
+  \param[in]  fh                        file handle
+*/
+static void efs_mark_freeMem (fsEFS_Handle *fh) {
+  FALLOC fa;
+  uint32_t addr, prev;
+
+  /* Set address to first FALLOC within block */
+  addr = addr_of_sign (fh->vol, fh->fblock) - sizeof(FALLOC);
+
+  for (prev = 0; ; prev = fa.end) {
+    if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
+      /* Force block allocation */
+      fh->fbot = fh->ftop;
+      return;
+    }
+
+    if (fa.end == fh->vol->ErasedValue) { break; }
+  }
+
+  /* Align previous end address */
+  prev = (prev + 3U) & ~3U;
+  
+  /* Set address to block relative address */
+  addr = addr - addr_of_block (fh->vol, fh->fblock);
+  
+  /* fbot (low address) points to 4-byte aligned free byte */
+  fh->fbot = prev;
+
+  /* ftop (hi address) points to free file allocation record */
+  fh->ftop = addr + sizeof(FALLOC);
+}
+
+
+/**
+  Determine remaining free space in block.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     Free space in bytes.
+*/
+static uint32_t efs_get_freeMem (fsEFS_Volume *vol, uint32_t block) {
+  FALLOC fa;
+  uint32_t size, addr, prev;
+
+  /* Set address to first FALLOC within block */
+  addr = addr_of_sign (vol, block) - sizeof(FALLOC);
+
+  for (prev = 0; ; prev = fa.end) {
+    if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
+      return (0U);
+    }
+
+    if (fa.end == vol->ErasedValue) { break; }
+  }
+  /* Align previous end address */
+  prev = (prev + 3U) & ~3U;
+  
+  /* Set address to block relative address */
+  addr = addr - addr_of_block (vol, block);
+
+  if (prev < addr) {
+    /* Free memory is between empty FALLOC and the end of previous data chunk */
+    size = addr - prev;
+  }
+  else {
+    /* Only empty FALLOC exists, no free space */
+    size = 0U;
+  }
+
+  return (size);
+}
+
+
+/**
+  Check if all stored file data within flash block is invalid.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     true/false
 */
-static uint32_t ed_copy (fsEFS_Handle *fh_s, fsEFS_Handle *fh_d) {
+static uint32_t efs_BlockInvalid (fsEFS_Volume *vol, uint32_t block) {
   FALLOC fa;
-  uint32_t addr, n, nr, sz;
+  uint32_t addr;
 
-  /* Initialize destination file handle */
-  fh_d->fileID = fh_s->fileID;
-  fh_d->fsize  = 0U;
-  fh_d->fpos   = 0U;
-  fh_d->fidx   = 0U;
+  /* Set address to first file allocation record */
+  addr = addr_of_sign (vol, block) - 8;
 
-  if (fh_d->fbot >= (fh_d->ftop - sizeof(FALLOC))) {
-    /* Block is full */
-    if (efs_AllocBlock(fh_d) != fsOK) {
-      /* Out of memory */
+  /* Check if any valid file chunk exists within block */
+  for (;;) {
+    if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
+      return (false);
+    }
+
+    if (fa.end == vol->ErasedValue) { break; }
+    if (fa.fileID != (uint16_t)(~vol->ErasedValue)) {
+      /* Found valid file chunk */
       return (false);
     }
   }
+  return (true);
+}
 
-  /* Set file name length */
-  n = fh_s->ftop - fh_s->fbot;
 
-  /* Set source block start address */
-  addr = addr_of_block (fh_s->vol, fh_s->fblock);
+/**
+  Check if file allocation record describes a valid file chunk.
 
-  /* Read file name */
-  if (block_read (fh_s->vol, addr + fh_s->fbot, &cbuf, n) != fsOK) {
-    return (false);
-  }
+  Record whose fileID was not written due to power loss is not valid.
 
-  /* Set destination block start address */
-  addr = addr_of_block (fh_d->vol, fh_d->fblock);
+  \param[in]  vol                       volume description structure
+  \param[in]  fa                        file allocation record
+  \return     true/false
+*/
+static uint32_t chunk_valid (fsEFS_Volume *vol, const FALLOC *fa) {
 
-  /* Write file name */
-  if (block_write (fh_d->vol, addr + fh_d->fbot, &cbuf, n) != fsOK) {
+  if ((fa->fileID == (uint16_t)(~vol->ErasedValue)) || (fa->fileID == (uint16_t)vol->ErasedValue)) {
     return (false);
   }
+  return (true);
+}
 
-  fh_d->fbot += n;
 
-  fa.end    = fh_d->fbot;
-  fa.fileID = fh_d->fileID | 0x8000;
-  fa.index  = 0;
+/**
+  Initialize search for copies of reclaimed block chunks.
 
-  if (falloc_write (fh_d->vol, fh_d->fblock, fh_d->ftop, &fa) != fsOK) {
-    return false;
-  }
+  \param[in]  vol                       volume description structure
+  \param[out] cp                        copy search state
+*/
+static void chunk_copy_init (fsEFS_Volume *vol, EFS_COPY *cp) {
 
-  /* Adjust top address to next FALLOC */
-  fh_d->ftop -= sizeof(FALLOC);
+  cp->addr  = 0U;
+  cp->prev  = 0U;
+  cp->block = vol->SectorCount;
+  cp->done  = false;
+}
 
-  /* Realign bottom address to 4 bytes */
-  fh_d->fbot = (fh_d->fbot + 3U) & ~3U;
 
-  /* Copy source file content to destination */
-  fh_s->ftop  = 0;
-  fh_s->fbot  = 0;
-  fh_s->fidx  = 0;
-  fh_s->fsize = file_size_get (fh_s->vol, fh_s->fblock, fh_s->fileID);
+/**
+  Check if file chunk of the reclaimed block was already copied.
 
-  sz = fh_s->fsize;
+  Valid chunks are copied in the order of their allocation records, each
+  copy run is appended to a single block. The copy of the next chunk is
+  therefore expected at the next allocation record after the previous copy
+  and other blocks are searched only when the run ends. When a chunk was
+  not copied, none of the following chunks were copied either.
 
-  while (sz) {
-    nr = sz;
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     reclaimed block number
+  \param[in]  fc                        file allocation record of the chunk
+  \param[in]  size                      chunk size in bytes
+  \param[in,out] cp                     copy search state
+  \return     true when copy exists
+*/
+static uint32_t chunk_copied (fsEFS_Volume *vol, uint32_t block, const FALLOC *fc, uint32_t size, EFS_COPY *cp) {
+  FALLOC fa;
+  uint32_t bl, addr, prev;
 
-    if (nr > CBUFLEN) {
-      nr = CBUFLEN;
-    }
+  if (cp->done == true) {
+    return (false);
+  }
 
-    if (efs_rd (fh_s, (uint8_t *)cbuf, nr) != 0) {
-      return (false);
+  if (cp->block != vol->SectorCount) {
+    /* Check allocation record which follows the previous copy */
+    if (falloc_read (vol, cp->addr, &fa, &addr) == fsOK) {
+      if ((fa.end != vol->ErasedValue) && (fa.fileID == fc->fileID) && (fa.index == fc->index)) {
+        if ((fa.end - ((cp->prev + 3U) & ~3U)) == size) {
+          cp->addr = addr;
+          cp->prev = fa.end;
+          return (true);
+        }
+      }
     }
+  }
 
-    if (efs_wr (fh_d, (uint8_t *)cbuf, nr) != 0) {
-      return (false);
-    }
-    if (nr < CBUFLEN) {
-      break;
+  /* Copy run ended, search for the chunk in other blocks */
+  for (bl = 0U; bl < vol->SectorCount; bl++) {
+    addr = 0U;
+
+    if ((bl == block) || (bl == cp->block) || (sign_read (vol, bl, &fa.end, &addr) != fsOK)) {
+      continue;
     }
 
-    sz -= nr;
+    if ((fa.end != vol->ErasedValue) && (fa.end != (vol->ErasedValue ^ BlockTEMP))) {
+      for (prev = 0U; ; prev = fa.end) {
+        if (falloc_read (vol, addr, &fa, &addr) != fsOK) { break; }
+
+        if (fa.end == vol->ErasedValue) { break; }
+
+        if ((fa.fileID == fc->fileID) && (fa.index == fc->index)) {
+          if ((fa.end - ((prev + 3U) & ~3U)) == size) {
+            /* Following chunks are expected after this copy */
+            cp->block = (uint16_t)bl;
+            cp->addr  = addr;
+            cp->prev  = fa.end;
+            return (true);
+          }
+        }
+      }
+    }
   }
 
-  file_close (fh_d);
+  cp->done = true;
 
-  return (true);
+  return (false);
 }
 
 
 /**
-  Defragmenter get next file function.
+  Determine the amount of valid and invalidated data within block.
 
-  \param[in]  fh                        file handle
-  \return     - true  = Found next file
-              - false = Next file not found
+  Amount includes aligned chunk data and file allocation record.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \param[out] valid                     amount of valid data in bytes
+  \param[out] invalid                   amount of invalidated data in bytes
+  \param[in]  resume                    count chunks which were already copied as invalid
+  \return     execution status \ref fsStatus
 */
-static uint32_t ed_get_next (fsEFS_Handle *fh) {
+static fsStatus block_usage (fsEFS_Volume *vol, uint32_t block, uint32_t *valid, uint32_t *invalid, uint32_t resume) {
   FALLOC fa;
-  uint16_t bl;
-  uint32_t addr, prev;
-  uint32_t fid, nid;
+  EFS_COPY cp;
+  fsStatus stat;
+  uint32_t addr, prev, start, sz;
 
-  /* Search for file with next higher fileID. */
-  fid = 0x8000 | fh->fileID;
-  nid = 0xFFFF;
+  *valid   = 0U;
+  *invalid = 0U;
 
-  for (bl = 0; bl < fh->vol->SectorCount; bl++) {
-    /* Read block signature */
-    addr = 0U;
+  chunk_copy_init (vol, &cp);
 
-    if (sign_read (fh->vol, bl, &fa.end, &addr) != fsOK) {
-      return (false);
-    }
+  /* Set address to first file allocation record */
+  addr = addr_of_sign (vol, block) - sizeof(FALLOC);
 
-    if ((fa.end != fh->vol->ErasedValue) && (fa.end != (fh->vol->ErasedValue ^ BlockTEMP))) {
-      /* Block is used and is not temporary */
-      for (prev = 0; ; prev = fa.end) {
-        if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
-          return (false);
-        }
+  for (prev = 0U; ; prev = fa.end) {
+    stat = falloc_read (vol, addr, &fa, &addr);
 
-        if (fa.end == fh->vol->ErasedValue) { break; }
+    if (stat != fsOK) {
+      break;
+    }
 
-        if ((fa.fileID > fid) && (fa.fileID < nid)) {
-          /* Store next higher fileID */
-          nid = fa.fileID;
+    if (fa.end == vol->ErasedValue) { break; }
 
-          /* Set handle pointers to file name chunk */
-          fh->fblock = bl;
-          fh->fbot   = (prev + 3U) & ~3U;
-          fh->ftop   = fa.end;
+    /* Chunk starts 4-byte aligned after the previous chunk */
+    start = (prev + 3U) & ~3U;
+    sz    = ((fa.end + 3U) & ~3U) - start + sizeof(FALLOC);
 
-          if (nid == fid+1) {
-            goto x;
-          }
-        }
-      }
+    if (chunk_valid (vol, &fa) == false) {
+      *invalid += sz;
+    }
+    else if ((resume == true) && (chunk_copied (vol, block, &fa, fa.end - start, &cp) == true)) {
+      *invalid += sz;
+    }
+    else {
+      *valid   += sz;
     }
   }
-  if (nid == 0xFFFF) {
-    /* Next file not found. */
-    return (false);
-  }
-
-x:fh->fileID = nid & 0x7FFF;
-  fh->fidx   = 0;
-  fh->fpos   = 0;
 
-  return (true);
+  return (stat);
 }
 
 
 /**
-  Allocate next available Block.
+  Check if any opened file resides in given block.
 
-  \param[in]  fh                        file handle
-  \return     - true  = block allocated
-              - false = failed to allocate the block
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     block number
+  \return     true/false
 */
-static fsStatus efs_AllocBlock (fsEFS_Handle *fh) {
-  fsStatus stat;
-  uint16_t bl;
-  uint32_t i, addr, sign;
+static uint32_t block_is_open (fsEFS_Volume *vol, uint32_t block) {
+  fsEFS_Handle *fh;
+  uint32_t i;
 
-  bl = fh->fblock;
+  for (i = 0, fh = &fs_efs_fh[0]; i < fs_efs_fh_cnt; i++, fh++) {
+    if ((fh->vol == vol) && (fh->flags & EFS_HANDLE_OPEN) && (fh->fblock == block)) {
+      return (true);
+    }
+  }
+  return (false);
+}
 
-  /* Search for file blocks identified with 'fileID' */
-  for (i = 0; i < fh->vol->SectorCount; i++) {
-    /* Read block signature */
-    addr = 0U;
 
-    stat = sign_read (fh->vol, bl, &sign, &addr);
+/**
+  Check if free region of destination block is erased.
 
-    if (stat != fsOK) {
-      return (stat);
-    }
+  Power loss during file write may leave data without allocation record
+  in the free region of used block.
 
-    if (sign == fh->vol->ErasedValue) {
-      /* Allocate empty block */
-      if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
-        /* Application owned files reside in regular blocks */
-        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockUSED);
-      }
-      else {
-        /* Defragmenter owned files reside in temp blocks */
-        stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockTEMP);
-      }
+  \param[in]  fh                        destination handle (block and free region)
+  \param[in]  size                      size of region in bytes
+  \return     true/false
+*/
+static uint32_t block_free_erased (fsEFS_Handle *fh, uint32_t size) {
+  uint32_t addr, i, n, k;
 
-      fh->fblock = bl;
-      fh->ftop = addr - addr_of_block (fh->vol, bl);
-      fh->fbot = 0;
+  addr = addr_of_block (fh->vol, fh->fblock) + fh->fbot;
 
-      return (stat);
+  for (i = 0U; i < size; i += n) {
+    n = size - i;
+
+    if (n > CBUFLEN) {
+      n = CBUFLEN;
     }
 
-    if ((sign ^ BlockUSED) == fh->vol->ErasedValue) {
-      /* Used block found */
-      if ((fh->flags & EFS_HANDLE_DEFRAG) == 0U) {
-        /* Only application is allowed to allocate used block (defrag allocates empty blocks) */
-        if (efs_is_busy (fh, bl) == false) {
-          /* Block not busy, retrieve free space */
-          if (efs_get_freeMem (fh->vol, bl) == 0) {
-            /* No free space, mark block as full */
-            stat = sign_write (fh->vol, bl, fh->vol->ErasedValue ^ BlockFULL);
+    if (block_read (fh->vol, addr + i, cbuf, n) != fsOK) {
+      return (false);
+    }
 
-            if (stat != fsOK) {
-              return (stat);
-            }
-          }
-          else {
-            fh->fblock = bl;
-            efs_mark_freeMem (fh);
-            return (fsOK);
-          }
-        }
+    for (k = 0U; k < ((n + 3U) / 4U); k++) {
+      if (cbuf[k] != fh->vol->ErasedValue) {
+        return (false);
       }
     }
-    /* Go to next block */
-    bl++;
-    if (bl == fh->vol->SectorCount) {
-      bl = 0;
-    }
   }
-  /* Block allocation failed, out of free space */
-  EvrFsEFS_DiskFull (fh->vol->DrvLet);
-  return (fsNoFreeSpace);
+  return (true);
 }
 
 
 /**
-  Find data chunk associated with the current file state.
-  Sets the bottom, top address and increases index of opened file.
+  Copy valid file chunks from reclaimed block into the destination block.
 
-  \param[in]  fh                        file handle
-  \return     true/false
+  Chunks keep their fileID and index, so the files are not changed. When
+  destination handle is NULL, chunks which were already copied are
+  invalidated in the reclaimed block, so that the remaining chunks which
+  were not copied yet still follow the copied ones.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  block                     reclaimed block number
+  \param[in]  fh                        destination handle (block and free region) or NULL
+  \param[in]  resume                    skip chunks which were already copied
+  \return     execution status \ref fsStatus
 */
-static uint32_t efs_mark_fileMem (fsEFS_Handle *fh) {
-  FALLOC fa;
-  uint16_t bl;
-  uint32_t i, addr, prev;
+static fsStatus block_relocate (fsEFS_Volume *vol, uint32_t block, fsEFS_Handle *fh, uint32_t resume) {
+  FALLOC fa, fc;
+  EFS_COPY cp;
+  fsStatus stat;
+  uint32_t addr, prev, start, size, sa, da, i, n, invalid;
 
-  bl = fh->fblock;
+  invalid = ~vol->ErasedValue;
 
-  /* Search for file blocks identified with 'fileID' */
-  for (i = 0; i < fh->vol->SectorCount; i++) {
-    /* Read block signature */
-    addr = 0U;
+  chunk_copy_init (vol, &cp);
+
+  /* Set address to first file allocation record */
+  addr = addr_of_sign (vol, block) - sizeof(FALLOC);
 
-    if (sign_read (fh->vol, bl, &fa.end, &addr) != fsOK) {
-      return (false);
+  for (prev = 0U; ; prev = fa.end) {
+    stat = falloc_read (vol, addr, &fa, &addr);
+
+    if ((stat != fsOK) || (fa.end == vol->ErasedValue)) {
+      break;
     }
 
-    if ((fa.end != fh->vol->ErasedValue) && (fa.end != (fh->vol->ErasedValue ^ BlockTEMP))) {
-      /* Used block found */
-      for (prev = 0; ; prev = fa.end) {
-        if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
-          return (false);
-        }
+    if (chunk_valid (vol, &fa) == false) {
+      /* Invalidated chunk is not copied */
+      continue;
+    }
 
-        if ((fa.fileID == fh->fileID) && (fa.index == fh->fidx)) {
-          /* Set Current File Block parameters */
-          fh->fblock = bl;
-          fh->fbot   = (prev + 3U) & ~3U;
-          fh->ftop   = fa.end;
-          fh->fidx++;
+    start = (prev + 3U) & ~3U;
+    size  = fa.end - start;
 
-          return (true);
+    if (fh == NULL) {
+      /* Chunk exists twice, keep the copy and clear the fileID & index values */
+      if (chunk_copied (vol, block, &fa, size, &cp) == true) {
+        if (block_write (vol, addr + 12, &invalid, 4) == fsOK) {
+          fidx_del (vol, block, &fa);
         }
-        if (fa.end == fh->vol->ErasedValue) break;
       }
+      continue;
     }
-    /* Go to next block */
-    bl++;
-    if (bl == fh->vol->SectorCount) {
-      bl = 0;
+
+    if ((resume == true) && (chunk_copied (vol, block, &fa, size, &cp) == true)) {
+      continue;
     }
-  }
-  return (false);
-}
 
+    if ((fh->fbot + size + (2U * sizeof(FALLOC))) >= fh->ftop) {
+      /* Chunk does not fit into destination block */
+      stat = fsNoFreeSpace;
+      break;
+    }
 
-/**
-  Sets the top and bottom addresses of block free memory region.
+    /* Set source and destination block start address */
+    sa = addr_of_block (vol, block);
+    da = addr_of_block (vol, fh->fblock);
 
-  Top address is hi address within block where FALLOC is placed.
-  Bottom address is lo address where file names and data is stored.
+    /* Copy chunk data */
+    for (i = 0U; i < size; i += n) {
+      n = size - i;
 
-  \param[in]  fh                        file handle
-*/
-static void efs_mark_freeMem (fsEFS_Handle *fh) {
-  FALLOC fa;
-  uint32_t addr, prev;
+      if (n > CBUFLEN) {
+        n = CBUFLEN;
+      }
 
-  /* Set address to first FALLOC within block */
-  addr = addr_of_sign (fh->vol, fh->fblock) - sizeof(FALLOC);
+      stat = block_read (vol, sa + start + i, cbuf, n);
 
-  for (prev = 0; ; prev = fa.end) {
-    if (falloc_read (fh->vol, addr, &fa, &addr) != fsOK) {
-      /* Force block allocation */
-      fh->fbot = fh->ftop;
-      return;
+      if (stat == fsOK) {
+        stat = block_write (vol, da + fh->fbot + i, cbuf, n);
+      }
+
+      if (stat != fsOK) {
+        break;
+      }
     }
 
-    if (fa.end == fh->vol->ErasedValue) { break; }
-  }
+    if (stat != fsOK) {
+      break;
+    }
 
-  /* Align previous end address */
-  prev = (prev + 3U) & ~3U;
-  
-  /* Set address to block relative address */
-  addr = addr - addr_of_block (fh->vol, fh->fblock);
-  
-  /* fbot (low address) points to 4-byte aligned free byte */
-  fh->fbot = prev;
+    fh->fbot += size;
 
-  /* ftop (hi address) points to free file allocation record */
-  fh->ftop = addr + sizeof(FALLOC);
+    /* Write allocation record of the copied chunk */
+    fc.end    = fh->fbot;
+    fc.fileID = fa.fileID;
+    fc.index  = fa.index;
+
+    stat = falloc_write (vol, fh->fblock, fh->ftop, &fc);
+
+    if (stat != fsOK) {
+      break;
+    }
+
+    /* Adjust top address to next FALLOC */
+    fh->ftop -= sizeof(FALLOC);
+
+    /* Realign bottom address to 4 bytes */
+    fh->fbot = (fh->fbot + 3U) & ~3U;
+  }
+
+  return (stat);
 }
 
 
 /**
-  Determine remaining free space in block.
+  Reclaim block by moving its valid file chunks into another block and
+  erasing it.
+
+  Block is marked before the chunks are copied. When the operation is
+  interrupted, file chunks of the marked block may exist twice. The copy
+  is completed at next mount, or the copied chunks are removed from the
+  marked block when there is not enough free space to complete it.
 
   \param[in]  vol                       volume description structure
   \param[in]  block                     block number
-  \return     Free space in bytes.
+  \param[in]  resume                    complete interrupted reclaim
+  \return     execution status \ref fsStatus
 */
-static uint32_t efs_get_freeMem (fsEFS_Volume *vol, uint32_t block) {
-  FALLOC fa;
-  uint32_t size, addr, prev;
+static fsStatus block_reclaim (fsEFS_Volume *vol, uint32_t block, uint32_t resume) {
+  fsEFS_Handle fh;
+  fsStatus stat;
+  uint32_t bl, sign, valid, invalid, empty;
 
-  /* Set address to first FALLOC within block */
-  addr = addr_of_sign (vol, block) - sizeof(FALLOC);
+  stat = block_usage (vol, block, &valid, &invalid, resume);
 
-  for (prev = 0; ; prev = fa.end) {
-    if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
-      return (0U);
-    }
+  if ((stat == fsOK) && (valid != 0U)) {
+    memset (&fh, 0, sizeof(fh));
+    fh.vol = vol;
 
-    if (fa.end == vol->ErasedValue) { break; }
-  }
-  /* Align previous end address */
-  prev = (prev + 3U) & ~3U;
-  
-  /* Set address to block relative address */
-  addr = addr - addr_of_block (vol, block);
+    empty = vol->SectorCount;
 
-  if (prev < addr) {
-    /* Free memory is between empty FALLOC and the end of previous data chunk */
-    size = addr - prev;
-  }
-  else {
-    /* Only empty FALLOC exists, no free space */
-    size = 0U;
-  }
+    /* Find used block with enough free space, otherwise use empty block */
+    for (bl = 0U; bl < vol->SectorCount; bl++) {
+      if ((bl == block) || (block_is_open (vol, bl) == true)) {
+        continue;
+      }
 
-  return (size);
-}
+      stat = sign_read (vol, bl, &sign, NULL);
 
+      if (stat != fsOK) {
+        return (stat);
+      }
 
-/**
-  Check if all stored file data within flash block is invalid.
+      /* Interrupted copy may have left partially programmed data in free */
+      /* space of used block, resumed copy is written into empty block    */
+      if ((sign == (vol->ErasedValue ^ BlockUSED)) && (resume == false)) {
+        fh.fblock = bl;
+        efs_mark_freeMem (&fh);
 
-  \param[in]  vol                       volume description structure
-  \param[in]  block                     block number
-  \return     true/false
-*/
-static uint32_t efs_BlockInvalid (fsEFS_Volume *vol, uint32_t block) {
-  FALLOC fa;
-  uint32_t addr;
+        if (fh.ftop > (fh.fbot + valid + sizeof(FALLOC))) {
+          if (block_free_erased (&fh, valid) == true) {
+            break;
+          }
+        }
+      }
+      else if (sign == vol->ErasedValue) {
+        if ((empty == vol->SectorCount) && ((vol->Drv->GetSectorSize (bl) - 12U) > (valid + sizeof(FALLOC)))) {
+          empty = bl;
+        }
+      }
+    }
 
-  /* Set address to first file allocation record */
-  addr = addr_of_sign (vol, block) - 8;
+    if (bl == vol->SectorCount) {
+      if (empty == vol->SectorCount) {
+        /* No space for valid file chunks */
+        if (resume == true) {
+          /* Keep copies only, so that file chunks exist once */
+          block_relocate (vol, block, NULL, true);
+        }
+        return (fsNoFreeSpace);
+      }
 
-  /* Check if any valid file chunk exists within block */
-  for (;;) {
-    if (falloc_read (vol, addr, &fa, &addr) != fsOK) {
-      return (false);
+      stat = sign_write (vol, empty, vol->ErasedValue ^ BlockUSED);
+
+      if (stat != fsOK) {
+        return (stat);
+      }
+
+      fh.fblock = empty;
+      efs_mark_freeMem (&fh);
     }
 
-    if (fa.end == vol->ErasedValue) { break; }
-    if (fa.fileID != (uint16_t)(~vol->ErasedValue)) {
-      /* Found valid file chunk */
-      return (false);
+    if (resume == false) {
+      /* Mark block, its file chunks are going to be copied */
+      stat = sign_write (vol, block, vol->ErasedValue ^ BlockMOVE);
+    }
+
+    if (stat == fsOK) {
+      stat = block_relocate (vol, block, &fh, resume);
+
+      if (stat == fsNoFreeSpace) {
+        /* Keep copies only, so that file chunks exist once */
+        block_relocate (vol, block, NULL, true);
+      }
     }
   }
-  return (true);
+
+  if (stat == fsOK) {
+    stat = block_erase (vol, block);
+  }
+
+  if (stat == fsOK) {
+    EvrFsEFS_BlockReclaim (vol->DrvLet, block, valid, invalid);
+  }
+
+  return (stat);
 }
 
 
@@ -1373,11 +2576,15 @@ static int32_t efs_rd (fsEFS_Handle *fh, uint8_t *buf, uint32_t len) {
 */
 static int32_t efs_wr (fsEFS_Handle *fh, const uint8_t *buf, uint32_t len) {
   FALLOC fa;
-  uint32_t size, cnt, n, addr, state;
+  uint32_t size, cnt, n, addr, state, wc;
+  fsStatus stat;
   int32_t rval;
 
   rval = 0;
 
+  /* Check if write combining buffer can be used */
+  wc = wbuf_claim (fh);
+
   /* Set current block start address */
   addr = addr_of_block (fh->vol, fh->fblock);
 
@@ -1468,7 +2675,13 @@ static int32_t efs_wr (fsEFS_Handle *fh, const uint8_t *buf, uint32_t len) {
           cnt = size;
         }
 
-        if (block_write (fh->vol, addr + fh->fbot, (uint8_t *)(uint32_t)&buf[n], cnt) != fsOK) {
+        if (wc == true) {
+          stat = wbuf_write (fh, addr + fh->fbot, &buf[n], cnt);
+        } else {
+          stat = block_write (fh->vol, addr + fh->fbot, (uint8_t *)(uint32_t)&buf[n], cnt);
+        }
+
+        if (stat != fsOK) {
           state = EFS_WR_ERROR;
         }
         else {
@@ -1484,7 +2697,7 @@ static int32_t efs_wr (fsEFS_Handle *fh, const uint8_t *buf, uint32_t len) {
               /* Set flag 'write allocation record' */
               fh->flags |= EFS_HANDLE_WALLOC;
 
-              if (len & 3) {
+              if (((len & 3) != 0U) && (wc == false)) {
                 /* Unaligned data write, write also allocation record */
                 state = EFS_WR_FALLOC;
               } else {
@@ -1671,6 +2884,25 @@ __WEAK fsStatus efs_mount (fsEFS_Volume *vol) {
     /* Reset current top file ID */
     vol->TopID = 0U;
 
+    /* Build file index */
+    fidx_init  (vol);
+    fidx_build (vol);
+
+    /* Set program page size of write combining buffer */
+    wbuf_init (vol);
+
+    /* Complete block reclaim interrupted by power loss */
+    for (i = 0U; i < vol->SectorCount; i++) {
+      if (sign_read (vol, i, &val, NULL) == fsOK) {
+        if (val == (vol->ErasedValue ^ BlockMOVE)) {
+          block_reclaim (vol, i, true);
+        }
+      }
+    }
+
+    /* Start reclaim from the first block */
+    rclm_init (vol);
+
     vol->Status |= EFS_STATUS_MOUNT;
 
     /* Drive mounted */
@@ -1710,6 +2942,9 @@ __WEAK fsStatus efs_unmount (fsEFS_Volume *vol) {
   }
   vol->Status &= ~EFS_STATUS_MOUNT;
 
+  /* Invalidate file index */
+  vol->fidx.state = EFS_FIDX_STATE_NONE;
+
   /* Drive unmounted */
   EvrFsEFS_UnmountDriveSuccess (vol->DrvLet);
   return (fsOK);
@@ -1745,6 +2980,15 @@ __WEAK fsStatus efs_format (fsEFS_Volume *vol) {
     /* Reset file ID tracker */
     vol->TopID = 0;
 
+    if (vol->fidx.max != 0U) {
+      /* Drive is empty, so is the file index */
+      fidx_clear (&vol->fidx);
+      vol->fidx.state = EFS_FIDX_STATE_READY;
+    }
+
+    /* All blocks are erased */
+    rclm_init (vol);
+
     /* Formatting completed  */
     EvrFsEFS_FormatDriveSuccess (vol->DrvLet);
   }
@@ -2120,6 +3364,7 @@ __WEAK int32_t efs_flen (int32_t handle) {
 __WEAK int32_t efs_seek (int32_t handle, int32_t offset, int32_t whence) {
   fsEFS_Handle *fh;
   FALLOC fa;
+  EFS_FIDX_ENT *e;
   uint16_t bl, fidx;
   uint32_t addr, prev;
   uint32_t i, pos, fpos;
@@ -2174,6 +3419,35 @@ __WEAK int32_t efs_seek (int32_t handle, int32_t offset, int32_t whence) {
   fpos = 0;
   bl   = fh->fblock;
 
+  if (fh->vol->fidx.state == EFS_FIDX_STATE_READY) {
+    /* Walk indexed file chunks */
+    for (;;) {
+      e = fidx_chunk (fh->vol, bl, fh->fileID, fidx, false);
+
+      if (e == NULL) {
+        return -(int32_t)(fsError);
+      }
+      fidx++;
+      bl = e->Block;
+
+      if (fpos + (e->End - e->Start) < pos) {
+        /* Go and try next File Block */
+        fpos += (e->End - e->Start);
+        continue;
+      }
+
+      /* OK, the right File Block Index is found */
+      fh->fblock = bl;
+      fh->fidx   = fidx;
+      fh->fbot   = e->Start + (pos - fpos);
+      fh->ftop   = e->End;
+
+      /* Store new file position */
+      fh->fpos   = pos;
+      return ((int32_t)fh->fpos);
+    }
+  }
+
 next:
   /* Scan blocks for files with current fileID */
   for (i = 0; i < fh->vol->SectorCount; i++) {
@@ -2277,6 +3551,7 @@ __WEAK fsStatus efs_delete (const char *path, fsEFS_Volume *vol) {
 */
 __WEAK fsStatus efs_ffind (fsFileInfo *info, fsEFS_Volume *vol) {
   FALLOC fa;
+  EFS_FIDX_ENT *e;
   uint32_t block, addr;
   uint32_t nid, id, id_block = 0U;
   uint32_t prev, fn_addr = 0U;
@@ -2297,8 +3572,23 @@ __WEAK fsStatus efs_ffind (fsFileInfo *info, fsEFS_Volume *vol) {
   nid = 0x8000 | (info->fileID + 1);
   id  = 0xFFFF;
 
+  if (vol->fidx.state == EFS_FIDX_STATE_READY) {
+    e = fidx_next (vol, nid, false);
+
+    if (e != NULL) {
+      id       = e->FileID;
+      id_block = e->Block;
+      fn_addr  = addr_of_block (vol, e->Block) + e->Start;
+    }
+    /* Skip block scan */
+    block = vol->SectorCount;
+  }
+  else {
+    block = 0U;
+  }
+
   /* Scan through all blocks */
-  for (block = 0; block < vol->SectorCount; block++) {
+  for ( ; block < vol->SectorCount; block++) {
     /* Read block signature */
     addr = 0U;
 
@@ -2693,6 +3983,10 @@ __WEAK fsStatus efs_defrag (fsEFS_Volume *vol) {
   /* Invalidate file handle */
   fh->flags = 0U;
 
+  /* Discard data of temp file that was not copied */
+  vol->wbuf.cnt   = 0U;
+  vol->wbuf.owner = NULL;
+
   /* Erase invalidated blocks */
   for (bl = 0; bl < vol->SectorCount; bl++) {
     /* Read block signature */
@@ -2738,10 +4032,151 @@ __WEAK fsStatus efs_defrag (fsEFS_Volume *vol) {
     }
   }
 
+  if ((stat == fsOK) && (vol->fidx.state == EFS_FIDX_STATE_NONE)) {
+    /* Defragmented drive may fit into the file index */
+    fidx_build (vol);
+  }
+
+  /* Block usage has changed */
+  rclm_init (vol);
+
   return (stat);
 }
 
 
+/**
+  Restart reclaim cursor and count erased blocks.
+
+  \param[in]  vol                       volume description structure
+*/
+static void rclm_init (fsEFS_Volume *vol) {
+  EFS_RCLM *rc = &vol->rclm;
+  uint32_t  bl, sign;
+
+  rc->block  = 0U;
+  rc->victim = vol->SectorCount;
+  rc->max    = 0U;
+  rc->empty  = 0U;
+  rc->cnt    = 0U;
+
+  for (bl = 0U; bl < vol->SectorCount; bl++) {
+    if ((sign_read (vol, bl, &sign, NULL) == fsOK) && (sign == vol->ErasedValue)) {
+      rc->cnt++;
+    }
+  }
+}
+
+
+/**
+  Reclaim invalidated space in one bounded step.
+
+  Each step examines up to EFS_RECLAIM_SCAN blocks from the reclaim cursor
+  onward. When the cursor completes the pass over all blocks and the drive
+  has less erased blocks than configured reserve, block with most
+  invalidated data is reclaimed: valid file chunks are moved into free
+  space of another block and block is erased. Blocks of opened files are
+  not reclaimed.
+
+  \param[in]  vol                       volume description structure
+  \return     number of erased blocks or execution status
+              value >= 0: number of erased blocks counted in the last pass
+              value < 0:  error occurred, -value is execution status as defined with fsStatus
+*/
+__WEAK int32_t efs_reclaim (fsEFS_Volume *vol) {
+  EFS_RCLM *rc = &vol->rclm;
+  uint32_t  bl, n, sign, valid, invalid;
+  uint8_t   state;
+  fsStatus  stat;
+
+  stat = efs_vol_chk (EFS_STATUS_MOUNT, vol);
+  if (stat != fsOK) {
+    return (-(int32_t)stat);
+  }
+
+  /* Count erased blocks and find block with most invalidated data */
+  for (n = 0U; (n < EFS_RECLAIM_SCAN) && (rc->block < vol->SectorCount); n++) {
+    bl = rc->block;
+
+    stat = sign_read (vol, bl, &sign, NULL);
+
+    if (stat != fsOK) {
+      return (-(int32_t)stat);
+    }
+
+    if (sign == vol->ErasedValue) {
+      rc->empty++;
+    }
+    else if ((sign == (vol->ErasedValue ^ BlockUSED)) ||
+             (sign == (vol->ErasedValue ^ BlockFULL)) ||
+             (sign == (vol->ErasedValue ^ BlockMOVE))) {
+      if (block_is_open (vol, bl) == false) {
+        /* Block marked for reclaim may hold chunks which were already copied */
+        stat = block_usage (vol, bl, &valid, &invalid, (sign == (vol->ErasedValue ^ BlockMOVE)) ? true : false);
+
+        if (stat != fsOK) {
+          return (-(int32_t)stat);
+        }
+
+        if (valid == 0U) {
+          /* Invalidated block is erased first */
+          invalid = 0xFFFFFFFFU;
+        }
+
+        if (invalid > rc->max) {
+          rc->max    = invalid;
+          rc->victim = (uint16_t)bl;
+        }
+      }
+    }
+
+    rc->block++;
+  }
+
+  if (rc->block == vol->SectorCount) {
+    /* Pass completed, reclaim the victim when erased blocks are short */
+    rc->cnt = rc->empty;
+    bl      = rc->victim;
+
+    rc->block  = 0U;
+    rc->victim = vol->SectorCount;
+    rc->max    = 0U;
+    rc->empty  = 0U;
+
+    if ((rc->cnt < fs_efs_reclaim_rsv) && (bl != vol->SectorCount)) {
+      stat = sign_read (vol, bl, &sign, NULL);
+
+      if (stat != fsOK) {
+        return (-(int32_t)stat);
+      }
+
+      /* Victim may have been erased or opened since it was examined */
+      if ((block_is_open (vol, bl) == false) &&
+          ((sign == (vol->ErasedValue ^ BlockUSED)) ||
+           (sign == (vol->ErasedValue ^ BlockFULL)) ||
+           (sign == (vol->ErasedValue ^ BlockMOVE)))) {
+        state = vol->fidx.state;
+
+        stat = block_reclaim (vol, bl, (sign == (vol->ErasedValue ^ BlockMOVE)) ? true : false);
+
+        if (stat == fsOK) {
+          rc->cnt++;
+        }
+        else if (stat != fsNoFreeSpace) {
+          return (-(int32_t)stat);
+        }
+
+        if ((state == EFS_FIDX_STATE_READY) && (vol->fidx.state == EFS_FIDX_STATE_NONE)) {
+          /* Duplicated chunks overflowed the file index */
+          fidx_build (vol);
+        }
+      }
+    }
+  }
+
+  return ((int32_t)rc->cnt);
+}
+
+
 /**
   Read drive information.
 
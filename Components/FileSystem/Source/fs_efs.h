@@ -38,10 +38,14 @@
 /* Defragmentation buffer size */
 #define CBUFLEN               256
 
+/* Number of blocks examined per reclaim step */
+#define EFS_RECLAIM_SCAN      4U
+
 /* Signature Flags (Block Usage Flags) */
 #define BlockTEMP             0x03
 #define BlockUSED             0x0F
 #define BlockFULL             0xFF
+#define BlockMOVE             0xFFF
 
 /* Programable unit required by EFS */
 #define EFS_PROG_UNIT         4U
@@ -54,6 +58,14 @@
 #define EFS_WR_ERROR          4U
 
 
+/* File Index states */
+#define EFS_FIDX_STATE_NONE   0         /* Index not available                */
+#define EFS_FIDX_STATE_READY  1         /* Index complete for the volume      */
+
+/* File Index unused link */
+#define EFS_FIDX_NIL          0xFFFFU
+
+
 /* Types */
 typedef struct falloc {                 /* << File Allocation Info >>         */
   uint32_t end;                         /* Block End address                  */
@@ -61,6 +73,13 @@ typedef struct falloc {                 /* << File Allocation Info >>         */
   uint16_t index;                       /* File data block index              */
 } FALLOC;
 
+typedef struct efs_copy {               /* << Copies of Reclaimed Chunks >>   */
+  uint32_t addr;                        /* Allocation record of next copy     */
+  uint32_t prev;                        /* End address of previous copy       */
+  uint16_t block;                       /* Block with copies                  */
+  uint16_t done;                        /* Remaining chunks were not copied   */
+} EFS_COPY;
+
 /**
   Note that sector content is always as follows:
 
@@ -74,6 +74,9 @@
 #define EvtFsCore_fs_fflush             EvtFsCoreId(EventLevelAPI,    38)
 #define EvtFsCore_fs_fseek              EvtFsCoreId(EventLevelAPI,    39)
 #define EvtFsCore_fs_fsize              EvtFsCoreId(EventLevelAPI,    40)
+#define EvtFsCore_fs_fallocate          EvtFsCoreId(EventLevelAPI,    41)
+#define EvtFsCore_freclaim              EvtFsCoreId(EventLevelAPI,    42)
+#define EvtFsCore_ftrim                 EvtFsCoreId(EventLevelAPI,    43)
 
 /* Event id list for "FsFAT" */
 #define EvtFsFAT_InitDrive              EvtFsFATId(EventLevelOp,       0)
@@ -176,6 +179,16 @@
 #define EvtFsFAT_TimeSet                EvtFsFATId(EventLevelOp,      97)
 #define EvtFsFAT_TimeGet                EvtFsFATId(EventLevelOp,      98)
 #define EvtFsFAT_TimeData               EvtFsFATId(EventLevelDetail,  99)
+#define EvtFsFAT_FileAllocate           EvtFsFATId(EventLevelOp,     100)
+#define EvtFsFAT_FileAllocateRelease    EvtFsFATId(EventLevelOp,     101)
+#define EvtFsFAT_IoReadAhead            EvtFsFATId(EventLevelOp,     102)
+#define EvtFsFAT_IoWriteBehind          EvtFsFATId(EventLevelOp,     103)
+#define EvtFsFAT_FormatSectorSizeInvalid EvtFsFATId(EventLevelError, 104)
+#define EvtFsFAT_DirIndexBuild          EvtFsFATId(EventLevelOp,     105)
+#define EvtFsFAT_DirIndexOverflow       EvtFsFATId(EventLevelOp,     106)
+#define EvtFsFAT_JournalCommitFailed    EvtFsFATId(EventLevelError,  107)
+#define EvtFsFAT_Discard                EvtFsFATId(EventLevelOp,     108)
+#define EvtFsFAT_DiscardUnsupported     EvtFsFATId(EventLevelOp,     109)
 
 /* Event id list for "FsEFS" */
 #define EvtFsEFS_InitDrive              EvtFsEFSId(EventLevelOp,       0)
@@ -239,6 +252,9 @@
 #define EvtFsEFS_FileName               EvtFsEFSId(EventLevelDetail,  58)
 #define EvtFsEFS_FileAllocWrite         EvtFsEFSId(EventLevelDetail,  59)
 #define EvtFsEFS_FileAllocRead          EvtFsEFSId(EventLevelDetail,  60)
+#define EvtFsEFS_FileIndexBuild         EvtFsEFSId(EventLevelOp,      61)
+#define EvtFsEFS_FileIndexOverflow      EvtFsEFSId(EventLevelOp,      62)
+#define EvtFsEFS_BlockReclaim           EvtFsEFSId(EventLevelOp,      63)
 
 /* Event id list for "FsIOC" */
 #define EvtFsIOC_GetId                  EvtFsIOCId(EventLevelAPI,      0)
@@ -336,6 +352,8 @@
 #define EvtFsNFTL_StatusRead            EvtFsNFTLId(EventLevelDetail, 67)
 #define EvtFsNFTL_CacheWrite            EvtFsNFTLId(EventLevelDetail, 68)
 #define EvtFsNFTL_CacheRead             EvtFsNFTLId(EventLevelDetail, 69)
+#define EvtFsNFTL_WearLeveling          EvtFsNFTLId(EventLevelOp,     70)
+#define EvtFsNFTL_Discard               EvtFsNFTLId(EventLevelOp,     71)
 
 #if defined(FS_NAND_FLASH_0) || defined(FS_NAND_FLASH_1)
 /* Event id list for "FsNAND" */
@@ -420,6 +438,8 @@
 #define EvtFsMcMCI_WriteXferSetupError  EvtFsMcMCIId(EventLevelError, 53)
 #define EvtFsMcMCI_ParameterInvalid     EvtFsMcMCIId(EventLevelError, 54)
 #define EvtFsMcMCI_MediaPasswordEnabled EvtFsMcMCIId(EventLevelError, 55)
+#define EvtFsMcMCI_Erase                EvtFsMcMCIId(EventLevelOp,    56)
+#define EvtFsMcMCI_EraseError           EvtFsMcMCIId(EventLevelError, 57)
 
 /* Event id list for "FsMcSPI" */
 #define EvtFsMcSPI_InitDriver           EvtFsMcSPIId(EventLevelOp,     0)
@@ -470,6 +490,8 @@
 #define EvtFsMcSPI_ACmdResponseError    EvtFsMcSPIId(EventLevelError, 45)
 #define EvtFsMcSPI_ParameterInvalid     EvtFsMcSPIId(EventLevelError, 46)
 #define EvtFsMcSPI_MediaPasswordEnabled EvtFsMcSPIId(EventLevelError, 47)
+#define EvtFsMcSPI_CrcEnableError       EvtFsMcSPIId(EventLevelError, 48)
+#define EvtFsMcSPI_DataCrcError         EvtFsMcSPIId(EventLevelError, 49)
 #endif /* defined(FS_MEMORY_CARD_0) || defined(FS_MEMORY_CARD_1) */
 #endif
 
@@ -996,6 +1018,44 @@
   #define EvrFsCore_fs_fsize(handle)
 #endif
 
+/**
+  \brief  Event on file space preallocation (API)
+  \param[in]  handle    file handle
+  \param[in]  size      requested allocation size
+  \param[in]  flags     allocation flags
+ */
+#ifdef EvtFsCore_fs_fallocate
+  __STATIC_INLINE void EvrFsCore_fs_fallocate (int32_t handle, int64_t size, uint32_t flags) {
+    EventRecord4 (EvtFsCore_fs_fallocate, (uint32_t)handle, (uint32_t)size, (uint32_t)(size>>32), flags);
+  }
+#else
+  #define EvrFsCore_fs_fallocate(handle, size, flags)
+#endif
+
+/**
+  \brief  Event on drive reclaim step (API)
+  \param[in]  drive     a string specifying the drive.
+ */
+#ifdef EvtFsCore_freclaim
+  __STATIC_INLINE void EvrFsCore_freclaim (const char *drive) {
+    EventRecord2 (EvtFsCore_freclaim, (uint32_t)drive, 0);
+  }
+#else
+  #define EvrFsCore_freclaim(drive)
+#endif
+
+/**
+  \brief  Event on drive free space discard (API)
+  \param[in]  drive     a string specifying the drive.
+ */
+#ifdef EvtFsCore_ftrim
+  __STATIC_INLINE void EvrFsCore_ftrim (const char *drive) {
+    EventRecord2 (EvtFsCore_ftrim, (uint32_t)drive, 0);
+  }
+#else
+  #define EvrFsCore_ftrim(drive)
+#endif
+
 
 /**
   \brief  Event on FAT drive initialization (Op)
@@ -2302,6 +2362,140 @@
   #define EvrFsFAT_TimeData(create, access, write)
 #endif
 
+/**
+  \brief  Event on FAT file space preallocation (Op)
+  \param[in]  h         FAT file handle index
+  \param[in]  clus      first preallocated cluster
+  \param[in]  cnt       number of preallocated clusters
+ */
+#ifdef EvtFsFAT_FileAllocate
+  __STATIC_INLINE void EvrFsFAT_FileAllocate (int32_t h, uint32_t clus, uint32_t cnt) {
+    EventRecord4 (EvtFsFAT_FileAllocate, (uint32_t)h, clus, cnt, 0);
+  }
+#else
+  #define EvrFsFAT_FileAllocate(h, clus, cnt)
+#endif
+
+/**
+  \brief  Event on FAT file release of unused preallocated space (Op)
+  \param[in]  h         FAT file handle index
+  \param[in]  clus      first released cluster
+ */
+#ifdef EvtFsFAT_FileAllocateRelease
+  __STATIC_INLINE void EvrFsFAT_FileAllocateRelease (int32_t h, uint32_t clus) {
+    EventRecord2 (EvtFsFAT_FileAllocateRelease, (uint32_t)h, clus);
+  }
+#else
+  #define EvrFsFAT_FileAllocateRelease(h, clus)
+#endif
+
+/**
+  \brief  Event on background read-ahead of data sectors (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  sector    first sector number
+  \param[in]  count     number of sectors to read
+ */
+#ifdef EvtFsFAT_IoReadAhead
+  __STATIC_INLINE void EvrFsFAT_IoReadAhead (uint32_t drive, uint32_t sector, uint32_t count) {
+    EventRecord4 (EvtFsFAT_IoReadAhead, drive, sector, count, 0);
+  }
+#else
+  #define EvrFsFAT_IoReadAhead(drive, sector, count)
+#endif
+
+/**
+  \brief  Event on background write of buffered data sectors (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  sector    first sector number
+  \param[in]  count     number of sectors to write
+ */
+#ifdef EvtFsFAT_IoWriteBehind
+  __STATIC_INLINE void EvrFsFAT_IoWriteBehind (uint32_t drive, uint32_t sector, uint32_t count) {
+    EventRecord4 (EvtFsFAT_IoWriteBehind, drive, sector, count, 0);
+  }
+#else
+  #define EvrFsFAT_IoWriteBehind(drive, sector, count)
+#endif
+
+/**
+  \brief  Event on unsupported media sector size for format (Error)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  size      media sector size in bytes
+ */
+#ifdef EvtFsFAT_FormatSectorSizeInvalid
+  __STATIC_INLINE void EvrFsFAT_FormatSectorSizeInvalid (uint32_t drive, uint32_t size) {
+    EventRecord2 (EvtFsFAT_FormatSectorSizeInvalid, drive, size);
+  }
+#else
+  #define EvrFsFAT_FormatSectorSizeInvalid(drive, size)
+#endif
+
+/**
+  \brief  Event on directory index build (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  dir       first cluster of the directory
+  \param[in]  count     number of indexed file records
+ */
+#ifdef EvtFsFAT_DirIndexBuild
+  __STATIC_INLINE void EvrFsFAT_DirIndexBuild (uint32_t drive, uint32_t dir, uint32_t count) {
+    EventRecord4 (EvtFsFAT_DirIndexBuild, drive, dir, count, 0);
+  }
+#else
+  #define EvrFsFAT_DirIndexBuild(drive, dir, count)
+#endif
+
+/**
+  \brief  Event on directory too large for the directory index (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  dir       first cluster of the directory
+  \param[in]  max       maximum number of indexed file records
+ */
+#ifdef EvtFsFAT_DirIndexOverflow
+  __STATIC_INLINE void EvrFsFAT_DirIndexOverflow (uint32_t drive, uint32_t dir, uint32_t max) {
+    EventRecord4 (EvtFsFAT_DirIndexOverflow, drive, dir, max, 0);
+  }
+#else
+  #define EvrFsFAT_DirIndexOverflow(drive, dir, max)
+#endif
+
+/**
+  \brief  Event on journal transaction group commit failure (Error)
+  \param[in]  drive     4 byte encoded drive letter
+ */
+#ifdef EvtFsFAT_JournalCommitFailed
+  __STATIC_INLINE void EvrFsFAT_JournalCommitFailed (uint32_t drive) {
+    EventRecord2 (EvtFsFAT_JournalCommitFailed, drive, 0);
+  }
+#else
+  #define EvrFsFAT_JournalCommitFailed(drive)
+#endif
+
+/**
+  \brief  Event on discard of unused sectors (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  sect      first sector
+  \param[in]  cnt       number of sectors
+ */
+#ifdef EvtFsFAT_Discard
+  __STATIC_INLINE void EvrFsFAT_Discard (uint32_t drive, uint32_t sect, uint32_t cnt) {
+    EventRecord4 (EvtFsFAT_Discard, drive, sect, cnt, 0);
+  }
+#else
+  #define EvrFsFAT_Discard(drive, sect, cnt)
+#endif
+
+/**
+  \brief  Event on discard not supported by the media (Op)
+  \param[in]  drive     4 byte encoded drive letter
+ */
+#ifdef EvtFsFAT_DiscardUnsupported
+  __STATIC_INLINE void EvrFsFAT_DiscardUnsupported (uint32_t drive) {
+    EventRecord2 (EvtFsFAT_DiscardUnsupported, drive, 0);
+  }
+#else
+  #define EvrFsFAT_DiscardUnsupported(drive)
+#endif
+
 /**
   \brief  Event on EFS drive initialization (Op)
   \param[in]  drive     4 byte encoded drive letter
@@ -3080,6 +3274,47 @@
   #define EvrFsEFS_FileAllocRead(addr, end, fileID, index)
 #endif
 
+/**
+  \brief  Event on file index build (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  count     number of indexed file chunks
+ */
+#ifdef EvtFsEFS_FileIndexBuild
+  __STATIC_INLINE void EvrFsEFS_FileIndexBuild (uint32_t drive, uint32_t count) {
+    EventRecord2 (EvtFsEFS_FileIndexBuild, drive, count);
+  }
+#else
+  #define EvrFsEFS_FileIndexBuild(drive, count)
+#endif
+
+/**
+  \brief  Event on file chunks not fitting into the file index (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  max       maximum number of indexed file chunks
+ */
+#ifdef EvtFsEFS_FileIndexOverflow
+  __STATIC_INLINE void EvrFsEFS_FileIndexOverflow (uint32_t drive, uint32_t max) {
+    EventRecord2 (EvtFsEFS_FileIndexOverflow, drive, max);
+  }
+#else
+  #define EvrFsEFS_FileIndexOverflow(drive, max)
+#endif
+
+/**
+  \brief  Event on block reclaim (Op)
+  \param[in]  drive     4 byte encoded drive letter
+  \param[in]  block     reclaimed block number
+  \param[in]  valid     amount of moved valid data in bytes
+  \param[in]  invalid   amount of reclaimed invalidated data in bytes
+ */
+#ifdef EvtFsEFS_BlockReclaim
+  __STATIC_INLINE void EvrFsEFS_BlockReclaim (uint32_t drive, uint32_t block, uint32_t valid, uint32_t invalid) {
+    EventRecord4 (EvtFsEFS_BlockReclaim, drive, block, valid, invalid);
+  }
+#else
+  #define EvrFsEFS_BlockReclaim(drive, block, valid, invalid)
+#endif
+
 
 /**
   \brief  Event on call of \ref fs_ioc_get_id function (API)
@@ -4305,6 +4540,34 @@
   #define EvrFsNFTL_CacheRead(instance, pbn, pg, col)
 #endif
 
+/**
+  \brief  Event on NFTL static wear leveling operation (Op)
+  \param[in]  instance  NFTL instance number
+  \param[in]  lbn       logical block number
+  \param[in]  pbn       physical block number
+ */
+#ifdef EvtFsNFTL_WearLeveling
+  __STATIC_INLINE void EvrFsNFTL_WearLeveling (uint32_t instance, uint32_t lbn, uint32_t pbn) {
+    EventRecord4 (EvtFsNFTL_WearLeveling, instance, lbn, pbn, 0);
+  }
+#else
+  #define EvrFsNFTL_WearLeveling(instance, lbn, pbn)
+#endif
+
+/**
+  \brief  Event on NFTL sector range discard (Op)
+  \param[in]  instance  NFTL instance number
+  \param[in]  sect      first sector
+  \param[in]  cnt       number of sectors
+ */
+#ifdef EvtFsNFTL_Discard
+  __STATIC_INLINE void EvrFsNFTL_Discard (uint32_t instance, uint32_t sect, uint32_t cnt) {
+    EventRecord4 (EvtFsNFTL_Discard, instance, sect, cnt, 0);
+  }
+#else
+  #define EvrFsNFTL_Discard(instance, sect, cnt)
+#endif
+
 /**
   \brief  Event on NAND media layer initialization (Op)
   \param[in]  instance  NAND media layer instance
@@ -5295,6 +5558,35 @@
   #define EvrFsMcMCI_MediaPasswordEnabled(instance)
 #endif
 
+/**
+  \brief  Event on sector range erase (Op)
+  \param[in]  instance  memory card control layer instance
+  \param[in]  sect      first sector
+  \param[in]  cnt       number of sectors
+  \param[in]  arg       erase command argument
+ */
+#ifdef EvtFsMcMCI_Erase
+  __STATIC_INLINE void EvrFsMcMCI_Erase (uint32_t instance, uint32_t sect, uint32_t cnt, uint32_t arg) {
+    EventRecord4 (EvtFsMcMCI_Erase, instance, sect, cnt, arg);
+  }
+#else
+  #define EvrFsMcMCI_Erase(instance, sect, cnt, arg)
+#endif
+
+/**
+  \brief  Event on sector range erase failure (Error)
+  \param[in]  instance  memory card control layer instance
+  \param[in]  sect      first sector
+  \param[in]  cnt       number of sectors
+ */
+#ifdef EvtFsMcMCI_EraseError
+  __STATIC_INLINE void EvrFsMcMCI_EraseError (uint32_t instance, uint32_t sect, uint32_t cnt) {
+    EventRecord4 (EvtFsMcMCI_EraseError, instance, sect, cnt, 0);
+  }
+#else
+  #define EvrFsMcMCI_EraseError(instance, sect, cnt)
+#endif
+
 /**
   \brief  Event on memory card driver initialization (Op)
   \param[in]  instance  memory card control layer instance
@@ -5899,4 +6191,28 @@
   #define EvrFsMcSPI_MediaPasswordEnabled(instance)
 #endif
 
+/**
+  \brief  Event on failed CRC check enable (Error)
+  \param[in]  instance  memory card control layer instance
+ */
+#ifdef EvtFsMcSPI_CrcEnableError
+  __STATIC_INLINE void EvrFsMcSPI_CrcEnableError (uint32_t instance) {
+    EventRecord2 (EvtFsMcSPI_CrcEnableError, instance, 0);
+  }
+#else
+  #define EvrFsMcSPI_CrcEnableError(instance)
+#endif
+
+/**
+  \brief  Event on data block CRC mismatch (Error)
+  \param[in]  instance  memory card control layer instance
+ */
+#ifdef EvtFsMcSPI_DataCrcError
+  __STATIC_INLINE void EvrFsMcSPI_DataCrcError (uint32_t instance) {
+    EventRecord2 (EvtFsMcSPI_DataCrcError, instance, 0);
+  }
+#else
+  #define EvrFsMcSPI_DataCrcError(instance)
+#endif
+
 #endif /* FS_EVR_H__ */
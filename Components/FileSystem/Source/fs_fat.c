@@ -31,7 +31,7 @@
   FAT16 maximum clusters: 65,524
   FAT32 minimum clusters: 65,525
 
-  FAT32 max. volume size: 2TiB (4G of sectors * 512B)
+  FAT32 max. volume size: 2TiB (4G of sectors * 512B), 16TiB with 4KiB sectors
 */
 
 /* Formatting table */
@@ -154,7 +154,7 @@ __WEAK int32_t fat_handle_get (fsFAT_Volume *vol) {
   for (i = 0; i < fs_fat_fh_cnt; i++) {
     fh = &fs_fat_fh[i];
 
-    if (!(fh->flags & FAT_HANDLE_OPEN)) {
+    if (!(fh->flags & (FAT_HANDLE_OPEN | FAT_HANDLE_CLOSE))) {
       /* Clear File Control Block */
       memset (fh, 0, sizeof (fsFAT_Handle));
       fh->vol = vol;
@@ -192,6 +192,26 @@ static void fat_handles_reset (fsFAT_Volume *vol) {
 }
 
 
+/**
+  Check if a chunked file transfer or a file close is in progress on the FAT volume
+
+  \param[in]  vol                       volume description structure
+  \return     true if transfer is in progress, false otherwise
+*/
+static bool fat_xfer_active (fsFAT_Volume *vol) {
+  uint32_t i;
+
+  for (i = 0; i < fs_fat_fh_cnt; i++) {
+    if ((fs_fat_fh[i].vol == vol) && (fs_fat_fh[i].flags & (FAT_HANDLE_XFER | FAT_HANDLE_CLOSE))) {
+      /* File transfer in progress, volume lock released between chunks */
+      EvrFsFAT_FileIsInUse (vol->DrvLet);
+      return (true);
+    }
+  }
+  return (false);
+}
+
+
 /**
   Check if file is in use by another handle
 
@@ -1255,7 +1275,70 @@ static const char *name_strip (const char *fn, uint8_t *len, uint8_t *flags) {
 
 
 /**
-  Read a 512 byte sector from the media.
+  Return sector to be read from the media. Sector which was written with
+  journal and is not yet committed is read from its copy in the journal.
+*/
+static uint32_t jour_sect (fsFAT_Volume *vol, uint32_t sect) {
+  uint32_t jsect;
+
+  if (vol->fsj != NULL) {
+    jsect = fsj_find (vol->fsj, sect);
+    if (jsect != 0U) {
+      return (jsect);
+    }
+  }
+  return (sect);
+}
+
+
+/**
+  Read sectors from the media. Sectors which were written with journal and
+  are not yet committed are replaced with their copy in the journal.
+*/
+static uint32_t jour_read (fsFAT_Volume *vol, uint32_t sect, uint8_t *buf, uint32_t cnt) {
+  uint32_t i, jsect;
+
+  if (cnt == 1U) {
+    return (vol->Drv->ReadSect (jour_sect (vol, sect), buf, 1));
+  }
+
+  if (vol->Drv->ReadSect (sect, buf, cnt) == false) {
+    return (false);
+  }
+
+  if ((vol->fsj != NULL) && (vol->fsj->GrpCnt != 0U)) {
+    for (i = 0U; i < cnt; i++) {
+      jsect = fsj_find (vol->fsj, sect + i);
+      if (jsect != 0U) {
+        /* Sector is in the open journal group */
+        if (vol->Drv->ReadSect (jsect, &buf[i * vol->cfg.BytesPerSec], 1) == false) {
+          return (false);
+        }
+      }
+    }
+  }
+  return (true);
+}
+
+
+/**
+  Commit sectors written with journal since the last commit. Commit is
+  deferred while an operation which consists of several steps is running.
+*/
+static uint32_t jour_commit (fsFAT_Volume *vol) {
+
+  if ((vol->fsj != NULL) && !(vol->Status & FAT_STATUS_JOURHOLD)) {
+    if (fsj_commit (vol->fsj) == false) {
+      EvrFsFAT_JournalCommitFailed (vol->DrvLet);
+      return (false);
+    }
+  }
+  return (true);
+}
+
+
+/**
+  Read a sector from the media.
 */
 static uint32_t read_sector (fsFAT_Volume *vol, uint32_t sect) {
 
@@ -1266,13 +1349,13 @@ static uint32_t read_sector (fsFAT_Volume *vol, uint32_t sect) {
 
   if (sect >= vol->ca.csect && sect < (vol->ca.csect + vol->ca.nwr)) {
     /* This sector is in write cache buffer. */
-    memcpy (vol->ca.buf, vol->ca.cbuf + (sect - vol->ca.csect) * 512, 512);
+    memcpy (vol->ca.buf, vol->ca.cbuf + (sect - vol->ca.csect) * vol->cfg.BytesPerSec, vol->cfg.BytesPerSec);
     vol->ca.sect = sect;
     return (true);
   }
 
-  /* Sector not in cache, read it from Device. */
-  if (vol->Drv->ReadSect (sect, vol->ca.buf, 1) == true) {
+  /* Sector not in cache, read it from Device or from the journal group. */
+  if (jour_read (vol, sect, vol->ca.buf, 1) == true) {
     vol->ca.sect = sect;
     return (true);
   }
@@ -1285,7 +1368,7 @@ static uint32_t read_sector (fsFAT_Volume *vol, uint32_t sect) {
 
 
 /**
-  Write a 512 byte sector to the media.
+  Write a sector to the media.
 */
 static uint32_t write_sector (fsFAT_Volume *vol, uint32_t sect, uint32_t act) {
   uint32_t rtv;
@@ -1311,7 +1394,7 @@ static uint32_t write_sector (fsFAT_Volume *vol, uint32_t sect, uint32_t act) {
 
 
 /**
-  Read a 512 byte sector through cache.
+  Read a sector through cache.
 */
 static uint32_t read_cache (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
 
@@ -1323,7 +1406,7 @@ static uint32_t read_cache (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
   if (vol->ca.nrd > 0) {
     if ((vol->ca.csect <= sect) && sect < (vol->ca.csect + vol->ca.nrd)) {
       /* Requested sector is already cached. */
-      memcpy (vol->ca.buf, vol->ca.cbuf + (sect - vol->ca.csect) * 512, 512);
+      memcpy (vol->ca.buf, vol->ca.cbuf + (sect - vol->ca.csect) * vol->cfg.BytesPerSec, vol->cfg.BytesPerSec);
       vol->ca.sect = sect;
       return (true);
     }
@@ -1333,8 +1416,11 @@ static uint32_t read_cache (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
     cnt = vol->CaSize;
   }
 
+  /* Sector not in cache, pending read-ahead is superseded. */
+  vol->ca.nra = 0;
+
   /* Sector not in cache, read it from the Memory Card. */
-  if (vol->Drv->ReadSect (sect, vol->ca.buf, cnt) == true) {
+  if (jour_read (vol, sect, vol->ca.buf, cnt) == true) {
     vol->ca.sect  = sect;
     /* First sector is used, the rest is cached. */
     vol->ca.csect = sect + 1;
@@ -1351,7 +1437,7 @@ static uint32_t read_cache (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
 
 
 /**
-  Write a 512 byte sector through cache.
+  Write a sector through cache.
 */
 static uint32_t write_cache (fsFAT_Volume *vol, uint32_t sect) {
 
@@ -1380,13 +1466,13 @@ static uint32_t write_cache (fsFAT_Volume *vol, uint32_t sect) {
   if (vol->ca.nwr > 0) {
     if (sect == (vol->ca.csect + vol->ca.nwr) && vol->ca.nwr < vol->CaSize) {
       /* Next sector is continuous, still space in cache. */
-      memcpy (vol->ca.cbuf + (vol->ca.nwr * 512), vol->ca.buf, 512);
+      memcpy (vol->ca.cbuf + (vol->ca.nwr * vol->cfg.BytesPerSec), vol->ca.buf, vol->cfg.BytesPerSec);
       vol->ca.nwr++;
       return (true);
     }
     else if (sect >= (vol->ca.csect ) && sect < (vol->ca.csect + vol->ca.nwr)) {
       /* Sector is already in the cache */
-      memcpy (vol->ca.cbuf + ((sect - vol->ca.csect) * 512), vol->ca.buf, 512);
+      memcpy (vol->ca.cbuf + ((sect - vol->ca.csect) * vol->cfg.BytesPerSec), vol->ca.buf, vol->cfg.BytesPerSec);
       return (true);
     }
     /* Not continuous sector or buffer full, flush the cache. */
@@ -1398,7 +1484,7 @@ static uint32_t write_cache (fsFAT_Volume *vol, uint32_t sect) {
     vol->ca.nwr = 0;
   }
   /* Write Data cache is empty. */
-  memcpy (vol->ca.cbuf, vol->ca.buf, 512);
+  memcpy (vol->ca.cbuf, vol->ca.buf, vol->cfg.BytesPerSec);
   vol->ca.csect = sect;
   vol->ca.nwr   = 1;
   vol->ca.nrd   = 0;
@@ -1407,685 +1493,2333 @@ static uint32_t write_cache (fsFAT_Volume *vol, uint32_t sect) {
 
 
 /**
-  Handle FAT Cache. Read/write a 512 byte FAT sector.
-*/
-static uint32_t cache_fat (fsFAT_Volume *vol, uint32_t sect) {
-  uint32_t ofs;
+  Read multiple sectors from the media directly into user buffer.
 
-  if (sect == vol->fat.sect) {
-    /* Required sector already in buffer. */
-    return (true);
-  }
-  if (vol->fat.dirty == true) {
-    /* Current FAT sector has been changed, write it first. */
+  Data cache is bypassed, write cache is flushed first if it holds
+  any of the requested sectors. Used only on drives whose cache is not
+  located in a dedicated section, since the driver may use DMA.
+*/
+static uint32_t read_direct (fsFAT_Volume *vol, uint32_t sect, uint8_t *buf, uint32_t cnt) {
 
-    if (vol->fsj && vol->Status & FAT_STATUS_JOURACT) {
-      /* Write FAT with journal */
-      ofs = (vol->cfg.NumOfFat == 2) ? (vol->fat.sect + vol->cfg.FatSize) : (0);
-      if (fsj_write (vol->fsj, vol->fat.sect, ofs, vol->fat.buf) == false) {
-        return (false);
-      }
-    }
-    else {
-      /* Write FAT without journal */
-      if (vol->Drv->WriteSect (vol->fat.sect, vol->fat.buf, 1) == false) {
-        /* Sector write failed */
-        EvrFsFAT_SectorWriteFailed (vol->DrvLet, vol->fat.sect, 1);
+  if (vol->ca.nwr > 0) {
+    if ((vol->ca.csect < (sect + cnt)) && (sect < (vol->ca.csect + vol->ca.nwr))) {
+      /* Requested sectors overlap write cache, flush it. */
+      if (write_cache (vol, 0) == false) {
         return (false);
       }
-
-      if (vol->cfg.NumOfFat == 2) {
-        /* Write copy of FAT */
-        if (vol->Drv->WriteSect (vol->fat.sect+vol->cfg.FatSize, vol->fat.buf, 1) == false) {
-          /* Sector write failed */
-          EvrFsFAT_SectorWriteFailed (vol->DrvLet, vol->fat.sect+vol->cfg.FatSize, 1);
-          return (false);
-        }
-      }
     }
-
-    vol->fat.dirty = false;
   }
-  if (sect == 0) {
-    /* Only write if sector updated. */
-    return (true);
-  }
-
-  /* Set sector offset to select FAT */
-  ofs = vol->fat.cfat * vol->cfg.FatSize;
 
-  if (vol->Drv->ReadSect (sect+ofs, vol->fat.buf, 1) == true) {
-    vol->fat.sect = sect;
-    return (true);
+  if (jour_read (vol, sect, buf, cnt) == false) {
+    /* Sector read failed */
+    EvrFsFAT_SectorReadFailed (vol->DrvLet, sect, cnt);
+    return (false);
   }
-  /* Sector read failed */
-  EvrFsFAT_SectorReadFailed (vol->DrvLet, sect+ofs, 1);
-
-  vol->fat.sect = INVAL_SECT;
-  return (false);
+  return (true);
 }
 
 
 /**
-  Calculate absolute FAT Sector address from cluster address.
-*/
-static uint32_t get_fat_sect (FATINFO *fvi, uint32_t clus) {
-  uint32_t fats;
-
-  switch (fvi->FatType) {
-    case FS_FAT12:
-      /* FAT Cluster width 12 bits. */
-      fats = (clus * 3) / 1024;
-      break;
-
-    case FS_FAT16:
-      /* FAT Cluster width 16 bits. */
-      fats = clus / 256;
-      break;
+  Write multiple sectors to the media directly from user buffer.
 
-    case FS_FAT32:
-      /* FAT Cluster width 32 bits. */
-      fats = clus / 128;
-      break;
+  Data cache is bypassed, cached copies of the written sectors are
+  flushed or invalidated to keep the cache coherent. Used only on drives
+  whose cache is not located in a dedicated section, since the driver
+  may use DMA.
+*/
+static uint32_t write_direct (fsFAT_Volume *vol, uint32_t sect, const uint8_t *buf, uint32_t cnt) {
 
-    default:
-      /* Not supported. */
-      return (0);
+  if (vol->ca.nwr > 0) {
+    /* Flush write cache to keep the write order. */
+    if (write_cache (vol, 0) == false) {
+      return (false);
+    }
   }
-  if (fats >= fvi->FatSize) {
-    return (0);
+  if ((vol->ca.sect >= sect) && (vol->ca.sect < (sect + cnt))) {
+    /* Working buffer holds old sector data */
+    vol->ca.sect = INVAL_SECT;
   }
-  fats += (fvi->BootSector + fvi->RsvdSecCnt);
-  return (fats);
+  if ((vol->ca.csect < (sect + cnt)) && (sect < (vol->ca.csect + vol->ca.nrd))) {
+    /* Read cache holds old sector data */
+    vol->ca.nrd = 0;
+  }
+
+  if (vol->Drv->WriteSect (sect, buf, cnt) == false) {
+    /* Sector write failed */
+    EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect, cnt);
+    return (false);
+  }
+  return (true);
 }
 
 
 /**
-  Retrieve root cluster number
+  Add FAT sectors to the runs which are copied to second FAT on cache flush.
 
-  \param[in]  vol                       volume description structure
+  Sectors overlapping or adjacent to an existing run extend that run, so
+  that sectors far apart do not cause the sectors in between to be copied.
+
+  \return     true when sectors are registered, false when all runs are in use
 */
-static uint32_t get_root_clus (fsFAT_Volume *vol) {
-  if (vol->cfg.FatType == FS_FAT32) {
-    /* Root directory cluster on FAT32 */
-    return (vol->cfg.FAT32_RootClus);
+static uint32_t mirr_add (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
+  FMIRR_RUN *r, *fr;
+  uint32_t   i;
+
+  fr = NULL;
+  for (i = 0U; i < (sizeof(vol->fat.mrun) / sizeof(vol->fat.mrun[0])); i++) {
+    r = &vol->fat.mrun[i];
+    if (r->cnt == 0U) {
+      if (fr == NULL) {
+        fr = r;
+      }
+    }
+    else if ((sect <= (r->sect + r->cnt)) && (r->sect <= (sect + cnt))) {
+      /* Extend existing run */
+      if ((sect + cnt) > (r->sect + r->cnt)) {
+        r->cnt = (sect + cnt) - r->sect;
+      }
+      if (sect < r->sect) {
+        r->cnt += r->sect - sect;
+        r->sect = sect;
+      }
+      return (true);
+    }
   }
-  else {
-    /* Root directory cluster on FAT12 or FAT16 */
-    return (0);
+
+  if (fr == NULL) {
+    return (false);
   }
+  /* Start new run */
+  fr->sect = sect;
+  fr->cnt  = cnt;
+  return (true);
 }
 
 
 /**
-  Calculate absolute sector address from the cluster number
+  Write FAT sectors to the media, to the first FAT and optionally to its copy.
 */
-static uint32_t clus_to_sect (FATINFO *fvi, uint32_t clus) {
-  uint32_t sect;
+static uint32_t fat_sect_write (fsFAT_Volume *vol, uint32_t sect, const uint8_t *buf, uint32_t cnt, uint32_t mirror) {
 
-  /* Root directory first sector for FAT12 or FAT16 */
-  sect = fvi->BootSector + fvi->RootDirAddr;
-  if (clus == 0) {
-    if (fvi->FatType != FS_FAT32) {
-      /* Root cluster for FAT12 or FAT16 */
-      return sect;
-    }
+  if (vol->Drv->WriteSect (sect, buf, cnt) == false) {
+    /* Sector write failed */
+    EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect, cnt);
+    return (false);
   }
 
-  if (fvi->FatType != FS_FAT32) {
-    /* First sector of data region for FAT12 or FAT16 */
-    sect += fvi->RootSecCnt;
+  if (vol->cfg.NumOfFat == 2) {
+    if (mirror) {
+      /* Write copy of FAT */
+      if (vol->Drv->WriteSect (sect+vol->cfg.FatSize, buf, cnt) == false) {
+        /* Sector write failed */
+        EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect+vol->cfg.FatSize, cnt);
+        return (false);
+      }
+    }
+    else if (mirr_add (vol, sect, cnt) == false) {
+      /* No free run, write copy of FAT now */
+      if (vol->Drv->WriteSect (sect+vol->cfg.FatSize, buf, cnt) == false) {
+        /* Sector write failed */
+        EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect+vol->cfg.FatSize, cnt);
+        return (false);
+      }
+    }
   }
-  /* First sector of given cluster in data region */
-  sect += (clus - 2) * fvi->SecPerClus;
-  return (sect);
+  return (true);
 }
 
 
 /**
-  Return an End Of Chain Marker.
+  Write back FAT cache entry.
 */
-static uint32_t get_EOC (uint32_t fat_type) {
-  switch (fat_type) {
-    case FS_FAT12: return (0x00000FFF);
-    case FS_FAT16: return (0x0000FFFF);
-    case FS_FAT32: return (0x0FFFFFFF);
+static uint32_t fat_ent_write (fsFAT_Volume *vol, FCACHE_ENT *ent, uint32_t mirror) {
+  uint32_t ofs;
 
-    default: return (0);
+  if (vol->fsj && vol->Status & FAT_STATUS_JOURACT) {
+    /* Write FAT with journal */
+    ofs = (vol->cfg.NumOfFat == 2) ? (ent->sect + vol->cfg.FatSize) : (0);
+    if (fsj_write (vol->fsj, ent->sect, ofs, ent->buf) == false) {
+      return (false);
+    }
+  }
+  else {
+    /* Write FAT without journal */
+    if (fat_sect_write (vol, ent->sect, ent->buf, 1, mirror) == false) {
+      return (false);
+    }
   }
+  ent->dirty = false;
+  return (true);
 }
 
 
 /**
-  Return "Cluster Reserved" Marker.
+  Discard a range of sectors on the media.
+
+  Media which does not support discard is not asked again until the
+  volume is mounted again.
 */
-static uint32_t get_RSVD (uint32_t fat_type) {
-  switch (fat_type) {
-    case FS_FAT12: return (0x00000FF7);
-    case FS_FAT16: return (0x0000FFF7);
-    case FS_FAT32: return (0x0FFFFFF7);
+static fsStatus disc_sect (fsFAT_Volume *vol, uint32_t sect, uint32_t cnt) {
+  fsDiscardRange range;
+  fsStatus       status;
 
-    default: return (0);
+  if (vol->Status & FAT_STATUS_NODISCARD) {
+    return (fsUnsupported);
+  }
+  EvrFsFAT_Discard (vol->DrvLet, sect, cnt);
+
+  range.sect = sect;
+  range.cnt  = cnt;
+
+  status = vol->Drv->DeviceCtrl (fsDevCtrlCodeDiscard, &range);
+
+  if (status == fsUnsupported) {
+    EvrFsFAT_DiscardUnsupported (vol->DrvLet);
+    vol->Status |= FAT_STATUS_NODISCARD;
   }
+  return (status);
 }
 
 
 /**
-  Read FAT entry value for given cluster
+  Add freed cluster to the pending discard runs.
 
-  \param[in]  clus                      cluster number
-  \param[out] val                       FAT entry value
-  \param[in]  vol                       volume description structure
+  Cluster adjacent to an existing run extends that run. When all runs are
+  in use the cluster is not discarded (it can still be discarded by trim).
 */
-static uint32_t alloc_table_read (uint32_t clus, uint32_t *val, fsFAT_Volume *vol) {
-  uint32_t sect, offs, link;
+static void disc_add (fsFAT_Volume *vol, uint32_t clus) {
+  FDISC_RUN *r;
+  uint32_t   i;
 
-  /* Read a part of FAT table to buffer. */
-  sect = get_fat_sect (&vol->cfg, clus);
-  if (cache_fat (vol, sect) == false) {
-    return (false);
+  if ((fs_fat_discard == 0U) || (vol->Status & FAT_STATUS_NODISCARD)) {
+    return;
   }
 
-  switch (vol->cfg.FatType) {
-    case FS_FAT12:
-      offs  = ((clus * 3) / 2) & 0x1FF;
-      if (offs < 511) {
-        link = get_u16 (&vol->fat.buf[offs]);
-      }
-      else {
-        /* This cluster spans on two sectors in the FAT. */
-        link = vol->fat.buf[511];
-        if (cache_fat (vol, sect+1) == false) {
-          return (false);
-        }
-        link |= (uint32_t)(vol->fat.buf[0] << 8);
+  for (i = 0U; i < (sizeof(vol->disc.run) / sizeof(vol->disc.run[0])); i++) {
+    r = &vol->disc.run[i];
+    if (r->Cnt != 0U) {
+      if (clus == (r->Clus + r->Cnt)) {
+        /* Extend run at the end */
+        r->Cnt++;
+        return;
       }
-      if (clus & 0x001) {
-        link >>= 4;
-      }
-      else {
-        link &= 0xFFF;
+      if (clus == (r->Clus - 1U)) {
+        /* Extend run at the beginning */
+        r->Clus = clus;
+        r->Cnt++;
+        return;
       }
-      break;
-
-    case FS_FAT16:
-      offs  = (clus & 0xFF) << 1;
-      link = get_u16 (&vol->fat.buf[offs]);
-      break;
-
-    case FS_FAT32:
-      offs  = (clus & 0x7F) << 2;
-      link = get_u32 (&vol->fat.buf[offs]);
-      break;
+    }
+  }
 
-    default:
-      return (false);
+  for (i = 0U; i < (sizeof(vol->disc.run) / sizeof(vol->disc.run[0])); i++) {
+    r = &vol->disc.run[i];
+    if (r->Cnt == 0U) {
+      /* Start new run */
+      r->Clus = clus;
+      r->Cnt  = 1U;
+      return;
+    }
   }
-  *val = link;
-  return (true);
 }
 
 
 /**
-  Write FAT entry value for given cluster
+  Remove allocated cluster from the pending discard runs.
+
+  Run containing the cluster is split, tail part is dropped when there is
+  no unused run left.
 */
-static uint32_t alloc_table_write (uint32_t clus, uint32_t val, fsFAT_Volume *vol) {
-  uint32_t sect, link, offs;
-  uint16_t temp;
+static void disc_remove (fsFAT_Volume *vol, uint32_t clus) {
+  FDISC_RUN *r;
+  uint32_t   i, n, tail;
 
-  sect = get_fat_sect (&vol->cfg, clus);
-  if (cache_fat (vol, sect) == false) {
-    return (false);
+  if (fs_fat_discard == 0U) {
+    return;
   }
 
-  link = val;
+  for (i = 0U; i < (sizeof(vol->disc.run) / sizeof(vol->disc.run[0])); i++) {
+    r = &vol->disc.run[i];
+    if ((r->Cnt != 0U) && (clus >= r->Clus) && (clus < (r->Clus + r->Cnt))) {
+      tail   = (r->Clus + r->Cnt) - (clus + 1U);
+      r->Cnt = clus - r->Clus;
 
-  switch (vol->cfg.FatType) {
-    case FS_FAT12:
-      link &= 0x0FFF;
-      offs  = ((clus * 3) / 2) & 0x1FF;
-      if (offs < 511) {
-        temp = get_u16 (&vol->fat.buf[offs]);
-        if (clus & 0x001) {
-          temp = (uint16_t)((temp & 0x000F) | (link << 4));
+      if (tail != 0U) {
+        if (r->Cnt == 0U) {
+          /* Cluster was first in the run */
+          r->Clus = clus + 1U;
+          r->Cnt  = tail;
         }
         else {
-          temp = (uint16_t)((temp & 0xF000) | link);
+          for (n = 0U; n < (sizeof(vol->disc.run) / sizeof(vol->disc.run[0])); n++) {
+            if (vol->disc.run[n].Cnt == 0U) {
+              vol->disc.run[n].Clus = clus + 1U;
+              vol->disc.run[n].Cnt  = tail;
+              break;
+            }
+          }
         }
-        set_u16 (&vol->fat.buf[offs], temp);
       }
-      else {
-        /* This cluster spans on two sectors in the FAT. */
-        if (clus & 0x001) {
-          vol->fat.buf[511] = (uint8_t)((vol->fat.buf[511] & 0x0F) | (link << 4));
-        }
-        else {
-          vol->fat.buf[511] = (uint8_t)link;
-        }
-        vol->fat.dirty = true;
-
-        if (cache_fat (vol, sect + 1) == false) {
-          return (false);
+      return;
+    }
+  }
+}
+
+
+/**
+  Discard pending runs of freed clusters.
+
+  Called when the allocation table is written and committed, clusters are
+  never discarded while the media still references them.
+*/
+static void disc_flush (fsFAT_Volume *vol) {
+  FDISC_RUN *r;
+  uint32_t   i, sect;
+
+  for (i = 0U; i < (sizeof(vol->disc.run) / sizeof(vol->disc.run[0])); i++) {
+    r = &vol->disc.run[i];
+    if (r->Cnt != 0U) {
+      /* First sector of the run in data region */
+      sect = vol->cfg.BootSector + vol->cfg.RootDirAddr + vol->cfg.RootSecCnt +
+             ((r->Clus - 2U) * vol->cfg.SecPerClus);
+
+      (void)disc_sect (vol, sect, r->Cnt * vol->cfg.SecPerClus);
+      r->Cnt = 0U;
+    }
+  }
+}
+
+
+/**
+  Flush FAT cache. Write back all modified FAT sectors and update copy of FAT.
+
+  Dirty sectors are written in ascending order. Runs of adjacent dirty sectors
+  are coalesced in data cache buffer and written with a single request.
+  Sectors written with journal are committed at the end.
+*/
+static uint32_t flush_fat (fsFAT_Volume *vol) {
+  FCACHE_ENT *ent;
+  FMIRR_RUN  *r;
+  uint32_t i, n, sect, cnt;
+
+  cnt = 0;
+  for (i = 0; i < (sizeof(vol->fat.mrun) / sizeof(vol->fat.mrun[0])); i++) {
+    cnt += vol->fat.mrun[i].cnt;
+  }
+
+  if ((vol->fat.dirty == false) && (cnt == 0)) {
+    /* Nothing to write, commit directory sectors */
+    if (jour_commit (vol) == false) {
+      return (false);
+    }
+    disc_flush (vol);
+    return (true);
+  }
+
+  if ((vol->CaSize > 1) && ((vol->fsj == NULL) || !(vol->Status & FAT_STATUS_JOURACT))) {
+    /* Data cache buffer is used for coalescing, flush it first */
+    if (write_cache (vol, 0) == false) {
+      return (false);
+    }
+    vol->ca.nrd = 0;
+  }
+
+  while (vol->fat.dirty) {
+    /* Find dirty sector with the lowest sector number */
+    ent = NULL;
+    for (i = 0; i < vol->fat.cnt; i++) {
+      if (vol->fat.ent[i].dirty) {
+        if ((ent == NULL) || (vol->fat.ent[i].sect < ent->sect)) {
+          ent = &vol->fat.ent[i];
         }
+      }
+    }
+    if (ent == NULL) {
+      /* All sectors written */
+      vol->fat.dirty = false;
+      break;
+    }
 
-        if (clus & 0x001) {
-          vol->fat.buf[0] = (uint8_t)(link >> 4);
+    if ((vol->CaSize < 2) || (vol->fsj && (vol->Status & FAT_STATUS_JOURACT))) {
+      /* Write single sector */
+      if (fat_ent_write (vol, ent, true) == false) {
+        return (false);
+      }
+      continue;
+    }
+
+    /* Collect run of adjacent dirty sectors */
+    sect = ent->sect;
+    cnt  = 0;
+    do {
+      memcpy (vol->ca.cbuf + (cnt * vol->cfg.BytesPerSec), ent->buf, vol->cfg.BytesPerSec);
+      ent->dirty = false;
+      cnt++;
+
+      ent = NULL;
+      for (n = 0; n < vol->fat.cnt; n++) {
+        if (vol->fat.ent[n].dirty && (vol->fat.ent[n].sect == (sect + cnt))) {
+          ent = &vol->fat.ent[n];
+          break;
         }
-        else {
-          vol->fat.buf[0] = (uint8_t)((vol->fat.buf[0] & 0xF0) | (link >> 8));
+      }
+    } while ((ent != NULL) && (cnt < vol->CaSize));
+
+    if (fat_sect_write (vol, sect, vol->ca.cbuf, cnt, true) == false) {
+      return (false);
+    }
+  }
+
+  /* Copy FAT sectors written on cache replacement to second FAT */
+  for (i = 0; i < (sizeof(vol->fat.mrun) / sizeof(vol->fat.mrun[0])); i++) {
+    r    = &vol->fat.mrun[i];
+    sect = r->sect;
+
+    while (r->cnt) {
+      if (vol->CaSize > 1) {
+        cnt = (r->cnt < vol->CaSize) ? (r->cnt) : (vol->CaSize);
+        if (jour_read (vol, sect, vol->ca.cbuf, cnt) == false) {
+          EvrFsFAT_SectorReadFailed (vol->DrvLet, sect, cnt);
+          return (false);
+        }
+        if (vol->Drv->WriteSect (sect + vol->cfg.FatSize, vol->ca.cbuf, cnt) == false) {
+          EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect + vol->cfg.FatSize, cnt);
+          return (false);
+        }
+      }
+      else {
+        /* Use working data buffer */
+        cnt = 1;
+        if (write_cache (vol, 0) == false) {
+          return (false);
+        }
+        vol->ca.sect = INVAL_SECT;
+        if (jour_read (vol, sect, vol->ca.buf, 1) == false) {
+          EvrFsFAT_SectorReadFailed (vol->DrvLet, sect, 1);
+          return (false);
+        }
+        if (vol->Drv->WriteSect (sect + vol->cfg.FatSize, vol->ca.buf, 1) == false) {
+          EvrFsFAT_SectorWriteFailed (vol->DrvLet, sect + vol->cfg.FatSize, 1);
+          return (false);
         }
       }
+      sect    += cnt;
+      r->sect  = sect;
+      r->cnt  -= cnt;
+    }
+  }
+  /* Commit sectors written with journal */
+  if (jour_commit (vol) == false) {
+    return (false);
+  }
+  /* Freed clusters are no longer referenced, discard them */
+  disc_flush (vol);
+  return (true);
+}
+
+
+/**
+  Invalidate FAT cache, modified sectors are discarded.
+*/
+static void inval_fat (fsFAT_Volume *vol) {
+  uint32_t i;
+
+  for (i = 0; i < vol->fat.cnt; i++) {
+    vol->fat.ent[i].sect  = INVAL_SECT;
+    vol->fat.ent[i].age   = 0;
+    vol->fat.ent[i].dirty = false;
+  }
+  vol->fat.sect  = INVAL_SECT;
+  vol->fat.buf   = vol->fat.ent[0].buf;
+  vol->fat.idx   = 0;
+  vol->fat.tick  = 0;
+  vol->fat.dirty = false;
+}
+
+
+/**
+  Mark current FAT cache sector as modified.
+*/
+static void dirty_fat (fsFAT_Volume *vol) {
+  vol->fat.ent[vol->fat.idx].dirty = true;
+  vol->fat.dirty = true;
+}
+
+
+/**
+  Handle FAT Cache. Read/write a FAT sector.
+
+  FAT sectors are cached in a set of entries with LRU replacement. Modified
+  sector is written back to the first FAT when replaced, copy of FAT and
+  remaining modified sectors are updated when cache is flushed (sect == 0).
+*/
+static uint32_t cache_fat (fsFAT_Volume *vol, uint32_t sect) {
+  FCACHE_ENT *ent;
+  uint32_t i, lru, ofs;
+
+  if (sect == 0) {
+    /* Flush cache request. */
+    return (flush_fat (vol));
+  }
+
+  if (++vol->fat.tick == 0) {
+    /* Tick counter overflow, restart aging */
+    for (i = 0; i < vol->fat.cnt; i++) {
+      vol->fat.ent[i].age = 0;
+    }
+    vol->fat.tick = 1;
+  }
+
+  if (sect == vol->fat.sect) {
+    /* Required sector already in buffer. */
+    vol->fat.ent[vol->fat.idx].age = vol->fat.tick;
+    return (true);
+  }
+
+  lru = 0;
+  for (i = 0; i < vol->fat.cnt; i++) {
+    if (vol->fat.ent[i].sect == sect) {
+      break;
+    }
+    if (vol->fat.ent[i].age < vol->fat.ent[lru].age) {
+      lru = i;
+    }
+  }
+
+  if (i == vol->fat.cnt) {
+    /* Sector not cached, replace least recently used entry */
+    i   = lru;
+    ent = &vol->fat.ent[i];
+
+    if (ent->dirty) {
+      /* Sector has been changed, write it first. */
+      if (fat_ent_write (vol, ent, false) == false) {
+        return (false);
+      }
+    }
+
+    /* Set sector offset to select FAT */
+    ofs = vol->fat.cfat * vol->cfg.FatSize;
+
+    if (jour_read (vol, sect+ofs, ent->buf, 1) == false) {
+      /* Sector read failed */
+      EvrFsFAT_SectorReadFailed (vol->DrvLet, sect+ofs, 1);
+
+      ent->sect     = INVAL_SECT;
+      ent->age      = 0;
+      vol->fat.sect = INVAL_SECT;
+      return (false);
+    }
+    ent->sect = sect;
+  }
+
+  vol->fat.ent[i].age = vol->fat.tick;
+  vol->fat.idx  = (uint8_t)i;
+  vol->fat.buf  = vol->fat.ent[i].buf;
+  vol->fat.sect = sect;
+  return (true);
+}
+
+
+/**
+  Calculate absolute FAT Sector address from cluster address.
+*/
+static uint32_t get_fat_sect (FATINFO *fvi, uint32_t clus) {
+  uint32_t fats;
+
+  switch (fvi->FatType) {
+    case FS_FAT12:
+      /* FAT Cluster width 12 bits. */
+      fats = (clus * 3) / (2U * fvi->BytesPerSec);
       break;
 
     case FS_FAT16:
-      offs  = (clus & 0xFF) << 1;
-      set_u16 (&vol->fat.buf[offs], (uint16_t)link);
+      /* FAT Cluster width 16 bits. */
+      fats = clus / (fvi->BytesPerSec / 2U);
+      break;
+
+    case FS_FAT32:
+      /* FAT Cluster width 32 bits. */
+      fats = clus / (fvi->BytesPerSec / 4U);
       break;
 
-    case FS_FAT32:
-      offs  = (clus & 0x7F) << 2;
-      set_u32 (&vol->fat.buf[offs], link);
-      break;
+    default:
+      /* Not supported. */
+      return (0);
+  }
+  if (fats >= fvi->FatSize) {
+    return (0);
+  }
+  fats += (fvi->BootSector + fvi->RsvdSecCnt);
+  return (fats);
+}
+
+
+/**
+  Retrieve root cluster number
+
+  \param[in]  vol                       volume description structure
+*/
+static uint32_t get_root_clus (fsFAT_Volume *vol) {
+  if (vol->cfg.FatType == FS_FAT32) {
+    /* Root directory cluster on FAT32 */
+    return (vol->cfg.FAT32_RootClus);
+  }
+  else {
+    /* Root directory cluster on FAT12 or FAT16 */
+    return (0);
+  }
+}
+
+
+/**
+  Calculate absolute sector address from the cluster number
+*/
+static uint32_t clus_to_sect (FATINFO *fvi, uint32_t clus) {
+  uint32_t sect;
+
+  /* Root directory first sector for FAT12 or FAT16 */
+  sect = fvi->BootSector + fvi->RootDirAddr;
+  if (clus == 0) {
+    if (fvi->FatType != FS_FAT32) {
+      /* Root cluster for FAT12 or FAT16 */
+      return sect;
+    }
+  }
+
+  if (fvi->FatType != FS_FAT32) {
+    /* First sector of data region for FAT12 or FAT16 */
+    sect += fvi->RootSecCnt;
+  }
+  /* First sector of given cluster in data region */
+  sect += (clus - 2) * fvi->SecPerClus;
+  return (sect);
+}
+
+
+/**
+  Return an End Of Chain Marker.
+*/
+static uint32_t get_EOC (uint32_t fat_type) {
+  switch (fat_type) {
+    case FS_FAT12: return (0x00000FFF);
+    case FS_FAT16: return (0x0000FFFF);
+    case FS_FAT32: return (0x0FFFFFFF);
+
+    default: return (0);
+  }
+}
+
+
+/**
+  Return "Cluster Reserved" Marker.
+*/
+static uint32_t get_RSVD (uint32_t fat_type) {
+  switch (fat_type) {
+    case FS_FAT12: return (0x00000FF7);
+    case FS_FAT16: return (0x0000FFF7);
+    case FS_FAT32: return (0x0FFFFFF7);
+
+    default: return (0);
+  }
+}
+
+
+/**
+  Read FAT entry value for given cluster
+
+  \param[in]  clus                      cluster number
+  \param[out] val                       FAT entry value
+  \param[in]  vol                       volume description structure
+*/
+static uint32_t alloc_table_read (uint32_t clus, uint32_t *val, fsFAT_Volume *vol) {
+  uint32_t sect, offs, link;
+
+  /* Read a part of FAT table to buffer. */
+  sect = get_fat_sect (&vol->cfg, clus);
+  if (cache_fat (vol, sect) == false) {
+    return (false);
+  }
+
+  switch (vol->cfg.FatType) {
+    case FS_FAT12:
+      offs  = ((clus * 3) / 2) & (vol->cfg.BytesPerSec - 1U);
+      if (offs < (vol->cfg.BytesPerSec - 1U)) {
+        link = get_u16 (&vol->fat.buf[offs]);
+      }
+      else {
+        /* This cluster spans on two sectors in the FAT. */
+        link = vol->fat.buf[offs];
+        if (cache_fat (vol, sect+1) == false) {
+          return (false);
+        }
+        link |= (uint32_t)(vol->fat.buf[0] << 8);
+      }
+      if (clus & 0x001) {
+        link >>= 4;
+      }
+      else {
+        link &= 0xFFF;
+      }
+      break;
+
+    case FS_FAT16:
+      offs  = (clus << 1) & (vol->cfg.BytesPerSec - 1U);
+      link = get_u16 (&vol->fat.buf[offs]);
+      break;
+
+    case FS_FAT32:
+      offs  = (clus << 2) & (vol->cfg.BytesPerSec - 1U);
+      link = get_u32 (&vol->fat.buf[offs]);
+      break;
+
+    default:
+      return (false);
+  }
+  *val = link;
+  return (true);
+}
+
+
+/**
+  Write FAT entry value for given cluster
+*/
+static uint32_t alloc_table_write (uint32_t clus, uint32_t val, fsFAT_Volume *vol) {
+  uint32_t sect, link, offs;
+  uint16_t temp;
+
+  if (val != 0U) {
+    /* Cluster is in use, it must not be discarded */
+    disc_remove (vol, clus);
+  }
+
+  sect = get_fat_sect (&vol->cfg, clus);
+  if (cache_fat (vol, sect) == false) {
+    return (false);
+  }
+
+  link = val;
+
+  switch (vol->cfg.FatType) {
+    case FS_FAT12:
+      link &= 0x0FFF;
+      offs  = ((clus * 3) / 2) & (vol->cfg.BytesPerSec - 1U);
+      if (offs < (vol->cfg.BytesPerSec - 1U)) {
+        temp = get_u16 (&vol->fat.buf[offs]);
+        if (clus & 0x001) {
+          temp = (uint16_t)((temp & 0x000F) | (link << 4));
+        }
+        else {
+          temp = (uint16_t)((temp & 0xF000) | link);
+        }
+        set_u16 (&vol->fat.buf[offs], temp);
+      }
+      else {
+        /* This cluster spans on two sectors in the FAT. */
+        if (clus & 0x001) {
+          vol->fat.buf[offs] = (uint8_t)((vol->fat.buf[offs] & 0x0F) | (link << 4));
+        }
+        else {
+          vol->fat.buf[offs] = (uint8_t)link;
+        }
+        dirty_fat (vol);
+
+        if (cache_fat (vol, sect + 1) == false) {
+          return (false);
+        }
+
+        if (clus & 0x001) {
+          vol->fat.buf[0] = (uint8_t)(link >> 4);
+        }
+        else {
+          vol->fat.buf[0] = (uint8_t)((vol->fat.buf[0] & 0xF0) | (link >> 8));
+        }
+      }
+      break;
+
+    case FS_FAT16:
+      offs  = (clus << 1) & (vol->cfg.BytesPerSec - 1U);
+      set_u16 (&vol->fat.buf[offs], (uint16_t)link);
+      break;
+
+    case FS_FAT32:
+      offs  = (clus << 2) & (vol->cfg.BytesPerSec - 1U);
+      set_u32 (&vol->fat.buf[offs], link);
+      break;
+
+    default:
+      return (false);
+  }
+  dirty_fat (vol);
+  return (true);
+}
+
+
+/**
+  Initialize free cluster map. Map size determines the cluster group size.
+*/
+static void fmap_init (fsFAT_Volume *vol) {
+  uint32_t n;
+
+  if (vol->fmap.map != NULL) {
+    n = vol->cfg.DataClusCnt + 1;
+    vol->fmap.shift = 0;
+    while ((n >> vol->fmap.shift) >= (vol->fmap.size * 32)) {
+      vol->fmap.shift++;
+    }
+    /* All groups may contain free clusters */
+    memset (vol->fmap.map, 0, vol->fmap.size * 4);
+  }
+}
+
+
+/**
+  Check if cluster belongs to a group with all clusters allocated.
+*/
+static uint32_t fmap_full (fsFAT_Volume *vol, uint32_t clus) {
+  uint32_t n;
+
+  if (vol->fmap.map == NULL) {
+    return (false);
+  }
+  n = clus >> vol->fmap.shift;
+  return ((vol->fmap.map[n >> 5] & (1U << (n & 0x1F))) != 0U);
+}
+
+
+/**
+  Mark cluster group as fully allocated or as possibly containing free clusters.
+*/
+static void fmap_set (fsFAT_Volume *vol, uint32_t clus, uint32_t full) {
+  uint32_t n;
+
+  if (vol->fmap.map != NULL) {
+    n = clus >> vol->fmap.shift;
+    if (full) {
+      vol->fmap.map[n >> 5] |=  (1U << (n & 0x1F));
+    } else {
+      vol->fmap.map[n >> 5] &= ~(1U << (n & 0x1F));
+    }
+  }
+}
+
+
+/**
+  Update free cluster map while scanning allocation table in ascending order.
+*/
+static void fmap_scan (fsFAT_Volume *vol, uint32_t clus, uint32_t link, uint32_t *gfree) {
+
+  if (vol->fmap.map != NULL) {
+    if (link == 0) {
+      (*gfree)++;
+    }
+    if ((((clus + 1) >> vol->fmap.shift) != (clus >> vol->fmap.shift)) ||
+         ((clus + 1) == (vol->cfg.DataClusCnt + 2))) {
+      /* Last cluster of the group */
+      fmap_set (vol, clus, (*gfree == 0));
+      *gfree = 0;
+    }
+  }
+}
+
+
+/**
+  Scan FAT and count number of free clusters.
+
+  \param[out] count                     number of free clusters
+  \param[in]  vol                       volume description structure
+*/
+static uint32_t count_free_clus (uint32_t *count, fsFAT_Volume *vol) {
+  uint32_t clus, link, cnt, gfree;
+
+  EvrFsFAT_CountFreeClus(vol->DrvLet);
+
+  cnt   = 0;
+  gfree = 0;
+  for (clus = 2; clus < (vol->cfg.DataClusCnt + 2); clus++) {
+    if (alloc_table_read (clus, &link, vol) == false) {
+      /* Read sector issue */
+      return (false);
+    }
+    if (link == 0) {
+      cnt++;
+    }
+    fmap_scan (vol, clus, link, &gfree);
+  }
+  *count = cnt;
+  return (true);
+}
+
+
+/**
+  Scan FAT-32 allocation table and count number of free clusters.
+
+  This routine is meant to be used only during mount to quickly
+  determine number of free clusters required by FS Info structure.
+
+  \param[out] count                     number of free clusters
+  \param[in]  vol                       volume description structure
+*/
+static uint32_t count_free_clus32 (uint32_t *count, fsFAT_Volume *vol) {
+  uint32_t sect, csect;
+  uint32_t offs, clus, link, cnt, gfree;
+
+  EvrFsFAT_CountFreeClus(vol->DrvLet);
+
+  cnt   = 0;
+  gfree = 0;
+  csect = 0;
+  clus  = 2;
+  offs  = vol->cfg.BootSector + vol->cfg.RsvdSecCnt;
+
+  do {
+    /* Determine table sector */
+    sect = clus / (vol->cfg.BytesPerSec / 4U);
+    
+    if ((offs + sect) > csect) {
+      /* Block read requests till we cross sector border */
+      csect = offs + sect;
+
+      if (read_cache (vol, csect, vol->cfg.FatSize - sect) == false) {
+        return (false);
+      }
+    }
+
+    /* Get linked cluster number */
+    link = get_u32(&vol->ca.buf[(clus << 2) & (vol->cfg.BytesPerSec - 1U)]);
+
+    if (link == 0) {
+      cnt++;
+    }
+    fmap_scan (vol, clus, link, &gfree);
+    clus++;
+  }
+  while (clus < (vol->cfg.DataClusCnt + 2));
+
+  *count = cnt;
+  return (true);
+}
+
+
+/**
+  Allocate cluster
+*/
+static uint32_t alloc_clus (uint32_t *clus, fsFAT_Volume *vol) {
+  uint32_t n, link, gmask;
+
+  link  = 0xFFFFFFFF;
+  gmask = (1U << vol->fmap.shift) - 1U;
+
+  /* Find free cluster */
+  for (n = vol->free_clus; n < (vol->cfg.DataClusCnt + 2); n++) {
+    if (fmap_full (vol, n)) {
+      /* Skip group without free clusters */
+      n |= gmask;
+      continue;
+    }
+    if (alloc_table_read (n, &link, vol) == false) {
+      /* Read sector issue */
+      return (false);
+    }
+    if (link == 0) {
+      break;
+    }
+    if ((vol->fmap.map != NULL) && ((n & gmask) == gmask)) {
+      /* Last cluster of the group checked */
+      if (((n & ~gmask) >= vol->free_clus) || (vol->free_clus <= 2)) {
+        /* Whole group was checked, all clusters are allocated */
+        fmap_set (vol, n, true);
+      }
+    }
+  }
+
+  if (link != 0) {
+    /* No free clusters - disk full */
+    EvrFsFAT_DiskFull(vol->DrvLet);
+    return (false);
+  }
+  if (alloc_table_write (n, get_EOC(vol->cfg.FatType), vol) == false) {
+    return (false);
+  }
+  vol->free_clus = n + 1;
+
+  /* Cluster allocated */
+  if (vol->Status & FAT_STATUS_FREECNT) {
+    vol->free_clus_cnt--;
+  }
+  if (vol->cfg.FatType == FS_FAT32) {
+    vol->Status |= FAT_STATUS_FSINFO;
+  }
+  *clus = n;
+  return (true);
+}
+
+
+/**
+  Allocate cluster that directly follows the last cluster of a chain.
+
+  \param[in]  clus                      last cluster of the chain
+  \param[out] next                      allocated cluster or 0 when following cluster is not free
+  \param[in]  vol                       volume description structure
+
+  \return     - true: Ok
+              - false: FAT sector read/write failed
+*/
+static uint32_t alloc_clus_next (uint32_t clus, uint32_t *next, fsFAT_Volume *vol) {
+  uint32_t n, link;
+
+  *next = 0;
+  n     = clus + 1;
+
+  if (n >= (vol->cfg.DataClusCnt + 2)) {
+    /* End of the data area */
+    return (true);
+  }
+  if (alloc_table_read (n, &link, vol) == false) {
+    return (false);
+  }
+  if (link != 0) {
+    /* Following cluster is in use */
+    return (true);
+  }
+  if (alloc_table_write (n, get_EOC(vol->cfg.FatType), vol) == false) {
+    return (false);
+  }
+  if (alloc_table_write (clus, n, vol) == false) {
+    return (false);
+  }
+  if (vol->free_clus == n) {
+    vol->free_clus = n + 1;
+  }
+
+  /* Cluster allocated */
+  if (vol->Status & FAT_STATUS_FREECNT) {
+    vol->free_clus_cnt--;
+  }
+  if (vol->cfg.FatType == FS_FAT32) {
+    vol->Status |= FAT_STATUS_FSINFO;
+  }
+  *next = n;
+  return (true);
+}
+
+
+/**
+  Find a contiguous run of free clusters.
+
+  Allocation table is scanned once, starting at given cluster and wrapping
+  around at the end of the data area.
+
+  \param[in]  start                     cluster where the search starts
+  \param[in]  cnt                       number of clusters in the run
+  \param[out] clus                      first cluster of the run or 0 when not found
+  \param[in]  vol                       volume description structure
+
+  \return     - true: Ok
+              - false: FAT sector read failed
+*/
+static uint32_t find_free_run (uint32_t start, uint32_t cnt, uint32_t *clus, fsFAT_Volume *vol) {
+  uint32_t i, k, n, end, len, link, gmask;
+
+  *clus = 0;
+  gmask = (1U << vol->fmap.shift) - 1U;
+  end   = vol->cfg.DataClusCnt + 2;
+
+  if ((start < 2) || (start >= end)) {
+    start = 2;
+  }
+  n   = start;
+  len = 0;
+
+  for (i = 0; i < vol->cfg.DataClusCnt; i += k) {
+    k = 1;
+    if (fmap_full (vol, n)) {
+      /* Group without free clusters breaks the run */
+      k   = (n | gmask) - n + 1;
+      len = 0;
+    }
+    else {
+      if (alloc_table_read (n, &link, vol) == false) {
+        return (false);
+      }
+      if (link != 0) {
+        len = 0;
+      }
+      else {
+        len++;
+        if (len == cnt) {
+          *clus = n + 1 - cnt;
+          break;
+        }
+      }
+    }
+    n += k;
+    if (n >= end) {
+      /* Wrap around, run can not continue */
+      n   = 2;
+      len = 0;
+    }
+  }
+  return (true);
+}
+
+
+/**
+  Link two clusters together
+*/
+static uint32_t link_clus (uint32_t clus, uint32_t next_clus, fsFAT_Volume *vol) {
+  return alloc_table_write (clus, next_clus, vol);
+}
+
+/**
+  Unlink cluster chain.
+*/
+static uint32_t unlink_clus (uint32_t clus, fsFAT_Volume *vol) {
+  uint32_t n, link, eoc;
+
+  if (clus < 2) {
+    /* Empty file */
+    return (true);
+  }
+  eoc = get_EOC (vol->cfg.FatType);
+
+  n = clus;
+  while (n < (vol->cfg.DataClusCnt + 2)) {
+    if (alloc_table_read (n, &link, vol) == false) {
+      return (false);
+    }
+    if (alloc_table_write (n, 0, vol) == false) {
+      return (false);
+    }
+    /* Group contains free cluster */
+    fmap_set (vol, n, false);
+
+    /* Discard cluster when FAT is written */
+    disc_add (vol, n);
+
+    if (vol->Status & FAT_STATUS_FREECNT) {
+      /* Update free cluster count */
+      vol->free_clus_cnt++;
+    }
+    if (vol->cfg.FatType == FS_FAT32) {
+      vol->Status |= FAT_STATUS_FSINFO;
+    }
+    if (link == eoc) {
+      break;
+    } else {
+      /* Check if link corrupted */
+      if (link < 2) {
+        return (false);
+      }
+    }
+    n = link;
+
+    if (n < clus) {
+      /* Keep track of the lowest free cluster */
+      clus = n;
+    }
+  }
+  if (clus < vol->free_clus) {
+    vol->free_clus = clus;
+  }
+  /* Cluster chain unlinked */
+  return (true);
+}
+
+
+/**
+  Reset file cluster extent map, map starts with the first data cluster.
+*/
+static void ext_reset (fsFAT_Handle *fh) {
+
+  fh->ext_cnt = 0;
+
+  if (fh->first_clus >= 2) {
+    fh->ext[0].fclus = 0;
+    fh->ext[0].clus  = fh->first_clus;
+    fh->ext[0].cnt   = 1;
+    fh->ext_cnt      = 1;
+  }
+}
+
+
+/**
+  Add cluster to the file cluster extent map.
+
+  Map covers the beginning of the cluster chain, cluster is added only
+  when it directly follows the last mapped cluster.
+
+  \param[in]  fh                        file handle
+  \param[in]  fidx                      file cluster index
+  \param[in]  clus                      data cluster number
+*/
+static void ext_add (fsFAT_Handle *fh, uint32_t fidx, uint32_t clus) {
+  FAT_EXT *ext;
+
+  if (fh->ext_cnt == 0) {
+    return;
+  }
+  ext = &fh->ext[fh->ext_cnt - 1];
+
+  if (fidx != (ext->fclus + ext->cnt)) {
+    /* Cluster not adjacent to mapped part of the chain */
+    return;
+  }
+  if (clus == (ext->clus + ext->cnt)) {
+    /* Extend last extent */
+    ext->cnt++;
+  }
+  else if (fh->ext_cnt < FAT_EXT_CNT) {
+    /* Start new extent */
+    ext++;
+    ext->fclus = fidx;
+    ext->clus  = clus;
+    ext->cnt   = 1;
+    fh->ext_cnt++;
+  }
+}
+
+
+/**
+  Find the closest mapped cluster at or before given file cluster index.
+
+  \param[in]  fh                        file handle
+  \param[in]  fidx                      file cluster index
+  \param[out] clus                      data cluster number
+  \return     file cluster index of the returned cluster
+*/
+static uint32_t ext_find (fsFAT_Handle *fh, uint32_t fidx, uint32_t *clus) {
+  FAT_EXT *ext;
+  uint32_t lo, hi, mid;
+
+  if (fh->ext_cnt == 0) {
+    *clus = fh->first_clus;
+    return (0);
+  }
+
+  /* Binary search for the last extent starting at or before fidx */
+  lo = 0;
+  hi = fh->ext_cnt - 1U;
+  while (lo < hi) {
+    mid = (lo + hi + 1) / 2;
+    if (fh->ext[mid].fclus <= fidx) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  ext = &fh->ext[lo];
+
+  if (fidx < (ext->fclus + ext->cnt)) {
+    *clus = ext->clus + (fidx - ext->fclus);
+    return (fidx);
+  }
+  *clus = ext->clus + ext->cnt - 1;
+  return (ext->fclus + ext->cnt - 1);
+}
+
+
+/**
+  Get the next cluster of a file, use extent map when cluster is mapped.
+
+  \param[in]     fh                     file handle
+  \param[in]     fidx                   file cluster index of the next cluster
+  \param[in,out] clus                   current cluster / next cluster
+  \return        - true: Ok
+                 - false: FAT sector read failed
+*/
+static uint32_t ext_next (fsFAT_Handle *fh, uint32_t fidx, uint32_t *clus) {
+  uint32_t n;
+
+  if (ext_find (fh, fidx, &n) == fidx) {
+    /* Cluster is mapped */
+    *clus = n;
+    return (true);
+  }
+  if (alloc_table_read (*clus, clus, fh->vol) == false) {
+    return (false);
+  }
+  if ((*clus >= 2) && (*clus < (fh->vol->cfg.DataClusCnt + 2))) {
+    ext_add (fh, fidx, *clus);
+  }
+  return (true);
+}
+
+
+/**
+  Get the next cluster of a file, allocate and link a free cluster when
+  the cluster chain ends. Clusters preallocated past the end of file are used
+  before any new cluster is allocated.
+
+  \param[in]     fh                     file handle
+  \param[in]     fidx                   file cluster index of the next cluster
+  \param[in,out] clus                   current cluster / next cluster
+  \return        execution status \ref fsStatus
+*/
+static fsStatus ext_next_alloc (fsFAT_Handle *fh, uint32_t fidx, uint32_t *clus) {
+  uint32_t n;
+
+  n = *clus;
+  if (ext_next (fh, fidx, &n) == false) {
+    return (fsDriverError);
+  }
+  if ((n < 2) || (n >= (fh->vol->cfg.DataClusCnt + 2))) {
+    /* End of chain, allocate a free cluster and link it to chain */
+    if (alloc_clus (&n, fh->vol) == false) {
+      return (fsNoFreeSpace);
+    }
+    if (link_clus (*clus, n, fh->vol) == false) {
+      return (fsDriverError);
+    }
+    ext_add (fh, fidx, n);
+  }
+  *clus = n;
+  return (fsOK);
+}
+
+
+/**
+  Get the data cluster at given file cluster index.
+
+  \param[in]  fh                        file handle
+  \param[in]  fidx                      file cluster index
+  \param[out] clus                      data cluster number
+  \return     - true: Ok
+              - false: FAT sector read failed or cluster chain too short
+*/
+static uint32_t ext_get (fsFAT_Handle *fh, uint32_t fidx, uint32_t *clus) {
+  uint32_t i, n;
+
+  i = ext_find (fh, fidx, &n);
+
+  while (i < fidx) {
+    i++;
+    if (ext_next (fh, i, &n) == false) {
+      return (false);
+    }
+    if ((n < 2) || (n >= (fh->vol->cfg.DataClusCnt + 2))) {
+      /* End of chain */
+      return (false);
+    }
+  }
+  *clus = n;
+  return (true);
+}
+
+
+/**
+  Release clusters linked past the end of file.
+
+  \param[in]  fh                        file handle
+  \param[out] clus                      first released cluster or 0 when none
+  \return     - true: Ok
+              - false: FAT sector read/write failed
+*/
+static uint32_t release_clus (fsFAT_Handle *fh, uint32_t *clus) {
+  fsFAT_Volume *vol = fh->vol;
+  uint32_t last, link;
+
+  *clus = 0;
+
+  if (fh->first_clus == 0) {
+    /* Empty file */
+    return (true);
+  }
+
+  if (fh->fcsz == 0) {
+    /* No data, release the whole chain */
+    link = fh->first_clus;
+
+    fh->first_clus   = 0;
+    fh->current_clus = 0;
+    ext_reset (fh);
+  }
+  else {
+    /* Get the last cluster holding data */
+    if (ext_get (fh, (fh->fcsz - 1) / vol->cfg.ClusSize, &last) == false) {
+      return (false);
+    }
+    if (alloc_table_read (last, &link, vol) == false) {
+      return (false);
+    }
+    if ((link < 2) || (link >= (vol->cfg.DataClusCnt + 2))) {
+      /* Nothing linked past the end of file */
+      return (true);
+    }
+    if (alloc_table_write (last, get_EOC(vol->cfg.FatType), vol) == false) {
+      return (false);
+    }
+  }
+  if (unlink_clus (link, vol) == false) {
+    return (false);
+  }
+  *clus = link;
+  return (true);
+}
+
+
+/**
+  Determine number of sectors in a contiguous run starting at current file position.
+
+  Run starts at current sector and extends over following clusters as long as
+  the cluster chain is contiguous. When writing past the end of the cluster
+  chain, the run is extended by allocating the physically following free clusters.
+
+  \param[in]  fh                        file handle
+  \param[in]  fidx                      file cluster index of the current cluster
+  \param[in]  cnt                       maximum number of sectors in the run
+  \param[in]  alloc                     allocate clusters past the end of chain (true/false)
+  \param[out] last                      last cluster of the run
+  \param[out] num                       number of sectors in the run
+
+  \return     - true: Ok
+              - false: FAT sector read/write failed
+*/
+static uint32_t clus_run (fsFAT_Handle *fh, uint32_t fidx, uint32_t cnt, uint32_t alloc, uint32_t *last, uint32_t *num) {
+  fsFAT_Volume *vol = fh->vol;
+  uint32_t n, clus, next;
+
+  n    = vol->cfg.SecPerClus - fh->current_sect;
+  clus = fh->current_clus;
+
+  while (n < cnt) {
+    fidx++;
+    next = clus;
+    if (ext_next (fh, fidx, &next) == false) {
+      return (false);
+    }
+    if ((alloc != false) && (next >= (vol->cfg.DataClusCnt + 2))) {
+      /* End of chain, allocate the following cluster */
+      if (alloc_clus_next (clus, &next, vol) == false) {
+        return (false);
+      }
+      if (next == 0) {
+        break;
+      }
+      ext_add (fh, fidx, next);
+    }
+    if (next != (clus + 1)) {
+      break;
+    }
+    clus = next;
+    n   += vol->cfg.SecPerClus;
+  }
+  if (n > cnt) {
+    n = cnt;
+  }
+  *last = clus;
+  *num  = n;
+  return (true);
+}
+
+
+/**
+  Request background read-ahead of sectors following the current file position.
+
+  Request is posted only when the next sector is not in the data cache,
+  read-ahead covers the rest of the cluster that holds the next sector.
+
+  \param[in]  fh                        file handle
+*/
+static void io_read_ahead (fsFAT_Handle *fh) {
+  fsFAT_Volume *vol = fh->vol;
+  uint32_t n, sect, spos, clus, cnt;
+
+  if ((vol->ca.wmark == 0U) || (vol->ca.nwr > 0U)) {
+    /* Background I/O disabled or write caching active */
+    return;
+  }
+
+  /* File position of the next sector */
+  n    = fh->current_sect;
+  spos = fh->fpos & ~(vol->cfg.BytesPerSec - 1U);
+  if ((fh->fpos & (vol->cfg.BytesPerSec - 1U)) != 0U) {
+    /* Current sector is in working buffer, start with the following one */
+    n++;
+    spos += vol->cfg.BytesPerSec;
+  }
+  if (spos >= fh->fcsz) {
+    /* End of file */
+    return;
+  }
+
+  clus = fh->current_clus;
+  if (n >= vol->cfg.SecPerClus) {
+    /* Next sector is in the following cluster */
+    if (ext_next (fh, spos / vol->cfg.ClusSize, &clus) == false) {
+      return;
+    }
+    if ((clus < 2) || (clus >= (vol->cfg.DataClusCnt + 2))) {
+      return;
+    }
+    n = 0;
+  }
+  sect = clus_to_sect (&vol->cfg, clus) + n;
+
+  if ((vol->ca.nrd > 0U) && (vol->ca.csect <= sect) && (sect < (vol->ca.csect + vol->ca.nrd))) {
+    /* Next sector already cached */
+    return;
+  }
+
+  cnt = vol->cfg.SecPerClus - n;
+  if (cnt > ((fh->fcsz - spos + vol->cfg.BytesPerSec - 1U) / vol->cfg.BytesPerSec)) {
+    cnt = (fh->fcsz - spos + vol->cfg.BytesPerSec - 1U) / vol->cfg.BytesPerSec;
+  }
+  if (cnt > vol->CaSize) {
+    cnt = vol->CaSize;
+  }
+
+  vol->ca.rasect = sect;
+  vol->ca.nra    = (uint8_t)cnt;
+
+  fs_io_thread_signal ();
+}
+
+
+/**
+  Clear current cluster.
+
+  \param[in]  clus                      cluster number
+  \param[in]  vol                       volume description structure
+
+  \return     - true: Ok
+              - false: sector write failed
+*/
+static uint32_t clear_clus (uint32_t clus, fsFAT_Volume *vol) {
+  uint32_t i;
+  uint32_t sect = clus_to_sect(&vol->cfg, clus);
+
+  /* Use cache for faster write. */
+  memset(vol->ca.buf, 0, vol->cfg.BytesPerSec);
+  for (i = 0; i < vol->cfg.SecPerClus; i++) {
+    if (write_cache(vol, sect + i) == false) {
+      return (false);
+    }
+  }
+  /* Flush cache buffer */
+  if (write_cache (vol, 0) == false) {
+    return (false);
+  }
+  return (true);
+}
+
+
+/**
+  Compare current directory entry position with elink entry and determine how
+  many entries we can skip (since they are cached).
+
+  \param[in]  pos                       entry position structure pointer
+  \param[in]  el                        entry link structure pointer
+
+  \return     -  0: entry position and entry link do not match
+              - >0: number of directory entries covered by name cache
+*/
+static uint8_t entry_pos_comp (ENTRY_POS *pos, ELINK *el) {
+  if (el) {
+    if (pos->Clus == el->Info.EntryClus) {
+      if (pos->Offs == el->Info.EntryOffs) {
+        /* Entry position match */
+        return ((uint8_t)el->Info.EntryCount);
+      }
+    }
+  }
+  return (0);
+}
+
+
+/**
+  Increment directory entry position
+
+  \param[in]  pos                       initial entry position
+  \param[in]  cnt                       increment count
+  \param[in]  vol                       volume description structure
+
+  \return     - 0: Ok
+              - 1: Failed, no more entries, end of current directory
+              - 2: Failed, no more entries
+*/
+static uint32_t entry_pos_inc (ENTRY_POS *pos, uint32_t cnt, fsFAT_Volume *vol) {
+  uint32_t clus, eoc, offs;
+  
+  /* Advance offset within cluster */
+  offs  = pos->Offs & (vol->cfg.EntsPerClus - 1);
+  offs += cnt;
+
+  pos->Offs += cnt;
+
+  if (vol->cfg.FatType != FS_FAT32) {
+    /* Check for root entry limit on FAT12/FAT16 */
+    if (pos->Clus == 0) {
+      if (pos->Offs >= vol->cfg.RootEntCnt) {
+        /* No more entries */
+        return (2);
+      }
+      return (0);
+    }
+  }
+
+  eoc = get_EOC (vol->cfg.FatType);
+
+  /* Check if step to next cluster is needed. */
+  while (offs >= vol->cfg.EntsPerClus) {
+    offs -= vol->cfg.EntsPerClus;
+
+    /* Preserve last used cluster */
+    clus = pos->Clus;
+
+    if (alloc_table_read (clus, &clus, vol) == false) {
+      /* Sector (FAT) read error */
+      return (2);
+    }
+
+    if (clus == eoc) {
+      /* No more entries, end of current directory. */
+      return (1);
+    }
+    /* Set next cluster */
+    pos->Clus = clus;
+  }
+  return (0);
+}
+
+
+/**
+  Read directory entry at given position and return it's pointer
+
+  \param[in]  pos                       directory entry position
+  \param[out] frec                      file record structure pointer
+  \param[in]  vol                       volume description structure
+
+  \return     - 0: Directory entry read and pointer to it is set
+              - 1: Sector read error
+*/
+static uint32_t entry_read (ENTRY_POS *pos, FILEREC **frec, fsFAT_Volume *vol) {
+  uint32_t sect, offs;
+
+  if ((pos->Clus == 0) && (vol->cfg.FatType != FS_FAT32)) {
+    offs = pos->Offs;
+  }
+  else {
+    offs = pos->Offs & (vol->cfg.EntsPerClus - 1);
+  }
+
+  sect = clus_to_sect (&vol->cfg, pos->Clus);
 
-    default:
-      return (false);
+  if (read_sector (vol, sect + (offs / (vol->cfg.BytesPerSec >> 5))) == false) {
+    /* Sector (directory entries) read error */
+    return (1);
   }
-  vol->fat.dirty = true;
-  return (true);
+  *frec = (FILEREC *)(uint32_t)vol->ca.buf + (offs & ((vol->cfg.BytesPerSec >> 5) - 1U));
+  return (0);
 }
 
 
 /**
-  Scan FAT and count number of free clusters.
+  Return directory entry type
 
-  \param[out] count                     number of free clusters
+  This function will check the filename and attributes field in order to
+  determine directory entry type.
+
+  \param[in]  de                        directory entry
+
+  \return     Directory entry type \ref ENTRY_TYPE
+*/
+static uint32_t entry_type (FILEREC *de) {
+  if (de->FileName[0] == 0x00) {
+    /* Free entry, last one in the directory */
+    return (ENTRY_TYPE_LAST_IN_DIR);
+  }
+  else if (de->FileName[0] == 0xE5) {
+    /* Free directory entry (erased) */
+    return (ENTRY_TYPE_FREE);
+  }
+  else if ((de->Attr & ATTR_LONG_NAME_MASK) == ATTR_LONG_NAME) {
+    /* Long file name entry */
+    return (ENTRY_TYPE_LFN);
+  }
+  else {
+    if ((de->Attr & (FS_FAT_ATTR_DIRECTORY | FS_FAT_ATTR_VOLUME_ID)) == FS_FAT_ATTR_VOLUME_ID) {
+    /* Volume label */
+    return (ENTRY_TYPE_LABEL);
+    }
+    /* Short file name entry (may be file or directory */
+    return (ENTRY_TYPE_SFN);
+  }
+}
+
+/**
+  Flush entry that was previously read with entry_read to the media
+
+  \param[in]  pos                       directory entry position
   \param[in]  vol                       volume description structure
+
+  \return \ref fsStatus
 */
-static uint32_t count_free_clus (uint32_t *count, fsFAT_Volume *vol) {
-  uint32_t clus, link, cnt;
+static fsStatus entry_flush (ENTRY_POS *pos, fsFAT_Volume *vol) {
+  uint32_t sect, offs;
 
-  EvrFsFAT_CountFreeClus(vol->DrvLet);
+  if ((pos->Clus == 0) && (vol->cfg.FatType != FS_FAT32)) {
+    offs = pos->Offs;
+  }
+  else {
+    offs = pos->Offs & (vol->cfg.EntsPerClus - 1);
+  }
 
-  cnt = 0;
-  for (clus = 2; clus < (vol->cfg.DataClusCnt + 2); clus++) {
-    if (alloc_table_read (clus, &link, vol) == false) {
-      /* Read sector issue */
-      return (false);
-    }
-    if (link == 0) {
-      cnt++;
-    }
+  sect = clus_to_sect (&vol->cfg, pos->Clus);
+
+  if (write_sector (vol, sect + (offs / (vol->cfg.BytesPerSec >> 5)), ACT_USEJOUR) == false) {
+    /* Sector write error */
+    return (fsDriverError);
   }
-  *count = cnt;
-  return (true);
+  /* Entry flushed to media */
+  return (fsOK);
 }
 
 
 /**
-  Scan FAT-32 allocation table and count number of free clusters.
+  Clear directory index and assign it to the given directory
 
-  This routine is meant to be used only during mount to quickly
-  determine number of free clusters required by FS Info structure.
+  \param[in]  dir_clus                  first cluster of the directory
+  \param[in]  dx                        directory index
+*/
+static void didx_clear (uint32_t dir_clus, DINDEX *dx) {
+
+  /* Empty name and short name hash chains */
+  memset (dx->bkt, 0xFF, (uint32_t)dx->nbkt * 4U);
+
+  dx->dir   = dir_clus;
+  dx->top   = 0U;
+  dx->free  = DIDX_NIL;
+  dx->tClus = dir_clus;
+  dx->tOffs = 0U;
+  dx->state = DIDX_STATE_NONE;
+  dx->lost  = 0U;
+
+  memset (dx->run, 0, sizeof(dx->run));
+}
+
+
+/**
+  Initialize directory index. Index memory pool is split into hash buckets
+  and index entries, one name and one short name bucket per entry.
 
-  \param[out] count                     number of free clusters
   \param[in]  vol                       volume description structure
 */
-static uint32_t count_free_clus32 (uint32_t *count, fsFAT_Volume *vol) {
-  uint32_t sect, csect;
-  uint32_t offs, clus, link, cnt;
+static void didx_init (fsFAT_Volume *vol) {
+  DINDEX  *dx = &vol->didx;
+  uint32_t n;
 
-  EvrFsFAT_CountFreeClus(vol->DrvLet);
+  dx->state = DIDX_STATE_NONE;
+  dx->max   = 0U;
 
-  cnt   = 0;
-  csect = 0;
-  clus  = 2;
-  offs  = vol->cfg.BootSector + vol->cfg.RsvdSecCnt;
+  if (dx->buf != NULL) {
+    n = (dx->size * 4U) / (sizeof(DINDEX_ENT) + 4U);
 
-  do {
-    /* Determine table sector */
-    sect = clus / 128;
-    
-    if ((offs + sect) > csect) {
-      /* Block read requests till we cross sector border */
-      csect = offs + sect;
+    dx->nbkt = 1U;
+    while ((dx->nbkt * 2U) <= n) {
+      dx->nbkt <<= 1;
+    }
+    dx->bkt = (uint16_t *)dx->buf;
+    dx->ent = (DINDEX_ENT *)&dx->buf[dx->nbkt];
 
-      if (read_cache (vol, csect, vol->cfg.FatSize - sect) == false) {
-        return (false);
-      }
+    n = ((dx->size - dx->nbkt) * 4U) / sizeof(DINDEX_ENT);
+    if (n > (DIDX_NIL - 1U)) {
+      n = DIDX_NIL - 1U;
     }
+    dx->max = (uint16_t)n;
+  }
+}
 
-    /* Get linked cluster number */
-    link = get_u32(&vol->ca.buf[(clus & 0x7F) << 2]);
 
-    if (link == 0) {
-      cnt++;
-    }
-    clus++;
+/**
+  Add file record to the directory index
+
+  \param[in]  dx                        directory index
+  \param[in]  nameH                     long name hash or short name hash
+  \param[in]  shortH                    short name hash
+  \param[in]  pos                       position of the first record entry
+  \param[in]  cnt                       number of record entries
+
+  \return     true if added, false when index is full
+*/
+static uint32_t didx_add (DINDEX *dx, uint32_t nameH, uint32_t shortH, ENTRY_POS *pos, uint32_t cnt) {
+  DINDEX_ENT *e;
+  uint32_t    b;
+  uint16_t    i;
+
+  if (dx->free != DIDX_NIL) {
+    /* Reuse entry of a deleted record */
+    i = dx->free;
+    dx->free = dx->ent[i].NextN;
+  }
+  else if (dx->top < dx->max) {
+    i = dx->top++;
+  }
+  else {
+    /* Index is full */
+    return (false);
   }
-  while (clus < (vol->cfg.DataClusCnt + 2));
 
-  *count = cnt;
+  e = &dx->ent[i];
+  e->NameH  = nameH;
+  e->ShortH = shortH;
+  e->Clus   = pos->Clus;
+  e->Offs   = pos->Offs;
+  e->Cnt    = (uint8_t)cnt;
+
+  /* Link entry into name and short name hash chains */
+  b = nameH & (dx->nbkt - 1U);
+  e->NextN = dx->bkt[b];
+  dx->bkt[b] = i;
+
+  b = dx->nbkt + (shortH & (dx->nbkt - 1U));
+  e->NextS = dx->bkt[b];
+  dx->bkt[b] = i;
+
+  if (pos->Offs >= dx->tOffs) {
+    /* Record is the last one in directory */
+    dx->tClus = pos->Clus;
+    dx->tOffs = pos->Offs;
+  }
   return (true);
 }
 
 
 /**
-  Allocate cluster
+  Unlink entry from the hash chains and put it into the free chain
+
+  \param[in]  dx                        directory index
+  \param[in]  i                         entry index
 */
-static uint32_t alloc_clus (uint32_t *clus, fsFAT_Volume *vol) {
-  uint32_t n, link;
+static void didx_unlink (DINDEX *dx, uint16_t i) {
+  DINDEX_ENT *e;
+  uint16_t   *p;
 
-  link = 0xFFFFFFFF;
-  /* Find free cluster */
-  for (n = vol->free_clus; n < (vol->cfg.DataClusCnt + 2); n++) {
-    if (alloc_table_read (n, &link, vol) == false) {
-      /* Read sector issue */
-      return (false);
-    }
-    if (link == 0) {
-      break;
-    }
+  e = &dx->ent[i];
+
+  p = &dx->bkt[e->NameH & (dx->nbkt - 1U)];
+  while (*p != i) {
+    p = &dx->ent[*p].NextN;
   }
+  *p = e->NextN;
 
-  if (link != 0) {
-    /* No free clusters - disk full */
-    EvrFsFAT_DiskFull(vol->DrvLet);
-    return (false);
+  p = &dx->bkt[dx->nbkt + (e->ShortH & (dx->nbkt - 1U))];
+  while (*p != i) {
+    p = &dx->ent[*p].NextS;
   }
-  if (alloc_table_write (n, get_EOC(vol->cfg.FatType), vol) == false) {
-    return (false);
+  *p = e->NextS;
+
+  e->Cnt   = 0U;
+  e->NextN = dx->free;
+  dx->free = i;
+}
+
+
+/**
+  Register run of free directory entries. Adjacent runs are merged, when
+  all run slots are used the shortest run is dropped.
+
+  \param[in]  dx                        directory index
+  \param[in]  pos                       position of the first free entry
+  \param[in]  len                       number of free entries
+*/
+static void didx_run_add (DINDEX *dx, ENTRY_POS *pos, uint32_t len) {
+  DINDEX_RUN *r;
+  uint32_t    i, n;
+
+  n = 0U;
+  for (i = 0U; i < (sizeof(dx->run) / sizeof(dx->run[0])); i++) {
+    r = &dx->run[i];
+
+    if (r->Len != 0U) {
+      if ((r->Offs + r->Len) == pos->Offs) {
+        /* Append to existing run */
+        r->Len = (uint16_t)(r->Len + len);
+        return;
+      }
+      if ((pos->Offs + len) == r->Offs) {
+        /* Prepend to existing run */
+        r->Clus = pos->Clus;
+        r->Offs = pos->Offs;
+        r->Len  = (uint16_t)(r->Len + len);
+        return;
+      }
+    }
+    if (r->Len < dx->run[n].Len) {
+      n = i;
+    }
   }
-  vol->free_clus = n + 1;
 
-  /* Cluster allocated */
-  if (vol->cfg.FatType == FS_FAT32) {
-    vol->free_clus_cnt--;
-    vol->Status |= FAT_STATUS_FSINFO;
+  r = &dx->run[n];
+  if (r->Len != 0U) {
+    /* Run is not tracked anymore */
+    dx->lost = 1U;
+
+    if (r->Len >= len) {
+      return;
+    }
   }
-  *clus = n;
-  return (true);
+  r->Clus = pos->Clus;
+  r->Offs = pos->Offs;
+  r->Len  = (uint16_t)len;
 }
 
 
 /**
-  Link two clusters together
+  Remove allocated directory entries from free entry runs
+
+  \param[in]  pos                       position of the first allocated entry
+  \param[in]  cnt                       number of allocated entries
+  \param[in]  vol                       volume description structure
 */
-static uint32_t link_clus (uint32_t clus, uint32_t next_clus, fsFAT_Volume *vol) {
-  return alloc_table_write (clus, next_clus, vol);
+static void didx_run_use (ENTRY_POS *pos, uint32_t cnt, fsFAT_Volume *vol) {
+  DINDEX_RUN *r;
+  ENTRY_POS   rpos;
+  uint32_t    i;
+
+  for (i = 0U; i < (sizeof(vol->didx.run) / sizeof(vol->didx.run[0])); i++) {
+    r = &vol->didx.run[i];
+
+    if ((r->Len != 0U) && (r->Offs < (pos->Offs + cnt)) && (pos->Offs < (r->Offs + r->Len))) {
+      if ((r->Offs == pos->Offs) && (r->Len > cnt)) {
+        /* Allocated from the beginning of the run, shrink it */
+        rpos.Clus = r->Clus;
+        rpos.Offs = r->Offs;
+
+        if (entry_pos_inc (&rpos, cnt, vol) == 0U) {
+          r->Clus = rpos.Clus;
+          r->Offs = rpos.Offs;
+          r->Len  = (uint16_t)(r->Len - cnt);
+          continue;
+        }
+      }
+      /* Release the run, entries behind allocation are not tracked */
+      if (((r->Offs + r->Len) > (pos->Offs + cnt))) {
+        vol->didx.lost = 1U;
+      }
+      r->Len = 0U;
+    }
+  }
 }
 
+
 /**
-  Unlink cluster chain.
+  Build directory index by scanning all entries of the directory
+
+  \param[in]  dir_clus                  first cluster of the directory
+  \param[in]  vol                       volume description structure
+
+  \return     true on success, false on read error
 */
-static uint32_t unlink_clus (uint32_t clus, fsFAT_Volume *vol) {
-  uint32_t n, link, eoc;
+static uint32_t didx_build (uint32_t dir_clus, fsFAT_Volume *vol) {
+#ifndef FS_FAT_NO_LFN
+  LFN_FILEREC *lfne;
+  ENTRY_POS ord_pos;
+  uint8_t   chksum;
+  uint8_t   valid;
+  uint8_t   ents;
+  bool      ord;
+#endif
+  DINDEX   *dx = &vol->didx;
+  FILEREC  *frec;
+  ENTRY_POS pos, rpos, fpos;
+  uint32_t  hash, shortH;
+  uint32_t  nfree;
+  uint32_t  cnt;
+  uint32_t  typ;
+  uint32_t  err;
 
-  if (clus < 2) {
-    /* Empty file */
-    return (true);
-  }
-  eoc = get_EOC (vol->cfg.FatType);
+  didx_clear (dir_clus, dx);
 
-  n = clus;
-  while (n < (vol->cfg.DataClusCnt + 2)) {
-    if (alloc_table_read (n, &link, vol) == false) {
+#ifndef FS_FAT_NO_LFN
+  ord_pos.Clus = 0U;
+  ord_pos.Offs = 0U;
+  chksum = 0U;
+  valid  = 0U;
+  ents   = 0U;
+  ord    = false;
+#endif
+  hash  = 0U;
+  nfree = 0U;
+  fpos.Clus = 0U;
+  fpos.Offs = 0U;
+
+  pos.Clus = dir_clus;
+  pos.Offs = 0U;
+  err      = 0U;
+
+  do {
+    if (entry_read (&pos, &frec, vol)) {
       return (false);
     }
-    if (alloc_table_write (n, 0, vol) == false) {
-      return (false);
+
+    typ = entry_type (frec);
+
+    if (typ == ENTRY_TYPE_FREE) {
+      /* Count contiguous erased entries */
+      if (nfree == 0U) {
+        fpos = pos;
+      }
+      nfree++;
     }
-    if (vol->cfg.FatType == FS_FAT32) {
-      /* Update free cluster count for FAT32 */
-      vol->free_clus_cnt++;
-      vol->Status |= FAT_STATUS_FSINFO;
+    else if (nfree != 0U) {
+      didx_run_add (dx, &fpos, nfree);
+      nfree = 0U;
     }
-    if (link == eoc) {
+
+    if (typ == ENTRY_TYPE_LAST_IN_DIR) {
+      /* Remaining entries are unused */
       break;
-    } else {
-      /* Check if link corrupted */
-      if (link < 2) {
-        return (false);
+    }
+
+    #ifndef FS_FAT_NO_LFN
+    if (typ == ENTRY_TYPE_LFN) {
+      lfne = (LFN_FILEREC *)frec;
+
+      if (lfne->Ordinal & ORD_LONG_NAME_LAST) {
+        /* First component of the long name */
+        ents    = lfne->Ordinal & ~ORD_LONG_NAME_LAST;
+        chksum  = lfne->Checksum;
+        hash    = 0xFFFFFFFF;
+        valid   = 0U;
+        ord     = true;
+        ord_pos = pos;
+      }
+
+      if (chksum == lfne->Checksum) {
+        valid++;
+        hash = long_ent_hash (lfne, hash);
+      }
+      else {
+        valid = 0U;
       }
     }
-    n = link;
+    #endif
 
-    if (n < clus) {
-      /* Keep track of the lowest free cluster */
-      clus = n;
+    if (typ == ENTRY_TYPE_SFN) {
+      shortH = short_ent_hash (frec, 0U);
+
+      /* Independent short entry */
+      rpos = pos;
+      cnt  = 1U;
+      #ifndef FS_FAT_NO_LFN
+      if (ord) {
+        ord = false;
+        if ((ents == valid) && (chksum == sn_chksum ((char *)frec->FileName))) {
+          /* Short entry with valid long name */
+          rpos = ord_pos;
+          cnt += ents;
+        }
+      }
+      #endif
+
+      if (didx_add (dx, (cnt > 1U) ? hash : shortH, shortH, &rpos, cnt) == false) {
+        /* Directory does not fit into the index */
+        dx->state = DIDX_STATE_OVERFLOW;
+        EvrFsFAT_DirIndexOverflow (vol->DrvLet, dir_clus, dx->max);
+        return (true);
+      }
     }
+
+    err = entry_pos_inc (&pos, 1, vol);
   }
-  if (clus < vol->free_clus) {
-    vol->free_clus = clus;
+  while (err == 0U);
+
+  if ((err == 2U) && ((pos.Clus != 0U) || (vol->cfg.FatType == FS_FAT32))) {
+    /* FAT read error */
+    return (false);
+  }
+  if (nfree != 0U) {
+    /* Erased entries at the end of directory */
+    didx_run_add (dx, &fpos, nfree);
   }
-  /* Cluster chain unlinked */
+
+  dx->state = DIDX_STATE_READY;
+  EvrFsFAT_DirIndexBuild (vol->DrvLet, dir_clus, (uint32_t)dx->top);
+
   return (true);
 }
 
 
 /**
-  Traverse cluster chain.
+  Check if directory index is available for given directory
+
+  \param[in]  dir_clus                  first cluster of the directory
+  \param[in]  build                     build the index when not available
+  \param[in]  vol                       volume description structure
+
+  \return     true when index is complete, false otherwise
 */
-static uint32_t follow_clus (uint32_t *clus, uint32_t *link, uint32_t cnt, fsFAT_Volume *vol) {
-  uint32_t eoc, n, val;
+static uint32_t didx_ready (uint32_t dir_clus, uint32_t build, fsFAT_Volume *vol) {
+  DINDEX *dx = &vol->didx;
 
-  eoc = get_EOC (vol->cfg.FatType);
-  n   = *clus;
+  if (dx->max == 0U) {
+    /* Directory index is disabled */
+    return (false);
+  }
 
-  do {
-    if (alloc_table_read (n, &val, vol) == false) {
+  if ((dx->state == DIDX_STATE_NONE) || (dx->dir != dir_clus)) {
+    if (build == false) {
       return (false);
     }
-    if (val == eoc) {
-      break;
-    }
-    if (cnt) {
-      n = val;
+    if (didx_build (dir_clus, vol) == false) {
+      dx->state = DIDX_STATE_NONE;
+      return (false);
     }
   }
-  while (cnt--);
-  *clus = n;
-  *link = val;
-  return (true);
+  return (dx->state == DIDX_STATE_READY);
 }
 
 
+#ifndef FS_FAT_NO_LFN
 /**
-  Clear current cluster.
+  Compare long name of an indexed file record with the searched name
 
-  \param[in]  clus                      cluster number
-  \param[in]  vol                       volume description structure
+  \param[in,out] pinfo                  path info structure with record position
+  \param[out]    match                  true if long name matches
+  \param[in]     vol                    volume description structure
 
-  \return     - true: Ok
-              - false: sector write failed
+  \return     - 0: Long name compared
+              - 1: Directory entry read failed
 */
-static uint32_t clear_clus (uint32_t clus, fsFAT_Volume *vol) {
-  uint32_t i;
-  uint32_t sect = clus_to_sect(&vol->cfg, clus);
-
-  /* Use cache for faster write. */
-  memset(vol->ca.buf, 0, 512);
-  for (i = 0; i < vol->cfg.SecPerClus; i++) {
-    if (write_cache(vol, sect + i) == false) {
-      return (false);
-    }
-  }
-  /* Flush cache buffer */
-  if (write_cache (vol, 0) == false) {
-    return (false);
-  }
-  return (true);
-}
+static uint32_t didx_lfn_cmp (PATH_INFO *pinfo, bool *match, fsFAT_Volume *vol) {
+  LFN_FILEREC *lfne;
+  FILEREC     *frec;
+  ENTRY_POS    pos;
+  uint32_t     n, offs, cnt;
 
+  *match = false;
 
-/**
-  Compare current directory entry position with elink entry and determine how
-  many entries we can skip (since they are cached).
+  pos = pinfo->frec.pos;
 
-  \param[in]  pos                       entry position structure pointer
-  \param[in]  el                        entry link structure pointer
+  /* Long entries are stored in descending ordinal order */
+  for (n = pinfo->frec.cnt - 1U; n > 0U; n--) {
+    if (entry_read (&pos, &frec, vol)) {
+      return (1U);
+    }
+    if (entry_type (frec) != ENTRY_TYPE_LFN) {
+      return (0U);
+    }
+    lfne = (LFN_FILEREC *)frec;
 
-  \return     -  0: entry position and entry link do not match
-              - >0: number of directory entries covered by name cache
-*/
-static uint8_t entry_pos_comp (ENTRY_POS *pos, ELINK *el) {
-  if (el) {
-    if (pos->Clus == el->Info.EntryClus) {
-      if (pos->Offs == el->Info.EntryOffs) {
-        /* Entry position match */
-        return ((uint8_t)el->Info.EntryCount);
+    if ((lfne->Ordinal & 0x1F) != n) {
+      return (0U);
+    }
+    if (lfne->Ordinal & ORD_LONG_NAME_LAST) {
+      if (pinfo->fn_len != ((n - 1U) * 13U + lfn_char_cnt (lfne))) {
+        /* Name length different */
+        return (0U);
       }
     }
+    offs = (n - 1U) * 13U;
+    if (offs >= pinfo->fn_len) {
+      return (0U);
+    }
+    cnt = pinfo->fn_len - offs;
+    if (cnt > 13U) {
+      cnt = 13U;
+    }
+
+    /* Case insensitive name compare with long entry name */
+    if (lfn_name_cmp (lfne, &pinfo->fn[offs], cnt) == false) {
+      return (0U);
+    }
+
+    if (entry_pos_inc (&pos, 1U, vol) != 0U) {
+      return (1U);
+    }
   }
-  return (0);
+
+  *match = true;
+  return (0U);
 }
+#endif
 
 
 /**
-  Increment directory entry position
+  Find file record with specified name in the directory index
 
-  \param[in]  pos                       initial entry position
-  \param[in]  cnt                       increment count
-  \param[in]  vol                       volume description structure
+  \param[in,out] pinfo                  path info structure
+  \param[in]     vol                    volume description structure
 
-  \return     - 0: Ok
-              - 1: Failed, no more entries, end of current directory
-              - 2: Failed, no more entries
+  \return     execution status \ref fsStatus
+                - fsOK           = file record found and short entry loaded
+                - fsFileNotFound = name does not exist in directory
+                - fsError        = io operation failed
 */
-static uint32_t entry_pos_inc (ENTRY_POS *pos, uint32_t cnt, fsFAT_Volume *vol) {
-  uint32_t clus, eoc, offs;
-  
-  /* Advance offset within cluster */
-  offs  = pos->Offs & (vol->cfg.EntsPerClus - 1);
-  offs += cnt;
+static fsStatus didx_find (PATH_INFO *pinfo, fsFAT_Volume *vol) {
+  DINDEX     *dx = &vol->didx;
+  DINDEX_ENT *e;
+  ENTRY_POS   pos;
+  uint32_t    hash;
+  uint32_t    k;
+  uint16_t    i;
+  char        sn[13];
+#ifndef FS_FAT_NO_LFN
+  bool        match;
+#endif
 
-  pos->Offs += cnt;
+  hash = name_hash (pinfo->fn, pinfo->fn_len);
 
-  if (vol->cfg.FatType != FS_FAT32) {
-    /* Check for root entry limit on FAT12/FAT16 */
-    if (pos->Clus == 0) {
-      if (pos->Offs >= 512) {
-        /* No more entries */
-        return (2);
-      }
-      return (0);
-    }
-  }
+  /* Scan name hash chain first, then short name hash chain */
+  for (k = 0U; k < 2U; k++) {
+    i = dx->bkt[(k * dx->nbkt) + (hash & (dx->nbkt - 1U))];
 
-  eoc = get_EOC (vol->cfg.FatType);
+    while (i != DIDX_NIL) {
+      e = &dx->ent[i];
 
-  /* Check if step to next cluster is needed. */
-  while (offs >= vol->cfg.EntsPerClus) {
-    offs -= vol->cfg.EntsPerClus;
+      if (((k == 0U) ? e->NameH : e->ShortH) == hash) {
+        pinfo->frec.pos.Clus = e->Clus;
+        pinfo->frec.pos.Offs = e->Offs;
+        pinfo->frec.cnt      = e->Cnt;
 
-    /* Preserve last used cluster */
-    clus = pos->Clus;
+        #ifndef FS_FAT_NO_LFN
+        if ((k == 0U) && (e->Cnt > 1U)) {
+          /* Long name hash match, compare names */
+          if (didx_lfn_cmp (pinfo, &match, vol) != 0U) {
+            return (fsError);
+          }
+          if (match == false) {
+            /* Hash collision, continue with next entry in chain */
+            i = e->NextN;
+            continue;
+          }
+        }
+        #endif
 
-    if (alloc_table_read (clus, &clus, vol) == false) {
-      /* Sector (FAT) read error */
-      return (2);
-    }
+        /* Read short entry */
+        pos = pinfo->frec.pos;
+        if (e->Cnt > 1U) {
+          if (entry_pos_inc (&pos, e->Cnt - 1U, vol) != 0U) {
+            return (fsError);
+          }
+        }
+        if (entry_read (&pos, &pinfo->sfne, vol)) {
+          return (fsError);
+        }
 
-    if (clus == eoc) {
-      /* No more entries, end of current directory. */
-      return (1);
+        if ((k == 0U) && (e->Cnt > 1U)) {
+          /* Long name match */
+          return (fsOK);
+        }
+
+        /* Short name hash match, compare names */
+        if (sfn_extract (sn, pinfo->sfne->FileName) == pinfo->fn_len) {
+          if (fs_strncasecmp (sn, pinfo->fn, pinfo->fn_len) == 0) {
+            return (fsOK);
+          }
+        }
+      }
+      i = (k == 0U) ? e->NextN : e->NextS;
     }
-    /* Set next cluster */
-    pos->Clus = clus;
   }
-  return (0);
+  return (fsFileNotFound);
 }
 
 
 /**
-  Read directory entry at given position and return it's pointer
+  Set directory entry allocation start position, so that used entries are
+  skipped. Position is not changed when free entry runs are not known.
 
-  \param[in]  pos                       directory entry position
-  \param[out] frec                      file record structure pointer
+  \param[in]  dir_clus                  first cluster of the directory
+  \param[in]  cnt                       number of entries to allocate
+  \param[in,out] pos                    allocation start position
   \param[in]  vol                       volume description structure
-
-  \return     - 0: Directory entry read and pointer to it is set
-              - 1: Sector read error
 */
-static uint32_t entry_read (ENTRY_POS *pos, FILEREC **frec, fsFAT_Volume *vol) {
-  uint32_t sect, offs;
+static void didx_hint (uint32_t dir_clus, uint32_t cnt, ENTRY_POS *pos, fsFAT_Volume *vol) {
+  DINDEX  *dx = &vol->didx;
+  uint32_t i;
 
-  if ((pos->Clus == 0) && (vol->cfg.FatType != FS_FAT32)) {
-    offs = pos->Offs;
-  }
-  else {
-    offs = pos->Offs & (vol->cfg.EntsPerClus - 1);
+  if ((dx->max == 0U) || (dx->state != DIDX_STATE_READY) || (dx->dir != dir_clus)) {
+    return;
   }
 
-  sect = clus_to_sect (&vol->cfg, pos->Clus);
+  for (i = 0U; i < (sizeof(dx->run) / sizeof(dx->run[0])); i++) {
+    if (dx->run[i].Len >= cnt) {
+      /* First fitting run of erased entries */
+      pos->Clus = dx->run[i].Clus;
+      pos->Offs = dx->run[i].Offs;
+      return;
+    }
+  }
 
-  if (read_sector (vol, sect + (offs >> 4)) == false) {
-    /* Sector (directory entries) read error */
-    return (1);
+  if (dx->lost == 0U) {
+    /* No fitting run, continue after last record */
+    pos->Clus = dx->tClus;
+    pos->Offs = dx->tOffs;
   }
-  *frec = (FILEREC *)(uint32_t)vol->ca.buf + (offs & 0x0F);
-  return (0);
 }
 
 
 /**
-  Return directory entry type
-
-  This function will check the filename and attributes field in order to
-  determine directory entry type.
+  Add newly created file record to the directory index
 
-  \param[in]  de                        directory entry
-
-  \return     Directory entry type \ref ENTRY_TYPE
+  \param[in]  pinfo                     path info of the created record
+  \param[in]  pos                       position of the first record entry
+  \param[in]  sfne                      short name in entry format
+  \param[in]  vol                       volume description structure
 */
-static uint32_t entry_type (FILEREC *de) {
-  if (de->FileName[0] == 0x00) {
-    /* Free entry, last one in the directory */
-    return (ENTRY_TYPE_LAST_IN_DIR);
-  }
-  else if (de->FileName[0] == 0xE5) {
-    /* Free directory entry (erased) */
-    return (ENTRY_TYPE_FREE);
+static void didx_insert (PATH_INFO *pinfo, ENTRY_POS *pos, FILEREC *sfne, fsFAT_Volume *vol) {
+  DINDEX  *dx = &vol->didx;
+  uint32_t nameH, shortH;
+
+  if ((dx->max == 0U) || (dx->state != DIDX_STATE_READY) || (dx->dir != pinfo->dir_clus)) {
+    return;
   }
-  else if ((de->Attr & ATTR_LONG_NAME_MASK) == ATTR_LONG_NAME) {
-    /* Long file name entry */
-    return (ENTRY_TYPE_LFN);
+
+  didx_run_use (pos, pinfo->frec.cnt, vol);
+
+  shortH = short_ent_hash (sfne, 0U);
+  nameH  = shortH;
+  if (pinfo->frec.cnt > 1U) {
+    nameH = name_hash (pinfo->fn, pinfo->fn_len);
   }
-  else {
-    if ((de->Attr & (FS_FAT_ATTR_DIRECTORY | FS_FAT_ATTR_VOLUME_ID)) == FS_FAT_ATTR_VOLUME_ID) {
-    /* Volume label */
-    return (ENTRY_TYPE_LABEL);
-    }
-    /* Short file name entry (may be file or directory */
-    return (ENTRY_TYPE_SFN);
+
+  if (didx_add (dx, nameH, shortH, pos, pinfo->frec.cnt) == false) {
+    /* Directory does not fit into the index anymore */
+    dx->state = DIDX_STATE_OVERFLOW;
+    EvrFsFAT_DirIndexOverflow (vol->DrvLet, dx->dir, dx->max);
   }
 }
 
+
 /**
-  Flush entry that was previously read with entry_read to the media
+  Remove file record from the directory index
 
-  \param[in]  pos                       directory entry position
+  \param[in]  rpos                      position of the record
+  \param[in]  sfne                      short entry of the record
   \param[in]  vol                       volume description structure
-
-  \return \ref fsStatus
 */
-static fsStatus entry_flush (ENTRY_POS *pos, fsFAT_Volume *vol) {
-  uint32_t sect, offs;
+static void didx_remove (FREC_POS *rpos, FILEREC *sfne, fsFAT_Volume *vol) {
+  DINDEX     *dx = &vol->didx;
+  DINDEX_ENT *e;
+  uint16_t    i;
 
-  if ((pos->Clus == 0) && (vol->cfg.FatType != FS_FAT32)) {
-    offs = pos->Offs;
+  if ((dx->max == 0U) || (dx->state == DIDX_STATE_NONE)) {
+    return;
   }
-  else {
-    offs = pos->Offs & (vol->cfg.EntsPerClus - 1);
+
+  if ((sfne->Attr & FS_FAT_ATTR_DIRECTORY) && (extract_clus (sfne) == dx->dir)) {
+    /* Indexed directory is removed */
+    dx->state = DIDX_STATE_NONE;
+    return;
   }
 
-  sect = clus_to_sect (&vol->cfg, pos->Clus);
+  if (dx->state == DIDX_STATE_READY) {
+    i = dx->bkt[dx->nbkt + (short_ent_hash (sfne, 0U) & (dx->nbkt - 1U))];
 
-  if (write_sector (vol, sect + (offs >> 4), ACT_USEJOUR) == false) {
-    /* Sector write error */
-    return (fsDriverError);
+    while (i != DIDX_NIL) {
+      e = &dx->ent[i];
+
+      if ((e->Clus == rpos->pos.Clus) && (e->Offs == rpos->pos.Offs)) {
+        /* Record belongs to the indexed directory */
+        didx_unlink (dx, i);
+        didx_run_add (dx, &rpos->pos, rpos->cnt);
+        break;
+      }
+      i = e->NextS;
+    }
   }
-  /* Entry flushed to media */
-  return (fsOK);
 }
 
 
@@ -2117,6 +3851,9 @@ static uint32_t frec_allocate (uint32_t start_clus, uint32_t cnt, ENTRY_POS *pos
   cur_pos.Clus = start_clus;
   cur_pos.Offs = 0;
 
+  /* Skip used entries known to the directory index */
+  didx_hint (start_clus, cnt, &cur_pos, vol);
+
   /* Search through name entries. */
   ents = 0;
   do {
@@ -2240,6 +3977,11 @@ static fsStatus frec_delete (FREC_POS *rpos, fsFAT_Volume *vol) {
       return (fsError);
     }
 
+    if (cnt == 1U) {
+      /* Short entry, remove file record from the directory index */
+      didx_remove (rpos, frec, vol);
+    }
+
     /* Mark entry as free */
     frec->FileName[0] = 0xE5;
 
@@ -2249,7 +3991,7 @@ static fsStatus frec_delete (FREC_POS *rpos, fsFAT_Volume *vol) {
       done = true;
     }
 
-    if (done || (pos.Offs & 0x0F) == 0x0F) {
+    if (done || ((pos.Offs + 1U) & ((vol->cfg.BytesPerSec >> 5) - 1U)) == 0U) {
       if (entry_flush (&pos, vol) != fsOK) {
         /* Read/Write error */
         return (fsError);
@@ -2468,7 +4210,7 @@ static fsStatus frec_find_elink (PATH_INFO *pinfo, fsFAT_Volume *vol) {
 
       pinfo->frec.cnt      = (uint8_t)el->Info.EntryCount;
       pinfo->frec.pos.Clus = el->Info.EntryClus;
-      pinfo->frec.pos.Offs = (uint8_t)el->Info.EntryOffs;
+      pinfo->frec.pos.Offs = (uint16_t)el->Info.EntryOffs;
 
       pos.Clus = pinfo->frec.pos.Clus;
       pos.Offs = pinfo->frec.pos.Offs;
@@ -2517,6 +4259,12 @@ static fsStatus frec_find (PATH_INFO *pinfo, fsFAT_Volume *vol) {
   uint32_t hash;
   uint32_t err;
 
+  /* Index is built for the directory holding the last name in path */
+  if (didx_ready (pinfo->dir_clus, (pinfo->fn_flags & FAT_NAME_LAST) != 0U, vol)) {
+    /* Directory index is complete, scan is not needed */
+    return (didx_find (pinfo, vol));
+  }
+
   /* Init scan */
   pos.Clus = pinfo->dir_clus;
   pos.Offs = 0;
@@ -2739,7 +4487,7 @@ static fsStatus create_lfn_entry (PATH_INFO *pinfo, uint8_t sfn_chksum, fsFAT_Vo
     /* Copy name characters into long entry component */
     lfn_name_copy (frec, &pinfo->fn[offs], cnt);
 
-    if ((pinfo->frec.pos.Offs & 0x0F) == 0x0F) {
+    if (((pinfo->frec.pos.Offs + 1U) & ((vol->cfg.BytesPerSec >> 5) - 1U)) == 0U) {
       /* Sector full, flush entries */
       stat = entry_flush (&pinfo->frec.pos, vol);
       if (stat != fsOK) {
@@ -2865,7 +4613,7 @@ static uint32_t mbr_write (fsFAT_Volume *vol, uint32_t iSz) {
 
   EvrFsFAT_WriteMBR (vol->DrvLet, 0);
 
-  memset (vol->ca.buf, 0, 512);
+  memset (vol->ca.buf, 0, vol->cfg.BytesPerSec);
 
   /* Boot Descriptor: Non Bootable Device. */
   vol->ca.buf[446] = 0;
@@ -2955,7 +4703,7 @@ static uint32_t mbr_read (fsFAT_Volume *vol) {
 static uint32_t bs_write (fsFAT_Volume *vol) {
   uint32_t sernum = 0x12345678;
 
-  memset (vol->ca.buf, 0, 512);
+  memset (vol->ca.buf, 0, vol->cfg.BytesPerSec);
 
   /* Boot Code: E9 00 90 */
   vol->ca.buf[0] = 0xE9;
@@ -2966,7 +4714,7 @@ static uint32_t bs_write (fsFAT_Volume *vol) {
   memcpy (&vol->ca.buf[3], "MSWIN4.1", 8);
 
   /* Bytes per Sector */
-  set_u16 (&vol->ca.buf[11], 512);
+  set_u16 (&vol->ca.buf[11], vol->cfg.BytesPerSec);
 
   /* Sectors per Cluster */
   vol->ca.buf[13] = vol->cfg.SecPerClus;
@@ -2980,7 +4728,7 @@ static uint32_t bs_write (fsFAT_Volume *vol) {
   /* Root Entry Count */
   if (vol->cfg.FatType != FS_FAT32) {
     /* Must be 0 for FAT32. */
-    set_u16 (&vol->ca.buf[17], 512);
+    set_u16 (&vol->ca.buf[17], vol->cfg.RootEntCnt);
   }
 
   /* Total Sector Count */
@@ -3137,7 +4885,7 @@ static uint32_t bs_read (fsFAT_Volume *vol) {
 static uint32_t fsinfo_write (fsFAT_Volume *vol) {
   uint32_t sect;
 
-  memset (vol->ca.buf, 0, 512);
+  memset (vol->ca.buf, 0, vol->cfg.BytesPerSec);
 
   /* Lead Signature */
   set_u32 (&vol->ca.buf[0], 0x41615252);
@@ -3367,7 +5115,7 @@ static uint32_t wipe_disk (fsFAT_Volume *vol, uint32_t dsize) {
   if (csize == 0) {
     csize = 1;
   }
-  memset (vol->ca.buf, 0xFF, csize * 512);
+  memset (vol->ca.buf, 0xFF, csize * vol->cfg.BytesPerSec);
 
   for (i = 0; i < dsize; i += csize) {
     if (vol->Drv->WriteSect (i, vol->ca.buf, csize) == false) {
@@ -3378,6 +5126,32 @@ static uint32_t wipe_disk (fsFAT_Volume *vol, uint32_t dsize) {
 }
 
 
+/**
+  Set sector size of the volume and adjust data cache geometry.
+
+  \param[in]  vol                       volume description structure
+  \param[in]  size                      sector size in bytes
+*/
+static void set_sect_size (fsFAT_Volume *vol, uint32_t size) {
+
+  vol->cfg.BytesPerSec = (uint16_t)size;
+
+  /* Multi-sector reads fill the working buffer and continue into data cache */
+  vol->ca.cbuf = vol->ca.buf + size;
+
+  /* Number of sectors that fit into data cache */
+  vol->CaSize = vol->ca.cbsz / size;
+
+  /* Background I/O requires data cache */
+  vol->ca.wmark = 0U;
+  if ((fs_fat_io_wmark != 0U) && (vol->CaSize != 0U)) {
+    if (fs_io_thread_new () == 0U) {
+      vol->ca.wmark = (uint8_t)(((vol->CaSize * fs_fat_io_wmark) + 99U) / 100U);
+    }
+  }
+}
+
+
 /**
   Check if Volume Info is sane.
 
@@ -3387,8 +5161,9 @@ static uint32_t wipe_disk (fsFAT_Volume *vol, uint32_t dsize) {
 static fsStatus fat_validate (FATINFO *vol) {
   fsStatus status;
 
-  if (vol->BytesPerSec != 512) {
-    /* We only support 512 byte sectors. */
+  if ((vol->BytesPerSec < 512U) || (vol->BytesPerSec > fs_fat_sect_max) ||
+      ((vol->BytesPerSec & (vol->BytesPerSec - 1U)) != 0U)) {
+    /* Sector size must be a power of 2, from 512 bytes up to configured maximum */
     status = fsError;
   }
   else if (vol->RsvdSecCnt == 0) {
@@ -3436,7 +5211,7 @@ static uint32_t switch_fat (fsFAT_Volume *vol, uint8_t fat_num) {
     }
   }
   /* Invalidate cache */
-  vol->fat.sect = INVAL_SECT;
+  inval_fat (vol);
   /* Set new FAT */
   vol->fat.cfat = fat_num;
   return (true);
@@ -3760,6 +5535,8 @@ __WEAK uint32_t fat_jour_init (fsFAT_Volume *vol) {
     }
 
     /* Init low level journaling system */
+    vol->fsj->SectSize = vol->cfg.BytesPerSec;
+
     if (fsj_init (vol->fsj, vol->Drv) == false) {
       /* Journal inconsistent? Driver error? */
       return (false);
@@ -3786,8 +5563,7 @@ __WEAK uint32_t fat_jour_prep (fsFAT_Volume *vol) {
     vol->Status   &= ~FAT_STATUS_JOURACT;
 
     /* Invalidate FAT cache */
-    vol->fat.sect  = INVAL_SECT;
-    vol->fat.dirty = false;
+    inval_fat (vol);
 
     first_clus    = 0;
     cnt           = 0;
@@ -3946,6 +5722,7 @@ static fsStatus path_create (PATH_INFO *pinfo, bool mkdir, fsFAT_Volume *vol) {
   uint32_t  first_clus;
   uint8_t   attrib;
   ELINK    *el;
+  ENTRY_POS pos;
   #ifndef FS_FAT_NO_LFN
   fsStatus  stat;
   uint32_t  num;
@@ -4022,6 +5799,8 @@ static fsStatus path_create (PATH_INFO *pinfo, bool mkdir, fsFAT_Volume *vol) {
       /* Cannot allocate */
       return (fsError);
     }
+    pos = pinfo->frec.pos;
+
     el = elink_cmd (ELINK_CMD_ALLOC, vol->ncache);
 
     if (pinfo->fn_flags & FAT_NAME_DIR) {
@@ -4070,6 +5849,9 @@ static fsStatus path_create (PATH_INFO *pinfo, bool mkdir, fsFAT_Volume *vol) {
       return (fsError);
     }
 
+    /* Add file record to the directory index */
+    didx_insert (pinfo, &pos, (FILEREC *)(uint32_t)sn, vol);
+
     if (el) {
       el->Info.ShortNameH  = short_ent_hash ((FILEREC *)(uint32_t)sn, el->Info.ShortNameH);
       el->Info.DirClus     = pinfo->dir_clus;
@@ -4115,7 +5897,7 @@ static fsStatus path_create (PATH_INFO *pinfo, bool mkdir, fsFAT_Volume *vol) {
 */
 __WEAK fsStatus fat_init (fsFAT_Volume *vol) {
   fsStatus status;
-  uint32_t mask;
+  uint32_t mask, i;
 
   mask = (~FAT_STATUS_MASK) | FAT_STATUS_INIT_IO;
 
@@ -4134,8 +5916,8 @@ __WEAK fsStatus fat_init (fsFAT_Volume *vol) {
       /* Mutex was not created */
       status = fsError;
     }
-    else if (vol->Drv == NULL) {
-      /* Configuration error, no driver registered */
+    else if ((vol->Drv == NULL) || (vol->fat.ent == NULL) || (vol->fat.cnt == 0U)) {
+      /* Configuration error, no driver or FAT cache registered */
       EvrFsFAT_InitDriverCfgError (vol->DrvLet);
       status = fsError;
     }
@@ -4143,9 +5925,17 @@ __WEAK fsStatus fat_init (fsFAT_Volume *vol) {
       vol->Status = 0U;
 
       /* Initialize cache buffers */
+      vol->fat.ent[0].buf = (uint8_t *)&vol->CaBuf[0];
+      for (i = 1; i < vol->fat.cnt; i++) {
+        vol->fat.ent[i].buf = (uint8_t *)&vol->FatCaBuf[(i - 1) * (fs_fat_sect_max / 4U)];
+      }
       vol->fat.buf = (uint8_t *)&vol->CaBuf[0];
-      vol->ca.buf  = (uint8_t *)&vol->CaBuf[128];
-      vol->ca.cbuf = (uint8_t *)&vol->CaBuf[256];
+      vol->ca.buf  = (uint8_t *)&vol->CaBuf[fs_fat_sect_max / 4U];
+
+      /* Data cache size is configured in 512 byte sectors */
+      vol->ca.nra  = 0U;
+      vol->ca.cbsz = vol->CaSize * 512U;
+      set_sect_size (vol, 512U);
 
       if (vol->Drv->Init (DM_IO) == false) {
         /* Failed to initialize the driver */
@@ -4174,12 +5964,27 @@ __WEAK fsStatus fat_init (fsFAT_Volume *vol) {
 */
 __WEAK fsStatus fat_uninit (fsFAT_Volume *vol) {
   fsStatus status;
+  uint32_t i;
 
   status = fsOK;
 
   /* Uninitializing drive */
   EvrFsFAT_UninitDrive (vol->DrvLet);
 
+  if (fat_xfer_active (vol)) {
+    return (fsAccessDenied);
+  }
+
+  for (i = 0; i < fs_fat_fh_cnt; i++) {
+    if ((fs_fat_fh[i].vol == vol) && (fs_fat_fh_mtx[i] != NULL)) {
+      /* Delete file handle mutex */
+      if (fs_mutex_delete (fs_fat_fh_mtx[i]) != 0U) {
+        status = fsError;
+      }
+      fs_fat_fh_mtx[i] = NULL;
+    }
+  }
+
   if (vol->Mutex != NULL) {
     if (fs_mutex_delete (vol->Mutex) != 0U) {
       status = fsError;
@@ -4236,17 +6041,25 @@ __WEAK fsStatus fat_mount (fsFAT_Volume *vol) {
   memset (&vol->cfg, 0, sizeof (vol->cfg));
 
   /* Initialize FAT Cache and Data Cache */
-  vol->fat.sect  = INVAL_SECT;
-  vol->fat.dirty = false;
+  inval_fat (vol);
+  memset (vol->fat.mrun, 0, sizeof (vol->fat.mrun));
   vol->fat.cfat  = FAT_1;
 
   vol->ca.sect = INVAL_SECT;
   vol->ca.nwr  = 0;
   vol->ca.nrd  = 0;
+  vol->ca.nra  = 0;
 
   /* First 2 clusters are always reserved. */
   vol->free_clus = 2;
 
+  /* Free cluster count not known yet */
+  vol->Status &= ~FAT_STATUS_FREECNT;
+
+  /* No pending discards, ask media again for discard support */
+  memset (&vol->disc, 0, sizeof (vol->disc));
+  vol->Status &= ~FAT_STATUS_NODISCARD;
+
   /* Read Master Boot Record */
   if (mbr_read (vol) == false) {
     /* Invalid MBR? */
@@ -4266,6 +6079,9 @@ __WEAK fsStatus fat_mount (fsFAT_Volume *vol) {
     return (fsNoFileSystem);
   }
 
+  /* Adjust data cache to the volume sector size */
+  set_sect_size (vol, vol->cfg.BytesPerSec);
+
   /* Calculate Root Sector Count. */
   root_scnt = (vol->cfg.RootEntCnt * 32 + vol->cfg.BytesPerSec - 1) / vol->cfg.BytesPerSec;
 
@@ -4278,6 +6094,12 @@ __WEAK fsStatus fat_mount (fsFAT_Volume *vol) {
   vol->cfg.ClusSize    = vol->cfg.SecPerClus * vol->cfg.BytesPerSec;
   vol->cfg.EntsPerClus = (uint16_t)(vol->cfg.ClusSize / 32);
 
+  /* Free cluster map is built while the allocation table is scanned */
+  fmap_init (vol);
+
+  /* Directory index is built on first access to a directory */
+  didx_init (vol);
+
   /* Determine Fat Type. */
   if (vol->cfg.DataClusCnt < 4085) {
     vol->cfg.FatType = FS_FAT12;
@@ -4287,6 +6109,9 @@ __WEAK fsStatus fat_mount (fsFAT_Volume *vol) {
   }
   else {
     vol->cfg.FatType = FS_FAT32;
+    /* Free cluster count is maintained in FSInfo */
+    vol->Status |= FAT_STATUS_FREECNT;
+
     /* Read File System info sector. */
     if (fsinfo_read (vol) != fsOK) {
       if (count_free_clus32 (&vol->free_clus_cnt, vol) == false) {
@@ -4337,6 +6162,10 @@ __WEAK fsStatus fat_unmount (fsFAT_Volume *vol) {
   /* Unmounting drive */
   EvrFsFAT_UnmountDrive (vol->DrvLet);
 
+  if (fat_xfer_active (vol)) {
+    return (fsAccessDenied);
+  }
+
   for (i = 0, fh = &fs_fat_fh[0]; i < fs_fat_fh_cnt; i++, fh++) {
     if (fh->flags & FAT_HANDLE_OPEN) {
       if (fh->vol == vol) {
@@ -4368,7 +6197,7 @@ __WEAK fsStatus fat_unmount (fsFAT_Volume *vol) {
   \return     execution status \ref fsStatus
 */
 __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
-  uint32_t datSect, volSz, iSz, i, sec, mbr;
+  uint32_t datSect, volSz, iSz, i, sec, mbr, blen, mul;
   uint8_t secClus;
   int32_t len;
   fsMediaInfo info;
@@ -4391,6 +6220,10 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
     return (stat);
   }
 
+  if (fat_xfer_active (vol)) {
+    return (fsAccessDenied);
+  }
+
   /* Reset all active file handles on this drive */
   fat_handles_reset (vol);
 
@@ -4466,7 +6299,20 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
     return (fsNoFreeSpace);
   }
 
-  volSz = info.block_cnt >> 11;
+  /* Check sector size, 512 bytes are assumed when not reported */
+  blen = (info.read_blen != 0U) ? info.read_blen : 512U;
+
+  if ((blen < 512U) || (blen > fs_fat_sect_max) || ((blen & (blen - 1U)) != 0U)) {
+    EvrFsFAT_FormatSectorSizeInvalid (vol->DrvLet, blen);
+    return (fsUnsupported);
+  }
+  set_sect_size (vol, blen);
+
+  /* Formatting table is defined for 512 byte sectors */
+  mul = blen / 512U;
+
+  /* Volume size in MB */
+  volSz = (uint32_t)(((uint64_t)info.block_cnt * blen) >> 20);
   for (iSz = 0, i = 8; iSz < 13; i <<= 1, iSz++) {
     if (volSz < i) break;
   }
@@ -4476,7 +6322,7 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
   }
 
   /* Invalidate FAT cache */
-  vol->fat.sect = INVAL_SECT;
+  inval_fat (vol);
 
   /* Check for parameter: /W */
   if (find_param (opt, "/W")) {
@@ -4494,22 +6340,22 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
 
   if (mbr) {
     /* Format with partition table (MBR) */
-    vol->cfg.BootSector = IniDevCfg[iSz].BootSector;
-    secClus             = IniDevCfg[iSz].SecClus;
+    vol->cfg.BootSector = IniDevCfg[iSz].BootSector / mul;
+    secClus             = (uint8_t)(IniDevCfg[iSz].SecClus / mul);
   }
   else {
     /* Don't write MBR */
     vol->cfg.BootSector = 0;
 
     /* Use small clusters when appropriate */
-    if (info.block_cnt <= 4142) {
+    if ((info.block_cnt * mul) <= 4142) {
       secClus = 1;
     }
-    else if (info.block_cnt <= 8229) {
+    else if ((info.block_cnt * mul) <= 8229) {
       secClus = 2;
     }
     else {
-      secClus = IniDevCfg[iSz].SecClus;
+      secClus = (uint8_t)(IniDevCfg[iSz].SecClus / mul);
     }
   }
 
@@ -4517,7 +6363,6 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
   vol->cfg.FatType    = IniDevCfg[iSz].FatType;
   vol->cfg.DskSize    = info.block_cnt - vol->cfg.BootSector;
   vol->cfg.RsvdSecCnt = 1;
-  vol->cfg.BytesPerSec= 512;
   vol->cfg.NumOfFat   = 2;
 
   /* Check for parameter: /FAT32 */
@@ -4534,40 +6379,45 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
     vol->cfg.FAT32_RootClus = 2;
     vol->cfg.FAT32_BkBootSec= 6;
 
-    secClus  = IniDevCfg[iSz].SecClus32;
-    if (secClus == 0) {
+    if (IniDevCfg[iSz].SecClus32 == 0) {
       /* Not possible to use FAT32, size is too small. */
       EvrFsFAT_FormatNoSpaceFAT32 (vol->DrvLet);
       return (fsNoFreeSpace);
     }
+    secClus  = (uint8_t)(IniDevCfg[iSz].SecClus32 / mul);
+  }
+
+  if (secClus == 0) {
+    /* Cluster of the table is smaller than a large sector */
+    secClus = 1;
   }
 
   vol->cfg.SecPerClus  = secClus;
-  vol->cfg.ClusSize    = secClus * 512;
+  vol->cfg.ClusSize    = secClus * blen;
   vol->cfg.EntsPerClus = (uint16_t)(vol->cfg.ClusSize / 32);
 
   datSect = vol->cfg.DskSize - vol->cfg.RsvdSecCnt;
   /* Calculate Data Space and FAT Table Size. */
   switch (vol->cfg.FatType) {
     case FS_FAT12:
-      datSect -= 32;
       vol->cfg.RootEntCnt  = 512;
-      vol->cfg.RootSecCnt  = 32;
-      vol->cfg.DataClusCnt = (datSect * 512 - 1022) / (secClus * 512 + 3);
-      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt * 3 + 1022) / 1024);
+      vol->cfg.RootSecCnt  = (uint16_t)((512 * 32) / blen);
+      datSect -= vol->cfg.RootSecCnt;
+      vol->cfg.DataClusCnt = (datSect * blen - (2*blen - 2)) / (secClus * blen + 3);
+      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt * 3 + (2*blen - 2)) / (2*blen));
       break;
     case FS_FAT16:
-      datSect -= 32;
       vol->cfg.RootEntCnt  = 512;
-      vol->cfg.RootSecCnt  = 32;
-      vol->cfg.DataClusCnt = (datSect * 128 - 255) / (secClus * 128 + 1);
-      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt + 255) / 256);
+      vol->cfg.RootSecCnt  = (uint16_t)((512 * 32) / blen);
+      datSect -= vol->cfg.RootSecCnt;
+      vol->cfg.DataClusCnt = (datSect * (blen/4) - (blen/2 - 1)) / (secClus * (blen/4) + 1);
+      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt + (blen/2 - 1)) / (blen/2));
       break;
     case FS_FAT32:
       vol->cfg.RootSecCnt  = 0;
-      calc                = ((uint64_t)(datSect) * 64 - 127) / (secClus * 64 + 1);
+      calc                = ((uint64_t)(datSect) * (blen/8) - (blen/4 - 1)) / (secClus * (blen/8) + 1);
       vol->cfg.DataClusCnt = (uint32_t)(calc);
-      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt + 127) / 128);
+      vol->cfg.FatSize     = (uint32_t)((vol->cfg.DataClusCnt + (blen/4 - 1)) / (blen/4));
       break;
   }
 
@@ -4582,7 +6432,7 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
   if (mbr) {
     /* 2nd Cluster should be 32K aligned for optimal Card performance. */
     sec = vol->cfg.RootDirAddr + vol->cfg.RootSecCnt;
-    vol->cfg.BootSector = ((vol->cfg.BootSector + sec) & (uint32_t)~0x3F) - sec;
+    vol->cfg.BootSector = ((vol->cfg.BootSector + sec) & ~((32768U / blen) - 1U)) - sec;
 
     /* Write MBR, create Partition Table. */
     if (mbr_write (vol, iSz) == false) {
@@ -4590,7 +6440,7 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
     }
   }
 
-  memset (vol->ca.buf, 0, 512);
+  memset (vol->ca.buf, 0, vol->cfg.BytesPerSec);
 
   /* Clear hidden sectors */
   EvrFsFAT_ClearHiddenSectors (vol->DrvLet, 1, vol->cfg.BootSector);
@@ -4609,8 +6459,15 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
   /* First 2 clusters are always reserved. */
   vol->free_clus = 2;
 
+  /* Reset free cluster map, directory index and pending discards */
+  fmap_init (vol);
+  didx_init (vol);
+  memset (&vol->disc, 0, sizeof (vol->disc));
+  vol->Status &= ~(FAT_STATUS_FREECNT | FAT_STATUS_NODISCARD);
+
   if (vol->cfg.FatType == FS_FAT32) {
     vol->free_clus_cnt = vol->cfg.DataClusCnt - 1;
+    vol->Status |= FAT_STATUS_FREECNT;
 
     /* Generate FSInfo on FAT32. */
     if (fsinfo_write (vol) == false) {
@@ -4619,7 +6476,7 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
   }
 
   /* Clear data buffer */
-  memset (vol->ca.buf, 0, 512);
+  memset (vol->ca.buf, 0, vol->cfg.BytesPerSec);
 
   /* Set sector number to boot sector */
   sec = vol->cfg.BootSector;
@@ -4731,6 +6588,12 @@ __WEAK fsStatus fat_format (fsFAT_Volume *vol, const char *opt) {
     return (fsDriverError);
   }
 
+  if (fs_fat_discard) {
+    /* Discard the rest of the data area (before journal is reserved) */
+    i = vol->cfg.BootSector + vol->cfg.DskSize;
+    (void)disc_sect (vol, sec + datSect, i - (sec + datSect));
+  }
+
   /* Reserve space for journal */
   if (fat_jour_prep (vol) == false) {
     return (fsError);
@@ -4885,6 +6748,10 @@ __WEAK fsStatus fat_open (int32_t handle, const char *path, int32_t openmode) {
           return (fsError);
         }
       }
+      /* Commit truncated short entry */
+      if (jour_commit (fh->vol) == false) {
+        return (fsError);
+      }
     }
   }
   else if (status == fsFileNotFound) {
@@ -4914,6 +6781,8 @@ __WEAK fsStatus fat_open (int32_t handle, const char *path, int32_t openmode) {
 
     fh->current_clus = fh->first_clus;
     fh->current_sect = 0;
+
+    ext_reset (fh);
   }
 
   if (status == fsOK) {
@@ -4939,6 +6808,7 @@ __WEAK fsStatus fat_close (int32_t handle) {
   fsStatus  stat;
   fsTime    time;
   uint16_t  ent_time, ent_date;
+  uint32_t  clus;
   bool      frec_update;
 
   EvrFsFAT_FileClose(handle);
@@ -4965,6 +6835,17 @@ __WEAK fsStatus fat_close (int32_t handle) {
       goto exit;
     }
 
+    if (fh->flags & FAT_HANDLE_FREE) {
+      /* Release unused preallocated clusters */
+      if (release_clus (fh, &clus) == false) {
+        stat = fsError;
+        goto exit;
+      }
+      if (clus != 0) {
+        EvrFsFAT_FileAllocateRelease (handle, clus);
+      }
+    }
+
     /* Check if short entry needs update */
     frec_update = false;
 
@@ -5031,6 +6912,13 @@ __WEAK fsStatus fat_close (int32_t handle) {
         goto exit;
       }
     }
+    else {
+      /* Commit updated short entry */
+      if (jour_commit (fh->vol) == false) {
+        stat = fsError;
+        goto exit;
+      }
+    }
   }
   else {
     stat = fsOK;
@@ -5055,7 +6943,8 @@ exit:
 __WEAK int32_t fat_read (int32_t handle, uint8_t *buf, uint32_t len) {
   fsFAT_Handle *fh;
   fsStatus status;
-  uint32_t sect, pos, nr, rlen;
+  uint32_t sect, pos, nr, rlen, clus, n;
+  bool     cached;
 
   EvrFsFAT_FileRead (handle, buf, len);
 
@@ -5104,11 +6993,12 @@ __WEAK int32_t fat_read (int32_t handle, uint8_t *buf, uint32_t len) {
   }
   fh->flags |= FAT_HANDLE_DATA_RD;
 
-  pos = fh->fpos & 0x1FF;
+  cached = false;
+  pos    = fh->fpos & (fh->vol->cfg.BytesPerSec - 1U);
   for (nr = 0; nr < len; nr += rlen) {
     if (fh->current_sect == fh->vol->cfg.SecPerClus) {
       /* All sectors from current cluster are read, load next cluster */
-      if (alloc_table_read (fh->current_clus, &fh->current_clus, fh->vol) == false) {
+      if (ext_next (fh, (fh->fpos + nr) / fh->vol->cfg.ClusSize, &fh->current_clus) == false) {
         /* Read error */
         return (-(int32_t)fsDriverError);
       }
@@ -5116,19 +7006,38 @@ __WEAK int32_t fat_read (int32_t handle, uint8_t *buf, uint32_t len) {
     }
 
     sect = clus_to_sect (&fh->vol->cfg, fh->current_clus) + fh->current_sect;
+
+    if ((pos == 0U) && ((len - nr) >= fh->vol->cfg.BytesPerSec) && (((uint32_t)&buf[nr] & 3U) == 0U) && (fh->vol->DirectIO != 0U)) {
+      /* Sector aligned transfer, read whole sectors directly into user buffer */
+      if (clus_run (fh, (fh->fpos + nr) / fh->vol->cfg.ClusSize, (len - nr) / fh->vol->cfg.BytesPerSec, false, &clus, &n) == false) {
+        return (-(int32_t)fsDriverError);
+      }
+      if (read_direct (fh->vol, sect, &buf[nr], n) == false) {
+        /* Read error */
+        return (-(int32_t)fsDriverError);
+      }
+      rlen = n * fh->vol->cfg.BytesPerSec;
+      /* Position to the sector following the run */
+      n += fh->current_sect;
+      fh->current_clus = clus;
+      fh->current_sect = ((n - 1) % fh->vol->cfg.SecPerClus) + 1;
+      continue;
+    }
+
     /* Try to cache current cluster. */
     if (read_cache (fh->vol, sect, fh->vol->cfg.SecPerClus - fh->current_sect) == false) {
       /* Read error */
       return (-(int32_t)fsDriverError);
     }
+    cached = true;
 
     rlen = len - nr;
-    if ((rlen + pos) > 512) {
-      rlen = 512 - pos;
+    if ((rlen + pos) > fh->vol->cfg.BytesPerSec) {
+      rlen = fh->vol->cfg.BytesPerSec - pos;
     }
 
     memcpy (&buf[nr], &fh->vol->ca.buf[pos], rlen);
-    pos = (pos + rlen) & 0x1FF;
+    pos = (pos + rlen) & (fh->vol->cfg.BytesPerSec - 1U);
     if (pos == 0) {
       /* Current sector complete, get next one. */
       fh->current_sect++;
@@ -5136,6 +7045,11 @@ __WEAK int32_t fat_read (int32_t handle, uint8_t *buf, uint32_t len) {
   }
   fh->fpos += nr;
 
+  if (cached) {
+    /* Sequential read through cache, prefetch following sectors */
+    io_read_ahead (fh);
+  }
+
   /* Return number of characters read. */
   return ((int32_t)nr);
 }
@@ -5153,7 +7067,7 @@ __WEAK int32_t fat_read (int32_t handle, uint8_t *buf, uint32_t len) {
 __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
   fsFAT_Handle *fh;
   fsStatus status;
-  uint32_t sect,pos,cnt,wlen,clus,sz;
+  uint32_t sect,pos,cnt,wlen,clus,sz,n;
 
   EvrFsFAT_FileWrite (handle, buf, len);
 
@@ -5198,7 +7112,7 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
 
   if (fh->flags & (FAT_HANDLE_PLUS | FAT_HANDLE_SEEK)) {
     fh->flags &= ~FAT_HANDLE_SEEK;
-    sz = 512;
+    sz = fh->vol->cfg.BytesPerSec;
   }
   else {
     sz = 0;
@@ -5212,6 +7126,8 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
     }
     fh->current_clus = fh->first_clus;
     fh->current_sect = 0;
+
+    ext_reset (fh);
   }
 
   cnt = 0;
@@ -5227,21 +7143,21 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
       /* This cluster is filled, get next one. */
       if (fh->fpos < fh->fcsz) {
         /* Cluster is already allocated */
-        if (alloc_table_read (fh->current_clus, &fh->current_clus, fh->vol) == false) {
+        if (ext_next (fh, fh->fpos / fh->vol->cfg.ClusSize, &fh->current_clus) == false) {
           /* Read error */
           return (-(int32_t)fsDriverError);
         }
       }
       else {
-        clus = fh->current_clus;
-        /* Allocate a free cluster and link it to chain */
-        if (alloc_clus (&fh->current_clus, fh->vol) == false) {
+        /* Use preallocated cluster or allocate a free one */
+        status = ext_next_alloc (fh, fh->fpos / fh->vol->cfg.ClusSize, &fh->current_clus);
+        if (status == fsNoFreeSpace) {
           /* Out of free space, return number of bytes written */
           break;
         }
-        if (link_clus (clus, fh->current_clus, fh->vol) == false) {
-          /* Write error */
-          return (-(int32_t)fsDriverError);
+        if (status != fsOK) {
+          /* Read or write error */
+          return (-(int32_t)status);
         }
       }
       fh->current_sect = 0;
@@ -5249,11 +7165,35 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
     sect = clus_to_sect (&fh->vol->cfg, fh->current_clus) + fh->current_sect;
 
     /* Calculate write-length for the sector. */
-    pos  = fh->fpos & 0x1FF;
+    pos  = fh->fpos & (fh->vol->cfg.BytesPerSec - 1U);
     wlen = len - cnt;
 
-    if ((pos + wlen) > 512) {
-      wlen = 512 - pos;
+    if ((pos == 0U) && (wlen >= fh->vol->cfg.BytesPerSec) && (((uint32_t)&buf[cnt] & 3U) == 0U) && (fh->vol->DirectIO != 0U)) {
+      /* Sector aligned transfer, write whole sectors directly from user buffer */
+      n = wlen / fh->vol->cfg.BytesPerSec;
+      if (n > ((0xFFFFFFFE - fh->fpos) / fh->vol->cfg.BytesPerSec)) {
+        n = (0xFFFFFFFE - fh->fpos) / fh->vol->cfg.BytesPerSec;
+      }
+      if (n > 0U) {
+        if (clus_run (fh, fh->fpos / fh->vol->cfg.ClusSize, n, true, &clus, &n) == false) {
+          return (-(int32_t)fsDriverError);
+        }
+        if (write_direct (fh->vol, sect, &buf[cnt], n) == false) {
+          /* Write error */
+          return (-(int32_t)fsDriverError);
+        }
+        cnt      += n * fh->vol->cfg.BytesPerSec;
+        fh->fpos += n * fh->vol->cfg.BytesPerSec;
+        /* Position to the sector following the run */
+        n += fh->current_sect;
+        fh->current_clus = clus;
+        fh->current_sect = ((n - 1) % fh->vol->cfg.SecPerClus) + 1;
+        continue;
+      }
+    }
+
+    if ((pos + wlen) > fh->vol->cfg.BytesPerSec) {
+      wlen = fh->vol->cfg.BytesPerSec - pos;
     }
 
     if (fh->fpos > (0xFFFFFFFE - wlen)) {
@@ -5261,7 +7201,7 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
     }
 
     if ((pos != 0U) || (wlen < sz)) {
-      /* File position not 512-byte aligned. */
+      /* File position not sector aligned. */
       if (read_sector (fh->vol, sect) == false) {
         /* Read error */
         return (-(int32_t)fsDriverError);
@@ -5279,7 +7219,7 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
     cnt      += wlen;
     fh->fpos += wlen;
 
-    if ((fh->fpos & 0x1FF) == 0U) {
+    if ((fh->fpos & (fh->vol->cfg.BytesPerSec - 1U)) == 0U) {
       /* Current sector is full, use next one. */
       fh->current_sect++;
     }
@@ -5290,6 +7230,11 @@ __WEAK int32_t fat_write (int32_t handle, const uint8_t *buf, uint32_t len) {
     fh->fcsz = fh->fpos;
   }
 
+  if ((fh->vol->ca.wmark != 0U) && (fh->vol->ca.nwr >= fh->vol->ca.wmark)) {
+    /* Write buffered data in the background */
+    fs_io_thread_signal ();
+  }
+
   return ((int32_t)cnt);
 }
 
@@ -5366,7 +7311,7 @@ __WEAK int32_t fat_flen (int32_t handle) {
 __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
   fsFAT_Handle *fh;
   fsStatus      stat;
-  uint32_t i, cnt, clus, link;
+  uint32_t i, n, cnt, clus, link;
   uint32_t offs, wlen, len;
   uint8_t sect;
   uint32_t pos;
@@ -5428,30 +7373,46 @@ __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
       if (clear_clus (fh->first_clus, fh->vol) == false) {
         return -(int64_t)(fsDriverError);
       }
+      ext_reset (fh);
       clus = fh->first_clus;
+      sect = 0;
     }
     else {
-      if (follow_clus (&fh->current_clus, &link, get_EOC(fh->vol->cfg.FatType), fh->vol) == false) {
+      /* Get the cluster at the end of file, chain may continue past it */
+      n = (fh->fcsz == 0) ? 0 : ((fh->fcsz - 1) / fh->vol->cfg.ClusSize);
+      if (ext_get (fh, n, &clus) == false) {
         /* R/W error */
         return -(int64_t)(fsDriverError);
       }
-      clus = fh->current_clus;
+      if ((fh->fcsz != 0) && ((fh->fcsz % fh->vol->cfg.ClusSize) == 0)) {
+        /* Last cluster is full */
+        sect = fh->vol->cfg.SecPerClus;
+      }
+      else {
+        sect = (fh->fcsz / fh->vol->cfg.BytesPerSec) % fh->vol->cfg.SecPerClus;
+      }
     }
 
-    sect = (fh->fcsz / 512) % fh->vol->cfg.SecPerClus;
-    offs = fh->fcsz & 0x1FF;
+    offs = fh->fcsz & (fh->vol->cfg.BytesPerSec - 1U);
     len  = pos - fh->fcsz;
 
     for (cnt = 0; cnt < len; cnt += wlen) {
+      if (sect == fh->vol->cfg.SecPerClus) {
+        /* This cluster is filled, use preallocated cluster or allocate a free one */
+        if (ext_next_alloc (fh, (fh->fcsz + cnt) / fh->vol->cfg.ClusSize, &clus) != fsOK) {
+          return -(int64_t)(fsError);
+        }
+        sect = 0;
+      }
       i = clus_to_sect (&fh->vol->cfg, clus) + sect;
 
       wlen = len - cnt;
-      if ((wlen + offs) > 512) {
-        wlen = 512 - offs;
+      if ((wlen + offs) > fh->vol->cfg.BytesPerSec) {
+        wlen = fh->vol->cfg.BytesPerSec - offs;
       }
 
       if (offs) {
-        /* File position not 512-byte aligned. */
+        /* File position not sector aligned. */
         if (read_sector (fh->vol, i) == false) {
           return -(int64_t)(fsError);
         }
@@ -5462,22 +7423,10 @@ __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
         return -(int64_t)(fsError);
       }
 
-      offs = (offs + wlen) & 0x1FF;
+      offs = (offs + wlen) & (fh->vol->cfg.BytesPerSec - 1U);
       if (offs == 0) {
         /* Current sector is full, use next one. */
         sect++;
-
-        if (sect == fh->vol->cfg.SecPerClus) {
-          /* Allocate a free cluster and link it to chain */
-          if (alloc_clus (&link, fh->vol) == false) {
-            return -(int64_t)(fsError);
-          }
-          if (link_clus (clus, link, fh->vol) == false) {
-            return -(int64_t)(fsError);
-          }
-          clus = link;
-          sect = 0;
-        }
       }
     }
     fh->fcsz += len;
@@ -5485,32 +7434,35 @@ __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
   else /* if (pos <= fh->fcsz) */ {
     fh->flags |= FAT_HANDLE_SEEK;
 
-    if (pos < fh->fpos) {
-      /* Scan the cluster chain from the first cluster */
-      clus = fh->first_clus;
-      cnt  = pos / fh->vol->cfg.ClusSize;
-    }
-    else /* if (pos > fh->fpos) */ {
-      /* Scan the cluster chain from current cluster */
-      clus = fh->current_clus;
-      i    = fh->fpos & ~(fh->vol->cfg.ClusSize-1);
-      cnt  = (pos - i) / fh->vol->cfg.ClusSize;
+    /* File cluster index of the new position */
+    cnt = pos / fh->vol->cfg.ClusSize;
 
+    /* Scan the cluster chain from the closest cluster in extent map */
+    i = ext_find (fh, cnt, &clus);
+
+    if ((pos > fh->fpos) && (fh->current_clus >= 2)) {
+      /* Current cluster may be closer */
+      n = fh->fpos / fh->vol->cfg.ClusSize;
       if (fh->current_sect == fh->vol->cfg.SecPerClus) {
-        /* Current sector is out of bound, load next cluster */
-        if (alloc_table_read (clus, &clus, fh->vol) == false) {
-          return -(int64_t)(fsError);
-        }
+        /* Current position is at the end of current cluster */
+        n--;
+      }
+      if (n > i) {
+        i    = n;
+        clus = fh->current_clus;
       }
     }
 
     link = clus;
 
-    for (i = cnt; i; i--) {
+    for (; i < cnt; i++) {
       link = clus;
-      if (alloc_table_read (link, &clus, fh->vol) == false) {
+      if (ext_next (fh, i + 1, &clus) == false) {
         return -(int64_t)(fsError);
       }
+      if (clus == get_EOC(fh->vol->cfg.FatType)) {
+        break;
+      }
     }
 
     if (clus == get_EOC(fh->vol->cfg.FatType)) {
@@ -5518,7 +7470,7 @@ __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
       clus = link;
     }
     else {
-      sect = (pos / 512) % fh->vol->cfg.SecPerClus;
+      sect = (pos / fh->vol->cfg.BytesPerSec) % fh->vol->cfg.SecPerClus;
     }
   }
   /* Set new position */
@@ -5530,6 +7482,236 @@ __WEAK int64_t fat_seek (int32_t handle, int64_t offset, int32_t whence) {
 }
 
 
+/**
+  Preallocate space for a file.
+
+  Clusters are linked to the end of the file cluster chain without changing
+  the file size, following writes use them without any cluster allocation.
+  Allocation table is scanned for a contiguous run of free clusters starting
+  with the cluster that follows the end of the chain. When no run is large
+  enough, free clusters are allocated one by one.
+
+  \param[in]  handle                    file handle
+  \param[in]  size                      number of bytes to reserve from the start of the file
+  \param[in]  flags                     allocate flags (FS_FALLOC_KEEP, FS_FALLOC_RELEASE)
+  \return     execution status \ref fsStatus
+*/
+__WEAK fsStatus fat_allocate (int32_t handle, uint32_t size, uint32_t flags) {
+  fsFAT_Handle *fh;
+  fsFAT_Volume *vol;
+  fsStatus      stat;
+  uint32_t i, n, cnt, fidx, clus, last, link;
+
+  if ((handle < 0) || (handle >= fs_fat_fh_cnt)) {
+    /* Invalid parameter: handle number out of range */
+    EvrFsFAT_FileHandleInvalid (handle);
+    return (fsInvalidParameter);
+  }
+
+  fh  = &fs_fat_fh[handle];
+  vol = fh->vol;
+
+  if ((fh->flags & FAT_HANDLE_ERROR) || !(fh->flags & FAT_HANDLE_OPEN)) {
+    /* Handle error or file not opened */
+    EvrFsFAT_FileHandleError (handle, fh->flags);
+    return (fsError);
+  }
+
+  if ((fh->flags & FAT_HANDLE_MODES) == FAT_HANDLE_READ) {
+    /* Only opened for read */
+    EvrFsFAT_FileModeRead (handle);
+    return (fsAccessDenied);
+  }
+
+  stat = fat_vol_chk (FAT_STATUS_REMOVABLE | FAT_STATUS_READY | FAT_STATUS_MOUNT, vol);
+  if (stat != fsOK) {
+    fh->flags |= FAT_HANDLE_ERROR;
+    return (stat);
+  }
+
+  if ((vol->Status & FAT_STATUS_WRITE) == 0) {
+    /* Write protection is active */
+    EvrFsFAT_VolumeWriteStatError (vol->DrvLet);
+    return (fsAccessDenied);
+  }
+
+  if (flags & FS_FALLOC_RELEASE) {
+    fh->flags |= FAT_HANDLE_FREE;
+  }
+  else {
+    fh->flags &= ~FAT_HANDLE_FREE;
+  }
+
+  /* Number of clusters required */
+  cnt = size / vol->cfg.ClusSize;
+  if (size % vol->cfg.ClusSize) {
+    cnt++;
+  }
+
+  /* Find the end of the cluster chain */
+  fidx = 0;
+  last = 0;
+  if (fh->first_clus != 0) {
+    i = ext_find (fh, 0xFFFFFFFF, &last);
+    for (;;) {
+      link = last;
+      if (ext_next (fh, i + 1, &link) == false) {
+        return (fsDriverError);
+      }
+      if (link >= (vol->cfg.DataClusCnt + 2)) {
+        /* End of chain */
+        break;
+      }
+      if (link < 2) {
+        /* Cluster chain corrupted */
+        return (fsError);
+      }
+      last = link;
+      i++;
+    }
+    fidx = i + 1;
+  }
+
+  if (fidx >= cnt) {
+    /* Space already allocated */
+    return (fsOK);
+  }
+  cnt -= fidx;
+
+  if ((vol->Status & FAT_STATUS_FREECNT) && (vol->free_clus_cnt < cnt)) {
+    /* Not enough free clusters */
+    EvrFsFAT_DiskFull (vol->DrvLet);
+    return (fsNoFreeSpace);
+  }
+  fh->flags |= FAT_HANDLE_DATA_WR;
+
+  /* Search for contiguous run, preferably directly after the chain */
+  if (find_free_run ((last != 0) ? (last + 1) : vol->free_clus, cnt, &clus, vol) == false) {
+    return (fsDriverError);
+  }
+
+  if (clus != 0) {
+    /* Link the run in reverse order, chain is extended at the end */
+    link = get_EOC (vol->cfg.FatType);
+    for (i = cnt; i > 0; i--) {
+      if (alloc_table_write (clus + i - 1, link, vol) == false) {
+        return (fsDriverError);
+      }
+      link = clus + i - 1;
+    }
+    if (vol->free_clus == clus) {
+      vol->free_clus = clus + cnt;
+    }
+    if (vol->Status & FAT_STATUS_FREECNT) {
+      vol->free_clus_cnt -= cnt;
+    }
+    if (vol->cfg.FatType == FS_FAT32) {
+      vol->Status |= FAT_STATUS_FSINFO;
+    }
+    n = cnt;
+  }
+  else {
+    /* Allocate the first free cluster, the rest is linked one by one */
+    if (alloc_clus (&clus, vol) == false) {
+      return (fsNoFreeSpace);
+    }
+    n = 1;
+  }
+
+  if (last == 0) {
+    /* File was empty */
+    fh->first_clus   = clus;
+    fh->current_clus = clus;
+    fh->current_sect = 0;
+    ext_reset (fh);
+  }
+  else {
+    if (link_clus (last, clus, vol) == false) {
+      return (fsDriverError);
+    }
+  }
+  for (i = 0; i < n; i++) {
+    ext_add (fh, fidx + i, clus + i);
+  }
+  EvrFsFAT_FileAllocate (handle, clus, n);
+
+  last  = clus + n - 1;
+  fidx += n;
+
+  for (cnt -= n; cnt > 0; cnt--) {
+    if (alloc_clus (&clus, vol) == false) {
+      return (fsNoFreeSpace);
+    }
+    if (link_clus (last, clus, vol) == false) {
+      return (fsDriverError);
+    }
+    ext_add (fh, fidx, clus);
+    EvrFsFAT_FileAllocate (handle, clus, 1);
+
+    last = clus;
+    fidx++;
+  }
+  return (fsOK);
+}
+
+
+/**
+  Run background I/O requests of all FAT volumes.
+
+  Function is called from the background I/O worker thread. Buffered write
+  data is written to the media when the write-behind watermark is reached
+  and requested read-ahead sectors are loaded into the data cache.
+  Volume mutex is held during the transfer, fat_flush therefore still
+  writes all buffered data before it returns.
+*/
+__WEAK void fat_io_run (void) {
+  fsFAT_Volume *vol;
+  uint32_t i;
+
+  for (i = 0; i < fs_ndrv; i++) {
+    if ((fs_DevPool[i].attr & FS_FAT) == 0U) {
+      continue;
+    }
+    vol = (fsFAT_Volume *)fs_DevPool[i].dcb;
+
+    if ((vol->ca.nra == 0U) && ((vol->ca.wmark == 0U) || (vol->ca.nwr < vol->ca.wmark))) {
+      /* No pending request */
+      continue;
+    }
+    if (fs_mutex_acquire (vol->Mutex) != 0U) {
+      continue;
+    }
+
+    if ((vol->Status & (FAT_STATUS_READY | FAT_STATUS_MOUNT)) == (FAT_STATUS_READY | FAT_STATUS_MOUNT)) {
+      if ((vol->ca.wmark != 0U) && (vol->ca.nwr >= vol->ca.wmark)) {
+        /* Write-behind: write buffered sectors, error is reported on next flush */
+        EvrFsFAT_IoWriteBehind (vol->DrvLet, vol->ca.csect, vol->ca.nwr);
+        (void)write_cache (vol, 0);
+      }
+
+      if ((vol->ca.nra != 0U) && (vol->ca.nwr == 0U)) {
+        if ((vol->ca.nrd == 0U) || (vol->ca.rasect <  vol->ca.csect)
+                                || (vol->ca.rasect >= (vol->ca.csect + vol->ca.nrd))) {
+          /* Read-ahead: load following file sectors into data cache */
+          EvrFsFAT_IoReadAhead (vol->DrvLet, vol->ca.rasect, vol->ca.nra);
+
+          if (jour_read (vol, vol->ca.rasect, vol->ca.cbuf, vol->ca.nra) == true) {
+            vol->ca.csect = vol->ca.rasect;
+            vol->ca.nrd   = vol->ca.nra;
+          }
+          else {
+            vol->ca.nrd = 0;
+          }
+        }
+      }
+    }
+    vol->ca.nra = 0;
+
+    (void)fs_mutex_release (vol->Mutex);
+  }
+}
+
+
 /**
   Delete a file from requested directory.
 
@@ -5882,15 +8064,19 @@ __WEAK fsStatus fat_rename (const char *path, const char *newname, fsFAT_Volume
     status = path_open (&pinfo, vol);
 
     if (status == fsFileNotFound) {
+      /* New entry and removal of the old one are committed together */
+      vol->Status |= FAT_STATUS_JOURHOLD;
+
       /* Create new path */
       pinfo.fn_flags = 0;
       status = path_create (&pinfo, false, vol);
 
-      if (status == fsOK) {
+      if ((status == fsOK) && entry_read (&pinfo.frec.pos, &pinfo.sfne, vol)) {
         /* When path is created, frec.pos is already at SN entry!!! */
-        if (entry_read (&pinfo.frec.pos, &pinfo.sfne, vol)) {
-          return (fsError);
-        }
+        status = fsError;
+      }
+
+      if (status == fsOK) {
         /* Copy some data from the old entry */
         pinfo.sfne->Attr         = old_entry.Attr | FS_FAT_ATTR_ARCHIVE;
         pinfo.sfne->NTRsvd       = 0;
@@ -5906,14 +8092,21 @@ __WEAK fsStatus fat_rename (const char *path, const char *newname, fsFAT_Volume
         pinfo.sfne->FileSize     = old_entry.FileSize;
 
         if (entry_flush (&pinfo.frec.pos, vol)) {
-          return (fsError);
+          status = fsError;
         }
-        /* Delete old file record from the name cache */
-        if (elink_scan (hash, &el, vol->ncache) == 0) {
-          frec_delete_elink (&ent, vol);
+        else {
+          /* Delete old file record from the name cache */
+          if (elink_scan (hash, &el, vol->ncache) == 0) {
+            frec_delete_elink (&ent, vol);
+          }
+          /* Delete old file record */
+          status = frec_delete (&ent, vol);
         }
-        /* Delete old file record */
-        status = frec_delete (&ent, vol);
+      }
+      vol->Status &= ~FAT_STATUS_JOURHOLD;
+
+      if ((status == fsOK) && (jour_commit (vol) == false)) {
+        status = fsError;
       }
     }
     else if (status == fsOK) {
@@ -6244,7 +8437,7 @@ __WEAK fsStatus fat_info (fsDriveInfo *info, fsFAT_Volume *vol) {
           status = fsError;
           break;
       }
-      info->capacity = (uint64_t)vol->cfg.DskSize * 512;
+      info->capacity = (uint64_t)vol->cfg.DskSize * vol->cfg.BytesPerSec;
     }
   }
 
@@ -6252,6 +8445,100 @@ __WEAK fsStatus fat_info (fsDriveInfo *info, fsFAT_Volume *vol) {
 }
 
 
+/**
+  Reclaim invalidated space on the drive media in one step.
+
+  FAT does not track invalidated media space itself, the step is done by
+  the media driver (NAND flash translation layer). It runs in the context
+  of the caller, so the application decides when and at which priority
+  the work is done. Drivers without such work return fsUnsupported.
+
+  \param[in]  vol                       volume description structure
+  \return     number of erased blocks or execution status
+                - value >= 0: number of erased blocks ready for writing
+                - value < 0:  error occurred, -value is execution status as defined with \ref fsStatus
+*/
+__WEAK int32_t fat_reclaim (fsFAT_Volume *vol) {
+  fsStatus status;
+  uint32_t cnt;
+
+  status = fat_vol_chk (FAT_STATUS_READY | FAT_STATUS_MOUNT | FAT_STATUS_WRITE, vol);
+
+  if (status == fsOK) {
+    /* Let the media driver reclaim invalidated space */
+    status = vol->Drv->DeviceCtrl (fsDevCtrlCodeReclaim, &cnt);
+  }
+
+  if (status != fsOK) {
+    return (-(int32_t)status);
+  }
+  return ((int32_t)cnt);
+}
+
+
+/**
+  Discard all free clusters on the drive media.
+
+  \param[in]  vol                       volume description structure
+  \return     execution status \ref fsStatus
+*/
+__WEAK fsStatus fat_trim (fsFAT_Volume *vol) {
+  fsStatus status;
+  uint32_t clus, link, first, cnt, sect;
+
+  status = fat_vol_chk (FAT_STATUS_READY | FAT_STATUS_MOUNT | FAT_STATUS_WRITE, vol);
+
+  if (status != fsOK) {
+    return (status);
+  }
+
+  /* Write allocation table, pending discards are issued as well */
+  if (flush_fat (vol) == false) {
+    return (fsError);
+  }
+
+  if (vol->Status & FAT_STATUS_NODISCARD) {
+    return (fsUnsupported);
+  }
+
+  cnt   = 0U;
+  first = 0U;
+  clus  = 2U;
+  while (clus < (vol->cfg.DataClusCnt + 2U)) {
+    link = 1U;
+
+    if (fmap_full (vol, clus)) {
+      /* Skip group with all clusters allocated */
+      clus = ((clus >> vol->fmap.shift) + 1U) << vol->fmap.shift;
+    }
+    else {
+      if (alloc_table_read (clus, &link, vol) == false) {
+        return (fsError);
+      }
+      if (link == 0U) {
+        if (cnt == 0U) {
+          first = clus;
+        }
+        cnt++;
+      }
+      clus++;
+    }
+
+    if ((cnt != 0U) && ((link != 0U) || (clus >= (vol->cfg.DataClusCnt + 2U)))) {
+      /* End of free cluster run */
+      sect   = clus_to_sect (&vol->cfg, first);
+      status = disc_sect (vol, sect, cnt * vol->cfg.SecPerClus);
+      if (status != fsOK) {
+        return (status);
+      }
+      cnt = 0U;
+    }
+  }
+
+  return (fsOK);
+}
+
+
 /**
   Change working directory.
 
@@ -6514,6 +8801,10 @@ __WEAK fsStatus fat_attrib (fsFAT_Volume *vol, const char *path, uint32_t attrib
 
     /* Write updated short entry */
     status = entry_flush (&pinfo.frec.pos, vol);
+
+    if ((status == fsOK) && (jour_commit (vol) == false)) {
+      status = fsError;
+    }
   }
 
 #ifdef FS_DEBUG
@@ -6541,11 +8832,14 @@ __WEAK int64_t fat_free (fsFAT_Volume *vol) {
   status = fat_vol_chk (FAT_STATUS_READY | FAT_STATUS_MOUNT, vol);
 
   if (status == fsOK) {
-    if (vol->cfg.FatType != FS_FAT32) {
-      /* Count free clusters only for FAT12 and FAT16 */
+    if ((vol->Status & FAT_STATUS_FREECNT) == 0) {
+      /* Count free clusters, count is then maintained on allocation */
       if (count_free_clus (&vol->free_clus_cnt, vol) == false) {
         status = fsDriverError;
       }
+      else {
+        vol->Status |= FAT_STATUS_FREECNT;
+      }
     }
   }
 
@@ -6652,6 +8946,9 @@ __WEAK fsStatus fat_time_set (const char *path, fsTime *create, fsTime *access,
     if (entry_flush (&pinfo.frec.pos, vol)) {
       status = fsError;
     }
+    else if (jour_commit (vol) == false) {
+      status = fsError;
+    }
   }
 
   return (status);
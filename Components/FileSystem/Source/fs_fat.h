@@ -21,6 +21,9 @@
 #define FAT_STATUS_JOURACT    0x00000040U   /* FS journal is active           */
 #define FAT_STATUS_JOURERR    0x00000080U   /* FS journal error               */
 #define FAT_STATUS_FSINFO     0x00000100U   /* FSINFO structure updated       */
+#define FAT_STATUS_FREECNT    0x00000200U   /* Free cluster count valid       */
+#define FAT_STATUS_NODISCARD  0x00000400U   /* Media does not support discard */
+#define FAT_STATUS_JOURHOLD   0x00000800U   /* FS journal commit deferred     */
 
 #define FAT_STATUS_MASK      (FAT_STATUS_INIT_IO    | \
                               FAT_STATUS_INIT_MEDIA | \
@@ -30,7 +33,10 @@
                               FAT_STATUS_REMOVABLE  | \
                               FAT_STATUS_JOURACT    | \
                               FAT_STATUS_JOURERR    | \
-                              FAT_STATUS_FSINFO     )
+                              FAT_STATUS_FSINFO     | \
+                              FAT_STATUS_FREECNT    | \
+                              FAT_STATUS_NODISCARD  | \
+                              FAT_STATUS_JOURHOLD   )
 
 /* FAT File Handle Flags */
 #define FAT_HANDLE_READ       0x0001    /* File opened for read               */
@@ -41,6 +47,9 @@
 #define FAT_HANDLE_DATA_RD    0x0020    /* File data was read                 */
 #define FAT_HANDLE_DATA_WR    0x0040    /* File data was written              */
 #define FAT_HANDLE_SEEK       0x0080    /* Seek performed                     */
+#define FAT_HANDLE_FREE       0x0100    /* Release preallocated clusters      */
+#define FAT_HANDLE_XFER       0x0200    /* Chunked transfer in progress       */
+#define FAT_HANDLE_CLOSE      0x0400    /* Handle mutex waiters being released*/
 
 /* FAT File Handle Flag Masks */
 #define FAT_HANDLE_OPEN      (FAT_HANDLE_READ   | \
@@ -90,6 +99,14 @@
 #define ACT_NONE    0x00
 #define ACT_USEJOUR 0x01
 
+/* Directory Index states */
+#define DIDX_STATE_NONE       0         /* Index not built                    */
+#define DIDX_STATE_READY      1         /* Index complete for directory       */
+#define DIDX_STATE_OVERFLOW   2         /* Directory too large for the index  */
+
+/* Directory Index end of chain */
+#define DIDX_NIL              0xFFFFU
+
 /* Entry position set commands */
 #define ENTRY_POS_INCREMENT 0
 #define ENTRY_POS_CURRENT   1
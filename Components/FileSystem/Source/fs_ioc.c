@@ -185,7 +185,7 @@ fsStatus fs_ioc_get_cache (int32_t drv_id, fsIOC_Cache *cache_info) {
     vol = (fsFAT_Volume *)fs_DevPool[drv_id].dcb;
 
     cache_info->buffer = (uint8_t *)vol->CaBuf;
-    cache_info->size   = (vol->CaSize + 2U) * 512U;
+    cache_info->size   = vol->ca.cbsz + (2U * fs_fat_sect_max);
 
     EvrFsIOC_GetCacheSuccess (drv_id, (uint32_t)cache_info->buffer, cache_info->size);
     status = fsOK;
@@ -1,6 +1,6 @@
 /*------------------------------------------------------------------------------
  * MDK Middleware - Component ::File System
- * Copyright (c) 2004-2019 Arm Limited (or its affiliates). All rights reserved.
+ * Copyright (c) 2004-2024 Arm Limited (or its affiliates). All rights reserved.
  *------------------------------------------------------------------------------
  * Name:    fs_journal.c
  * Purpose: File System Journaling Implementation
@@ -18,13 +18,14 @@
  *        Set sector for the next journal transaction entry
  *  Parameters:
  *  fsj  - journal instance pointer
+ *  cnt  - number of sectors used by the current transaction
  *
  *  Returns: true if first sector of the next transaction was set
  *           false otherwise
  *----------------------------------------------------------------------------*/
-static uint32_t SetTrSect (FSJOUR *fsj) {
+static uint32_t SetTrSect (FSJOUR *fsj, uint32_t cnt) {
 
-  fsj->TrSect += JOUR_TR_SZ;
+  fsj->TrSect += cnt;
 
   if (fsj->FirstSect + fsj->JournSect - fsj->TrSect < JOUR_TR_SZ) {
     fsj->TrSect = fsj->FirstSect;
@@ -33,6 +34,47 @@ static uint32_t SetTrSect (FSJOUR *fsj) {
 }
 
 
+/*-----------------------------------------------------------------------------
+ *        Get number of journal sectors used by a transaction group
+ *        Group uses the slots of a single sector transaction (copy, footer and
+ *        end sector) followed by the remaining copies and is rounded up to
+ *        the transaction size, so that footers are always found at the same
+ *        offsets when journal is checked.
+ *  Parameters:
+ *  cnt  - number of sectors in the group
+ *
+ *  Returns: number of journal sectors
+ *----------------------------------------------------------------------------*/
+static uint32_t GrpExt (uint32_t cnt) {
+  return (((cnt + 2U + (JOUR_TR_SZ - 1U)) / JOUR_TR_SZ) * JOUR_TR_SZ);
+}
+
+
+/*-----------------------------------------------------------------------------
+ *        Get journal sector which holds a copy of the group sector
+ *  Parameters:
+ *  base - first sector of the transaction group
+ *  idx  - index of the sector in the group
+ *
+ *  Returns: journal sector number
+ *----------------------------------------------------------------------------*/
+static uint32_t GrpSlot (uint32_t base, uint32_t idx) {
+  return ((idx == 0U) ? (base) : (base + 2U + idx));
+}
+
+
+/*-----------------------------------------------------------------------------
+ *        Get maximum number of sectors that can be listed in a group footer
+ *  Parameters:
+ *  fsj  - journal instance pointer
+ *
+ *  Returns: number of sectors
+ *----------------------------------------------------------------------------*/
+static uint32_t GrpCap (FSJOUR *fsj) {
+  return ((fsj->SectSize - JOUR_GRP_HDR - 4U) / 8U);
+}
+
+
 /*-----------------------------------------------------------------------------
  *        Set new state
  *  Parameters:
@@ -69,7 +111,7 @@ static uint32_t SetBuf (FSJOUR *fsj, uint32_t sect, uint32_t rsec) {
   uint32_t mark;
 
   /* Clear buffer */
-  memset (fsj->buf, 0x00, __SECT_SZ);
+  memset (fsj->buf, 0x00, fsj->SectSize);
   
   /* Set 1st journal signature */
   set_u32 (&fsj->buf[0], JOUR_SIGN);
@@ -99,8 +141,8 @@ static uint32_t SetBuf (FSJOUR *fsj, uint32_t sect, uint32_t rsec) {
   /* Set redundant sector number */
   set_u32 (&fsj->buf[16], rsec);
 
-  /* Set 2nd journal signature */
-  set_u32 (&fsj->buf[508], JOUR_SIGN);
+  /* Set 2nd journal signature at the end of sector */
+  set_u32 (&fsj->buf[fsj->SectSize - 4], JOUR_SIGN);
 
   return (true);
 }
@@ -117,7 +159,7 @@ static uint32_t SetBuf (FSJOUR *fsj, uint32_t sect, uint32_t rsec) {
  *----------------------------------------------------------------------------*/
 static uint32_t CheckJSect (FSJOUR *fsj, JTR_EN *jen) {
   /* Check signatures */
-  if (get_u32 (&fsj->buf[0]) == JOUR_SIGN && get_u32 (&fsj->buf[508]) == JOUR_SIGN) {
+  if (get_u32 (&fsj->buf[0]) == JOUR_SIGN && get_u32 (&fsj->buf[fsj->SectSize - 4]) == JOUR_SIGN) {
     jen->TrId = get_u32 (&fsj->buf[4]);
     jen->Mark = get_u32 (&fsj->buf[8]);
     jen->Sect = get_u32 (&fsj->buf[12]);
@@ -143,6 +185,7 @@ static uint32_t CheckJourn (FSJOUR *fsj) {
   /* Check journal consistency */
   uint32_t co;
   uint32_t tr, sect;
+  uint32_t i, cnt;
   JTR_EN jen[2];
 
   uint32_t no_tr = fsj->JournSect / JOUR_TR_SZ;
@@ -167,15 +210,21 @@ static uint32_t CheckJourn (FSJOUR *fsj) {
         return (false);
       }
 
+      /* Number of journaled sectors */
+      cnt = (jen[0].Mark == JOUR_GRUP) ? jen[0].Sect : 1U;
+
+      if ((cnt == 0U) || (cnt > GrpCap (fsj)) || ((sect + GrpExt (cnt)) > (fsj->FirstSect + fsj->JournSect))) {
+        /* Invalid group footer, skip this transaction */
+        continue;
+      }
+
       /* Determine number of the last transaction */
       if ((fsj->TrId < jen[0].TrId) || (fsj->TrId == 0xFFFFFFFF && jen[0].TrId == 0)) {
         fsj->TrId = jen[0].TrId;
         
         /* Set sector number for the new transaction */
-        fsj->TrSect = sect + JOUR_TR_SZ;
-        if (tr == (no_tr - 1)) {
-          fsj->TrSect = fsj->FirstSect;
-        }
+        fsj->TrSect = sect;
+        SetTrSect (fsj, (jen[0].Mark == JOUR_GRUP) ? GrpExt (cnt) : JOUR_TR_SZ);
       }
       
       co = false;
@@ -191,24 +240,40 @@ static uint32_t CheckJourn (FSJOUR *fsj) {
       }
 
       if (co == true) {
-        /* Copy sector from journal to his place */
-        if (fsj->drv->ReadSect (sect, fsj->buf, 1) == false) {
-          /* Low level error */
-          return (false);
-        }
+        for (i = 0; i < cnt; i++) {
+          if (jen[0].Mark == JOUR_GRUP) {
+            /* Read sector numbers from the group footer */
+            if (fsj->drv->ReadSect (sect+1, fsj->buf, 1) == false) {
+              /* Low level error */
+              return (false);
+            }
+            jen[1].Sect = get_u32 (&fsj->buf[JOUR_GRP_HDR + (i * 8U)]);
+            jen[1].RSec = get_u32 (&fsj->buf[JOUR_GRP_HDR + (i * 8U) + 4U]);
+          }
+          else {
+            jen[1].Sect = jen[0].Sect;
+            jen[1].RSec = jen[0].RSec;
+          }
+
+          /* Copy sector from journal to his place */
+          if (fsj->drv->ReadSect (GrpSlot (sect, i), fsj->buf, 1) == false) {
+            /* Low level error */
+            return (false);
+          }
         
-        if (fsj->drv->WriteSect (jen[0].Sect, fsj->buf, 1) == false) {
-          /* Low level error */
-          return (false);
-        }
-
-        if (jen[0].RSec && fsj->drv->WriteSect (jen[0].RSec, fsj->buf, 1) == false) {
-          /* Low level error */
-          return (false);
+          if (fsj->drv->WriteSect (jen[1].Sect, fsj->buf, 1) == false) {
+            /* Low level error */
+            return (false);
+          }
+
+          if (jen[1].RSec && fsj->drv->WriteSect (jen[1].RSec, fsj->buf, 1) == false) {
+            /* Low level error */
+            return (false);
+          }
         }
         
         /* Restore done, clear journal entry */
-        memset (fsj->buf, 0, __SECT_SZ);
+        memset (fsj->buf, 0, fsj->SectSize);
         if (fsj->drv->WriteSect (sect+1, fsj->buf, 1) == false) {
           /* Low level error */
           return (false);
@@ -223,6 +288,59 @@ static uint32_t CheckJourn (FSJOUR *fsj) {
 }
 
 
+/*-----------------------------------------------------------------------------
+ *        Add sector to the open transaction group. Sector is written into its
+ *        group slot in the journal, original sector is written when the
+ *        group is committed. If group is full it is committed first.
+ *  Parameters:
+ *  fsj  - journal instance pointer
+ *  sect - sector number to be journaled
+ *  rsec - redundant sector number
+ *  buf  - sector buffer pointer
+ *
+ *  Returns: true if sector added to the group
+ *           false otherwise
+ *----------------------------------------------------------------------------*/
+static uint32_t GrpWrite (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *buf) {
+  uint32_t i;
+
+  /* Check if sector is already in the group */
+  for (i = 0; i < fsj->GrpCnt; i++) {
+    if (fsj->Grp[2*i] == sect) {
+      break;
+    }
+  }
+
+  if (i == fsj->GrpMax) {
+    /* Group full, commit it */
+    if (fsj_commit (fsj) == false) {
+      return (false);
+    }
+    i = 0;
+  }
+
+  if (fsj->GrpCnt == 0) {
+    /* New group, all its slots must fit into journal space */
+    if (fsj->FirstSect + fsj->JournSect - fsj->TrSect < GrpExt (fsj->GrpMax)) {
+      fsj->TrSect = fsj->FirstSect;
+    }
+  }
+
+  /* Write sector copy into its slot */
+  if (fsj->drv->WriteSect (GrpSlot (fsj->TrSect, i), buf, 1) == false) {
+    return (false);
+  }
+
+  if (i == fsj->GrpCnt) {
+    /* Add sector to the group */
+    fsj->Grp[2*i]   = sect;
+    fsj->Grp[2*i+1] = rsec;
+    fsj->GrpCnt++;
+  }
+  return (true);
+}
+
+
 /*-----------------------------------------------------------------------------
  *        Set first sector number and number of sectors available to journal.
  *        Journal will be written in contiguous space starting from start_sect
@@ -274,6 +392,11 @@ __WEAK uint32_t fsj_write (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *b
     return (false);
   }
 
+  if (fsj->GrpMax != 0) {
+    /* Add sector to the transaction group */
+    return (GrpWrite (fsj, sect, rsec, buf));
+  }
+
   jour_sect = fsj->TrSect;
   do {
     /* Change state */
@@ -327,7 +450,7 @@ __WEAK uint32_t fsj_write (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *b
   while (fsj->State != JST_TEND);
 
   /* Set sector for the next transaction */
-  if (SetTrSect (fsj) == false) {
+  if (SetTrSect (fsj, JOUR_TR_SZ) == false) {
     /* Sector fot the next journal transaction can not be obtained */
     return (false);
   }
@@ -339,6 +462,96 @@ __WEAK uint32_t fsj_write (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *b
 }
 
 
+/*-----------------------------------------------------------------------------
+ *        Find sector in the open transaction group.
+ *  Parameters:
+ *  fsj  - journal instance pointer
+ *  sect - sector number (original or redundant)
+ *
+ *  Returns: journal sector with the current sector content
+ *           0 if sector is not in the group
+ *----------------------------------------------------------------------------*/
+__WEAK uint32_t fsj_find (FSJOUR *fsj, uint32_t sect) {
+  uint32_t i;
+
+  for (i = 0; i < fsj->GrpCnt; i++) {
+    if ((fsj->Grp[2*i] == sect) || ((fsj->Grp[2*i+1] != 0) && (fsj->Grp[2*i+1] == sect))) {
+      return (GrpSlot (fsj->TrSect, i));
+    }
+  }
+  return (0);
+}
+
+
+/*-----------------------------------------------------------------------------
+ *        Commit the open transaction group. Footer with the list of grouped
+ *        sectors is written into the journal, grouped sectors are then
+ *        copied from the journal to their place and transaction is marked
+ *        as completed.
+ *  Parameters:
+ *  fsj  - journal instance pointer
+ *
+ *  Returns: true if group committed or there was nothing to commit
+ *           false otherwise
+ *----------------------------------------------------------------------------*/
+__WEAK uint32_t fsj_commit (FSJOUR *fsj) {
+  uint32_t i, cnt;
+
+  cnt = fsj->GrpCnt;
+
+  if (cnt == 0) {
+    /* No open group */
+    return (true);
+  }
+
+  /* Set group footer */
+  fsj->State = JST_FOOT;
+  SetBuf (fsj, cnt, 0);
+  set_u32 (&fsj->buf[8], JOUR_GRUP);
+
+  for (i = 0; i < cnt; i++) {
+    set_u32 (&fsj->buf[JOUR_GRP_HDR + (i * 8U)],      fsj->Grp[2*i]);
+    set_u32 (&fsj->buf[JOUR_GRP_HDR + (i * 8U) + 4U], fsj->Grp[2*i+1]);
+  }
+
+  /* Write footer, group is committed */
+  if (fsj->drv->WriteSect (fsj->TrSect + 1, fsj->buf, 1) == false) {
+    return (false);
+  }
+
+  for (i = 0; i < cnt; i++) {
+    /* Copy sector from the journal to its place */
+    if (fsj->drv->ReadSect (GrpSlot (fsj->TrSect, i), fsj->buf, 1) == false) {
+      return (false);
+    }
+    /* Write redundant sector first */
+    if (fsj->Grp[2*i+1] && fsj->drv->WriteSect (fsj->Grp[2*i+1], fsj->buf, 1) == false) {
+      return (false);
+    }
+    if (fsj->drv->WriteSect (fsj->Grp[2*i], fsj->buf, 1) == false) {
+      return (false);
+    }
+  }
+
+  /* Write end sector */
+  fsj->State = JST_TEND;
+  SetBuf (fsj, fsj->Grp[0], fsj->Grp[1]);
+
+  if (fsj->drv->WriteSect (fsj->TrSect + 2, fsj->buf, 1) == false) {
+    return (false);
+  }
+  fsj->GrpCnt = 0;
+
+  /* Set sector for the next transaction */
+  SetTrSect (fsj, GrpExt (cnt));
+
+  /* Increment transaction identifier */
+  fsj->TrId++;
+
+  return (true);
+}
+
+
 /*-----------------------------------------------------------------------------
  *        Init file system journal
  *        After successful init, journal is in JST_IDLE state.
@@ -358,8 +571,25 @@ __WEAK uint32_t fsj_init (FSJOUR *fsj, FAT_DRV *drv) {
     return (false);
   }
 
+  if (fsj->SectSize == 0) {
+    /* Sector size not set, use default */
+    fsj->SectSize = __SECT_SZ;
+  }
+
   fsj->TrId   = 0;                                /* Init transaction Id      */
   fsj->TrSect = fsj->FirstSect;                   /* Init itransaction sector */
+
+  /* Limit group size to the footer capacity and journal space */
+  if (fsj->Grp == NULL) {
+    fsj->GrpMax = 0;
+  }
+  if (fsj->GrpMax > GrpCap (fsj)) {
+    fsj->GrpMax = (uint8_t)GrpCap (fsj);
+  }
+  while ((fsj->GrpMax != 0) && (GrpExt (fsj->GrpMax) > fsj->JournSect)) {
+    fsj->GrpMax--;
+  }
+  fsj->GrpCnt = 0;
   
   fsj->State   = JST_IDLE;
   fsj->Status |= JSF_INIT;
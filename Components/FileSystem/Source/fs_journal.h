@@ -15,10 +15,12 @@
 #define JOUR_SIGN     0x4B46534A    /* "KFSJ" */
 #define JOUR_FOOT     0x464F4F54    /* "FOOT" */
 #define JOUR_TEND     0x54454E44    /* "TEND" */
+#define JOUR_GRUP     0x47525550    /* "GRUP" */
      
 #define JOUR_TR_SZ    3             /* Journal transaction size in sectors    */
+#define JOUR_GRP_HDR  20            /* Group footer header size in bytes      */
 
-#define __SECT_SZ 512
+#define __SECT_SZ     512           /* Default sector size in bytes           */
 
 /* Journal entry type */
 #define JTYP_DEN    0 /* Directory entries */
@@ -48,6 +50,8 @@ typedef struct journal_entry {
 /* Functions */
 extern uint32_t fsj_set_space (FSJOUR *fsj, uint32_t start_sect, uint32_t cnt);
 extern uint32_t fsj_write     (FSJOUR *fsj, uint32_t sect, uint32_t rsec, uint8_t *buf);
+extern uint32_t fsj_find      (FSJOUR *fsj, uint32_t sect);
+extern uint32_t fsj_commit    (FSJOUR *fsj);
 extern uint32_t fsj_init      (FSJOUR *fsj, FAT_DRV *drv);
 
 #endif /* FS_JOURNAL_H__ */
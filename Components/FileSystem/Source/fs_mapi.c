@@ -151,6 +151,7 @@ fsStatus finit (const char *drive) {
                 - fsOK               = Operation successful.
                 - fsInvalidParameter = Input parameter invalid.
                 - fsInvalidDrive     = Nonexistent drive letter specified.
+                - fsAccessDenied     = File transfer in progress on the drive.
                 - fsError            = System resource delete failed.
 */
 fsStatus funinit (const char *drive) {
@@ -239,6 +240,7 @@ fsStatus fmount (const char *drive) {
                 - fsOK               = Operation successful.
                 - fsInvalidParameter = Input parameter invalid.
                 - fsInvalidDrive     = Nonexistent drive letter specified.
+                - fsAccessDenied     = File transfer in progress on the drive.
 */
 fsStatus funmount (const char *drive) {
   FS_DEV  *dev;
@@ -579,6 +581,7 @@ fsStatus fcheck (const char *drive) {
                 - fsOK               = Operation successful.
                 - fsInvalidDrive     = Nonexistent drive letter specified.
                 - fsNoFileHandle     = File cannot be opened due to to many opened files.
+                - fsAccessDenied     = File transfer in progress on the drive.
                 - fsError            = Formatting failed.
 */
 fsStatus fformat (const char *drive, const char *options) {
@@ -701,6 +704,90 @@ fsStatus fdefrag (const char *drive) {
 }
 
 
+/**
+  \brief Reclaim invalidated space on Embedded Flash or NAND Flash drive in one step.
+  \param[in]  drive                    a string specifying the \ref drive "memory or storage device".
+  \return     number of erased blocks or execution status
+                - value >= 0: number of erased blocks on drive.
+                - value < 0:  error occurred, -value is execution status as defined with \ref fsStatus
+  \note       This function supports EFS and NAND drives only.
+*/
+int32_t freclaim (const char *drive) {
+  FS_DEV  *dev;
+  int32_t  id;
+
+  START_LOCK (int32_t);
+
+  EvrFsCore_freclaim (drive);
+
+  id = fs_drive_id (drive, NULL);
+  if (id < 0) {
+    /* Nonexistent drive or invalid input */
+    RETURN (id);
+  }
+  dev = &fs_DevPool[id];
+
+  if (dev->attr & FS_FAT) {
+    /* Lock FAT volume */
+    VOLUME_LOCK ((fsFAT_Volume *)dev->dcb);
+
+    /* Reclaim one step on the FAT drive media (NAND). */
+    RETURN (fat_reclaim ((fsFAT_Volume *)dev->dcb));
+  }
+  else {
+    /* Lock EFS volume */
+    VOLUME_LOCK ((fsEFS_Volume *)dev->dcb);
+
+    /* Reclaim one block on Embedded Flash drive. */
+    RETURN (efs_reclaim ((fsEFS_Volume *)dev->dcb));
+  }
+
+  END_LOCK;
+}
+
+
+/**
+  \brief Discard free space on the FAT drive media.
+  \param[in]  drive                    a string specifying the \ref drive "memory or storage device".
+  \return     execution status \ref fsStatus
+                - fsOK               = Operation successful.
+                - fsInvalidDrive     = Nonexistent drive letter specified.
+                - fsAccessDenied     = Drive is write protected.
+                - fsUnsupported      = EFS drive was specified or media does not support discard.
+                - fsError            = Read or write error.
+  \note       This function supports FAT drives only.
+*/
+fsStatus ftrim (const char *drive) {
+  FS_DEV  *dev;
+  int32_t  id;
+
+  START_LOCK (fsStatus);
+
+  EvrFsCore_ftrim (drive);
+
+  id = fs_drive_id (drive, NULL);
+  if (id < 0) {
+    /* Nonexistent drive or invalid input */
+    RETURN ((fsStatus)-id);
+  }
+  dev = &fs_DevPool[id];
+
+  if (dev->attr & FS_FAT) {
+    /* Lock FAT volume */
+    VOLUME_LOCK ((fsFAT_Volume *)dev->dcb);
+
+    /* Discard all free clusters on the FAT drive media. */
+    RETURN (fat_trim ((fsFAT_Volume *)dev->dcb));
+  }
+  else {
+    /* Not supported on EFS drive. */
+    RETURN (fsUnsupported);
+  }
+
+  END_LOCK;
+}
+
+
 /**
   Get attributes from the parameter string:
    +  Sets an attribute
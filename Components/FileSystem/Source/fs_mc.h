@@ -17,6 +17,13 @@
 #define MC_STATUS_DRIVER_INIT (1U <<  0)    ///< Driver initialized
 #define MC_STATUS_EMMC_SLEEP  (1U <<  1)    ///< eMMC device is in Sleep State
 #define MC_STATUS_LOCKED      (1U <<  2)    ///< Device password protection active
+#define MC_STATUS_CRC         (1U <<  3)    ///< Data CRC enabled (SPI mode)
+#define MC_STATUS_TRAN        (1U <<  4)    ///< Device selected and ready in TRAN state
+
+/**
+  Memory card SPI mode configuration flags
+*/
+#define MC_SPI_CFG_CRC        (1U <<  0)    ///< Use CRC protected data transfers
 
 /**
   Memory card default initialization bus speed (in Hz)
@@ -84,11 +91,17 @@
 #define MC_CMD_READ_SINGLE_BLOCK      17    ///< R1, Read a Single Block          MMC,SD
 #define MC_CMD_READ_MULTIPLE_BLOCK    18    ///< R1, Read Multiple Blocks         MMC,SD
 #define MC_CMD_SEND_TUNING_BLOCK      19    ///< R1, Send 64 bytes tuning pattern MMC,SD
+#define MC_CMD_SET_BLOCK_COUNT        23    ///< R1, Set block count of CMD18/25  MMC,SD
 #define MC_CMD_WRITE_SINGLE_BLOCK     24    ///< R1, Write a Block                MMC,SD
 #define MC_CMD_WRITE_MULTIPLE_BLOCK   25    ///< R1, Write Multiple Blocks        MMC,SD
 #define MC_CMD_SET_WRITE_PROT         28    ///< R1b,Sets write protection bit    MMC,SD
 #define MC_CMD_CLR_WRITE_PROT         29    ///< R1b,Clears write protection bit  MMC,SD
 #define MC_CMD_SEND_WRITE_PROT        30    ///< R1, Send write protection status MMC,SD
+#define MC_CMD_ERASE_WR_BLK_START     32    ///< R1, Set first block to erase     ---,SD
+#define MC_CMD_ERASE_WR_BLK_END       33    ///< R1, Set last block to erase      ---,SD
+#define MC_CMD_ERASE_GROUP_START      35    ///< R1, Set first block to erase     MMC,--
+#define MC_CMD_ERASE_GROUP_END        36    ///< R1, Set last block to erase      MMC,--
+#define MC_CMD_ERASE                  38    ///< R1b,Erase selected blocks        MMC,SD
 #define MC_CMD_LOCK_UNLOCK            42    ///< R1, Set/reset the password       MMC,SD
 #define MC_CMD_APP_CMD                55    ///< R1, App.Specific Cmd follows     MMC,SD
 #define MC_CMD_GEN_CMD                56    ///< R1, General Command              MMC,SD
@@ -96,8 +109,10 @@
 #define MC_CMD_CRC_ON_OFF             59    ///< R1, Turn CRC7 checking on/off    MMC,SD
 
 #define MC_ACMD_SD_SET_BUS_WIDTH       6    ///< R1, Set Bus Width 1bit/4bits     ---,SD
+#define MC_ACMD_SET_WR_BLK_ERASE_COUNT 23   ///< R1, Set Pre-erase Block Count    ---,SD
 #define MC_ACMD_SD_SEND_OP_COND       41    ///< R3, Send App. Op.Cond Register   ---,SD
 #define MC_ACMD_SET_CLR_CARD_DETECT   42    ///< R1, Conn/Disconn pull-up on DAT3 ---,SD
+#define MC_ACMD_SEND_SCR              51    ///< R1, Read SD Configuration Reg.   ---,SD
 
 /**
   Memory Card Response Type Flags
@@ -205,6 +220,9 @@
 #define MC_PROP_DATA_BUS_8BIT (1U << 10)    ///< 8-bit data bus supported
 #define MC_PROP_DATA_BUS_DDR  (1U << 11)    ///< DDR data bus supported
 #define MC_PROP_CCC_10        (1U << 12)    ///< Class 10 command set supported
+#define MC_PROP_CCC_5         (1U << 13)    ///< Class 5 (erase) command set supported
+#define MC_PROP_MMC_TRIM      (1U << 14)    ///< MMC TRIM operation supported
+#define MC_PROP_CMD23         (1U << 15)    ///< SET_BLOCK_COUNT (CMD23) supported
 
 /* ACMD6 Bus Width Argument Definition */
 #define ACMD6_ARG_BUS_WIDTH_1BIT       0    ///< Set 1-bit bus width
@@ -236,6 +254,14 @@
                                 ACMD41_ARG_VDD_3V4_3V5 | \
                                 ACMD41_ARG_VDD_3V5_3V6)
 
+/* CMD38 Argument Definitions */
+#define CMD38_ARG_ERASE       0x00000000U   ///< Erase selected blocks
+#define CMD38_ARG_TRIM        0x00000001U   ///< Trim selected blocks (MMC)
+
+/* Erase Definitions */
+#define MC_ERASE_CHUNK        0x2000U       ///< Max. blocks erased by one command (4MB)
+#define MC_ERASE_TIMEOUT      1000000U      ///< Erase busy timeout in us
+
 /* SD CMD6 Argument Definitions */
 #define CMD6_ARG_ACCESS_MODE(x)       (((x) & 0x0F) <<  0)
 #define CMD6_ARG_COMMAND_SYSTEM(x)    (((x) & 0x0F) <<  4)
@@ -15,6 +15,8 @@
 #include "fs_mc.h"
 #include "fs_evr.h"
 
+/* Local Function Prototypes */
+static uint32_t mc_select_tran_state (MC_MCI *mc);
 
 /**
   Callback function used to retrieve password management information
@@ -532,7 +534,8 @@ static uint32_t mc_select_deselect (uint32_t rca, uint32_t *r1, MC_MCI *mc) {
   int32_t stat;
   uint32_t flags, events;
 
-  mc->Event = 0;
+  mc->Event   = 0;
+  mc->Status &= ~MC_STATUS_TRAN;
 
   flags = ((rca == 0) ? (MC_RESPONSE_NONE) : (MC_RESPONSE_R1b)) | ARM_MCI_RESPONSE_CRC;
   stat  = mc->Driver->SendCommand (MC_CMD_SELECT_DESELECT_CARD, rca << 16, flags, r1);
@@ -812,6 +815,38 @@ static uint32_t mc_read_block (uint32_t block, bool multiple, MC_MCI *mc) {
 }
 
 
+/**
+  (CMD23, R1): Set number of blocks for the following multiple block read or write
+
+  Transfer started with CMD18 or CMD25 ends automatically after cnt blocks,
+  STOP_TRANSMISSION command is not needed.
+
+  \param[in]   cnt  Number of blocks
+  \param[in]   mc   Pointer to memory card instance object
+  \return
+*/
+static uint32_t mc_set_block_count (uint32_t cnt, MC_MCI *mc) {
+  int32_t  stat;
+  uint32_t r1, flags, events;
+
+  mc->Event = 0;
+
+  flags = MC_RESPONSE_R1 | ARM_MCI_RESPONSE_CRC;
+  stat  = mc->Driver->SendCommand (MC_CMD_SET_BLOCK_COUNT, cnt, flags, &r1);
+
+  if (stat == ARM_DRIVER_OK) {
+    /* Wait for event */
+    events = mc_wfe (MC_CMD_EVENTS, mc);
+
+    if ((events & MC_CMD_EVENTS) == ARM_MCI_EVENT_COMMAND_COMPLETE) {
+      return (0); //OK
+    }
+  }
+  EvrFsMcMCI_SendCommandError (mc->Instance, MC_CMD_SET_BLOCK_COUNT, cnt);
+  return (1); //Error
+}
+
+
 /**
   (CMD24 | CMD25, R1): Send single or multiple block write command
 
@@ -850,6 +885,74 @@ static uint32_t mc_write_block (uint32_t block, bool multiple, MC_MCI *mc) {
 }
 
 
+/**
+  (CMD32 | CMD35, CMD33 | CMD36, CMD38, R1b): Erase range of blocks
+
+  \param[in]   start    First block number to be erased
+  \param[in]   end      Last block number to be erased
+  \param[in]   arg      CMD38 argument (erase/trim)
+  \param[in]   mc       Pointer to memory card instance object
+  \return
+*/
+static uint32_t mc_erase_block (uint32_t start, uint32_t end, uint32_t arg, MC_MCI *mc) {
+  int32_t  stat;
+  uint32_t r1, idx, flags, events;
+
+  if (mc->Property & MC_PROP_ACCESS_BYTE) {
+    start <<= 9;
+    end   <<= 9;
+  }
+
+  /* CMD32 (SD) or CMD35 (MMC), R1 */
+  idx = (mc->Property & MC_PROP_TYPE_MMC) ? (MC_CMD_ERASE_GROUP_START) : (MC_CMD_ERASE_WR_BLK_START);
+
+  mc->Event = 0;
+
+  flags = MC_RESPONSE_R1 | ARM_MCI_RESPONSE_CRC;
+  stat  = mc->Driver->SendCommand (idx, start, flags, &r1);
+
+  if (stat == ARM_DRIVER_OK) {
+    events = mc_wfe (MC_CMD_EVENTS, mc);
+
+    if ((events & MC_CMD_EVENTS) == ARM_MCI_EVENT_COMMAND_COMPLETE) {
+      /* CMD33 (SD) or CMD36 (MMC), R1 */
+      idx = (mc->Property & MC_PROP_TYPE_MMC) ? (MC_CMD_ERASE_GROUP_END) : (MC_CMD_ERASE_WR_BLK_END);
+
+      mc->Event = 0;
+
+      stat = mc->Driver->SendCommand (idx, end, flags, &r1);
+
+      if (stat == ARM_DRIVER_OK) {
+        events = mc_wfe (MC_CMD_EVENTS, mc);
+
+        if ((events & MC_CMD_EVENTS) == ARM_MCI_EVENT_COMMAND_COMPLETE) {
+          /* CMD38, R1b */
+          idx = MC_CMD_ERASE;
+
+          mc->Event = 0;
+
+          flags = MC_RESPONSE_R1b | ARM_MCI_RESPONSE_CRC;
+          stat  = mc->Driver->SendCommand (idx, arg, flags, &r1);
+
+          if (stat == ARM_DRIVER_OK) {
+            events = mc_wfe (MC_CMD_EVENTS, mc);
+
+            if ((events & MC_CMD_EVENTS) == ARM_MCI_EVENT_COMMAND_COMPLETE) {
+              /* Check response */
+              if ((r1 & (R1_ERASE_SEQ_ERROR | R1_ERASE_PARAM | R1_WP_VIOLATION)) == 0) {
+                return (0); //OK
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  EvrFsMcMCI_SendCommandError (mc->Instance, idx, start);
+  return (1); //Error
+}
+
+
 /**
   (CMD42, R1): Set/Reset the password or lock/unlock the card.
 
@@ -1003,6 +1106,47 @@ static uint32_t mc_sd_send_op_cond (uint32_t arg, uint32_t *r3, MC_MCI *mc) {
 }
 
 
+/**
+  (ACMD51, R1): Read SD Configuration Register (SCR)
+
+  \param[out]  buf  Buffer for 8 byte SCR register content
+  \param[in]   mc   Memory card instance object
+  \return
+*/
+static uint32_t mc_send_scr (uint8_t *buf, MC_MCI *mc) {
+  int32_t  stat;
+  uint32_t r1, flags, events;
+
+  mc->Event = 0;
+
+  stat = mc->Driver->SetupTransfer (buf, 1, 8, ARM_MCI_TRANSFER_READ | ARM_MCI_TRANSFER_BLOCK);
+  if (stat != ARM_DRIVER_OK) {
+    /* Got error, can't do nothing about it */
+    EvrFsMcMCI_ReadXferSetupError (mc->Instance, buf, 1, 8);
+    return (1);
+  }
+
+  flags = MC_RESPONSE_R1 | ARM_MCI_RESPONSE_CRC | ARM_MCI_TRANSFER_DATA;
+  stat  = mc->Driver->SendCommand (MC_ACMD_SEND_SCR, 0, flags, &r1);
+
+  if (stat == ARM_DRIVER_OK) {
+    /* Wait for command event */
+    events = mc_wfe (MC_CMD_EVENTS, mc);
+
+    if ((events & MC_CMD_EVENTS) == ARM_MCI_EVENT_COMMAND_COMPLETE) {
+      /* Wait for transfer event */
+      events = mc_wfe (MC_DAT_EVENTS, mc);
+
+      if ((events & MC_DAT_EVENTS) == ARM_MCI_EVENT_TRANSFER_COMPLETE) {
+        return (0); // OK
+      }
+    }
+  }
+  EvrFsMcMCI_SendCommandError (mc->Instance, MC_ACMD_SEND_SCR, 0);
+  return (1); //Error
+}
+
+
 /**
   Fill extern CID structure with content read from CID register
 
@@ -1209,6 +1353,18 @@ static fsStatus mc_control_sleep (uint32_t code, MC_MCI *mc) {
       /* Device must be in STBY state in order to enter SLP */
       err = mc_read_status (mc->RCA, &r1, mc);
 
+      if ((err == 0U) && ((r1 & R1_STATE_Msk) != R1_STATE_STBY)) {
+        /* Device remains selected after data transfer, deselect it */
+        err = mc_select_tran_state (mc);
+
+        if (err == 0U) {
+          err = mc_select_deselect (0U, &r1, mc);
+        }
+        if (err == 0U) {
+          err = mc_read_status (mc->RCA, &r1, mc);
+        }
+      }
+
       if (err == 0U) {
         if ((r1 & R1_STATE_Msk) == R1_STATE_STBY) {
           if (mc_sleep_awake (mc->RCA, true, mc) == 0U) {
@@ -1427,6 +1583,107 @@ static fsStatus mc_control_lock (fsLockUnlock *lu, MC_MCI *mc) {
 }
 
 
+/**
+  Discard range of sectors
+
+  SD cards erase given write blocks, MMC devices use TRIM operation which
+  is performed on write blocks as well. Range is erased in chunks of at
+  most MC_ERASE_CHUNK blocks, each of them waiting for the busy state.
+
+  \param[in]   dr     Discard range structure
+  \param[in]   mc     Memory card instance object
+  \return      execution status \ref fsStatus
+*/
+static fsStatus mc_control_discard (fsDiscardRange *dr, MC_MCI *mc) {
+  uint32_t err, arg, sect, cnt, num, r1, tout;
+
+  /* Erase leaves device in PRG state, next transfer must check its state */
+  mc->Status &= ~MC_STATUS_TRAN;
+
+  if ((mc->MediaStatus & FS_MEDIA_INITIALIZED) == 0) {
+    /* Media is not initialized */
+    EvrFsMcMCI_MediaNotInitialized (mc->Instance);
+    return (fsNoMedia);
+  }
+  if (mc->Status & MC_STATUS_LOCKED) {
+    /* Password protection is active */
+    EvrFsMcMCI_MediaPasswordEnabled (mc->Instance);
+    return (fsAccessDenied);
+  }
+
+  if (mc->Property & MC_PROP_TYPE_MMC) {
+    if ((mc->Property & MC_PROP_MMC_TRIM) == 0) {
+      return (fsUnsupported);
+    }
+    arg = CMD38_ARG_TRIM;
+  }
+  else {
+    if ((mc->Property & MC_PROP_CCC_5) == 0) {
+      return (fsUnsupported);
+    }
+    arg = CMD38_ARG_ERASE;
+  }
+
+  sect = dr->sect;
+  cnt  = dr->cnt;
+
+  if ((sect >= mc->SectorCount) || (cnt > (mc->SectorCount - sect))) {
+    EvrFsMcMCI_ParameterInvalid (mc->Instance);
+    return (fsInvalidParameter);
+  }
+
+  EvrFsMcMCI_Erase (mc->Instance, sect, cnt, arg);
+
+  err = 0U;
+
+  while ((cnt != 0U) && (err == 0U)) {
+    num = (cnt > MC_ERASE_CHUNK) ? (MC_ERASE_CHUNK) : (cnt);
+
+    /* Switch device to TRAN state */
+    err = mc_select_tran_state (mc);
+
+    if (err == 0U) {
+      err = mc_erase_block (sect, sect + num - 1U, arg, mc);
+    }
+
+    if (err == 0U) {
+      /* Wait until erase is completed (PRG -> TRAN) */
+      tout = fs_get_sys_tick();
+      do {
+        err = mc_read_status (mc->RCA, &r1, mc);
+
+        if (err == 0U) {
+          if ((r1 & R1_STATE_Msk) != R1_STATE_PRG) {
+            break;
+          }
+          if ((fs_get_sys_tick() - tout) >= fs_get_sys_tick_us(MC_ERASE_TIMEOUT)) {
+            EvrFsMcMCI_DeviceStateTimeout (mc->Instance, R1_STATE_PRG, R1_STATE_TRAN);
+            err = 1U;
+          }
+        }
+      }
+      while (err == 0U);
+    }
+
+    sect += num;
+    cnt  -= num;
+  }
+
+  if (err != 0U) {
+    EvrFsMcMCI_EraseError (mc->Instance, dr->sect, dr->cnt);
+
+    /* Device state is unknown */
+    mc->Status &= ~MC_STATUS_TRAN;
+    return (fsError);
+  }
+
+  /* Disconnect memory card */
+  mc_select_deselect (0, &r1, mc);
+
+  return (fsOK);
+}
+
+
 /**
   Selects beetwen 4-bit and 8-bit data bus width during device initialization.
 
@@ -1701,6 +1958,9 @@ static uint32_t mc_native_init (MC_MCI *mc) {
   if (arg & (1U << 10)) {
     mc->Property |= MC_PROP_CCC_10;
   }
+  if (arg & (1U << 5)) {
+    mc->Property |= MC_PROP_CCC_5;
+  }
 
   if (mc->Property & MC_PROP_TYPE_MMC) {
     read_mmc_version (&r[0], mc);
@@ -1749,6 +2009,11 @@ static uint32_t mc_native_init (MC_MCI *mc) {
                                    mc->ExtCSD[214] << 16 |
                                    mc->ExtCSD[213] <<  8 |
                                    mc->ExtCSD[212]);
+
+      /* Check TRIM support (SEC_FEATURE_SUPPORT [231], SEC_GB_CL_EN) */
+      if (mc->ExtCSD[231] & (1U << 4)) {
+        mc->Property |= MC_PROP_MMC_TRIM;
+      }
     }
     /* High-speed mode selection for MMC V4.0 and higher */
     if (mc_switch (3, 185, 1, mc)) {
@@ -1815,6 +2080,29 @@ static uint32_t mc_native_init (MC_MCI *mc) {
     }
   }
 
+  if (mc->Property & MC_PROP_TYPE_SD) {
+    /* Read SCR register to check SET_BLOCK_COUNT (CMD23) support */
+    if (mc_enable_acmd (mc->RCA, mc) == 0) {
+      if (mc_send_scr (mc->ExtCSD, mc) == 0) {
+        /* CMD_SUPPORT [33:32], bit 33: CMD23 supported */
+        if (mc->ExtCSD[3] & (1U << 1)) {
+          mc->Property |= MC_PROP_CMD23;
+        }
+      }
+      else {
+        /* Abort incomplete data transfer */
+        EvrFsMcMCI_TransferAbort (mc->Instance);
+        mc->Driver->AbortTransfer();
+      }
+    }
+  }
+  else {
+    if (mc->Property & MC_PROP_MMC_V4) {
+      /* SET_BLOCK_COUNT (CMD23) is mandatory */
+      mc->Property |= MC_PROP_CMD23;
+    }
+  }
+
   /* Set data timeout to 550ms (500ms + 50ms overhead) */
   mci_data_timeout (550, speed, mc);
 
@@ -2053,6 +2341,7 @@ uint32_t mc_mci_Init (uint32_t mode, MC_MCI *mc) {
     mc->Property    = 0;
     mc->RCA         = 0;
     mc->Event       = 0;
+    mc->Status     &= ~MC_STATUS_TRAN;
 
     if (mc->Capabilities.cd_state) {
       if (mc->Driver->ReadCD() == 0) {
@@ -2131,6 +2420,7 @@ uint32_t mc_mci_UnInit (uint32_t mode, MC_MCI *mc) {
       EvrFsMcMCI_UninitMedia (mc->Instance);
 
       mc->MediaStatus &= ~FS_MEDIA_INITIALIZED;
+      mc->Status      &= ~MC_STATUS_TRAN;
       mc->Property     = 0;
 
       /* Power down the device */
@@ -2154,8 +2444,9 @@ uint32_t mc_mci_UnInit (uint32_t mode, MC_MCI *mc) {
 */
 uint32_t mc_mci_ReadSector (uint32_t sect, uint8_t *buf, uint32_t cnt, MC_MCI *mc) {
   int32_t  rval;
-  uint32_t err, r1, events;
+  uint32_t err, events;
   uint8_t  state, retry;
+  bool     predef;
 
   EvrFsMcMCI_SectorRead (mc->Instance, sect, cnt);
 
@@ -2177,14 +2468,29 @@ uint32_t mc_mci_ReadSector (uint32_t sect, uint8_t *buf, uint32_t cnt, MC_MCI *m
   while (err == 0U) {
     switch (state) {
       case MC_READ_INIT: /* Switch device to TRAN state */
-        err = mc_select_tran_state (mc);
+        if ((mc->Status & MC_STATUS_TRAN) == 0U) {
+          err = mc_select_tran_state (mc);
+        }
         if (err == 0U) {
           state = MC_READ_DATA;
         }
         break;
 
       case MC_READ_DATA: /* Read data */
-        /* Setup transfer and send write block command */
+        mc->Status &= ~MC_STATUS_TRAN;
+
+        /* Use pre-defined block count when supported, open-ended transfer otherwise */
+        predef = (cnt > 1U) && (cnt <= 0xFFFFU) && ((mc->Property & MC_PROP_CMD23) != 0U);
+
+        if (predef) {
+          err = mc_set_block_count (cnt, mc);
+
+          if (err != 0U) {
+            break;
+          }
+        }
+
+        /* Setup transfer and send read block command */
         rval = mc->Driver->SetupTransfer (buf, cnt, 512U, ARM_MCI_TRANSFER_READ | ARM_MCI_TRANSFER_BLOCK);
         if (rval != ARM_DRIVER_OK) {
           /* Got error, can't do nothing about it */
@@ -2204,14 +2510,14 @@ uint32_t mc_mci_ReadSector (uint32_t sect, uint8_t *buf, uint32_t cnt, MC_MCI *m
             err = 1U;
           }
 
-          if ((err != 0U) || (cnt > 1U)) {
+          if ((err != 0U) || ((cnt > 1U) && !predef)) {
             /* Send STOP_TRANSMISSION command */
             err = mc_stop_transmission (mc);
           }
 
           if (err == 0U) {
-            /* Disconnect memory card (TRAN -> STBY) */
-            mc_select_deselect (0U, &r1, mc);
+            /* Device returns to TRAN state, keep it selected for the next request */
+            mc->Status |= MC_STATUS_TRAN;
             return (true);
           }
         }
@@ -2253,6 +2559,7 @@ uint32_t mc_mci_WriteSector (uint32_t sect, const uint8_t *buf, uint32_t cnt, MC
   int32_t  rval;
   uint32_t err, r1, events;
   uint8_t  state, retry;
+  bool     predef;
 
   EvrFsMcMCI_SectorWrite (mc->Instance, sect, cnt);
 
@@ -2274,13 +2581,28 @@ uint32_t mc_mci_WriteSector (uint32_t sect, const uint8_t *buf, uint32_t cnt, MC
   while (err == 0U) {
     switch (state) {
       case MC_WRITE_INIT: /* Switch device to TRAN state */
-        err = mc_select_tran_state (mc);
+        if ((mc->Status & MC_STATUS_TRAN) == 0U) {
+          err = mc_select_tran_state (mc);
+        }
         if (err == 0U) {
           state = MC_WRITE_DATA;
         }
         break;
 
       case MC_WRITE_DATA:
+        mc->Status &= ~MC_STATUS_TRAN;
+
+        /* Use pre-defined block count when supported, open-ended transfer otherwise */
+        predef = (cnt > 1U) && (cnt <= 0xFFFFU) && ((mc->Property & MC_PROP_CMD23) != 0U);
+
+        if (predef) {
+          err = mc_set_block_count (cnt, mc);
+
+          if (err != 0U) {
+            break;
+          }
+        }
+
         /* Setup transfer and send write block command */
         rval = mc->Driver->SetupTransfer ((uint8_t *)(uint32_t)buf, cnt, 512U, ARM_MCI_TRANSFER_WRITE | ARM_MCI_TRANSFER_BLOCK);
         if (rval != ARM_DRIVER_OK) {
@@ -2301,7 +2623,7 @@ uint32_t mc_mci_WriteSector (uint32_t sect, const uint8_t *buf, uint32_t cnt, MC
             err = 1U;
           }
 
-          if ((err != 0) || (cnt > 1)) {
+          if ((err != 0) || ((cnt > 1) && !predef)) {
             /* Send STOP_TRANSMISSION command */
             err = mc_stop_transmission (mc);
           }
@@ -2318,9 +2640,8 @@ uint32_t mc_mci_WriteSector (uint32_t sect, const uint8_t *buf, uint32_t cnt, MC
             while ((r1 & R1_STATE_Msk) == R1_STATE_RCV);
 
             if (err == 0U) {
-              /* Disconnect memory card                               */
-              /* States: (PRG -> DIS -> STBY) or (PRG -> TRAN -> STBY)*/
-              mc_select_deselect (0, &r1, mc);
+              /* Keep memory card selected, programming (PRG -> TRAN) */
+              /* completes while the next request is prepared        */
               return (true);
             }
           }
@@ -2479,6 +2800,8 @@ fsStatus mc_mci_DevCtrl (fsDevCtrlCode code, void *p, MC_MCI *mc) {
   }
   else if (code == fsDevCtrlCodeLockUnlock) {
     /* Lock/Unlock the device */
+    mc->Status &= ~MC_STATUS_TRAN;
+
     if (mc_select_tran_state (mc) == 0) {
       status = mc_control_lock ((fsLockUnlock *)p, mc);
 
@@ -2499,6 +2822,12 @@ fsStatus mc_mci_DevCtrl (fsDevCtrlCode code, void *p, MC_MCI *mc) {
       status = mc_fsDevCtrlCodeHealthStatus ((fsHealthStatus *)p, mc);
     }
   }
+  else if (code == fsDevCtrlCodeDiscard) {
+    /* Discard sector range */
+    if (p != NULL) {
+      status = mc_control_discard ((fsDiscardRange *)p, mc);
+    }
+  }
   else {
     /* Unsupported */
     EvrFsMcMCI_DevCtrlUnsupported (mc->Instance, code);
@@ -172,20 +172,15 @@ static fsStatus mc_control_bus_speed (uint32_t freq, MC_SPI *mc) {
 
 
 /**
-  Send data over the SPI
+  Wait until SPI transfer is completed
 
-  \param[in]      data      data buffer
-  \param[in]      cnt       number of data to send
   \param[in,out]  mc        memory card instance object
   \return \ref fsStatus
 */
-static fsStatus mc_send (const uint8_t *data, uint32_t cnt, MC_SPI *mc) {
+static fsStatus mc_xfer_wait (MC_SPI *mc) {
   uint32_t tick, tout;
   fsStatus status;
 
-  mc->Event = 0;
-  mc->Driver->Send (data, cnt);
-
   tout = fs_get_sys_tick_us (MC_XFER_TOUT);
   tick = fs_get_sys_tick();
   do {
@@ -198,6 +193,28 @@ static fsStatus mc_send (const uint8_t *data, uint32_t cnt, MC_SPI *mc) {
     status = fsOK;
   } else {
     status = fsDriverError;
+  }
+  return (status);
+}
+
+
+/**
+  Send data over the SPI
+
+  \param[in]      data      data buffer
+  \param[in]      cnt       number of data to send
+  \param[in,out]  mc        memory card instance object
+  \return \ref fsStatus
+*/
+static fsStatus mc_send (const uint8_t *data, uint32_t cnt, MC_SPI *mc) {
+  fsStatus status;
+
+  mc->Event = 0;
+  mc->Driver->Send (data, cnt);
+
+  status = mc_xfer_wait (mc);
+
+  if (status != fsOK) {
     /* SPI send failed */
     EvrFsMcSPI_DriverSendError (mc->Instance, mc->Event);
   }
@@ -214,24 +231,14 @@ static fsStatus mc_send (const uint8_t *data, uint32_t cnt, MC_SPI *mc) {
   \return \ref fsStatus
 */
 static fsStatus mc_receive (uint8_t *data, uint32_t cnt, MC_SPI *mc) {
-  uint32_t tick, tout;
   fsStatus status;
 
   mc->Event = 0;
   mc->Driver->Receive (data, cnt);
 
-  tout = fs_get_sys_tick_us(MC_XFER_TOUT);
-  tick = fs_get_sys_tick();
-  do {
-    if (mc->Event & ARM_SPI_EVENT_TRANSFER_COMPLETE) {
-      break;
-    }
-  } while ((fs_get_sys_tick() - tick) < tout);
+  status = mc_xfer_wait (mc);
 
-  if (mc->Event & ARM_SPI_EVENT_TRANSFER_COMPLETE) {
-    status = fsOK;
-  } else {
-    status = fsDriverError;
+  if (status != fsOK) {
     /* SPI receive failed */
     EvrFsMcSPI_DriverReceiveError (mc->Instance, mc->Event);
   }
@@ -239,6 +246,63 @@ static fsStatus mc_receive (uint8_t *data, uint32_t cnt, MC_SPI *mc) {
 }
 
 
+/* CRC7 lookup table (polynomial 0x09, CRC in bits [7:1]) */
+static const uint8_t mc_crc7_tab[256] = {
+  0x00, 0x12, 0x24, 0x36, 0x48, 0x5A, 0x6C, 0x7E, 0x90, 0x82, 0xB4, 0xA6, 0xD8, 0xCA, 0xFC, 0xEE,
+  0x32, 0x20, 0x16, 0x04, 0x7A, 0x68, 0x5E, 0x4C, 0xA2, 0xB0, 0x86, 0x94, 0xEA, 0xF8, 0xCE, 0xDC,
+  0x64, 0x76, 0x40, 0x52, 0x2C, 0x3E, 0x08, 0x1A, 0xF4, 0xE6, 0xD0, 0xC2, 0xBC, 0xAE, 0x98, 0x8A,
+  0x56, 0x44, 0x72, 0x60, 0x1E, 0x0C, 0x3A, 0x28, 0xC6, 0xD4, 0xE2, 0xF0, 0x8E, 0x9C, 0xAA, 0xB8,
+  0xC8, 0xDA, 0xEC, 0xFE, 0x80, 0x92, 0xA4, 0xB6, 0x58, 0x4A, 0x7C, 0x6E, 0x10, 0x02, 0x34, 0x26,
+  0xFA, 0xE8, 0xDE, 0xCC, 0xB2, 0xA0, 0x96, 0x84, 0x6A, 0x78, 0x4E, 0x5C, 0x22, 0x30, 0x06, 0x14,
+  0xAC, 0xBE, 0x88, 0x9A, 0xE4, 0xF6, 0xC0, 0xD2, 0x3C, 0x2E, 0x18, 0x0A, 0x74, 0x66, 0x50, 0x42,
+  0x9E, 0x8C, 0xBA, 0xA8, 0xD6, 0xC4, 0xF2, 0xE0, 0x0E, 0x1C, 0x2A, 0x38, 0x46, 0x54, 0x62, 0x70,
+  0x82, 0x90, 0xA6, 0xB4, 0xCA, 0xD8, 0xEE, 0xFC, 0x12, 0x00, 0x36, 0x24, 0x5A, 0x48, 0x7E, 0x6C,
+  0xB0, 0xA2, 0x94, 0x86, 0xF8, 0xEA, 0xDC, 0xCE, 0x20, 0x32, 0x04, 0x16, 0x68, 0x7A, 0x4C, 0x5E,
+  0xE6, 0xF4, 0xC2, 0xD0, 0xAE, 0xBC, 0x8A, 0x98, 0x76, 0x64, 0x52, 0x40, 0x3E, 0x2C, 0x1A, 0x08,
+  0xD4, 0xC6, 0xF0, 0xE2, 0x9C, 0x8E, 0xB8, 0xAA, 0x44, 0x56, 0x60, 0x72, 0x0C, 0x1E, 0x28, 0x3A,
+  0x4A, 0x58, 0x6E, 0x7C, 0x02, 0x10, 0x26, 0x34, 0xDA, 0xC8, 0xFE, 0xEC, 0x92, 0x80, 0xB6, 0xA4,
+  0x78, 0x6A, 0x5C, 0x4E, 0x30, 0x22, 0x14, 0x06, 0xE8, 0xFA, 0xCC, 0xDE, 0xA0, 0xB2, 0x84, 0x96,
+  0x2E, 0x3C, 0x0A, 0x18, 0x66, 0x74, 0x42, 0x50, 0xBE, 0xAC, 0x9A, 0x88, 0xF6, 0xE4, 0xD2, 0xC0,
+  0x1C, 0x0E, 0x38, 0x2A, 0x54, 0x46, 0x70, 0x62, 0x8C, 0x9E, 0xA8, 0xBA, 0xC4, 0xD6, 0xE0, 0xF2
+};
+
+/* CCITT CRC16 lookup table (polynomial 0x1021) */
+static const uint16_t mc_crc16_tab[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+
 /**
   Calculate CRC7.
 
@@ -250,42 +314,36 @@ static fsStatus mc_receive (uint8_t *data, uint32_t cnt, MC_SPI *mc) {
 */
 static uint8_t mc_CRC7 (const uint8_t *buf) {
   uint32_t i;
-  uint32_t crc = 0;
+  uint8_t  crc = 0U;
 
-  for (i = 0; i < (6*8); i++) {
-    if (!(i & 0x07)) {
-      if ((i >> 3) < 5){ crc |= buf[i >> 3]; }
-    }
-    if (crc & 0x8000) { crc ^= 0x8900; }
-    crc <<= 1;
+  /* CRC is calculated over first 5 bytes */
+  for (i = 0U; i < 5U; i++) {
+    crc = mc_crc7_tab[crc ^ buf[i]];
   }
 
-  return (uint8_t)(crc >> 8);
+  return (crc);
 }
 
 
-#if 0
 /**
   Calculate CCITT CRC16.
 
   Polynomial: x^16 + x^12 + x^5 + 1 (0x1021)
   Init: 0x0000
+
+  \param[in]  buf       data buffer
+  \param[in]  cnt       number of bytes in buffer
+  \return crc calculated over given buffer
 */
 static uint16_t mc_CRC16 (const uint8_t *buf, uint32_t cnt) {
-  uint16_t crc = 0;
-  uint32_t i;
+  uint16_t crc = 0U;
 
   while (cnt--) {
-    crc ^= *buf++ << 8;
-
-    for (i = 0; i < 8; i++) {
-      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
-    }
+    crc = (uint16_t)(crc << 8) ^ mc_crc16_tab[(uint8_t)(crc >> 8) ^ *buf++];
   }
 
-  return crc;
+  return (crc);
 }
-#endif
 
 
 /**
@@ -395,6 +453,9 @@ static fsStatus mc_wait_busy (MC_SPI *mc) {
 /**
   Read cnt number of data blocks with size sz
 
+  When data CRC is enabled, CRC of a block is checked while the next
+  block is being received.
+
   \param[out] buf       data buffer
   \param[in]  sz        block size
   \param[in]  cnt       number of blocks
@@ -403,10 +464,15 @@ static fsStatus mc_wait_busy (MC_SPI *mc) {
 */
 static fsStatus mc_read_data (uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *mc) {
   fsStatus status;
-  uint32_t i;
+  uint32_t i, chk;
+  uint16_t crc16;
   uint8_t  resp;
   uint8_t  crc[2];
 
+  /* No block waiting for CRC check */
+  chk   = 0U;
+  crc16 = 0U;
+
   do {
     status = fsError;
 
@@ -427,8 +493,22 @@ static fsStatus mc_read_data (uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *m
     }
 
     if (status == fsOK) {
-      /* Read data block */
-      if (mc_receive (buf, sz, mc) != fsOK) {
+      /* Start data block reception */
+      mc->Event = 0;
+      mc->Driver->Receive (buf, sz);
+
+      if (chk != 0U) {
+        /* Check previous block while this one is received */
+        chk = 0U;
+        if (mc_CRC16 (buf - sz, sz) != crc16) {
+          EvrFsMcSPI_DataCrcError (mc->Instance);
+          status = fsError;
+        }
+      }
+
+      if (mc_xfer_wait (mc) != fsOK) {
+        /* SPI receive failed */
+        EvrFsMcSPI_DriverReceiveError (mc->Instance, mc->Event);
         status = fsError;
       }
     }
@@ -438,6 +518,12 @@ static fsStatus mc_read_data (uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *m
       if (mc_receive (crc, 2, mc) != fsOK) {
         status = fsError;
       }
+      else {
+        if (mc->Status & MC_STATUS_CRC) {
+          crc16 = (uint16_t)((crc[0] << 8) | crc[1]);
+          chk   = 1U;
+        }
+      }
     }
 
     buf += sz;
@@ -445,6 +531,14 @@ static fsStatus mc_read_data (uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *m
   }
   while ((cnt > 0) && (status == fsOK));
 
+  if (chk != 0U) {
+    /* Check last block */
+    if (mc_CRC16 (buf - sz, sz) != crc16) {
+      EvrFsMcSPI_DataCrcError (mc->Instance);
+      status = fsError;
+    }
+  }
+
   return (status);
 }
 
@@ -461,6 +555,7 @@ static fsStatus mc_read_data (uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *m
 static fsStatus mc_write_data (const uint8_t *buf, uint32_t sz, uint32_t cnt, MC_SPI *mc) {
   fsStatus status;
   uint32_t i;
+  uint16_t crc16;
   uint8_t  token, resp;
   uint8_t  crc[2];
 
@@ -476,16 +571,30 @@ static fsStatus mc_write_data (const uint8_t *buf, uint32_t sz, uint32_t cnt, MC
     }
 
     if (status == fsOK) {
-      /* Send data block */
-      if (mc_send (buf, sz, mc) != fsOK) {
+      /* Start data block transmission */
+      mc->Event = 0;
+      mc->Driver->Send (buf, sz);
+
+      if (mc->Status & MC_STATUS_CRC) {
+        /* Calculate CRC while the block is sent */
+        crc16  = mc_CRC16 (buf, sz);
+        crc[0] = (uint8_t)(crc16 >> 8);
+        crc[1] = (uint8_t)(crc16);
+      } else {
+        /* Dummy CRC */
+        crc[0] = 0xFF;
+        crc[1] = 0xFF;
+      }
+
+      if (mc_xfer_wait (mc) != fsOK) {
+        /* SPI send failed */
+        EvrFsMcSPI_DriverSendError (mc->Instance, mc->Event);
         status = fsError;
       }
     }
 
     if (status == fsOK) {
-      /* Send dummy CRC */
-      crc[0] = 0xFF;
-      crc[1] = 0xFF;
+      /* Send CRC */
       if (mc_send (crc, 2, mc) != fsOK) {
         status = fsError;
       }
@@ -497,6 +606,10 @@ static fsStatus mc_write_data (const uint8_t *buf, uint32_t sz, uint32_t cnt, MC
         status = fsError;
       } else {
         if ((resp & 0x0F) != 0x05) {
+          if ((resp & 0x0F) == 0x0B) {
+            /* Data rejected due to CRC error */
+            EvrFsMcSPI_DataCrcError (mc->Instance);
+          }
           status = fsError;
         }
       }
@@ -991,6 +1104,46 @@ static fsStatus mc_enable_acmd (uint8_t *r1, MC_SPI *mc) {
 }
 
 
+/**
+  (ACMD23, R1): Set number of blocks to pre-erase before multiple block write
+
+  \param[in]  cnt       number of blocks
+  \param[in]  mc        memory card instance object
+  \return \ref fsStatus
+*/
+static fsStatus mc_set_wr_blk_erase_count (uint32_t cnt, MC_SPI *mc) {
+  uint8_t r1;
+  fsStatus status;
+
+  if (mc_enable_acmd (&r1, mc) != fsOK) {
+    return (fsError);
+  }
+
+  mc_control_ss (ARM_SPI_SS_ACTIVE, mc);
+
+  if (mc_send_command (MC_ACMD_SET_WR_BLK_ERASE_COUNT, cnt & 0x7FFFFFU, mc) != 0U) {
+    status = fsError;
+  }
+  else {
+    if (mc_read_response (&r1, 1, mc) != 0U) {
+      /* No response to application command */
+      EvrFsMcSPI_ACmdResponseError (mc->Instance, MC_ACMD_SET_WR_BLK_ERASE_COUNT);
+      status = fsError;
+    }
+    else {
+      if (r1 == 0x00) {
+        status = fsOK;
+      } else {
+        status = fsError;
+      }
+    }
+  }
+  mc_control_ss (ARM_SPI_SS_INACTIVE, mc);
+
+  return (status);
+}
+
+
 /**
   (CMD56, R1): General Command
 
@@ -1458,6 +1611,7 @@ uint32_t mc_spi_Init (uint32_t mode, MC_SPI *mc) {
   /* Reset media status */
   mc->MediaStatus = 0;
   mc->Property    = 0;
+  mc->Status     &= ~MC_STATUS_CRC;
 
   /* Power-on SPI peripheral */
   if (mc->Driver->PowerControl (ARM_POWER_FULL) != ARM_DRIVER_OK) {
@@ -1662,11 +1816,22 @@ uint32_t mc_spi_Init (uint32_t mode, MC_SPI *mc) {
     return (false);
   }
 
-  /* Turn Off CRC option. */
-  if (mc_crc_on_off (0, mc) != fsOK) {
-    /* Failed to turn off CRC check */
-    EvrFsMcSPI_CrcDisableError (mc->Instance);
-    return (false);
+  if (mc->Config & MC_SPI_CFG_CRC) {
+    /* Turn On CRC option. */
+    if (mc_crc_on_off (1, mc) != fsOK) {
+      /* Failed to turn on CRC check */
+      EvrFsMcSPI_CrcEnableError (mc->Instance);
+      return (false);
+    }
+    mc->Status |= MC_STATUS_CRC;
+  }
+  else {
+    /* Turn Off CRC option. */
+    if (mc_crc_on_off (0, mc) != fsOK) {
+      /* Failed to turn off CRC check */
+      EvrFsMcSPI_CrcDisableError (mc->Instance);
+      return (false);
+    }
   }
 
   /* Success, card initialized. */
@@ -1786,6 +1951,11 @@ uint32_t mc_spi_WriteSector (uint32_t sect, const uint8_t *buf, uint32_t cnt, MC
   }
 
   if (err == 0) {
+    if ((cnt > 1) && (mc->Property & MC_PROP_TYPE_SD)) {
+      /* Let SD card pre-erase the blocks (failure is not fatal) */
+      (void)mc_set_wr_blk_erase_count (cnt, mc);
+    }
+
     if (mc->Property & MC_PROP_ACCESS_BYTE) {
       sect <<= 9;
     }
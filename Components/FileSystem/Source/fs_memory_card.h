@@ -43,7 +43,8 @@ typedef struct {
   uint8_t volatile      MediaStatus;    /* Media status                       */
   uint8_t               Status;         /* Device status                      */
   uint8_t               Instance;       /* Memory Card Instance number        */
-  uint8_t               Reserved[2];    /* Reserved for future use            */
+  uint8_t               Config;         /* Configuration flags                */
+  uint8_t               Reserved;       /* Reserved for future use            */
 } MC_SPI;
 
 /* Memory Card SPI mode interface functions */
@@ -21,6 +21,10 @@
 #define _DS_(b)               (b-(b*3)/100-1)
 #define _EP_(p)               ((p/512)*128)
 #define NAND_TSN_SIZE(b,p)    ((_DS_(b)+_EP_(p)-1)/_EP_(p))
+#define NAND_BTT_RAM_SIZE(b,r) ((r) ? _DS_(b) : 0)
+
+/* NAND FTL Page Cache hash table size (must be 2^n) */
+#define NAND_PG_HASH_SIZE     32
 
 /* NAND Page Layout configuration */
 typedef struct _NAND_PAGE_LAYOUT {
@@ -76,7 +80,7 @@ typedef struct _NFTL_DRIVER_HANDLE {
   uint8_t                  instance;    /* Media handle instance              */
   uint8_t                  jedec_id;    /* JEDEC Manufacturer ID              */
   uint8_t                  ecc_req;     /* ECC correctability requirement     */
-  uint8_t                  rsvd;        /* Reserved for future use            */
+  uint8_t                  opt_cmd;     /* Supported optional cache commands  */
 } NAND_MEDIA_HANDLE;
 
 /* NAND Feature Parameters */
@@ -101,6 +105,8 @@ typedef struct _NAND_MEDIA_DRIVER {
   int32_t (*ReadStatus)     (NAND_MEDIA_HANDLE *h, uint8_t *stat);
   int32_t (*GetFeatures)    (NAND_MEDIA_HANDLE *h, uint8_t addr, uint8_t *buf, uint32_t len);
   int32_t (*SetFeatures)    (NAND_MEDIA_HANDLE *h, uint8_t addr, const uint8_t *buf, uint32_t len);
+  int32_t (*ReadCache)      (NAND_MEDIA_HANDLE *h, uint32_t row, uint8_t *buf, uint32_t len, uint32_t mode);
+  int32_t (*WriteCache)     (NAND_MEDIA_HANDLE *h, uint32_t row, const uint8_t *buf, uint32_t len, uint32_t mode);
 } const NAND_MEDIA_DRIVER;
 
 /* NAND FTL Block Index Cache */
@@ -110,23 +116,29 @@ typedef struct {
   uint16_t lbn;                         /* Logical block number               */
   uint8_t  typ;                         /* Type of block in cache             */
   uint8_t  nextPg;                      /* Next page to be indexed            */
-  uint8_t  rsvd[2];                     /* Reserved for future use            */
+  uint16_t age;                         /* Last access time (LRU replacement) */
 } BLOCK_CACHE;
 
 /* NAND FTL Page Cache */
 typedef struct {
   uint32_t row;                         /* Row address of the page in cache   */
   uint8_t *buf;                         /* Cached page buffer                 */
+  uint32_t age;                         /* Last access time (LRU replacement) */
+  uint8_t  next;                        /* Next slot in the same hash chain   */
+  uint8_t  rsvd[3];                     /* Reserved for future use            */
 } PAGE_CACHE;
 
 /* NAND FTL Buffer Pointers Structure */
 typedef struct {
-  uint32_t CacheBS;                     /* Block slot for block caching       */
-  uint32_t CachePS;                     /* Page slot for page caching         */
+  uint32_t BlockTime;                   /* Block indexing cache access time   */
+  uint32_t PageTime;                    /* Page cache access time             */
   uint16_t CachedBlocks;                /* Number of indexed blocks           */
   uint16_t CachedPages;                 /* Number of cached pages             */
+  uint16_t TablePages;                  /* Number of pages for table area     */
+  uint8_t  Rsvd[2];                     /* Reserved for future use            */
   BLOCK_CACHE *Block;                   /* Block indexing cache info struct   */
   PAGE_CACHE  *Page;                    /* Page data cache info structure     */
+  uint8_t  Hash[NAND_PG_HASH_SIZE];     /* Page cache hash chain heads        */
 } NAND_FTL_CACHE;
 
 /* NAND FTL Configuration structure */
@@ -141,7 +153,10 @@ typedef struct nand_ftl_cfg {
   uint16_t NumCacheBlocks;              /* Number of indexed data blocks      */
   uint16_t NumCachePages;               /* Number of cached data pages        */
   uint16_t TsnTableSize;                /* Translation table cache size       */
-  uint8_t  Reserved[2];                 /* Reserved for future use            */
+  uint16_t BttTableSize;                /* Translation table RAM buffer size  */
+  /* Background Reclaim */
+  uint16_t GcThreshold;                 /* Replacement block fold threshold % */
+  uint16_t WlInterval;                  /* Block erases between WL moves      */
   /* Page buffer & Caches */
   uint8_t     *PgBuf;                   /* Page data buffer                   */
   BLOCK_CACHE *BlockCache;              /* Block indexing cache info struct   */
@@ -149,6 +164,7 @@ typedef struct nand_ftl_cfg {
   PAGE_CACHE  *PageCache;               /* Page data cache info structure     */
   uint8_t     *PageCacheBuf;            /* Page data cache buffer             */
   uint32_t    *TsnTable;                /* Translation table cache buffer     */
+  uint32_t    *BttTable;                /* Translation table RAM buffer       */
 } const NAND_FTL_CFG;
 
 /* NAND Device Control block */
@@ -175,11 +191,16 @@ typedef struct {
   uint16_t  CurrLBN;                    /* Current logical block number       */
   uint16_t  GcLBN;                      /* Current logical block number used  */
                                         /*  by forced GC                      */
+  uint16_t  WlLBN;                      /* Current logical block number used  */
+                                        /*  by static wear leveling           */
+  uint16_t  WlCnt;                      /* Block erases since last static     */
+                                        /*  wear leveling move                */
   uint16_t  PbnQ[3];                    /* Empty block queue                  */
   uint16_t  BadBlockCnt;                /* Bad Block Counter                  */
   uint16_t  NumDataBlocks;              /* Number of data blocks reported     */
   uint16_t  TsnTableSize;               /* Translation table cache size       */
   uint32_t *TsnTable;                   /* Translation table cache buffer     */
+  uint32_t *BttTable;                   /* Translation table RAM buffer       */
   uint8_t  *PgBuf;                      /* Page data buffer                   */
   uint8_t   Status;                     /* FTL Status Flags                   */
   uint8_t   Reserved[3];                /* Reserved for future use            */
@@ -790,15 +790,197 @@ static int32_t ReadPage (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, uint8
 }
 
 
+/*
+  Read sequential page using cache register (ExecuteSequence interface).
+*/
+static int32_t ReadCache_Seq (NAND_MEDIA_HANDLE *h, uint32_t row, uint8_t *buf, uint32_t len, uint32_t mode) {
+  ARM_DRIVER_NAND *drv = h->hw->drv;
+  uint32_t cmd;
+  uint32_t code;
+
+  if (mode & NAND_CACHE_OP_FIRST) {
+    /* Load the first page into the data register */
+    cmd = NAND_CMD_READ_1ST | (NAND_CMD_READ_2ND << 8);
+
+    code = ARM_NAND_CODE_SEND_CMD1      |
+           ARM_NAND_CODE_SEND_ADDR_COL1 |
+           ARM_NAND_CODE_SEND_ADDR_ROW1 |
+           ARM_NAND_CODE_SEND_CMD2      |
+           ARM_NAND_CODE_WAIT_BUSY      ;
+
+    if (h->dev->col_cycles > 1) {
+      code |= ARM_NAND_CODE_SEND_ADDR_COL2;
+    }
+    if (h->dev->row_cycles > 2) {
+      code |= ARM_NAND_CODE_SEND_ADDR_ROW2 | ARM_NAND_CODE_SEND_ADDR_ROW3;
+    }
+    else if (h->dev->row_cycles > 1) {
+      code |= ARM_NAND_CODE_SEND_ADDR_ROW2;
+    }
+
+    h->seq = 1;
+
+    drv->ExecuteSequence (h->dev->device_number,
+                          code,
+                          cmd,
+                          0,
+                          row,
+                          NULL,
+                          0,
+                          &h->status,
+                          &h->seq);
+    /* Wait until done */
+    if (WaitDrvBusy (drv, h->dev->device_number) == false) {
+      EvrFsNAND_DriverTimeoutError (h->instance, drv);
+      return (NAND_ERROR_TIMEOUT);
+    }
+  }
+
+  /* Move page to the cache register and start loading the next one */
+  if (mode & NAND_CACHE_OP_LAST) {
+    cmd = NAND_CMD_READ_CACHE_END;
+  }
+  else {
+    cmd = NAND_CMD_READ_CACHE_SEQUENTIAL;
+  }
+
+  code = ARM_NAND_CODE_SEND_CMD1 | ARM_NAND_CODE_WAIT_BUSY;
+
+  if (len) {
+    code |= ARM_NAND_CODE_READ_DATA | h->ecc;
+  }
+
+  h->seq = 1;
+
+  drv->ExecuteSequence (h->dev->device_number,
+                        code,
+                        cmd,
+                        0,
+                        row,
+                        buf,
+                        len,
+                        &h->status,
+                        &h->seq);
+  /* Wait until done */
+  if (WaitDrvBusy (drv, h->dev->device_number) == false) {
+    EvrFsNAND_DriverTimeoutError (h->instance, drv);
+    return (NAND_ERROR_TIMEOUT);
+  }
+  return (NAND_OK);
+}
+
+/*
+  Read sequential page using cache register (Bus interface).
+*/
+static int32_t ReadCache_Cmd (NAND_MEDIA_HANDLE *h, uint32_t row, uint8_t *buf, uint32_t len, uint32_t mode) {
+  ARM_DRIVER_NAND *drv     = h->hw->drv;
+  uint32_t         dev_num = h->dev->device_number;
+
+  if (mode & NAND_CACHE_OP_FIRST) {
+    /* Send Read 1st command */
+    drv->SendCommand (dev_num, NAND_CMD_READ_1ST);
+
+    /* Send address */
+    SendAddress (drv, dev_num, 0, h->dev->col_cycles);
+    SendAddress (drv, dev_num, row, h->dev->row_cycles);
+
+    /* Send Read 2nd command */
+    drv->SendCommand (dev_num, NAND_CMD_READ_2ND);
+
+    /* Wait until device ready */
+    if (WaitDevReady (drv, dev_num) == false) {
+      EvrFsNAND_DeviceTimeoutError (h->instance, drv, dev_num);
+      return NAND_ERROR_TIMEOUT;
+    }
+  }
+
+  /* Move page to the cache register and start loading the next one */
+  if (mode & NAND_CACHE_OP_LAST) {
+    drv->SendCommand (dev_num, NAND_CMD_READ_CACHE_END);
+  }
+  else {
+    drv->SendCommand (dev_num, NAND_CMD_READ_CACHE_SEQUENTIAL);
+  }
+
+  /* Wait until cache register ready */
+  if (WaitDevReady (drv, dev_num) == false) {
+    EvrFsNAND_DeviceTimeoutError (h->instance, drv, dev_num);
+    return NAND_ERROR_TIMEOUT;
+  }
+
+  /* Switch back to Read operation */
+  drv->SendCommand (dev_num, NAND_CMD_READ_1ST);
+
+  if (len) {
+    /* Transfer data from the cache register */
+    if (drv->ReadData (dev_num, buf, len, ARM_NAND_DRIVER_DONE_EVENT | h->ecc) != (int32_t)len) {
+      /* Wait until done */
+      if (WaitDrvBusy (drv, h->dev->device_number) == false) {
+        EvrFsNAND_DriverTimeoutError (h->instance, drv);
+        return (NAND_ERROR_TIMEOUT);
+      }
+    }
+  }
+
+  return (NAND_OK);
+}
+
+/**
+  \fn          int32_t ReadCache (NAND_MEDIA_HANDLE *h,
+                                  uint32_t           row,
+                                  uint8_t           *buf,
+                                  uint32_t           len,
+                                  uint32_t           mode)
+  \brief       Read sequential page using Read Cache commands.
+
+  The first call of a run (NAND_CACHE_OP_FIRST) loads the page at row into
+  the data register. Every call then moves the loaded page into the cache
+  register and returns its data, while the device already loads the next
+  page of the block. The last call (NAND_CACHE_OP_LAST) ends the run.
+  Buffer length may be zero to end a run without reading the data.
+
+  \param[in]   h    NAND Media Handle
+  \param[in]   row  Row address of the page being returned
+  \param[out]  buf  Buffer for data read from NAND
+  \param[in]   len  Number of bytes to read (buffer length)
+  \param[in]   mode Cache operation mode flags
+  \return      execution status
+*/
+static int32_t ReadCache (NAND_MEDIA_HANDLE *h, uint32_t row, uint8_t *buf, uint32_t len, uint32_t mode) {
+  int32_t rval;
+  NAND_HW_DRIVER *hw = h->hw;
+
+  /* Reading page */
+  EvrFsNAND_PageRead (h->instance, row, 0, len);
+
+  if (hw->capabilities.ce_manual) {
+    hw->drv->ChipEnable (h->dev->device_number, true);
+  }
+
+  if (h->dev->bus_width) {
+    len >>= 1;
+  }
+
+  if (hw->capabilities.sequence_operation == 0) {
+    rval = ReadCache_Cmd (h, row, buf, len, mode);
+  }
+  else {
+    rval = ReadCache_Seq (h, row, buf, len, mode);
+  }
+
+  return (rval);
+}
+
+
 /*
   Write data to NAND page (ExecuteSequence interface).
 */
-static int32_t WritePage_Seq (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, const uint8_t *buf, uint32_t len) {
+static int32_t WritePage_Seq (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, const uint8_t *buf, uint32_t len, uint32_t cmd2) {
   ARM_DRIVER_NAND *drv = h->hw->drv;
   uint32_t cmd;
   uint32_t code;
 
-  cmd = NAND_CMD_PROGRAM_1ST | (NAND_CMD_PROGRAM_2ND << 8);
+  cmd = NAND_CMD_PROGRAM_1ST | (cmd2 << 8);
 
   code = ARM_NAND_CODE_SEND_CMD1      |
          ARM_NAND_CODE_SEND_ADDR_COL1 |
@@ -840,7 +1022,7 @@ static int32_t WritePage_Seq (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col,
 /*
   Write data to NAND page (Bus interface).
 */
-static int32_t WritePage_Cmd (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, const uint8_t *buf, uint32_t len) {
+static int32_t WritePage_Cmd (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, const uint8_t *buf, uint32_t len, uint32_t cmd2) {
   ARM_DRIVER_NAND *drv     = h->hw->drv;
   uint32_t         dev_num = h->dev->device_number;
 
@@ -861,7 +1043,7 @@ static int32_t WritePage_Cmd (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col,
   }
 
   /* Send Program 2nd command */
-  drv->SendCommand (dev_num, NAND_CMD_PROGRAM_2ND);
+  drv->SendCommand (dev_num, (uint8_t)cmd2);
 
   return (NAND_OK);
 }
@@ -896,10 +1078,64 @@ static int32_t WritePage (NAND_MEDIA_HANDLE *h, uint32_t row, uint32_t col, cons
   }
 
   if (hw->capabilities.sequence_operation == 0) {
-    rval = WritePage_Cmd (h, row, col, buf, len);
+    rval = WritePage_Cmd (h, row, col, buf, len, NAND_CMD_PROGRAM_2ND);
+  }
+  else {
+    rval = WritePage_Seq (h, row, col, buf, len, NAND_CMD_PROGRAM_2ND);
+  }
+
+  return (rval);
+}
+
+
+/**
+  \fn          int32_t WriteCache (      NAND_MEDIA_HANDLE *h
+                                         uint32_t  row,
+                                   const uint8_t  *buf,
+                                         uint32_t  len,
+                                         uint32_t  mode)
+  \brief       Write sequential page using Page Cache Program command.
+
+  Pages other than the last one (NAND_CACHE_OP_LAST) are confirmed with
+  Page Cache Program command, which releases the cache register as soon
+  as the page is moved into the data register. Caller must wait until
+  device is ready before writing the next page.
+
+  \param[in]   h    NAND Media Handle
+  \param[in]   row  Row address
+  \param[out]  buf  Buffer with data to write to NAND
+  \param[in]   len  Number of bytes to write (buffer length)
+  \param[in]   mode Cache operation mode flags
+  \return      execution status
+*/
+static int32_t WriteCache (NAND_MEDIA_HANDLE *h, uint32_t row, const uint8_t *buf, uint32_t len, uint32_t mode) {
+  int32_t rval;
+  uint32_t cmd2;
+  NAND_HW_DRIVER *hw = h->hw;
+
+  /* Writing page */
+  EvrFsNAND_PageWrite (h->instance, row, 0, len);
+
+  if (hw->capabilities.ce_manual) {
+    hw->drv->ChipEnable (h->dev->device_number, true);
+  }
+
+  if (h->dev->bus_width) {
+    len >>= 1;
+  }
+
+  if (mode & NAND_CACHE_OP_LAST) {
+    cmd2 = NAND_CMD_PROGRAM_2ND;
+  }
+  else {
+    cmd2 = NAND_CMD_PAGE_CACHE_PROGRAM_2ND;
+  }
+
+  if (hw->capabilities.sequence_operation == 0) {
+    rval = WritePage_Cmd (h, row, 0, buf, len, cmd2);
   }
   else {
-    rval = WritePage_Seq (h, row, col, buf, len);
+    rval = WritePage_Seq (h, row, 0, buf, len, cmd2);
   }
 
   return (rval);
@@ -1296,5 +1532,7 @@ __WEAK NAND_MEDIA_DRIVER NAND_MediaDriver = {
   EraseBlock,
   ReadStatus,
   GetFeatures,
-  SetFeatures
+  SetFeatures,
+  ReadCache,
+  WriteCache
 };
@@ -93,6 +93,20 @@
 #define NAND_CMD_SET_FEATURES           0xEF  ///< Set Features
 
 
+/**
+  NAND Optional Commands Support Flags (ONFI V1.0 or higher)
+*/
+#define NAND_OPT_CACHE_PROGRAM          0x01  ///< Page Cache Program supported
+#define NAND_OPT_CACHE_READ             0x02  ///< Read Cache Sequential and Read Cache End supported
+
+
+/**
+  NAND Media Driver Cache Operation Mode Flags
+*/
+#define NAND_CACHE_OP_FIRST             0x01  ///< First page of a sequential page run
+#define NAND_CACHE_OP_LAST              0x02  ///< Last page of a sequential page run
+
+
 /* JEDEC manufacturer ID */
 #define JEDEC_ID_MICRON_TECH            0x2C  /* Micron Technology           */
 
@@ -259,6 +259,58 @@ static uint32_t Drv_ReadPage (uint32_t row, uint8_t *buf, NAND_FTL_DEV *ftl) {
 }
 
 
+/**
+  Wait until page program completes and check program status
+
+  \param[in]     row       page row address
+  \param[in]     ready     status flags which indicate that device is ready
+  \param[in]     fail      status flags which indicate that program failed
+  \param[in]     ftl       FTL instance object
+*/
+static uint32_t Drv_ProgramStatus (uint32_t row, uint32_t ready, uint32_t fail, NAND_FTL_DEV *ftl) {
+  uint32_t tick, tout;
+  uint32_t exec_status;
+  uint8_t  nand_status;
+
+  nand_status = 0;
+
+  /* Wait until NAND ready or timeout expires */
+  tout = fs_get_sys_tick_us (NAND_WRITE_TIMEOUT);
+  tick = fs_get_sys_tick();
+  do {
+    NAND_MediaDriver.ReadStatus (ftl->Media, &nand_status);
+
+    if ((nand_status & ready) == ready) {
+      break;
+    }
+  } while ((fs_get_sys_tick() - tick) < tout);
+
+  if ((nand_status & ready) != ready) {
+    NAND_MediaDriver.ReadStatus (ftl->Media, &nand_status);
+  }
+
+  EvrFsNFTL_StatusRead (ftl->Media->instance, nand_status);
+
+  if ((nand_status & ready) == ready) {
+    if (nand_status & fail) {
+      /* Page program failed */
+      EvrFsNFTL_PageProgramStatusErr (ftl->Media->instance, row);
+      exec_status = FTL_ERROR_PROGRAM;
+    } else {
+      /* Page program completed */
+      exec_status = FTL_OK;
+    }
+  }
+  else {
+    /* Page program timeout expired */
+    EvrFsNFTL_PageProgramTimeout (ftl->Media->instance, row);
+    exec_status = FTL_ERROR_TIMEOUT;
+  }
+
+  return (exec_status);
+}
+
+
 /**
   NAND media driver WritePage wrapper
 
@@ -268,48 +320,100 @@ static uint32_t Drv_ReadPage (uint32_t row, uint8_t *buf, NAND_FTL_DEV *ftl) {
 */
 static uint32_t Drv_WritePage (uint32_t row, uint8_t *buf, NAND_FTL_DEV *ftl) {
   int32_t  rtv;
-  uint32_t tick, tout;
   uint32_t exec_status;
-  uint8_t  nand_status;
 
   EvrFsNFTL_PageWrite (ftl->Media->instance, row / ftl->Media->dev->page_count, row % ftl->Media->dev->page_count);
 
   rtv = NAND_MediaDriver.WritePage (ftl->Media, row, 0, buf, pDev->page_size);
 
   if (rtv == NAND_OK) {
-    nand_status = 0;
+    exec_status = Drv_ProgramStatus (row, NAND_STAT_RDY, NAND_STAT_FAIL, ftl);
+  }
+  else {
+    /* Write error */
+    EvrFsNFTL_PageProgramFailed (ftl->Media->instance, row);
+    /* Driver error */
+    exec_status = FTL_ERROR_DRIVER;
+  }
 
-    /* Wait until NAND ready or timeout expires */
-    tout = fs_get_sys_tick_us (NAND_WRITE_TIMEOUT);
-    tick = fs_get_sys_tick();
-    do {
-      NAND_MediaDriver.ReadStatus (ftl->Media, &nand_status);
+  return (exec_status);
+}
 
-      if (nand_status & NAND_STAT_RDY) {
-        break;
-      }
-    } while ((fs_get_sys_tick() - tick) < tout);
 
-    if ((nand_status & NAND_STAT_RDY) == 0) {
-      NAND_MediaDriver.ReadStatus (ftl->Media, &nand_status);
-    }
+/**
+  NAND media driver ReadCache wrapper
 
-    EvrFsNFTL_StatusRead (ftl->Media->instance, nand_status);
+  \param[in]     row       page row address
+  \param[out]    buf       page buffer or NULL to end the sequence
+  \param[in]     mode      cache operation mode flags
+  \param[in]     ftl       FTL instance object
+*/
+static uint32_t Drv_ReadCache (uint32_t row, uint8_t *buf, uint32_t mode, NAND_FTL_DEV *ftl) {
+  int32_t  rtv;
+  uint32_t status;
 
-    if (nand_status & NAND_STAT_RDY) {
-      if (nand_status & NAND_STAT_FAIL) {
-        /* Page program failed */
-        EvrFsNFTL_PageProgramStatusErr (ftl->Media->instance, row);
-        exec_status = FTL_ERROR_PROGRAM;
-      } else {
-        /* Page program completed */
-        exec_status = FTL_OK;
-      }
+  EvrFsNFTL_PageRead (ftl->Media->instance, row / ftl->Media->dev->page_count, row % ftl->Media->dev->page_count);
+
+  rtv = NAND_MediaDriver.ReadCache (ftl->Media, row, buf, (buf != NULL) ? pDev->page_size : 0U, mode);
+
+  switch (rtv) {
+    case NAND_OK:
+      status = FTL_OK;
+      break;
+
+    case NAND_ERROR_ECC_CORRECTED:
+      status = FTL_ERROR_ECC_COR;
+      break;
+
+    case NAND_ERROR_ECC_FAILED:
+      status = FTL_ERROR_ECC_FAIL;
+      break;
+
+    default:
+      /* Read page error */
+      EvrFsNFTL_PageReadFailed (ftl->Media->instance, row);
+      status = FTL_ERROR_DRIVER;
+      break;
+  }
+
+  return (status);
+}
+
+
+/**
+  NAND media driver WriteCache wrapper
+
+  Page cache program reports status of the previous page in the sequence,
+  status of the last page is known when the whole sequence is completed.
+
+  \param[in]     row       page row address
+  \param[in]     buf       page buffer
+  \param[in]     mode      cache operation mode flags
+  \param[in]     ftl       FTL instance object
+*/
+static uint32_t Drv_WriteCache (uint32_t row, uint8_t *buf, uint32_t mode, NAND_FTL_DEV *ftl) {
+  int32_t  rtv;
+  uint32_t exec_status;
+  uint32_t fail;
+
+  EvrFsNFTL_PageWrite (ftl->Media->instance, row / ftl->Media->dev->page_count, row % ftl->Media->dev->page_count);
+
+  rtv = NAND_MediaDriver.WriteCache (ftl->Media, row, buf, pDev->page_size, mode);
+
+  if (rtv == NAND_OK) {
+    fail = 0U;
+
+    if (mode & NAND_CACHE_OP_LAST) {
+      fail |= NAND_STAT_FAIL;
     }
-    else {
-      /* Page program timeout expired */
-      EvrFsNFTL_PageProgramTimeout (ftl->Media->instance, row);
-      exec_status = FTL_ERROR_TIMEOUT;
+    if ((mode & NAND_CACHE_OP_FIRST) == 0U) {
+      fail |= NAND_STAT_FAILC;
+    }
+    exec_status = Drv_ProgramStatus (row, NAND_STAT_RDY, fail, ftl);
+
+    if ((exec_status != FTL_OK) && ((mode & NAND_CACHE_OP_LAST) == 0U)) {
+      /* Sequence interrupted, wait until array operation is completed */
+      Drv_ProgramStatus (row, NAND_STAT_RDY | NAND_STAT_ARDY, 0U, ftl);
     }
   }
   else {
@@ -439,6 +543,8 @@ static uint32_t Drv_ReadParameters (NAND_FTL_DEV *ftl) {
   uint32_t status;
   NAND_PARAM_PAGE *p;
 
+  ftl->Media->opt_cmd = 0U;
+
   if (NAND_MediaDriver.ReadParamPage (ftl->Media, 0, ftl->PgBuf, 256) == NAND_OK) {
     /* Examine parameter page values */
     p = (NAND_PARAM_PAGE *)ftl->PgBuf;
@@ -450,6 +556,15 @@ static uint32_t Drv_ReadParameters (NAND_FTL_DEV *ftl) {
 
       /* Remember correctability level */
       ftl->Media->ecc_req = p->ecc_correctability;
+
+      /* Remember supported cache commands */
+      if (NAND_MediaDriver.WriteCache != NULL) {
+        ftl->Media->opt_cmd |= p->optional[0] & NAND_OPT_CACHE_PROGRAM;
+      }
+      if ((NAND_MediaDriver.ReadCache != NULL) && (pDev->sw_ecc != 2)) {
+        /* EZ NAND reports ECC status per page, not usable with cache read */
+        ftl->Media->opt_cmd |= p->optional[0] & NAND_OPT_CACHE_READ;
+      }
     }
     status = FTL_OK;
   }
@@ -534,7 +649,7 @@ static uint32_t Drv_SetupFeatures (NAND_FTL_DEV *ftl) {
 */
 static uint32_t Drv_ManageECC (NAND_FTL_DEV *ftl) {
   const NAND_DEVICE *dev = ftl->Media->dev;
-  uint32_t status;
+  uint32_t status, spare;
 
   status = FTL_OK;
 
@@ -562,6 +677,15 @@ static uint32_t Drv_ManageECC (NAND_FTL_DEV *ftl) {
   /* Provide layout override support */
   fs_nand_setup_layout (ftl->Media->instance, &ftl->PgLay);
 
+  if (dev->sw_ecc >= 4) {
+    /* Software BCH, ECC must fit into the spare area of each sector */
+    spare = (dev->page_size - (dev->page_sectors * __SZ_SECT)) / dev->page_sectors;
+
+    if ((ftl->PgLay.spare.ofs_ecc + BCH_ECC_LEN(BCH_T(dev->sw_ecc))) > spare) {
+      status = FTL_ERROR;
+    }
+  }
+
   EvrFsNFTL_SetupPageLayout  (ftl->Media->instance, ftl->PgLay.sector_inc,    ftl->PgLay.spare_ofs,     ftl->PgLay.spare_inc);
   EvrFsNFTL_SetupSpareLayout (ftl->Media->instance, ftl->PgLay.spare.ofs_lsn, ftl->PgLay.spare.ofs_dcm, ftl->PgLay.spare.ofs_bbm, ftl->PgLay.spare.ofs_ecc);
 
@@ -628,17 +752,128 @@ static uint32_t Log2(uint32_t x) {
 }
 
 /**
-  Select new slot from page cache array
+  Determine page cache hash chain for a page
+
+  \param[in]      row       page row address
+  \return hash chain index
+*/
+__STATIC_FORCEINLINE uint32_t PgHash (uint32_t row) {
+  return ((row ^ (row >> 5) ^ (row >> 10)) & (NAND_PG_HASH_SIZE - 1));
+}
+
+/**
+  Update access time of page cache slot
 
   \param[in,out]  Ca        indexing cache control block
-  \return slot number
+  \param[in]      slot      slot number
+*/
+static void PgCacheTouch (NAND_FTL_CACHE *Ca, uint32_t slot) {
+  uint32_t i;
+
+  Ca->PageTime++;
+
+  if (Ca->PageTime == 0) {
+    /* Time wrapped, restart aging */
+    for (i = 0; i < Ca->CachedPages; i++) {
+      Ca->Page[i].age = 0;
+    }
+    Ca->PageTime = 1;
+  }
+  Ca->Page[slot].age = Ca->PageTime;
+}
+
+/**
+  Find page in page cache
+
+  \param[in]      Ca        indexing cache control block
+  \param[in]      row       page row address
+  \return slot number or INVALID when page is not cached
 */
-__STATIC_FORCEINLINE uint32_t GetPageCacheSlot (NAND_FTL_CACHE *Ca) {
+static uint32_t PgCacheFind (NAND_FTL_CACHE *Ca, uint32_t row) {
   uint32_t slot;
 
-  /* Select next slot */
-  slot = Ca->CachePS++;
-  if (Ca->CachePS == Ca->CachedPages) { Ca->CachePS = 0; }
+  for (slot = Ca->Hash[PgHash (row)]; slot != 0xFF; slot = Ca->Page[slot].next) {
+    if ((Ca->Page[slot].row & ~BIT_UNCOR) == row) {
+      return (slot);
+    }
+  }
+  return (INVALID);
+}
+
+/**
+  Remove page from page cache
+
+  \param[in,out]  Ca        indexing cache control block
+  \param[in]      slot      slot number
+*/
+static void PgCacheRemove (NAND_FTL_CACHE *Ca, uint32_t slot) {
+  uint8_t *p;
+
+  if (Ca->Page[slot].row != INVALID) {
+    /* Unlink slot from hash chain */
+    p = &Ca->Hash[PgHash (Ca->Page[slot].row & ~BIT_UNCOR)];
+
+    while (*p != 0xFF) {
+      if (*p == slot) {
+        *p = Ca->Page[slot].next;
+        break;
+      }
+      p = &Ca->Page[*p].next;
+    }
+    Ca->Page[slot].row = INVALID;
+  }
+  /* Reuse this slot first */
+  Ca->Page[slot].age = 0;
+}
+
+/**
+  Select new slot from page cache array
+
+  Least recently used slot is selected. Pages from the table area and pages
+  from the data area are cached in separate parts of the cache array, so
+  that data access does not evict translation table pages.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      row       row address of a page
+  \return slot number
+*/
+static uint32_t GetPageCacheSlot (NAND_FTL_DEV *ftl, uint32_t row) {
+  NAND_FTL_CACHE *Ca = &ftl->Ca;
+  uint32_t slot, i, n, h;
+
+  if (PBN(row) <= ftl->Cfg->BttEndBn) {
+    /* Table area page */
+    i = 0;
+    n = Ca->TablePages;
+  }
+  else {
+    /* Data area page */
+    i = Ca->TablePages;
+    n = Ca->CachedPages;
+  }
+
+  if (i == n) {
+    /* Cache is not divided */
+    i = 0;
+    n = Ca->CachedPages;
+  }
+
+  /* Select least recently used slot */
+  for (slot = i++; i < n; i++) {
+    if (Ca->Page[i].age < Ca->Page[slot].age) {
+      slot = i;
+    }
+  }
+
+  PgCacheRemove (Ca, slot);
+
+  /* Insert slot into hash chain */
+  h = PgHash (row);
+
+  Ca->Page[slot].row  = row;
+  Ca->Page[slot].next = Ca->Hash[h];
+  Ca->Hash[h] = (uint8_t)slot;
+
   return slot;
 }
 
@@ -653,34 +888,28 @@ __STATIC_FORCEINLINE uint32_t GetPageCacheSlot (NAND_FTL_CACHE *Ca) {
 */
 static uint32_t CachePgRead (NAND_FTL_DEV *ftl, uint32_t row, uint32_t col, uint32_t sz) {
   uint32_t slot, rtv;
-  uint32_t usecache = 0;
 
   EvrFsNFTL_CacheRead (ftl->Media->instance, row / ftl->Media->dev->page_count, row % ftl->Media->dev->page_count, col);
 
   rtv = FTL_OK;
 
-  for (slot = 0; slot < ftl->Ca.CachedPages; slot++) {
-    if ((ftl->Ca.Page[slot].row & ~BIT_UNCOR) == row) {
-      usecache = 1;
+  slot = PgCacheFind (&ftl->Ca, row);
 
-      if (ftl->Ca.Page[slot].row & BIT_UNCOR) {
-        /* Return ECC Error */
-        rtv = FTL_ERROR_ECC;
-      }
-      break;
+  if (slot != INVALID) {
+    if (ftl->Ca.Page[slot].row & BIT_UNCOR) {
+      /* Return ECC Error */
+      rtv = FTL_ERROR_ECC;
     }
   }
-
-  /* Read from flash to cache if row isn't cached */
-  if (!usecache) {
-    slot = GetPageCacheSlot (&ftl->Ca);
-    ftl->Ca.Page[slot].row = row;
+  else {
+    /* Read from flash to cache if row isn't cached */
+    slot = GetPageCacheSlot (ftl, row);
 
     rtv = Drv_ReadPage (row, ftl->Ca.Page[slot].buf, ftl);
 
     if (rtv == FTL_OK) {
-      if (pDev->sw_ecc == 1) {
-        /* Hamming ECC is enabled, decode ECC */
+      if (SW_ECC) {
+        /* Software ECC is enabled, decode ECC */
         rtv = DecodeECC(ftl, ftl->Ca.Page[slot].buf);
       }
     }
@@ -700,6 +929,8 @@ static uint32_t CachePgRead (NAND_FTL_DEV *ftl, uint32_t row, uint32_t col, uint
       rtv = FTL_ERROR_ECC;
     }
   }
+  PgCacheTouch (&ftl->Ca, slot);
+
   memcpy (ftl->PgBuf, &ftl->Ca.Page[slot].buf[col], sz);
 
   /* Set ECC Status */
@@ -720,23 +951,22 @@ static uint32_t CachePgRead (NAND_FTL_DEV *ftl, uint32_t row, uint32_t col, uint
 */
 static uint32_t CachePgWrite (NAND_FTL_DEV *ftl, uint32_t row) {
   uint32_t slot;
-  uint32_t newslot = 1;
 
   EvrFsNFTL_CacheWrite (ftl->Media->instance, row / ftl->Media->dev->page_count, row % ftl->Media->dev->page_count);
 
-  for (slot = 0; slot < ftl->Ca.CachedPages; slot++) {
-    if (ftl->Ca.Page[slot].row == row) {
-      newslot = 0;
-      break;
-    }
+  slot = PgCacheFind (&ftl->Ca, row);
+
+  if (slot == INVALID) {
+    slot = GetPageCacheSlot (ftl, row);
   }
-  if (newslot) {
-    slot = GetPageCacheSlot (&ftl->Ca);
+  else {
+    /* Page content is replaced, clear uncorrectable flag */
     ftl->Ca.Page[slot].row = row;
   }
+  PgCacheTouch (&ftl->Ca, slot);
 
-  if (pDev->sw_ecc == 1) {
-    /* Hamming ECC is enabled, encode ECC */
+  if (SW_ECC) {
+    /* Software ECC is enabled, encode ECC */
     EncodeECC (ftl, ftl->PgBuf);
   }
   memcpy (ftl->Ca.Page[slot].buf, ftl->PgBuf, pDev->page_size);
@@ -754,10 +984,27 @@ static uint32_t CachePgWrite (NAND_FTL_DEV *ftl, uint32_t row) {
 static void FlushPgCache (NAND_FTL_CACHE *Ca, uint32_t row) {
   uint32_t slot;
 
-  for (slot = 0; slot < Ca->CachedPages; slot++) {
-    if (Ca->Page[slot].row == row) {
-      Ca->Page[slot].row = INVALID;
-      break;
+  slot = PgCacheFind (Ca, row);
+
+  if (slot != INVALID) {
+    PgCacheRemove (Ca, slot);
+  }
+}
+
+/**
+  Flush cached pages of a block from cache
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      pbn       physical block number
+*/
+static void FlushPgCacheBlock (NAND_FTL_DEV *ftl, uint16_t pbn) {
+  uint32_t slot;
+
+  for (slot = 0; slot < ftl->Ca.CachedPages; slot++) {
+    if (ftl->Ca.Page[slot].row != INVALID) {
+      if (PBN(ftl->Ca.Page[slot].row & ~BIT_UNCOR) == pbn) {
+        PgCacheRemove (&ftl->Ca, slot);
+      }
     }
   }
 }
@@ -777,27 +1024,57 @@ static void FlushIdxCache(NAND_FTL_CACHE *Ca, uint16_t pbn) {
     if (Ca->Block[slot].pbn == pbn) {
       Ca->Block[slot].pbn    = INVALID_BLOCK;
       Ca->Block[slot].nextPg = 0;
+      Ca->Block[slot].age    = 0;
       break;
     }
   }
 }
 
+/**
+  Update access time of index cache slot
+
+  \param[in,out]  Ca        indexing cache control block
+  \param[in]      slot      slot number
+*/
+static void IdxCacheTouch (NAND_FTL_CACHE *Ca, uint32_t slot) {
+  uint32_t i;
+
+  Ca->BlockTime++;
+
+  if (Ca->BlockTime > 0xFFFF) {
+    /* Time wrapped, restart aging */
+    for (i = 0; i < Ca->CachedBlocks; i++) {
+      Ca->Block[i].age = 0;
+    }
+    Ca->BlockTime = 1;
+  }
+  Ca->Block[slot].age = (uint16_t)Ca->BlockTime;
+}
+
 /**
   Select new slot from index cache array
 
-  \param[in]      Ca        indexing cache control block
+  Least recently used slot is selected.
+
+  \param[in,out]  Ca        indexing cache control block
+  \param[in]      skip      slot which must not be selected or INVALID
   \return slot number
 */
-static uint32_t GetIdxCacheSlot(NAND_FTL_CACHE *Ca) {
-  uint32_t slot;
+static uint32_t GetIdxCacheSlot(NAND_FTL_CACHE *Ca, uint32_t skip) {
+  uint32_t slot, i;
 
-  /* Select next slot */
-  slot = Ca->CacheBS++;
+  slot = INVALID;
 
-  if (Ca->CacheBS == Ca->CachedBlocks) {
-    Ca->CacheBS = 0;
+  for (i = 0; i < Ca->CachedBlocks; i++) {
+    if (i != skip) {
+      if ((slot == INVALID) || (Ca->Block[i].age < Ca->Block[slot].age)) {
+        slot = i;
+      }
+    }
   }
 
+  IdxCacheTouch (Ca, slot);
+
   return slot;
 }
 
@@ -890,6 +1167,7 @@ static uint32_t EraseBlock (NAND_FTL_DEV *ftl, uint16_t *pbn) {
 
   /* Flush cache */
   FlushIdxCache (&ftl->Ca, *pbn);
+  FlushPgCacheBlock (ftl, *pbn);
 
   row = ROW(*pbn, 0);
 
@@ -902,6 +1180,12 @@ static uint32_t EraseBlock (NAND_FTL_DEV *ftl, uint16_t *pbn) {
       *pbn = INVALID_BLOCK;
     }
   }
+  else {
+    /* Count erases for static wear leveling */
+    if (ftl->WlCnt < 0xFFFF) {
+      ftl->WlCnt++;
+    }
+  }
   return rtv;
 }
 
@@ -974,36 +1258,141 @@ static uint32_t ScanTable (NAND_FTL_DEV *ftl, uint32_t lbn, uint32_t blTyp, uint
 
 
 /**
-  Mark block specified by pbn as bad. If erase argument is set to true, block is first
-  erased or not erased if set to false.
-  All spare area bytes of the first sector in the first page are invalidated
-  (set to 0). In case if write to the first page is unsuccessful, then spare area
-  of the last page is invalidated (set to 0).
+  Scan translation table and find primary block for the table garbage
+  collection which was interrupted by power loss.
+
+  Garbage collection copies table pages in page order into a new primary
+  block and erases old primary block before the replacement block. Until
+  replacement block is erased, several primary blocks with the same logical
+  block number (lbn) may exist. Block whose pages are not in page order was
+  written by table updates and is the original primary block. Otherwise,
+  block with most pages written is selected, since every copy contains the
+  same table sectors as the original block.
 
   \param[in,out]  ftl       FTL instance object
-  \param[in]      pbn       physical block number
-  \param[in]      erase     erase flag
+  \param[in]      lbn       logical block number
+  \param[out]    *pbn       pointer where physical block number is stored
   \returns execution status FTL_STATUS
 */
-static uint32_t MarkBlockBad (NAND_FTL_DEV *ftl, uint16_t pbn, uint32_t erase) {
-  uint32_t row, rtv;
+static uint32_t ScanTablePrim (NAND_FTL_DEV *ftl, uint32_t lbn, uint16_t *pbn) {
+  uint16_t block;
+  uint32_t lsn, type, cPg, maxPg, rtv;
 
-  /* Marking block as bad */
-  EvrFsNFTL_SetBadBlockMarker (ftl->Media->instance, pbn);
+  *pbn  = INVALID_BLOCK;
+  maxPg = 0;
 
-  row = ROW(pbn, 0);
+  for (block = ftl->Cfg->BttStartBn; block <= ftl->Cfg->BttEndBn; block++) {
+    for (cPg = 0; cPg < pDev->page_count; cPg++) {
+      rtv = CachePgRead (ftl, ROW(block, cPg), ftl->PgLay.spare_ofs, __SZ_SP_USED);
 
-  if (erase) {
-    rtv = Drv_EraseBlock (row, ftl);
-    if (rtv != FTL_OK && rtv != FTL_ERROR_ERASE) {
-      /* Driver error */
-      return rtv;
-    }
-  }
+      /* Ignore ECC error */
+      if ((rtv != FTL_OK) && (rtv != FTL_ERROR_ECC)) {
+        return rtv;
+      }
 
-  /* Invalidate first spare area in page */
-  memset (ftl->PgBuf, 0xFF, pDev->page_size);
-  memset (&ftl->PgBuf[ftl->PgLay.spare_ofs], 0x00, __SZ_SPARE);
+      /* Skip bad block */
+      if ((cPg == 0) && (ftl->PgBuf[ftl->PgLay.spare.ofs_bbm] != BB_MASK)) {
+        break;
+      }
+
+      lsn = GetLSN (&ftl->PgBuf[ftl->PgLay.spare.ofs_lsn], &type);
+
+      if ((lsn == EMPTY) || (type != TYP_PRIM) || (LBN(lsn) != lbn)) {
+        break;
+      }
+
+      if (lsn != IDX2LSN(lbn, cPg)) {
+        /* Table sectors are not in page order */
+        *pbn = block;
+        return FTL_OK;
+      }
+    }
+
+    if (cPg > maxPg) {
+      maxPg = cPg;
+      *pbn  = block;
+    }
+  }
+
+  if (*pbn == INVALID_BLOCK) {
+    return FTL_ERROR_NOT_FOUND;
+  }
+  return FTL_OK;
+}
+
+
+/**
+  Erase all primary table blocks with given logical block number (lbn) except
+  the one specified by keepBN.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      lbn       logical block number
+  \param[in]      keepBN    physical block number of valid primary block
+  \returns execution status FTL_STATUS
+*/
+static uint32_t EraseTablePrim (NAND_FTL_DEV *ftl, uint32_t lbn, uint16_t keepBN) {
+  uint16_t block, cBN;
+  uint32_t lsn, type, rtv;
+
+  for (block = ftl->Cfg->BttStartBn; block <= ftl->Cfg->BttEndBn; block++) {
+    if (block == keepBN) {
+      continue;
+    }
+
+    rtv = CachePgRead (ftl, ROW(block, 0), ftl->PgLay.spare_ofs, __SZ_SP_USED);
+
+    /* Ignore ECC error */
+    if ((rtv != FTL_OK) && (rtv != FTL_ERROR_ECC)) {
+      return rtv;
+    }
+
+    if (ftl->PgBuf[ftl->PgLay.spare.ofs_bbm] == BB_MASK) {
+      lsn = GetLSN (&ftl->PgBuf[ftl->PgLay.spare.ofs_lsn], &type);
+
+      if ((lsn != EMPTY) && (type == TYP_PRIM) && (LBN(lsn) == lbn)) {
+        cBN = block;
+        rtv = EraseBlock (ftl, &cBN);
+        if (rtv != FTL_OK) {
+          return rtv;
+        }
+      }
+    }
+  }
+  return FTL_OK;
+}
+
+
+/**
+  Mark block specified by pbn as bad. If erase argument is set to true, block is first
+  erased or not erased if set to false.
+  All spare area bytes of the first sector in the first page are invalidated
+  (set to 0). In case if write to the first page is unsuccessful, then spare area
+  of the last page is invalidated (set to 0).
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      pbn       physical block number
+  \param[in]      erase     erase flag
+  \returns execution status FTL_STATUS
+*/
+static uint32_t MarkBlockBad (NAND_FTL_DEV *ftl, uint16_t pbn, uint32_t erase) {
+  uint32_t row, rtv;
+
+  /* Marking block as bad */
+  EvrFsNFTL_SetBadBlockMarker (ftl->Media->instance, pbn);
+
+  row = ROW(pbn, 0);
+
+  if (erase) {
+    rtv = Drv_EraseBlock (row, ftl);
+    if (rtv != FTL_OK && rtv != FTL_ERROR_ERASE) {
+      /* Driver error */
+      return rtv;
+    }
+  }
+
+  /* Invalidate first spare area in page */
+  memset (ftl->PgBuf, 0xFF, pDev->page_size);
+  memset (&ftl->PgBuf[ftl->PgLay.spare_ofs], 0x00, __SZ_SPARE);
 
   ftl->BadBlockCnt++;
 
@@ -1293,13 +1682,14 @@ static uint32_t ScanBlock (NAND_FTL_DEV *ftl, uint16_t pbn, uint32_t lsn, uint32
         lbn  = ftl->Ca.Block[slot].lbn;
         type = ftl->Ca.Block[slot].typ;
         caRead = 1;
+        IdxCacheTouch (&ftl->Ca, slot);
         break;
       }
     }
     /* If we are not reading from cache, we will write */
     if (caRead == 0) {
       /* Select slot to write into */
-      slot = GetIdxCacheSlot(&ftl->Ca);
+      slot = GetIdxCacheSlot(&ftl->Ca, INVALID);
 
       ftl->Ca.Block[slot].pbn = pbn;
       ftl->Ca.Block[slot].nextPg = 0;
@@ -1469,6 +1859,52 @@ static uint32_t FindEmptyBlock (NAND_FTL_DEV *ftl, uint32_t area, uint16_t *bn)
   return FTL_ERROR_NOT_FOUND;
 }
 
+/**
+  Fold PRIM/REPL pair of a logical block into an empty block
+
+  Valid pages are copied into the empty block, translation table is
+  updated and old blocks are erased. Erased blocks are put in queue
+  if requested, otherwise they are found later by FindEmptyBlock.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      lbn       logical block number
+  \param[in,out] *btti      translation table entry of a logical block
+  \param[in]      emptyBN   physical block number of an empty block
+  \param[in]      queue     put erased blocks in queue (true/false)
+  \return execution status FTL_STATUS
+*/
+static uint32_t FoldBlocks (NAND_FTL_DEV *ftl, uint16_t lbn, BTT_ITEM *btti, uint16_t emptyBN, uint32_t queue) {
+  uint16_t pbn;
+  uint32_t rtv;
+
+  /* Start garbage collection */
+  rtv = GcRun (ftl, lbn, btti, AREA_DAT, emptyBN);
+  if (rtv != FTL_OK) {
+    return rtv;
+  }
+
+  /* GC ok, now update translation table */
+  pbn = INVALID_BLOCK;
+  rtv = UpdateBTT (ftl, lbn, &emptyBN, &pbn);
+  if (rtv != FTL_OK) {
+    return rtv;
+  }
+
+  /* Erase old blocks */
+  rtv = EraseBlock (ftl, &btti->primBN);
+  if (rtv != FTL_OK) { return rtv; }
+  rtv = EraseBlock (ftl, &btti->replBN);
+  if (rtv != FTL_OK) { return rtv; }
+
+  if (queue) {
+    /* Put blocks in queue if erase was ok */
+    if (btti->primBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti->primBN);
+    if (btti->replBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti->replBN);
+  }
+
+  return FTL_OK;
+}
+
 /**
   Function searches for logical block in data area with allocated
   PRIM/REPL pair. When pair of blocks is found, garbage collection is
@@ -1541,40 +1977,16 @@ static uint32_t ForceDataGc(NAND_FTL_DEV *ftl) {
       if (btti.primBN != INVALID_BLOCK && btti.replBN != INVALID_BLOCK) {
         if (lbn != ftl->CurrLBN) {
           /* Start garbage collection */
-          rtv = GcRun (ftl, lbn, &btti, AREA_DAT, emptyBN);
-
-          if (rtv == FTL_OK) {
-
-            /* GC ok, now update translation table */
-            pbn = INVALID_BLOCK;
-            rtv = UpdateBTT(ftl, lbn, &emptyBN, &pbn);
-
-            if (rtv != FTL_OK) {
-              return rtv;
-            }
+          rtv = FoldBlocks (ftl, lbn, &btti, emptyBN, true);
 
-            emptyBN = INVALID_BLOCK;
-
-            /* Erase old blocks */
-            rtv = EraseBlock (ftl, &btti.primBN);
-            if (rtv != FTL_OK) { return rtv; }
-            rtv = EraseBlock (ftl, &btti.replBN);
-            if (rtv != FTL_OK) { return rtv; }
-
-            /* Put blocks in queue if erase was ok */
-            if (btti.primBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti.primBN);
-            if (btti.replBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti.replBN);
-          }
-          else {
+          if (rtv != FTL_OK) {
             return rtv;
           }
 
-          if (emptyBN == INVALID_BLOCK) {
-            /* Empty block was used, set LBN for next GC and return */
-            ftl->GcLBN = lbn + 1;
-            if (ftl->GcLBN == ftl->NumDataBlocks) { ftl->GcLBN = 0; }
-            return FTL_OK;
-          }
+          /* Empty block was used, set LBN for next GC and return */
+          ftl->GcLBN = lbn + 1;
+          if (ftl->GcLBN == ftl->NumDataBlocks) { ftl->GcLBN = 0; }
+          return FTL_OK;
         }
       }
     }
@@ -1693,6 +2105,16 @@ static uint32_t SearchBTT(NAND_FTL_DEV *ftl, uint32_t lbn, BTT_ITEM *btt) {
   /* Check if given LSN in range for our flash device */
   if (lbn < ftl->NumDataBlocks) {
 
+    if (ftl->BttTable != NULL) {
+      /* Read entry from RAM table */
+      btt->primBN = (uint16_t)(ftl->BttTable[lbn]);
+      btt->replBN = (uint16_t)(ftl->BttTable[lbn] >> 16);
+
+      /* Found [%d, %d] translation entry for LBN %d */
+      EvrFsNFTL_LbnToPbn (ftl->Media->instance, lbn, btt->primBN, btt->replBN);
+      return FTL_OK;
+    }
+
     tsn = lbn >> BTT_EPS;
 
     /* Find entry in ram table */
@@ -1807,10 +2229,11 @@ static uint32_t UpdateBTT(NAND_FTL_DEV *ftl, uint16_t lbn, uint16_t *primBN, uin
     primRow = 0x00FFFFFF;
     replRow = 0x00FFFFFF;
     tsnB = tbnS << ftl->PPB;                /* First table index in block */
-    tsnE = tsnB + ftl->TsnTableSize;        /* Last table index in block  */
+    tsnE = tsnB + pDev->page_count;         /* Last table index in block  */
 
-    if (ftl->TsnTableSize > pDev->page_count) {
-      tsnE = tsnB + pDev->page_count;
+    if (tsnE > ftl->TsnTableSize) {
+      /* Last block of the table is only partially used */
+      tsnE = ftl->TsnTableSize;
     }
 
     for (tsnIdx = tsnB; tsnIdx < tsnE; tsnIdx++) {
@@ -1984,6 +2407,16 @@ static uint32_t UpdateBTT(NAND_FTL_DEV *ftl, uint16_t lbn, uint16_t *primBN, uin
     /* Update entry in RAM table */
     ftl->TsnTable[tsnIdx] = row | (wrTyp << 24);
 
+    if (ftl->BttTable != NULL) {
+      /* Update entry in RAM translation table */
+      if (primBN != NULL) {
+        ftl->BttTable[lbn] = (ftl->BttTable[lbn] & 0xFFFF0000U) | *primBN;
+      }
+      if (replBN != NULL) {
+        ftl->BttTable[lbn] = (ftl->BttTable[lbn] & 0x0000FFFFU) | ((uint32_t)*replBN << 16);
+      }
+    }
+
     if ((wrTyp == TYP_REPL) && (freePg == (uint32_t)(pDev->page_count-1))) {
       /* This is last page in replacement block, start GC */
 
@@ -2068,16 +2501,14 @@ static uint32_t GcRun(NAND_FTL_DEV *ftl, uint16_t lbn, BTT_ITEM *btt, uint32_t g
 
   /* Check if block in cache */
   for (slot = 0; slot < ftl->Ca.CachedBlocks; slot++) {
-    if (ftl->Ca.Block[slot].pbn == btt->primBN) { primSlot = slot; }
-    if (ftl->Ca.Block[slot].pbn == btt->replBN) { replSlot = slot; }
+    if (ftl->Ca.Block[slot].pbn == btt->primBN) { primSlot = slot; IdxCacheTouch (&ftl->Ca, slot); }
+    if (ftl->Ca.Block[slot].pbn == btt->replBN) { replSlot = slot; IdxCacheTouch (&ftl->Ca, slot); }
   }
 
   /* Assign cache slots to noncached blocks */
   if (primSlot == INVALID) {
     /* Primary block is not in cache */
-    slot = GetIdxCacheSlot(&ftl->Ca);
-    if (slot == replSlot) { slot = GetIdxCacheSlot(&ftl->Ca); }
-    primSlot = slot;
+    primSlot = GetIdxCacheSlot(&ftl->Ca, replSlot);
 
     ftl->Ca.Block[primSlot].pbn = btt->primBN;
     ftl->Ca.Block[primSlot].lbn = lbn;
@@ -2087,9 +2518,7 @@ static uint32_t GcRun(NAND_FTL_DEV *ftl, uint16_t lbn, BTT_ITEM *btt, uint32_t g
 
   if (replSlot == INVALID) {
     /* Replacement block is not in cache */
-    slot = GetIdxCacheSlot(&ftl->Ca);
-    if (slot == primSlot) { slot = GetIdxCacheSlot(&ftl->Ca); }
-    replSlot = slot;
+    replSlot = GetIdxCacheSlot(&ftl->Ca, primSlot);
 
     ftl->Ca.Block[replSlot].pbn = btt->replBN;
     ftl->Ca.Block[replSlot].lbn = lbn;
@@ -2261,12 +2690,231 @@ static uint32_t GcRun(NAND_FTL_DEV *ftl, uint16_t lbn, BTT_ITEM *btt, uint32_t g
 
   ftl->Ca.Block[primSlot].pbn    = INVALID_BLOCK;
   ftl->Ca.Block[primSlot].nextPg = 0;
+  ftl->Ca.Block[primSlot].age    = 0;
   ftl->Ca.Block[replSlot].pbn    = INVALID_BLOCK;
   ftl->Ca.Block[replSlot].nextPg = 0;
+  ftl->Ca.Block[replSlot].age    = 0;
 
   return FTL_OK;
 }
 
+/**
+  Read a run of whole pages from primary block using cache read
+
+  Pages are read from direct offsets within the block. While page N is
+  being decoded and copied to the caller's buffer, device already loads
+  page N+1 into its data register. Run stops at the first page which
+  does not contain expected logical sectors or reports an ECC event,
+  such page is left to the regular read path.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      pbn       physical block number of primary block
+  \param[in]      lsn       logical sector number (page aligned)
+  \param[out]    *buf       pointer to data buffer
+  \param[in,out] *cnt       number of sectors to read / sectors read
+  \param[out]    *eccWarn   set when data corruption marker found
+  \return execution status FTL_STATUS
+*/
+static uint32_t ReadRun (NAND_FTL_DEV *ftl, uint16_t pbn, uint32_t lsn, uint8_t *buf, uint32_t *cnt, uint32_t *eccWarn) {
+  uint32_t pg, num, i, sec, mode, rtv;
+  uint32_t di, si;
+
+  pg  = LSN2IDX(lsn);
+  num = *cnt >> ftl->SPP;
+  if (num > (uint32_t)(pDev->page_count - pg)) {
+    num = pDev->page_count - pg;
+  }
+  *cnt = 0;
+
+  if (num < 2) {
+    return FTL_OK;
+  }
+
+  rtv  = FTL_OK;
+  mode = NAND_CACHE_OP_FIRST;
+
+  for (i = 0; i < num; i++) {
+    if (i == (num - 1)) {
+      mode |= NAND_CACHE_OP_LAST;
+    }
+
+    rtv  = Drv_ReadCache (ROW(pbn, pg + i), ftl->PgBuf, mode, ftl);
+    mode = 0;
+
+    if (rtv == FTL_OK) {
+      if (SW_ECC) {
+        /* Software ECC is enabled, decode ECC */
+        rtv = DecodeECC (ftl, ftl->PgBuf);
+      }
+    }
+    if (rtv != FTL_OK) {
+      break;
+    }
+
+    /* Check if page contains expected LSN */
+    if (GetLSN (&ftl->PgBuf[ftl->PgLay.spare_ofs + ftl->PgLay.spare.ofs_lsn], NULL) != lsn) {
+      break;
+    }
+
+    for (sec = 0,  di = 0,                      si = ftl->PgLay.spare_ofs;
+         sec < ftl->PageSectors;
+         sec++,    di += ftl->PgLay.sector_inc, si += ftl->PgLay.spare_inc) {
+
+      EvrFsNFTL_LoadSector (ftl->Media->instance, lsn, di, si);
+
+      memcpy (buf, &ftl->PgBuf[di], __SZ_SECT);
+
+      if (ftl->PgBuf[si + ftl->PgLay.spare.ofs_dcm] != 0xFF) {
+        *eccWarn = true;
+      }
+      buf += __SZ_SECT;
+      lsn++;
+    }
+    *cnt += ftl->PageSectors;
+  }
+
+  if (i < (num - 1)) {
+    /* Run interrupted, end the cache read sequence */
+    if (Drv_ReadCache (ROW(pbn, pg + i + 1), NULL, NAND_CACHE_OP_LAST, ftl) != FTL_OK) {
+      return FTL_ERROR_DRIVER;
+    }
+  }
+
+  if ((rtv == FTL_ERROR_ECC_COR) || (rtv == FTL_ERROR_ECC_FAIL)) {
+    /* Page is reread and block relocated by the regular read path */
+    rtv = FTL_OK;
+  }
+
+  return (rtv);
+}
+
+/**
+  Determine number of whole pages which can be written as a run
+
+  Pages of a run are written to consecutive free pages of the same block,
+  starting with the page already selected by the regular write path. Next
+  page belongs to the run when the regular write path would also select
+  the same block for it: primary block when logical sector does not exist
+  yet, replacement block when it already exists in one of the blocks.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]     *btti      primary and replacement block
+  \param[in]      lsn       logical sector number (page aligned)
+  \param[in]      cnt       number of sectors to write
+  \param[in]      blTyp     type of block selected for the first page
+  \param[in]      freePg    free page selected for the first page
+  \param[in]      empty     block selected for the first page is empty
+  \return number of pages in the run
+*/
+static uint32_t WriteRunLength (NAND_FTL_DEV *ftl, BTT_ITEM *btti, uint32_t lsn, uint32_t cnt, uint32_t blTyp, uint32_t freePg, uint32_t empty) {
+  uint32_t num, max, pg, rtv;
+
+  max = cnt >> ftl->SPP;
+  if (max > (uint32_t)(pDev->page_count - LSN2IDX(lsn))) {
+    max = pDev->page_count - LSN2IDX(lsn);
+  }
+  if (max > (pDev->page_count - freePg)) {
+    max = pDev->page_count - freePg;
+  }
+
+  if ((blTyp == TYP_PRIM) && empty) {
+    /* Nothing written to this logical block yet */
+    return (max);
+  }
+
+  for (num = 1; num < max; num++) {
+    lsn += ftl->PageSectors;
+
+    if (blTyp == TYP_PRIM) {
+      /* Sector must not exist in either block */
+      if (btti->replBN != INVALID_BLOCK) {
+        if (ScanBlock (ftl, btti->replBN, lsn, &pg) != FTL_ERROR_NOT_FOUND) {
+          break;
+        }
+      }
+      if (ScanBlock (ftl, btti->primBN, lsn, &pg) != FTL_ERROR_NOT_FOUND) {
+        break;
+      }
+    }
+    else {
+      /* Sector must exist in one of the blocks */
+      rtv = FTL_ERROR_NOT_FOUND;
+      if (!empty) {
+        rtv = ScanBlock (ftl, btti->replBN, lsn, &pg);
+      }
+      if (rtv == FTL_ERROR_NOT_FOUND) {
+        rtv = ScanBlock (ftl, btti->primBN, lsn, &pg);
+      }
+      if (rtv != FTL_OK) {
+        break;
+      }
+    }
+  }
+
+  return (num);
+}
+
+/**
+  Write a run of whole pages using cache program
+
+  ECC of page N+1 is encoded while device programs page N.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      pbn       physical block number
+  \param[in]      pg        first page of the run
+  \param[in]      lsn       logical sector number (page aligned)
+  \param[in]     *buf       pointer to data buffer
+  \param[in]      num       number of pages to write
+  \param[in]      blTyp     block type
+  \return execution status FTL_STATUS
+*/
+static uint32_t WriteRun (NAND_FTL_DEV *ftl, uint16_t pbn, uint32_t pg, uint32_t lsn, const uint8_t *buf, uint32_t num, uint32_t blTyp) {
+  uint32_t i, sec, mode, row, rtv;
+  uint32_t di, si;
+
+  rtv = FTL_OK;
+
+  for (i = 0; i < num; i++) {
+    memset (ftl->PgBuf, 0xFF, pDev->page_size);
+
+    for (sec = 0,  di = 0,                      si = ftl->PgLay.spare_ofs;
+         sec < ftl->PageSectors;
+         sec++,    di += ftl->PgLay.sector_inc, si += ftl->PgLay.spare_inc) {
+
+      EvrFsNFTL_LoadSector (ftl->Media->instance, lsn, di, si);
+
+      memcpy (&ftl->PgBuf[di], buf, __SZ_SECT);
+      SetLSN (lsn, blTyp, &ftl->PgBuf[si + ftl->PgLay.spare.ofs_lsn]);
+      buf += __SZ_SECT;
+      lsn++;
+    }
+
+    if (SW_ECC) {
+      /* Software ECC is enabled, encode ECC */
+      EncodeECC (ftl, ftl->PgBuf);
+    }
+
+    mode = 0;
+    if (i == 0) {
+      mode |= NAND_CACHE_OP_FIRST;
+    }
+    if (i == (num - 1)) {
+      mode |= NAND_CACHE_OP_LAST;
+    }
+
+    /* Page may be cached as empty, remove it */
+    row = ROW(pbn, pg + i);
+    FlushPgCache (&ftl->Ca, row);
+
+    rtv = Drv_WriteCache (row, ftl->PgBuf, mode, ftl);
+    if (rtv != FTL_OK) {
+      break;
+    }
+  }
+
+  return (rtv);
+}
+
 /**
   Reads cnt sectors from NAND flash into *buf, starting from given
   logical sector number.
@@ -2295,10 +2943,10 @@ static uint32_t GcRun(NAND_FTL_DEV *ftl, uint16_t lbn, BTT_ITEM *btt, uint32_t g
 */
 uint32_t ftl_ReadSect(uint32_t lsn, uint8_t *buf, uint32_t cnt, NAND_FTL_DEV *ftl) {
   BTT_ITEM btti;
-  uint32_t empty, lookup, eccWarn;
+  uint32_t empty, lookup, eccWarn, run;
   uint32_t row, col;
   uint32_t cBN, sOffs, blTyp, sectPg, rtv;
-  uint32_t di, si;
+  uint32_t di, si, num;
 
   /* Read sector */
   EvrFsNFTL_ReadSector (ftl->Media->instance, lsn, buf, cnt);
@@ -2313,12 +2961,14 @@ uint32_t ftl_ReadSect(uint32_t lsn, uint8_t *buf, uint32_t cnt, NAND_FTL_DEV *ft
   empty   = false;
   eccWarn = false;
   lookup  = true;
+  run     = false;
   sectPg  = 0;
 
   ftl->CurrLBN = LBN(lsn);
 
   for (; cnt; ) {
     eccWarn = false;
+    empty   = false;
 
     /* Check table */
     if (lookup) {
@@ -2331,6 +2981,36 @@ uint32_t ftl_ReadSect(uint32_t lsn, uint8_t *buf, uint32_t cnt, NAND_FTL_DEV *ft
       if (rtv != FTL_OK) {
         return rtv;
       }
+      run = (ftl->Media->opt_cmd & NAND_OPT_CACHE_READ) ? true : false;
+    }
+
+    if (run) {
+      /* Try once per logical block */
+      run = false;
+
+      if ((empty == false) && (btti.primBN != INVALID_BLOCK) && (btti.replBN == INVALID_BLOCK)) {
+        if ((lsn & (ftl->PageSectors - 1)) == 0) {
+          /* Read whole pages from PRIM using cache read */
+          num = cnt;
+          rtv = ReadRun (ftl, btti.primBN, lsn, buf, &num, &eccWarn);
+          if (rtv != FTL_OK) {
+            return rtv;
+          }
+
+          if (num) {
+            buf += num * __SZ_SECT;
+            lsn += num;
+            cnt -= num;
+
+            /* Check if current LSN goes to other block */
+            if (LBN(lsn - 1) < LBN(lsn)) {
+              lookup = true;
+              ftl->CurrLBN = LBN(lsn);
+            }
+            continue;
+          }
+        }
+      }
     }
 
     cBN = btti.primBN;
@@ -2551,7 +3231,7 @@ uint32_t ftl_WriteSect(uint32_t lsn, const uint8_t *buf, uint32_t cnt, NAND_FTL_
   uint32_t oldBn, oldTyp;
   uint32_t sectPg, freePg, oldPg;
   uint32_t i, di, si, blTyp, rtv;
-  uint32_t k, cLsn, secNum;
+  uint32_t k, cLsn, secNum, num;
 
   /* Write sector */
   EvrFsNFTL_WriteSector (ftl->Media->instance, lsn, buf, cnt);
@@ -2722,49 +3402,64 @@ uint32_t ftl_WriteSect(uint32_t lsn, const uint8_t *buf, uint32_t cnt, NAND_FTL_
       }
     }
 
-    /* Read old LSN if exists or is needed */
-    if (oldPg != INVALID) {
-      if (!(lsn == cLsn && cnt >= ftl->PageSectors)) {
-        /* Read last valid page */
-        rtv = CachePgRead (ftl, ROW(oldBn, oldPg), 0, pDev->page_size);
-        if (rtv != FTL_OK) {
-          if (rtv != FTL_ERROR_ECC) { return rtv; }
-          /* Relocate block */
-          rtv = RefreshDataBlock(ftl, ftl->CurrLBN, oldTyp, &btti, pDev->page_count);
-          if (rtv != FTL_OK) {
-            return rtv;
-          }
-          continue;
-        }
+    num = 0;
+    if ((ftl->Media->opt_cmd & NAND_OPT_CACHE_PROGRAM) && (lsn == cLsn) && (cnt >= (2U << ftl->SPP))) {
+      /* Whole pages are written, check if next pages go to the same block */
+      num = WriteRunLength (ftl, &btti, lsn, cnt, blTyp, freePg, alloc);
+      if (num < 2) {
+        num = 0;
       }
     }
-    else {
-      memset (ftl->PgBuf, 0xFF, pDev->page_size);
+
+    if (num) {
+      /* Write run of pages using cache program */
+      rtv = WriteRun (ftl, cBN, freePg, lsn, buf, num, blTyp);
     }
+    else {
+      /* Read old LSN if exists or is needed */
+      if (oldPg != INVALID) {
+        if (!(lsn == cLsn && cnt >= ftl->PageSectors)) {
+          /* Read last valid page */
+          rtv = CachePgRead (ftl, ROW(oldBn, oldPg), 0, pDev->page_size);
+          if (rtv != FTL_OK) {
+            if (rtv != FTL_ERROR_ECC) { return rtv; }
+            /* Relocate block */
+            rtv = RefreshDataBlock(ftl, ftl->CurrLBN, oldTyp, &btti, pDev->page_count);
+            if (rtv != FTL_OK) {
+              return rtv;
+            }
+            continue;
+          }
+        }
+      }
+      else {
+        memset (ftl->PgBuf, 0xFF, pDev->page_size);
+      }
 
-    /* Prepare buffer for writing */
-    secNum = lsn & (ftl->PageSectors - 1);
-    p = buf;
+      /* Prepare buffer for writing */
+      secNum = lsn & (ftl->PageSectors - 1);
+      p = buf;
 
-    for (i = 0,       di = 0,                      si = ftl->PgLay.spare_ofs;
-         i < ftl->PageSectors;
-         i++, cLsn++, di += ftl->PgLay.sector_inc, si += ftl->PgLay.spare_inc) {
+      for (i = 0,       di = 0,                      si = ftl->PgLay.spare_ofs;
+           i < ftl->PageSectors;
+           i++, cLsn++, di += ftl->PgLay.sector_inc, si += ftl->PgLay.spare_inc) {
 
-      if (i == secNum) {
-        EvrFsNFTL_LoadSector (ftl->Media->instance, cLsn, di, si);
+        if (i == secNum) {
+          EvrFsNFTL_LoadSector (ftl->Media->instance, cLsn, di, si);
 
-        memcpy (&ftl->PgBuf[di], p, __SZ_SECT);
-        ftl->PgBuf[si + ftl->PgLay.spare.ofs_dcm] = 0xFF;
-        p += __SZ_SECT;
-        k++;
-        if (cnt - k) secNum++;
+          memcpy (&ftl->PgBuf[di], p, __SZ_SECT);
+          ftl->PgBuf[si + ftl->PgLay.spare.ofs_dcm] = 0xFF;
+          p += __SZ_SECT;
+          k++;
+          if (cnt - k) secNum++;
+        }
+
+        SetLSN (cLsn, blTyp, &ftl->PgBuf[si + ftl->PgLay.spare.ofs_lsn]);
       }
 
-      SetLSN (cLsn, blTyp, &ftl->PgBuf[si + ftl->PgLay.spare.ofs_lsn]);
+      /* Write page */
+      rtv = CachePgWrite (ftl, ROW(cBN, freePg));
     }
-
-    /* Write page */
-    rtv = CachePgWrite (ftl, ROW(cBN, freePg));
     if (rtv != FTL_OK) {
       if(rtv != FTL_ERROR_PROGRAM) {
         return rtv;
@@ -2781,6 +3476,13 @@ uint32_t ftl_WriteSect(uint32_t lsn, const uint8_t *buf, uint32_t cnt, NAND_FTL_
       continue;
     }
 
+    if (num) {
+      /* Run written, freePg is the last page of the run */
+      k       = num << ftl->SPP;
+      p       = buf + (k * __SZ_SECT);
+      freePg += num - 1;
+    }
+
     /* Update table if we allocated new block */
     if (alloc) {
       rtv = UpdateBTT (ftl, LBN(lsn), &btti.primBN, &btti.replBN);
@@ -2875,12 +3577,74 @@ static uint16_t CalcDataBlocks (NAND_FTL_DEV *ftl, uint16_t DataBBCnt) {
   \param[in,out]  ftl       FTL instance object
 */
 static void InitBtt (NAND_FTL_DEV *ftl) {
-  uint32_t tsnIdx;
+  uint32_t tsnIdx, lbn;
 
   /* Init table array */
   for (tsnIdx = 0; tsnIdx < ftl->TsnTableSize; tsnIdx++) {
     ftl->TsnTable[tsnIdx] = INVALID;
   }
+
+  if (ftl->BttTable != NULL) {
+    /* Init translation table in RAM */
+    for (lbn = 0; lbn < ftl->Cfg->BttTableSize; lbn++) {
+      ftl->BttTable[lbn] = INVALID;
+    }
+  }
+}
+
+/**
+  Load translation table into RAM
+
+  Each valid table page is read and translation entries of all logical
+  blocks are copied into RAM translation table.
+
+  \param[in,out]  ftl       FTL instance object
+  \return execution status FTL_STATUS
+*/
+static uint32_t LoadBttRam (NAND_FTL_DEV *ftl) {
+  uint16_t pbn;
+  uint32_t tsnIdx, tsn, lbn, row, i, n, rtv;
+  uint8_t *p;
+
+  for (tsnIdx = 0; tsnIdx < ftl->TsnTableSize; tsnIdx++) {
+    row = ftl->TsnTable[tsnIdx] & 0x00FFFFFF;
+
+    if (row == 0x00FFFFFF) {
+      /* Table sectors were not written yet */
+      continue;
+    }
+
+    rtv = CachePgRead (ftl, row, 0, pDev->page_size);
+
+    if ((rtv != FTL_OK) && (rtv != FTL_ERROR_ECC)) {
+      return rtv;
+    }
+
+    /* Copy entries from all table sectors within page */
+    for (i = 0; i < ftl->PageSectors; i++) {
+      tsn = (tsnIdx << ftl->SPP) + i;
+      lbn = tsn << BTT_EPS;
+      p   = &ftl->PgBuf[i * ftl->PgLay.sector_inc];
+
+      for (n = 0; n < (1U << BTT_EPS); n++, lbn++, p += BTT_ENTRY_SZ) {
+        if (lbn >= ftl->NumDataBlocks) {
+          break;
+        }
+        ftl->BttTable[lbn] = (uint32_t)p[0]        | ((uint32_t)p[1] << 8) |
+                             ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+      }
+    }
+
+    if (rtv == FTL_ERROR_ECC) {
+      pbn = PBN(row);
+      rtv = RelocBlock (ftl, &pbn, pDev->page_count, AREA_TBL, true);
+
+      if (rtv != FTL_OK) {
+        return rtv;
+      }
+    }
+  }
+  return FTL_OK;
 }
 
 /**
@@ -2954,7 +3718,7 @@ static uint32_t LoadBtt (NAND_FTL_DEV *ftl) {
         /* Start garbage collection */
         btti.primBN = INVALID_BLOCK;
 
-        rtv = ScanTable (ftl, LBN(tsn), TYP_PRIM, &btti.primBN);
+        rtv = ScanTablePrim (ftl, LBN(tsn), &btti.primBN);
         if (rtv != FTL_OK) { return rtv; }
 
         btti.replBN = cBN;
@@ -2972,14 +3736,19 @@ gc:
           return rtv;
         }
 
-        /* Now erase old blocks */
-        rtv = EraseBlock (ftl, &btti.primBN);
+        /* Now erase old blocks, replacement block last */
+        rtv = EraseTablePrim (ftl, LBN(tsn), allocBN);
         if (rtv != FTL_OK) { return rtv; }
         rtv = EraseBlock (ftl, &btti.replBN);
         if (rtv != FTL_OK) { return rtv; }
       }
     }
   }
+
+  if (ftl->BttTable != NULL) {
+    /* Load complete translation table into RAM */
+    return (LoadBttRam (ftl));
+  }
   return FTL_OK;
 }
 
@@ -3003,8 +3772,8 @@ static uint32_t RdBootBlock (NAND_FTL_DEV *ftl) {
   stat = Drv_ReadPage (0, ftl->PgBuf, ftl);
 
   if (stat == FTL_OK || stat == FTL_ERROR_ECC_COR || stat == FTL_ERROR_ECC_FAIL) {
-    if (pDev->sw_ecc == 1) {
-      /* Hamming ECC is enabled, decode ECC */
+    if (SW_ECC) {
+      /* Software ECC is enabled, decode ECC */
       DecodeECC(ftl, ftl->PgBuf);
     }
 
@@ -3144,6 +3913,10 @@ static uint32_t ftl_Format (NAND_FTL_DEV *ftl, void *par) {
 
     row = ROW (block, 0);
 
+    /* Block content is lost, remove it from cache */
+    FlushIdxCache (&ftl->Ca, (uint16_t)block);
+    FlushPgCacheBlock (ftl, (uint16_t)block);
+
     if (bad == false || ebb == true) {
       /* Erase block if not bad or if erase of bad blocks requested */
       rtv = Drv_EraseBlock (row, ftl);
@@ -3196,8 +3969,8 @@ static uint32_t ftl_Format (NAND_FTL_DEV *ftl, void *par) {
   p[8] = DataBBCnt;                 /* 8. data bad block count            */
   p[9] = BOOT_SIGN;                 /* 9. signature                       */
 
-  if (pDev->sw_ecc == 1) {
-    /* Hamming ECC is enabled, encode ECC */
+  if (SW_ECC) {
+    /* Software ECC is enabled, encode ECC */
     EncodeECC (ftl, ftl->PgBuf);
   }
 
@@ -3308,12 +4081,19 @@ static uint32_t ftl_init_resources (NAND_FTL_DEV *ftl) {
   ftl->Ca.Block = cfg->BlockCache;
   ftl->Ca.Page  = cfg->PageCache;
   ftl->TsnTable = cfg->TsnTable;
+  ftl->BttTable = cfg->BttTable;
 
   /* Load buffer sizes */
   ftl->Ca.CachedBlocks = cfg->NumCacheBlocks;
   ftl->Ca.CachedPages  = cfg->NumCachePages;
   ftl->TsnTableSize    = cfg->TsnTableSize;
 
+  /* Reserve a quarter of page cache for translation table pages */
+  ftl->Ca.TablePages = 0;
+  if (cfg->NumCachePages > 2) {
+    ftl->Ca.TablePages = (cfg->NumCachePages + 3) / 4;
+  }
+
   /* Load default page layout */
   ftl->PgLay.spare.ofs_lsn  = DL_POS_LSN;
   ftl->PgLay.spare.ofs_dcm  = DL_POS_COR;
@@ -3334,6 +4114,8 @@ static uint32_t ftl_init_resources (NAND_FTL_DEV *ftl) {
   ftl->LastDBN     = cfg->DataEndBn;
 
   ftl->GcLBN         = 0;
+  ftl->WlLBN         = 0;
+  ftl->WlCnt         = 0;
   ftl->BadBlockCnt   = 0;
   ftl->NumDataBlocks = 0;
   ftl->Status        = 0;
@@ -3347,12 +4129,21 @@ static uint32_t ftl_init_resources (NAND_FTL_DEV *ftl) {
   for (bp = cfg->BlockCacheBuf, i = 0; i < cfg->NumCacheBlocks; i++, bp += pDev->page_count) {
     ftl->Ca.Block[i].pbn   = INVALID_BLOCK;
     ftl->Ca.Block[i].pgIdx = bp;
+    ftl->Ca.Block[i].age   = 0;
   }
+  ftl->Ca.BlockTime = 0;
 
   /* Init page caching */
   for (bp = cfg->PageCacheBuf, i = 0; i < cfg->NumCachePages; i++, bp += pDev->page_size) {
-    ftl->Ca.Page[i].row = INVALID;
-    ftl->Ca.Page[i].buf = bp;
+    ftl->Ca.Page[i].row  = INVALID;
+    ftl->Ca.Page[i].buf  = bp;
+    ftl->Ca.Page[i].age  = 0;
+    ftl->Ca.Page[i].next = 0xFF;
+  }
+  ftl->Ca.PageTime = 0;
+
+  for (i = 0; i < NAND_PG_HASH_SIZE; i++) {
+    ftl->Ca.Hash[i] = 0xFF;
   }
 
   /* Init Block Translation Table Cache */
@@ -3471,6 +4262,213 @@ uint32_t ftl_ReadInfo (fsMediaInfo *info, NAND_FTL_DEV *ftl) {
 }
 
 
+/**
+  Perform one step of background reclaim
+
+  Block allocation queue is filled with erased blocks first. If there are
+  not enough erased blocks, any PRIM/REPL pair is folded to gain empty
+  blocks. Otherwise a pair whose REPL block is filled at least to the
+  configured threshold is folded, so that foreground writes do not need
+  to run garbage collection on it. When the configured number of blocks
+  was erased, a block without REPL (rarely written data) is moved to an
+  erased block to include its physical block into wear leveling.
+  At most one block pair is folded or one block is moved per call.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[out]    *cnt       number of erased blocks in allocation queue
+  \return execution status FTL_STATUS
+*/
+static uint32_t ftl_Reclaim (NAND_FTL_DEV *ftl, uint32_t *cnt) {
+  BTT_ITEM btti;
+  uint16_t lbn, pbn, emptyBN;
+  uint32_t num, pg, scan, rtv;
+
+  if ((ftl->Status & FTL_STATUS_MOUNT) == 0) {
+    return FTL_ERROR_UNMOUNTED;
+  }
+
+  /* Fill allocation queue with erased blocks */
+  num = NumBlocksInQueue (ftl->PbnQ);
+
+  while (num < __MIN_IN_QUEUE && num != INVALID) {
+    rtv = FindEmptyBlock (ftl, AREA_DAT, &pbn);
+    if (rtv != FTL_OK) {
+      if (rtv == FTL_ERROR_NOT_FOUND) break;
+      else return rtv;
+    }
+    num = PutBlockInQueue (ftl->PbnQ, pbn);
+  }
+
+  rtv = FTL_ERROR_NOT_FOUND;
+
+  if (NumBlocksInQueue (ftl->PbnQ) < __MIN_IN_QUEUE) {
+    /* Not enough erased blocks, fold any block pair */
+    rtv = ForceDataGc (ftl);
+  }
+  else if (ftl->Cfg->GcThreshold != 0U) {
+    /* Fold block pair with REPL block filled above threshold */
+    lbn  = ftl->GcLBN;
+    scan = 0;
+    do {
+      rtv = SearchBTT (ftl, lbn, &btti);
+      if (rtv != FTL_OK) {
+        return rtv;
+      }
+
+      if ((btti.primBN != INVALID_BLOCK) && (btti.replBN != INVALID_BLOCK) && (lbn != ftl->CurrLBN)) {
+        if (scan == __MAX_GC_SCAN) {
+          /* Continue scanning with this LBN in next step */
+          ftl->GcLBN = lbn;
+          rtv = FTL_ERROR_NOT_FOUND;
+          break;
+        }
+        scan++;
+
+        /* Find first empty page in REPL */
+        rtv = ScanBlock (ftl, btti.replBN, EMPTY, &pg);
+
+        if ((rtv == FTL_OK) || (rtv == FTL_ERROR_NOT_FOUND_EOB)) {
+          if ((pg * 100U) >= (ftl->Cfg->GcThreshold * (uint32_t)pDev->page_count)) {
+            rtv = GetBlockFromQueue (ftl->PbnQ, &emptyBN, ALLOC_LAST);
+            if (rtv != FTL_OK) {
+              return rtv;
+            }
+
+            /* Leave erased blocks to allocation in turn (wear leveling) */
+            rtv = FoldBlocks (ftl, lbn, &btti, emptyBN, false);
+            if (rtv != FTL_OK) {
+              return rtv;
+            }
+
+            /* Set LBN for next GC */
+            ftl->GcLBN = lbn + 1;
+            if (ftl->GcLBN == ftl->NumDataBlocks) { ftl->GcLBN = 0; }
+            break;
+          }
+        }
+        else if (rtv != FTL_ERROR_ECC) {
+          return rtv;
+        }
+      }
+      rtv = FTL_ERROR_NOT_FOUND;
+
+      lbn++;
+      if (lbn == ftl->NumDataBlocks) { lbn = 0; }
+    }
+    while (lbn != ftl->GcLBN);
+  }
+
+  if ((rtv == FTL_ERROR_NOT_FOUND) && (ftl->Cfg->WlInterval != 0U) && (ftl->WlCnt >= ftl->Cfg->WlInterval)) {
+    /* Static wear leveling: move next block without REPL */
+    lbn = ftl->WlLBN;
+    do {
+      rtv = SearchBTT (ftl, lbn, &btti);
+      if (rtv != FTL_OK) {
+        return rtv;
+      }
+
+      if ((btti.primBN != INVALID_BLOCK) && (btti.replBN == INVALID_BLOCK) && (lbn != ftl->CurrLBN)) {
+        EvrFsNFTL_WearLeveling (ftl->Media->instance, lbn, btti.primBN);
+
+        rtv = RefreshDataBlock (ftl, lbn, TYP_PRIM, &btti, pDev->page_count);
+        if (rtv != FTL_OK) {
+          return rtv;
+        }
+        ftl->WlCnt = 0;
+
+        /* Set LBN for next move */
+        ftl->WlLBN = lbn + 1;
+        if (ftl->WlLBN == ftl->NumDataBlocks) { ftl->WlLBN = 0; }
+        break;
+      }
+      rtv = FTL_ERROR_NOT_FOUND;
+
+      lbn++;
+      if (lbn == ftl->NumDataBlocks) { lbn = 0; }
+    }
+    while (lbn != ftl->WlLBN);
+  }
+
+  if ((rtv != FTL_OK) && (rtv != FTL_ERROR_NOT_FOUND)) {
+    return rtv;
+  }
+
+  *cnt = NumBlocksInQueue (ftl->PbnQ);
+
+  return FTL_OK;
+}
+
+
+/**
+  Discard range of logical sectors
+
+  Mapping of each logical block fully covered by the given sector range
+  is removed from translation table and its physical blocks are erased,
+  so that garbage collection no longer copies discarded data. Sectors of
+  partially covered logical blocks are left unchanged.
+
+  \param[in,out]  ftl       FTL instance object
+  \param[in]      lsn       first logical sector number
+  \param[in]      cnt       number of sectors
+  \return execution status FTL_STATUS
+*/
+static uint32_t ftl_Discard (NAND_FTL_DEV *ftl, uint32_t lsn, uint32_t cnt) {
+  BTT_ITEM btti;
+  uint16_t pbn;
+  uint32_t lbn, end, rtv;
+
+  if ((ftl->Status & FTL_STATUS_MOUNT) == 0) {
+    return FTL_ERROR_UNMOUNTED;
+  }
+
+  end = (uint32_t)ftl->NumDataBlocks << ftl->SPB;
+
+  if ((lsn >= end) || (cnt > (end - lsn))) {
+    return FTL_ERROR_RANGE;
+  }
+
+  EvrFsNFTL_Discard (ftl->Media->instance, lsn, cnt);
+
+  /* Process fully covered logical blocks only */
+  end = (lsn + cnt) >> ftl->SPB;
+  lbn = (lsn + (1U << ftl->SPB) - 1U) >> ftl->SPB;
+
+  for (; lbn < end; lbn++) {
+    rtv = SearchBTT (ftl, lbn, &btti);
+    if (rtv != FTL_OK) {
+      return rtv;
+    }
+
+    if ((btti.primBN == INVALID_BLOCK) && (btti.replBN == INVALID_BLOCK)) {
+      /* Logical block not mapped */
+      continue;
+    }
+
+    /* Remove mapping first, then erase blocks */
+    pbn = INVALID_BLOCK;
+    rtv = UpdateBTT (ftl, (uint16_t)lbn, &pbn, &pbn);
+    if (rtv != FTL_OK) {
+      return rtv;
+    }
+
+    if (btti.primBN != INVALID_BLOCK) {
+      rtv = EraseBlock (ftl, &btti.primBN);
+      if (rtv != FTL_OK) { return rtv; }
+    }
+    if (btti.replBN != INVALID_BLOCK) {
+      rtv = EraseBlock (ftl, &btti.replBN);
+      if (rtv != FTL_OK) { return rtv; }
+    }
+
+    /* Put erased blocks in queue, others are found by FindEmptyBlock */
+    if (btti.primBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti.primBN);
+    if (btti.replBN != INVALID_BLOCK) PutBlockInQueue(ftl->PbnQ, btti.replBN);
+  }
+
+  return FTL_OK;
+}
+
+
 /**
   Process given device control command
 
@@ -3514,6 +4512,22 @@ fsStatus ftl_DevCtrl (fsDevCtrlCode code, void *p, NAND_FTL_DEV *ftl) {
       status = fsOK;
     }
   }
+  else if (code == fsDevCtrlCodeReclaim) {
+    /* Background reclaim step */
+    if (p != NULL) {
+      if (ftl_Reclaim (ftl, (uint32_t *)p) == FTL_OK) {
+        status = fsOK;
+      }
+    }
+  }
+  else if (code == fsDevCtrlCodeDiscard) {
+    /* Discard sector range */
+    if (p != NULL) {
+      if (ftl_Discard (ftl, ((fsDiscardRange *)p)->sect, ((fsDiscardRange *)p)->cnt) == FTL_OK) {
+        status = fsOK;
+      }
+    }
+  }
   else {
     /* Unsupported */
     EvrFsNFTL_DevCtrlUnsupported (ftl->Media->instance, code);
@@ -3680,75 +4694,72 @@ static uint32_t ecc_Hamming8Verify (uint8_t *dataBuf, uint8_t *eccBuf) {
  *                   |     Row     |   Column    |    Row     |   Column   |
  *----------------------------------------------------------------------------*/
 static uint32_t ecc_Hamming512 (uint8_t *dataBuf, uint8_t *eccBuf) {
-  uint32_t i, colSum, rowSum0, rowSum1, rowSum2, rowSum3;
-  uint32_t h, val;
-
+  uint32_t i, colSum, rowSum0, rowSum1, rowSum2, rowSum3, rowSum4, rowSum5, rowSum6;
+  uint32_t w0, w1, w2, w3, w4, w5, w6, w7;
+  uint32_t a, b, c, d, e, g;
+  uint32_t h, odd;
+
+  /* Row parity bit Pn odd covers words with bit n of word index set, */
+  /* Pn even covers the remaining words. Words are XOR-ed into one    */
+  /* sum for each odd row parity bit, even bit is derived from the    */
+  /* parity of all words.                                             */
   colSum  = 0;
   rowSum0 = 0;
   rowSum1 = 0;
   rowSum2 = 0;
   rowSum3 = 0;
-
-  for (i = 0; i < 32; i++, dataBuf += 4) {
-    val = __UNALIGNED_UINT32_READ (dataBuf);
-
-    /* Column sum */
-    colSum ^= val;
-
-    /* Row sum */
-    rowSum0 |= parity32(val) << (i & 0x1F);
-  }
-  for (; i < 64; i++, dataBuf += 4) {
-    val = __UNALIGNED_UINT32_READ (dataBuf);
-
-    /* Column sum */
-    colSum ^= val;
-
-    /* Row sum */
-    rowSum1 |= parity32(val) << (i & 0x1F);
-  }
-  for (; i < 96; i++, dataBuf += 4) {
-    val = __UNALIGNED_UINT32_READ (dataBuf);
-
-    /* Column sum */
-    colSum ^= val;
-
-    /* Row sum */
-    rowSum2 |= parity32(val) << (i & 0x1F);
-  }
-  for (; i < 128; i++, dataBuf += 4) {
-    val = __UNALIGNED_UINT32_READ (dataBuf);
-
-    /* Column sum */
-    colSum ^= val;
-
-    /* Row sum */
-    rowSum3 |= parity32(val) << (i & 0x1F);
+  rowSum4 = 0;
+  rowSum5 = 0;
+  rowSum6 = 0;
+
+  for (i = 0; i < 16; i++, dataBuf += 32) {
+    w0 = __UNALIGNED_UINT32_READ (&dataBuf[0]);
+    w1 = __UNALIGNED_UINT32_READ (&dataBuf[4]);
+    w2 = __UNALIGNED_UINT32_READ (&dataBuf[8]);
+    w3 = __UNALIGNED_UINT32_READ (&dataBuf[12]);
+    w4 = __UNALIGNED_UINT32_READ (&dataBuf[16]);
+    w5 = __UNALIGNED_UINT32_READ (&dataBuf[20]);
+    w6 = __UNALIGNED_UINT32_READ (&dataBuf[24]);
+    w7 = __UNALIGNED_UINT32_READ (&dataBuf[28]);
+
+    a = w1 ^ w3;
+    b = w5 ^ w7;
+    c = w2 ^ w3;
+    d = w6 ^ w7;
+    e = w4 ^ w5;
+
+    /* Word index bits 0, 1, 2 */
+    rowSum0 ^= a ^ b;
+    rowSum1 ^= c ^ d;
+    rowSum2 ^= e ^ d;
+
+    /* Sum of the group, word index bits 3, 4, 5, 6 */
+    g = w0 ^ w1 ^ c ^ e ^ d;
+
+    colSum ^= g;
+    if (i & 0x01) { rowSum3 ^= g; }
+    if (i & 0x02) { rowSum4 ^= g; }
+    if (i & 0x04) { rowSum5 ^= g; }
+    if (i & 0x08) { rowSum6 ^= g; }
   }
 
   /* Column parity bits: P16, P8, P4, P2, P1 */
   h = ham32bit (colSum);
 
   /* Row parity bits: P64, P32, P16, P8, P4, P2, P1 */
-
-  /* Row: P64e */
-  val = rowSum1 ^ rowSum0;
-  h |= parity32 (val) << 11; // even bit(11)
-  /* Row: P64o */
-  val = rowSum3 ^ rowSum2;
-  h |= parity32 (val) << 27; // odd  bit(27)
-
-  /* Row: P32e */
-  val = rowSum2 ^ rowSum0;
-  h |= parity32 (val) << 10; // even bit(10)
-
-  /* Row: P32o */
-  val = rowSum3 ^ rowSum1;
-  h |= parity32 (val) << 26; // odd  bit(26)
-
-  /* Row: P16, P8, P4, P2, P1 */
-  val = rowSum3 ^ rowSum2 ^ rowSum1 ^ rowSum0;
-  h |= ham32bit (val) << 5;
+  odd = (parity32 (rowSum0)     ) |
+        (parity32 (rowSum1) << 1) |
+        (parity32 (rowSum2) << 2) |
+        (parity32 (rowSum3) << 3) |
+        (parity32 (rowSum4) << 4) |
+        (parity32 (rowSum5) << 5) |
+        (parity32 (rowSum6) << 6) ;
+
+  h |= odd << 21;                       // odd  bit(27..21)
+  if (parity32 (colSum)) {
+    odd ^= 0x7F;
+  }
+  h |= odd << 5;                        // even bit(11..5)
 
   eccBuf[0] = (uint8_t)(h);
   eccBuf[1] = (uint8_t)(((h & 0x000F0000) >> 12) | (h >> 8));
@@ -3796,6 +4807,658 @@ static uint32_t ecc_Hamming512Verify (uint8_t *dataBuf, uint8_t *eccBuf) {
   return err;
 }
 
+/*-----------------------------------------------------------------------------
+ *      BCH code over GF(2^13), x^13 + x^4 + x^3 + x + 1
+ *
+ *  Remainder of byte value v multiplied by x^(13*t) divided by generator
+ *  polynomial, left aligned in (t/2) 32-bit words. Used by byte wise LFSR.
+ *----------------------------------------------------------------------------*/
+static const uint32_t BchTbl4[256*2] = {
+  0x00000000U, 0x00000000U, 0x4523043AU, 0xB86AB000U,
+  0x8A460875U, 0x70D56000U, 0xCF650C4FU, 0xC8BFD000U,
+  0x51AF14D0U, 0x59C07000U, 0x148C10EAU, 0xE1AAC000U,
+  0xDBE91CA5U, 0x29151000U, 0x9ECA189FU, 0x917FA000U,
+  0xA35E29A0U, 0xB380E000U, 0xE67D2D9AU, 0x0BEA5000U,
+  0x291821D5U, 0xC3558000U, 0x6C3B25EFU, 0x7B3F3000U,
+  0xF2F13D70U, 0xEA409000U, 0xB7D2394AU, 0x522A2000U,
+  0x78B73505U, 0x9A95F000U, 0x3D94313FU, 0x22FF4000U,
+  0x039F577BU, 0xDF6B7000U, 0x46BC5341U, 0x6701C000U,
+  0x89D95F0EU, 0xAFBE1000U, 0xCCFA5B34U, 0x17D4A000U,
+  0x523043ABU, 0x86AB0000U, 0x17134791U, 0x3EC1B000U,
+  0xD8764BDEU, 0xF67E6000U, 0x9D554FE4U, 0x4E14D000U,
+  0xA0C17EDBU, 0x6CEB9000U, 0xE5E27AE1U, 0xD4812000U,
+  0x2A8776AEU, 0x1C3EF000U, 0x6FA47294U, 0xA4544000U,
+  0xF16E6A0BU, 0x352BE000U, 0xB44D6E31U, 0x8D415000U,
+  0x7B28627EU, 0x45FE8000U, 0x3E0B6644U, 0xFD943000U,
+  0x073EAEF7U, 0xBED6E000U, 0x421DAACDU, 0x06BC5000U,
+  0x8D78A682U, 0xCE038000U, 0xC85BA2B8U, 0x76693000U,
+  0x5691BA27U, 0xE7169000U, 0x13B2BE1DU, 0x5F7C2000U,
+  0xDCD7B252U, 0x97C3F000U, 0x99F4B668U, 0x2FA94000U,
+  0xA4608757U, 0x0D560000U, 0xE143836DU, 0xB53CB000U,
+  0x2E268F22U, 0x7D836000U, 0x6B058B18U, 0xC5E9D000U,
+  0xF5CF9387U, 0x54967000U, 0xB0EC97BDU, 0xECFCC000U,
+  0x7F899BF2U, 0x24431000U, 0x3AAA9FC8U, 0x9C29A000U,
+  0x04A1F98CU, 0x61BD9000U, 0x4182FDB6U, 0xD9D72000U,
+  0x8EE7F1F9U, 0x1168F000U, 0xCBC4F5C3U, 0xA9024000U,
+  0x550EED5CU, 0x387DE000U, 0x102DE966U, 0x80175000U,
+  0xDF48E529U, 0x48A88000U, 0x9A6BE113U, 0xF0C23000U,
+  0xA7FFD02CU, 0xD23D7000U, 0xE2DCD416U, 0x6A57C000U,
+  0x2DB9D859U, 0xA2E81000U, 0x689ADC63U, 0x1A82A000U,
+  0xF650C4FCU, 0x8BFD0000U, 0xB373C0C6U, 0x3397B000U,
+  0x7C16CC89U, 0xFB286000U, 0x3935C8B3U, 0x4342D000U,
+  0x0E7D5DEFU, 0x7DADC000U, 0x4B5E59D5U, 0xC5C77000U,
+  0x843B559AU, 0x0D78A000U, 0xC11851A0U, 0xB5121000U,
+  0x5FD2493FU, 0x246DB000U, 0x1AF14D05U, 0x9C070000U,
+  0xD594414AU, 0x54B8D000U, 0x90B74570U, 0xECD26000U,
+  0xAD23744FU, 0xCE2D2000U, 0xE8007075U, 0x76479000U,
+  0x27657C3AU, 0xBEF84000U, 0x62467800U, 0x0692F000U,
+  0xFC8C609FU, 0x97ED5000U, 0xB9AF64A5U, 0x2F87E000U,
+  0x76CA68EAU, 0xE7383000U, 0x33E96CD0U, 0x5F528000U,
+  0x0DE20A94U, 0xA2C6B000U, 0x48C10EAEU, 0x1AAC0000U,
+  0x87A402E1U, 0xD213D000U, 0xC28706DBU, 0x6A796000U,
+  0x5C4D1E44U, 0xFB06C000U, 0x196E1A7EU, 0x436C7000U,
+  0xD60B1631U, 0x8BD3A000U, 0x9328120BU, 0x33B91000U,
+  0xAEBC2334U, 0x11465000U, 0xEB9F270EU, 0xA92CE000U,
+  0x24FA2B41U, 0x61933000U, 0x61D92F7BU, 0xD9F98000U,
+  0xFF1337E4U, 0x48862000U, 0xBA3033DEU, 0xF0EC9000U,
+  0x75553F91U, 0x38534000U, 0x30763BABU, 0x8039F000U,
+  0x0943F318U, 0xC37B2000U, 0x4C60F722U, 0x7B119000U,
+  0x8305FB6DU, 0xB3AE4000U, 0xC626FF57U, 0x0BC4F000U,
+  0x58ECE7C8U, 0x9ABB5000U, 0x1DCFE3F2U, 0x22D1E000U,
+  0xD2AAEFBDU, 0xEA6E3000U, 0x9789EB87U, 0x52048000U,
+  0xAA1DDAB8U, 0x70FBC000U, 0xEF3EDE82U, 0xC8917000U,
+  0x205BD2CDU, 0x002EA000U, 0x6578D6F7U, 0xB8441000U,
+  0xFBB2CE68U, 0x293BB000U, 0xBE91CA52U, 0x91510000U,
+  0x71F4C61DU, 0x59EED000U, 0x34D7C227U, 0xE1846000U,
+  0x0ADCA463U, 0x1C105000U, 0x4FFFA059U, 0xA47AE000U,
+  0x809AAC16U, 0x6CC53000U, 0xC5B9A82CU, 0xD4AF8000U,
+  0x5B73B0B3U, 0x45D02000U, 0x1E50B489U, 0xFDBA9000U,
+  0xD135B8C6U, 0x35054000U, 0x9416BCFCU, 0x8D6FF000U,
+  0xA9828DC3U, 0xAF90B000U, 0xECA189F9U, 0x17FA0000U,
+  0x23C485B6U, 0xDF45D000U, 0x66E7818CU, 0x672F6000U,
+  0xF82D9913U, 0xF650C000U, 0xBD0E9D29U, 0x4E3A7000U,
+  0x726B9166U, 0x8685A000U, 0x3748955CU, 0x3EEF1000U,
+  0x1CFABBDEU, 0xFB5B8000U, 0x59D9BFE4U, 0x43313000U,
+  0x96BCB3ABU, 0x8B8EE000U, 0xD39FB791U, 0x33E45000U,
+  0x4D55AF0EU, 0xA29BF000U, 0x0876AB34U, 0x1AF14000U,
+  0xC713A77BU, 0xD24E9000U, 0x8230A341U, 0x6A242000U,
+  0xBFA4927EU, 0x48DB6000U, 0xFA879644U, 0xF0B1D000U,
+  0x35E29A0BU, 0x380E0000U, 0x70C19E31U, 0x8064B000U,
+  0xEE0B86AEU, 0x111B1000U, 0xAB288294U, 0xA971A000U,
+  0x644D8EDBU, 0x61CE7000U, 0x216E8AE1U, 0xD9A4C000U,
+  0x1F65ECA5U, 0x2430F000U, 0x5A46E89FU, 0x9C5A4000U,
+  0x9523E4D0U, 0x54E59000U, 0xD000E0EAU, 0xEC8F2000U,
+  0x4ECAF875U, 0x7DF08000U, 0x0BE9FC4FU, 0xC59A3000U,
+  0xC48CF000U, 0x0D25E000U, 0x81AFF43AU, 0xB54F5000U,
+  0xBC3BC505U, 0x97B01000U, 0xF918C13FU, 0x2FDAA000U,
+  0x367DCD70U, 0xE7657000U, 0x735EC94AU, 0x5F0FC000U,
+  0xED94D1D5U, 0xCE706000U, 0xA8B7D5EFU, 0x761AD000U,
+  0x67D2D9A0U, 0xBEA50000U, 0x22F1DD9AU, 0x06CFB000U,
+  0x1BC41529U, 0x458D6000U, 0x5EE71113U, 0xFDE7D000U,
+  0x91821D5CU, 0x35580000U, 0xD4A11966U, 0x8D32B000U,
+  0x4A6B01F9U, 0x1C4D1000U, 0x0F4805C3U, 0xA427A000U,
+  0xC02D098CU, 0x6C987000U, 0x850E0DB6U, 0xD4F2C000U,
+  0xB89A3C89U, 0xF60D8000U, 0xFDB938B3U, 0x4E673000U,
+  0x32DC34FCU, 0x86D8E000U, 0x77FF30C6U, 0x3EB25000U,
+  0xE9352859U, 0xAFCDF000U, 0xAC162C63U, 0x17A74000U,
+  0x6373202CU, 0xDF189000U, 0x26502416U, 0x67722000U,
+  0x185B4252U, 0x9AE61000U, 0x5D784668U, 0x228CA000U,
+  0x921D4A27U, 0xEA337000U, 0xD73E4E1DU, 0x5259C000U,
+  0x49F45682U, 0xC3266000U, 0x0CD752B8U, 0x7B4CD000U,
+  0xC3B25EF7U, 0xB3F30000U, 0x86915ACDU, 0x0B99B000U,
+  0xBB056BF2U, 0x2966F000U, 0xFE266FC8U, 0x910C4000U,
+  0x31436387U, 0x59B39000U, 0x746067BDU, 0xE1D92000U,
+  0xEAAA7F22U, 0x70A68000U, 0xAF897B18U, 0xC8CC3000U,
+  0x60EC7757U, 0x0073E000U, 0x25CF736DU, 0xB8195000U,
+  0x1287E631U, 0x86F64000U, 0x57A4E20BU, 0x3E9CF000U,
+  0x98C1EE44U, 0xF6232000U, 0xDDE2EA7EU, 0x4E499000U,
+  0x4328F2E1U, 0xDF363000U, 0x060BF6DBU, 0x675C8000U,
+  0xC96EFA94U, 0xAFE35000U, 0x8C4DFEAEU, 0x1789E000U,
+  0xB1D9CF91U, 0x3576A000U, 0xF4FACBABU, 0x8D1C1000U,
+  0x3B9FC7E4U, 0x45A3C000U, 0x7EBCC3DEU, 0xFDC97000U,
+  0xE076DB41U, 0x6CB6D000U, 0xA555DF7BU, 0xD4DC6000U,
+  0x6A30D334U, 0x1C63B000U, 0x2F13D70EU, 0xA4090000U,
+  0x1118B14AU, 0x599D3000U, 0x543BB570U, 0xE1F78000U,
+  0x9B5EB93FU, 0x29485000U, 0xDE7DBD05U, 0x9122E000U,
+  0x40B7A59AU, 0x005D4000U, 0x0594A1A0U, 0xB837F000U,
+  0xCAF1ADEFU, 0x70882000U, 0x8FD2A9D5U, 0xC8E29000U,
+  0xB24698EAU, 0xEA1DD000U, 0xF7659CD0U, 0x52776000U,
+  0x3800909FU, 0x9AC8B000U, 0x7D2394A5U, 0x22A20000U,
+  0xE3E98C3AU, 0xB3DDA000U, 0xA6CA8800U, 0x0BB71000U,
+  0x69AF844FU, 0xC308C000U, 0x2C8C8075U, 0x7B627000U,
+  0x15B948C6U, 0x3820A000U, 0x509A4CFCU, 0x804A1000U,
+  0x9FFF40B3U, 0x48F5C000U, 0xDADC4489U, 0xF09F7000U,
+  0x44165C16U, 0x61E0D000U, 0x0135582CU, 0xD98A6000U,
+  0xCE505463U, 0x1135B000U, 0x8B735059U, 0xA95F0000U,
+  0xB6E76166U, 0x8BA04000U, 0xF3C4655CU, 0x33CAF000U,
+  0x3CA16913U, 0xFB752000U, 0x79826D29U, 0x431F9000U,
+  0xE74875B6U, 0xD2603000U, 0xA26B718CU, 0x6A0A8000U,
+  0x6D0E7DC3U, 0xA2B55000U, 0x282D79F9U, 0x1ADFE000U,
+  0x16261FBDU, 0xE74BD000U, 0x53051B87U, 0x5F216000U,
+  0x9C6017C8U, 0x979EB000U, 0xD94313F2U, 0x2FF40000U,
+  0x47890B6DU, 0xBE8BA000U, 0x02AA0F57U, 0x06E11000U,
+  0xCDCF0318U, 0xCE5EC000U, 0x88EC0722U, 0x76347000U,
+  0xB578361DU, 0x54CB3000U, 0xF05B3227U, 0xECA18000U,
+  0x3F3E3E68U, 0x241E5000U, 0x7A1D3A52U, 0x9C74E000U,
+  0xE4D722CDU, 0x0D0B4000U, 0xA1F426F7U, 0xB561F000U,
+  0x6E912AB8U, 0x7DDE2000U, 0x2BB22E82U, 0xC5B49000U
+};
+static const uint32_t BchTbl8[256*4] = {
+  0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U,
+  0x15F914E0U, 0x7B0C1387U, 0x41C5C4FBU, 0x23000000U,
+  0x2BF229C0U, 0xF618270EU, 0x838B89F6U, 0x46000000U,
+  0x3E0B3D20U, 0x8D143489U, 0xC24E4D0DU, 0x65000000U,
+  0x57E45381U, 0xEC304E1DU, 0x071713ECU, 0x8C000000U,
+  0x421D4761U, 0x973C5D9AU, 0x46D2D717U, 0xAF000000U,
+  0x7C167A41U, 0x1A286913U, 0x849C9A1AU, 0xCA000000U,
+  0x69EF6EA1U, 0x61247A94U, 0xC5595EE1U, 0xE9000000U,
+  0xAFC8A703U, 0xD8609C3AU, 0x0E2E27D9U, 0x18000000U,
+  0xBA31B3E3U, 0xA36C8FBDU, 0x4FEBE322U, 0x3B000000U,
+  0x843A8EC3U, 0x2E78BB34U, 0x8DA5AE2FU, 0x5E000000U,
+  0x91C39A23U, 0x5574A8B3U, 0xCC606AD4U, 0x7D000000U,
+  0xF82CF482U, 0x3450D227U, 0x09393435U, 0x94000000U,
+  0xEDD5E062U, 0x4F5CC1A0U, 0x48FCF0CEU, 0xB7000000U,
+  0xD3DEDD42U, 0xC248F529U, 0x8AB2BDC3U, 0xD2000000U,
+  0xC627C9A2U, 0xB944E6AEU, 0xCB777938U, 0xF1000000U,
+  0x4A685AE7U, 0xCBCD2BF3U, 0x5D998B49U, 0x13000000U,
+  0x5F914E07U, 0xB0C13874U, 0x1C5C4FB2U, 0x30000000U,
+  0x619A7327U, 0x3DD50CFDU, 0xDE1202BFU, 0x55000000U,
+  0x746367C7U, 0x46D91F7AU, 0x9FD7C644U, 0x76000000U,
+  0x1D8C0966U, 0x27FD65EEU, 0x5A8E98A5U, 0x9F000000U,
+  0x08751D86U, 0x5CF17669U, 0x1B4B5C5EU, 0xBC000000U,
+  0x367E20A6U, 0xD1E542E0U, 0xD9051153U, 0xD9000000U,
+  0x23873446U, 0xAAE95167U, 0x98C0D5A8U, 0xFA000000U,
+  0xE5A0FDE4U, 0x13ADB7C9U, 0x53B7AC90U, 0x0B000000U,
+  0xF059E904U, 0x68A1A44EU, 0x1272686BU, 0x28000000U,
+  0xCE52D424U, 0xE5B590C7U, 0xD03C2566U, 0x4D000000U,
+  0xDBABC0C4U, 0x9EB98340U, 0x91F9E19DU, 0x6E000000U,
+  0xB244AE65U, 0xFF9DF9D4U, 0x54A0BF7CU, 0x87000000U,
+  0xA7BDBA85U, 0x8491EA53U, 0x15657B87U, 0xA4000000U,
+  0x99B687A5U, 0x0985DEDAU, 0xD72B368AU, 0xC1000000U,
+  0x8C4F9345U, 0x7289CD5DU, 0x96EEF271U, 0xE2000000U,
+  0x94D0B5CFU, 0x979A57E6U, 0xBB331692U, 0x26000000U,
+  0x8129A12FU, 0xEC964461U, 0xFAF6D269U, 0x05000000U,
+  0xBF229C0FU, 0x618270E8U, 0x38B89F64U, 0x60000000U,
+  0xAADB88EFU, 0x1A8E636FU, 0x797D5B9FU, 0x43000000U,
+  0xC334E64EU, 0x7BAA19FBU, 0xBC24057EU, 0xAA000000U,
+  0xD6CDF2AEU, 0x00A60A7CU, 0xFDE1C185U, 0x89000000U,
+  0xE8C6CF8EU, 0x8DB23EF5U, 0x3FAF8C88U, 0xEC000000U,
+  0xFD3FDB6EU, 0xF6BE2D72U, 0x7E6A4873U, 0xCF000000U,
+  0x3B1812CCU, 0x4FFACBDCU, 0xB51D314BU, 0x3E000000U,
+  0x2EE1062CU, 0x34F6D85BU, 0xF4D8F5B0U, 0x1D000000U,
+  0x10EA3B0CU, 0xB9E2ECD2U, 0x3696B8BDU, 0x78000000U,
+  0x05132FECU, 0xC2EEFF55U, 0x77537C46U, 0x5B000000U,
+  0x6CFC414DU, 0xA3CA85C1U, 0xB20A22A7U, 0xB2000000U,
+  0x790555ADU, 0xD8C69646U, 0xF3CFE65CU, 0x91000000U,
+  0x470E688DU, 0x55D2A2CFU, 0x3181AB51U, 0xF4000000U,
+  0x52F77C6DU, 0x2EDEB148U, 0x70446FAAU, 0xD7000000U,
+  0xDEB8EF28U, 0x5C577C15U, 0xE6AA9DDBU, 0x35000000U,
+  0xCB41FBC8U, 0x275B6F92U, 0xA76F5920U, 0x16000000U,
+  0xF54AC6E8U, 0xAA4F5B1BU, 0x6521142DU, 0x73000000U,
+  0xE0B3D208U, 0xD143489CU, 0x24E4D0D6U, 0x50000000U,
+  0x895CBCA9U, 0xB0673208U, 0xE1BD8E37U, 0xB9000000U,
+  0x9CA5A849U, 0xCB6B218FU, 0xA0784ACCU, 0x9A000000U,
+  0xA2AE9569U, 0x467F1506U, 0x623607C1U, 0xFF000000U,
+  0xB7578189U, 0x3D730681U, 0x23F3C33AU, 0xDC000000U,
+  0x7170482BU, 0x8437E02FU, 0xE884BA02U, 0x2D000000U,
+  0x64895CCBU, 0xFF3BF3A8U, 0xA9417EF9U, 0x0E000000U,
+  0x5A8261EBU, 0x722FC721U, 0x6B0F33F4U, 0x6B000000U,
+  0x4F7B750BU, 0x0923D4A6U, 0x2ACAF70FU, 0x48000000U,
+  0x26941BAAU, 0x6807AE32U, 0xEF93A9EEU, 0xA1000000U,
+  0x336D0F4AU, 0x130BBDB5U, 0xAE566D15U, 0x82000000U,
+  0x0D66326AU, 0x9E1F893CU, 0x6C182018U, 0xE7000000U,
+  0x189F268AU, 0xE5139ABBU, 0x2DDDE4E3U, 0xC4000000U,
+  0x3C587F7FU, 0x5438BC4AU, 0x37A3E9DFU, 0x6F000000U,
+  0x29A16B9FU, 0x2F34AFCDU, 0x76662D24U, 0x4C000000U,
+  0x17AA56BFU, 0xA2209B44U, 0xB4286029U, 0x29000000U,
+  0x0253425FU, 0xD92C88C3U, 0xF5EDA4D2U, 0x0A000000U,
+  0x6BBC2CFEU, 0xB808F257U, 0x30B4FA33U, 0xE3000000U,
+  0x7E45381EU, 0xC304E1D0U, 0x71713EC8U, 0xC0000000U,
+  0x404E053EU, 0x4E10D559U, 0xB33F73C5U, 0xA5000000U,
+  0x55B711DEU, 0x351CC6DEU, 0xF2FAB73EU, 0x86000000U,
+  0x9390D87CU, 0x8C582070U, 0x398DCE06U, 0x77000000U,
+  0x8669CC9CU, 0xF75433F7U, 0x78480AFDU, 0x54000000U,
+  0xB862F1BCU, 0x7A40077EU, 0xBA0647F0U, 0x31000000U,
+  0xAD9BE55CU, 0x014C14F9U, 0xFBC3830BU, 0x12000000U,
+  0xC4748BFDU, 0x60686E6DU, 0x3E9ADDEAU, 0xFB000000U,
+  0xD18D9F1DU, 0x1B647DEAU, 0x7F5F1911U, 0xD8000000U,
+  0xEF86A23DU, 0x96704963U, 0xBD11541CU, 0xBD000000U,
+  0xFA7FB6DDU, 0xED7C5AE4U, 0xFCD490E7U, 0x9E000000U,
+  0x76302598U, 0x9FF597B9U, 0x6A3A6296U, 0x7C000000U,
+  0x63C93178U, 0xE4F9843EU, 0x2BFFA66DU, 0x5F000000U,
+  0x5DC20C58U, 0x69EDB0B7U, 0xE9B1EB60U, 0x3A000000U,
+  0x483B18B8U, 0x12E1A330U, 0xA8742F9BU, 0x19000000U,
+  0x21D47619U, 0x73C5D9A4U, 0x6D2D717AU, 0xF0000000U,
+  0x342D62F9U, 0x08C9CA23U, 0x2CE8B581U, 0xD3000000U,
+  0x0A265FD9U, 0x85DDFEAAU, 0xEEA6F88CU, 0xB6000000U,
+  0x1FDF4B39U, 0xFED1ED2DU, 0xAF633C77U, 0x95000000U,
+  0xD9F8829BU, 0x47950B83U, 0x6414454FU, 0x64000000U,
+  0xCC01967BU, 0x3C991804U, 0x25D181B4U, 0x47000000U,
+  0xF20AAB5BU, 0xB18D2C8DU, 0xE79FCCB9U, 0x22000000U,
+  0xE7F3BFBBU, 0xCA813F0AU, 0xA65A0842U, 0x01000000U,
+  0x8E1CD11AU, 0xABA5459EU, 0x630356A3U, 0xE8000000U,
+  0x9BE5C5FAU, 0xD0A95619U, 0x22C69258U, 0xCB000000U,
+  0xA5EEF8DAU, 0x5DBD6290U, 0xE088DF55U, 0xAE000000U,
+  0xB017EC3AU, 0x26B17117U, 0xA14D1BAEU, 0x8D000000U,
+  0xA888CAB0U, 0xC3A2EBACU, 0x8C90FF4DU, 0x49000000U,
+  0xBD71DE50U, 0xB8AEF82BU, 0xCD553BB6U, 0x6A000000U,
+  0x837AE370U, 0x35BACCA2U, 0x0F1B76BBU, 0x0F000000U,
+  0x9683F790U, 0x4EB6DF25U, 0x4EDEB240U, 0x2C000000U,
+  0xFF6C9931U, 0x2F92A5B1U, 0x8B87ECA1U, 0xC5000000U,
+  0xEA958DD1U, 0x549EB636U, 0xCA42285AU, 0xE6000000U,
+  0xD49EB0F1U, 0xD98A82BFU, 0x080C6557U, 0x83000000U,
+  0xC167A411U, 0xA2869138U, 0x49C9A1ACU, 0xA0000000U,
+  0x07406DB3U, 0x1BC27796U, 0x82BED894U, 0x51000000U,
+  0x12B97953U, 0x60CE6411U, 0xC37B1C6FU, 0x72000000U,
+  0x2CB24473U, 0xEDDA5098U, 0x01355162U, 0x17000000U,
+  0x394B5093U, 0x96D6431FU, 0x40F09599U, 0x34000000U,
+  0x50A43E32U, 0xF7F2398BU, 0x85A9CB78U, 0xDD000000U,
+  0x455D2AD2U, 0x8CFE2A0CU, 0xC46C0F83U, 0xFE000000U,
+  0x7B5617F2U, 0x01EA1E85U, 0x0622428EU, 0x9B000000U,
+  0x6EAF0312U, 0x7AE60D02U, 0x47E78675U, 0xB8000000U,
+  0xE2E09057U, 0x086FC05FU, 0xD1097404U, 0x5A000000U,
+  0xF71984B7U, 0x7363D3D8U, 0x90CCB0FFU, 0x79000000U,
+  0xC912B997U, 0xFE77E751U, 0x5282FDF2U, 0x1C000000U,
+  0xDCEBAD77U, 0x857BF4D6U, 0x13473909U, 0x3F000000U,
+  0xB504C3D6U, 0xE45F8E42U, 0xD61E67E8U, 0xD6000000U,
+  0xA0FDD736U, 0x9F539DC5U, 0x97DBA313U, 0xF5000000U,
+  0x9EF6EA16U, 0x1247A94CU, 0x5595EE1EU, 0x90000000U,
+  0x8B0FFEF6U, 0x694BBACBU, 0x14502AE5U, 0xB3000000U,
+  0x4D283754U, 0xD00F5C65U, 0xDF2753DDU, 0x42000000U,
+  0x58D123B4U, 0xAB034FE2U, 0x9EE29726U, 0x61000000U,
+  0x66DA1E94U, 0x26177B6BU, 0x5CACDA2BU, 0x04000000U,
+  0x73230A74U, 0x5D1B68ECU, 0x1D691ED0U, 0x27000000U,
+  0x1ACC64D5U, 0x3C3F1278U, 0xD8304031U, 0xCE000000U,
+  0x0F357035U, 0x473301FFU, 0x99F584CAU, 0xED000000U,
+  0x313E4D15U, 0xCA273576U, 0x5BBBC9C7U, 0x88000000U,
+  0x24C759F5U, 0xB12B26F1U, 0x1A7E0D3CU, 0xAB000000U,
+  0x78B0FEFEU, 0xA8717894U, 0x6F47D3BEU, 0xDE000000U,
+  0x6D49EA1EU, 0xD37D6B13U, 0x2E821745U, 0xFD000000U,
+  0x5342D73EU, 0x5E695F9AU, 0xECCC5A48U, 0x98000000U,
+  0x46BBC3DEU, 0x25654C1DU, 0xAD099EB3U, 0xBB000000U,
+  0x2F54AD7FU, 0x44413689U, 0x6850C052U, 0x52000000U,
+  0x3AADB99FU, 0x3F4D250EU, 0x299504A9U, 0x71000000U,
+  0x04A684BFU, 0xB2591187U, 0xEBDB49A4U, 0x14000000U,
+  0x115F905FU, 0xC9550200U, 0xAA1E8D5FU, 0x37000000U,
+  0xD77859FDU, 0x7011E4AEU, 0x6169F467U, 0xC6000000U,
+  0xC2814D1DU, 0x0B1DF729U, 0x20AC309CU, 0xE5000000U,
+  0xFC8A703DU, 0x8609C3A0U, 0xE2E27D91U, 0x80000000U,
+  0xE97364DDU, 0xFD05D027U, 0xA327B96AU, 0xA3000000U,
+  0x809C0A7CU, 0x9C21AAB3U, 0x667EE78BU, 0x4A000000U,
+  0x95651E9CU, 0xE72DB934U, 0x27BB2370U, 0x69000000U,
+  0xAB6E23BCU, 0x6A398DBDU, 0xE5F56E7DU, 0x0C000000U,
+  0xBE97375CU, 0x11359E3AU, 0xA430AA86U, 0x2F000000U,
+  0x32D8A419U, 0x63BC5367U, 0x32DE58F7U, 0xCD000000U,
+  0x2721B0F9U, 0x18B040E0U, 0x731B9C0CU, 0xEE000000U,
+  0x192A8DD9U, 0x95A47469U, 0xB155D101U, 0x8B000000U,
+  0x0CD39939U, 0xEEA867EEU, 0xF09015FAU, 0xA8000000U,
+  0x653CF798U, 0x8F8C1D7AU, 0x35C94B1BU, 0x41000000U,
+  0x70C5E378U, 0xF4800EFDU, 0x740C8FE0U, 0x62000000U,
+  0x4ECEDE58U, 0x79943A74U, 0xB642C2EDU, 0x07000000U,
+  0x5B37CAB8U, 0x029829F3U, 0xF7870616U, 0x24000000U,
+  0x9D10031AU, 0xBBDCCF5DU, 0x3CF07F2EU, 0xD5000000U,
+  0x88E917FAU, 0xC0D0DCDAU, 0x7D35BBD5U, 0xF6000000U,
+  0xB6E22ADAU, 0x4DC4E853U, 0xBF7BF6D8U, 0x93000000U,
+  0xA31B3E3AU, 0x36C8FBD4U, 0xFEBE3223U, 0xB0000000U,
+  0xCAF4509BU, 0x57EC8140U, 0x3BE76CC2U, 0x59000000U,
+  0xDF0D447BU, 0x2CE092C7U, 0x7A22A839U, 0x7A000000U,
+  0xE106795BU, 0xA1F4A64EU, 0xB86CE534U, 0x1F000000U,
+  0xF4FF6DBBU, 0xDAF8B5C9U, 0xF9A921CFU, 0x3C000000U,
+  0xEC604B31U, 0x3FEB2F72U, 0xD474C52CU, 0xF8000000U,
+  0xF9995FD1U, 0x44E73CF5U, 0x95B101D7U, 0xDB000000U,
+  0xC79262F1U, 0xC9F3087CU, 0x57FF4CDAU, 0xBE000000U,
+  0xD26B7611U, 0xB2FF1BFBU, 0x163A8821U, 0x9D000000U,
+  0xBB8418B0U, 0xD3DB616FU, 0xD363D6C0U, 0x74000000U,
+  0xAE7D0C50U, 0xA8D772E8U, 0x92A6123BU, 0x57000000U,
+  0x90763170U, 0x25C34661U, 0x50E85F36U, 0x32000000U,
+  0x858F2590U, 0x5ECF55E6U, 0x112D9BCDU, 0x11000000U,
+  0x43A8EC32U, 0xE78BB348U, 0xDA5AE2F5U, 0xE0000000U,
+  0x5651F8D2U, 0x9C87A0CFU, 0x9B9F260EU, 0xC3000000U,
+  0x685AC5F2U, 0x11939446U, 0x59D16B03U, 0xA6000000U,
+  0x7DA3D112U, 0x6A9F87C1U, 0x1814AFF8U, 0x85000000U,
+  0x144CBFB3U, 0x0BBBFD55U, 0xDD4DF119U, 0x6C000000U,
+  0x01B5AB53U, 0x70B7EED2U, 0x9C8835E2U, 0x4F000000U,
+  0x3FBE9673U, 0xFDA3DA5BU, 0x5EC678EFU, 0x2A000000U,
+  0x2A478293U, 0x86AFC9DCU, 0x1F03BC14U, 0x09000000U,
+  0xA60811D6U, 0xF4260481U, 0x89ED4E65U, 0xEB000000U,
+  0xB3F10536U, 0x8F2A1706U, 0xC8288A9EU, 0xC8000000U,
+  0x8DFA3816U, 0x023E238FU, 0x0A66C793U, 0xAD000000U,
+  0x98032CF6U, 0x79323008U, 0x4BA30368U, 0x8E000000U,
+  0xF1EC4257U, 0x18164A9CU, 0x8EFA5D89U, 0x67000000U,
+  0xE41556B7U, 0x631A591BU, 0xCF3F9972U, 0x44000000U,
+  0xDA1E6B97U, 0xEE0E6D92U, 0x0D71D47FU, 0x21000000U,
+  0xCFE77F77U, 0x95027E15U, 0x4CB41084U, 0x02000000U,
+  0x09C0B6D5U, 0x2C4698BBU, 0x87C369BCU, 0xF3000000U,
+  0x1C39A235U, 0x574A8B3CU, 0xC606AD47U, 0xD0000000U,
+  0x22329F15U, 0xDA5EBFB5U, 0x0448E04AU, 0xB5000000U,
+  0x37CB8BF5U, 0xA152AC32U, 0x458D24B1U, 0x96000000U,
+  0x5E24E554U, 0xC076D6A6U, 0x80D47A50U, 0x7F000000U,
+  0x4BDDF1B4U, 0xBB7AC521U, 0xC111BEABU, 0x5C000000U,
+  0x75D6CC94U, 0x366EF1A8U, 0x035FF3A6U, 0x39000000U,
+  0x602FD874U, 0x4D62E22FU, 0x429A375DU, 0x1A000000U,
+  0x44E88181U, 0xFC49C4DEU, 0x58E43A61U, 0xB1000000U,
+  0x51119561U, 0x8745D759U, 0x1921FE9AU, 0x92000000U,
+  0x6F1AA841U, 0x0A51E3D0U, 0xDB6FB397U, 0xF7000000U,
+  0x7AE3BCA1U, 0x715DF057U, 0x9AAA776CU, 0xD4000000U,
+  0x130CD200U, 0x10798AC3U, 0x5FF3298DU, 0x3D000000U,
+  0x06F5C6E0U, 0x6B759944U, 0x1E36ED76U, 0x1E000000U,
+  0x38FEFBC0U, 0xE661ADCDU, 0xDC78A07BU, 0x7B000000U,
+  0x2D07EF20U, 0x9D6DBE4AU, 0x9DBD6480U, 0x58000000U,
+  0xEB202682U, 0x242958E4U, 0x56CA1DB8U, 0xA9000000U,
+  0xFED93262U, 0x5F254B63U, 0x170FD943U, 0x8A000000U,
+  0xC0D20F42U, 0xD2317FEAU, 0xD541944EU, 0xEF000000U,
+  0xD52B1BA2U, 0xA93D6C6DU, 0x948450B5U, 0xCC000000U,
+  0xBCC47503U, 0xC81916F9U, 0x51DD0E54U, 0x25000000U,
+  0xA93D61E3U, 0xB315057EU, 0x1018CAAFU, 0x06000000U,
+  0x97365CC3U, 0x3E0131F7U, 0xD25687A2U, 0x63000000U,
+  0x82CF4823U, 0x450D2270U, 0x93934359U, 0x40000000U,
+  0x0E80DB66U, 0x3784EF2DU, 0x057DB128U, 0xA2000000U,
+  0x1B79CF86U, 0x4C88FCAAU, 0x44B875D3U, 0x81000000U,
+  0x2572F2A6U, 0xC19CC823U, 0x86F638DEU, 0xE4000000U,
+  0x308BE646U, 0xBA90DBA4U, 0xC733FC25U, 0xC7000000U,
+  0x596488E7U, 0xDBB4A130U, 0x026AA2C4U, 0x2E000000U,
+  0x4C9D9C07U, 0xA0B8B2B7U, 0x43AF663FU, 0x0D000000U,
+  0x7296A127U, 0x2DAC863EU, 0x81E12B32U, 0x68000000U,
+  0x676FB5C7U, 0x56A095B9U, 0xC024EFC9U, 0x4B000000U,
+  0xA1487C65U, 0xEFE47317U, 0x0B5396F1U, 0xBA000000U,
+  0xB4B16885U, 0x94E86090U, 0x4A96520AU, 0x99000000U,
+  0x8ABA55A5U, 0x19FC5419U, 0x88D81F07U, 0xFC000000U,
+  0x9F434145U, 0x62F0479EU, 0xC91DDBFCU, 0xDF000000U,
+  0xF6AC2FE4U, 0x03D43D0AU, 0x0C44851DU, 0x36000000U,
+  0xE3553B04U, 0x78D82E8DU, 0x4D8141E6U, 0x15000000U,
+  0xDD5E0624U, 0xF5CC1A04U, 0x8FCF0CEBU, 0x70000000U,
+  0xC8A712C4U, 0x8EC00983U, 0xCE0AC810U, 0x53000000U,
+  0xD038344EU, 0x6BD39338U, 0xE3D72CF3U, 0x97000000U,
+  0xC5C120AEU, 0x10DF80BFU, 0xA212E808U, 0xB4000000U,
+  0xFBCA1D8EU, 0x9DCBB436U, 0x605CA505U, 0xD1000000U,
+  0xEE33096EU, 0xE6C7A7B1U, 0x219961FEU, 0xF2000000U,
+  0x87DC67CFU, 0x87E3DD25U, 0xE4C03F1FU, 0x1B000000U,
+  0x9225732FU, 0xFCEFCEA2U, 0xA505FBE4U, 0x38000000U,
+  0xAC2E4E0FU, 0x71FBFA2BU, 0x674BB6E9U, 0x5D000000U,
+  0xB9D75AEFU, 0x0AF7E9ACU, 0x268E7212U, 0x7E000000U,
+  0x7FF0934DU, 0xB3B30F02U, 0xEDF90B2AU, 0x8F000000U,
+  0x6A0987ADU, 0xC8BF1C85U, 0xAC3CCFD1U, 0xAC000000U,
+  0x5402BA8DU, 0x45AB280CU, 0x6E7282DCU, 0xC9000000U,
+  0x41FBAE6DU, 0x3EA73B8BU, 0x2FB74627U, 0xEA000000U,
+  0x2814C0CCU, 0x5F83411FU, 0xEAEE18C6U, 0x03000000U,
+  0x3DEDD42CU, 0x248F5298U, 0xAB2BDC3DU, 0x20000000U,
+  0x03E6E90CU, 0xA99B6611U, 0x69659130U, 0x45000000U,
+  0x161FFDECU, 0xD2977596U, 0x28A055CBU, 0x66000000U,
+  0x9A506EA9U, 0xA01EB8CBU, 0xBE4EA7BAU, 0x84000000U,
+  0x8FA97A49U, 0xDB12AB4CU, 0xFF8B6341U, 0xA7000000U,
+  0xB1A24769U, 0x56069FC5U, 0x3DC52E4CU, 0xC2000000U,
+  0xA45B5389U, 0x2D0A8C42U, 0x7C00EAB7U, 0xE1000000U,
+  0xCDB43D28U, 0x4C2EF6D6U, 0xB959B456U, 0x08000000U,
+  0xD84D29C8U, 0x3722E551U, 0xF89C70ADU, 0x2B000000U,
+  0xE64614E8U, 0xBA36D1D8U, 0x3AD23DA0U, 0x4E000000U,
+  0xF3BF0008U, 0xC13AC25FU, 0x7B17F95BU, 0x6D000000U,
+  0x3598C9AAU, 0x787E24F1U, 0xB0608063U, 0x9C000000U,
+  0x2061DD4AU, 0x03723776U, 0xF1A54498U, 0xBF000000U,
+  0x1E6AE06AU, 0x8E6603FFU, 0x33EB0995U, 0xDA000000U,
+  0x0B93F48AU, 0xF56A1078U, 0x722ECD6EU, 0xF9000000U,
+  0x627C9A2BU, 0x944E6AECU, 0xB777938FU, 0x10000000U,
+  0x77858ECBU, 0xEF42796BU, 0xF6B25774U, 0x33000000U,
+  0x498EB3EBU, 0x62564DE2U, 0x34FC1A79U, 0x56000000U,
+  0x5C77A70BU, 0x195A5E65U, 0x7539DE82U, 0x75000000U
+};
+
+/*-----------------------------------------------------------------------------
+ *      Galois field multiplication
+ *----------------------------------------------------------------------------*/
+static uint32_t gf_mul (uint32_t a, uint32_t b) {
+  uint32_t r;
+
+  r = 0;
+  while (b) {
+    if (b & 1) {
+      r ^= a;
+    }
+    b >>= 1;
+    a <<= 1;
+    if (a & (1U << BCH_M)) {
+      a ^= BCH_POLY;
+    }
+  }
+  return r;
+}
+
+/*-----------------------------------------------------------------------------
+ *      Galois field inversion: a^(2^13 - 2)
+ *----------------------------------------------------------------------------*/
+static uint32_t gf_inv (uint32_t a) {
+  uint32_t i, r;
+
+  r = a;
+  for (i = 1; i < (BCH_M - 1); i++) {
+    r = gf_mul (gf_mul (r, r), a);
+  }
+  return gf_mul (r, r);
+}
+
+/*-----------------------------------------------------------------------------
+ *      BCH LFSR: divide data by generator polynomial
+ *
+ *  Data bits are inverted so that an erased page is a valid codeword.
+ *
+ *  *buf = data buffer
+ *   len = number of bytes
+ *  *r   = remainder register
+ *   t   = number of correctable bits (4 or 8)
+ *----------------------------------------------------------------------------*/
+static void bch_Remainder (const uint8_t *buf, uint32_t len, uint32_t *r, uint32_t t) {
+  const uint32_t *tbl, *tv;
+  uint32_t i;
+
+  if (t == 4) {
+    tbl = BchTbl4;
+
+    for (i = 0; i < len; i++) {
+      tv = &tbl[((r[0] >> 24) ^ (uint8_t)~buf[i]) << 1];
+
+      r[0] = ((r[0] << 8) | (r[1] >> 24)) ^ tv[0];
+      r[1] = ( r[1] << 8)                 ^ tv[1];
+    }
+  }
+  else {
+    tbl = BchTbl8;
+
+    for (i = 0; i < len; i++) {
+      tv = &tbl[((r[0] >> 24) ^ (uint8_t)~buf[i]) << 2];
+
+      r[0] = ((r[0] << 8) | (r[1] >> 24)) ^ tv[0];
+      r[1] = ((r[1] << 8) | (r[2] >> 24)) ^ tv[1];
+      r[2] = ((r[2] << 8) | (r[3] >> 24)) ^ tv[2];
+      r[3] = ( r[3] << 8)                 ^ tv[3];
+    }
+  }
+}
+
+/*-----------------------------------------------------------------------------
+ *      Calculate BCH ECC for a 512 bytes chunk of data and spare metadata
+ *
+ *  *dataBuf = sector data (512 bytes)
+ *  *spBuf   = spare metadata protected by ECC
+ *   spLen   = number of spare metadata bytes
+ *  *eccBuf  = ECC output buffer
+ *   t       = number of correctable bits (4 or 8)
+ *
+ *  Returns: number of ECC bytes
+ *----------------------------------------------------------------------------*/
+static uint32_t ecc_Bch (uint8_t *dataBuf, uint8_t *spBuf, uint32_t spLen, uint8_t *eccBuf, uint32_t t) {
+  uint32_t r[BCH_T_MAX/2];
+  uint32_t i, len;
+
+  memset (r, 0, sizeof(r));
+
+  bch_Remainder (dataBuf, __SZ_SECT, r, t);
+  bch_Remainder (spBuf,   spLen,     r, t);
+
+  /* Store inverted remainder */
+  len = BCH_ECC_LEN(t);
+
+  for (i = 0; i < len; i++) {
+    eccBuf[i] = (uint8_t)~(r[i >> 2] >> (24 - ((i & 3) << 3)));
+  }
+  return len;
+}
+
+/*-----------------------------------------------------------------------------
+ *      Verify BCH ECC for a 512 bytes chunk of data and spare metadata
+ *
+ *  Syndromes are evaluated from the remainder, error locator polynomial is
+ *  determined using Berlekamp-Massey algorithm and its roots are found with
+ *  Chien search.
+ *
+ *  Returns: number of corrected bits or INVALID when data is uncorrectable
+ *----------------------------------------------------------------------------*/
+static uint32_t ecc_BchVerify (uint8_t *dataBuf, uint8_t *spBuf, uint32_t spLen, uint8_t *eccBuf, uint32_t t) {
+  uint32_t r[BCH_T_MAX/2];
+  uint32_t s[2*BCH_T_MAX+1];
+  uint32_t c[2*BCH_T_MAX+1], b[2*BCH_T_MAX+1], tmp[2*BCH_T_MAX+1];
+  uint32_t i, k, j, n, nw, nb, nr, len, bit, deg, pos;
+  uint32_t d, db, l, m, aj, sum;
+
+  memset (r, 0, sizeof(r));
+
+  bch_Remainder (dataBuf, __SZ_SECT, r, t);
+  bch_Remainder (spBuf,   spLen,     r, t);
+
+  /* Remainder of the received codeword: r ^ stored parity */
+  len = BCH_ECC_LEN(t);
+  nw  = t / 2;
+  nb  = BCH_M * t;
+
+  for (i = 0; i < len; i++) {
+    r[i >> 2] ^= (uint32_t)(uint8_t)~eccBuf[i] << (24 - ((i & 3) << 3));
+  }
+  r[nw - 1] &= ~((1UL << ((nw * 32) - nb)) - 1);
+
+  d = 0;
+  for (i = 0; i < nw; i++) {
+    d |= r[i];
+  }
+  if (d == 0) {
+    /* No error */
+    return 0;
+  }
+
+  /* Odd syndromes: S(j) = R(a^j), Horner scheme from the highest degree */
+  for (j = 1; j < 2*t; j += 2) {
+    /* a^j */
+    aj = 1;
+    for (i = 0; i < j; i++) {
+      aj = gf_mul (aj, 2);
+    }
+    sum = 0;
+    for (i = 0; i < nb; i++) {
+      bit = (r[i >> 5] >> (31 - (i & 0x1F))) & 1;
+      sum = gf_mul (sum, aj) ^ bit;
+    }
+    s[j] = sum;
+  }
+  /* Even syndromes: S(2j) = S(j)^2 */
+  for (j = 2; j <= 2*t; j += 2) {
+    s[j] = gf_mul (s[j/2], s[j/2]);
+  }
+
+  /* Berlekamp-Massey */
+  memset (c, 0, sizeof(c));
+  memset (b, 0, sizeof(b));
+  c[0] = 1;
+  b[0] = 1;
+  l  = 0;
+  m  = 1;
+  db = 1;
+
+  for (n = 0; n < 2*t; n++) {
+    /* Discrepancy */
+    d = s[n + 1];
+    for (i = 1; i <= l; i++) {
+      d ^= gf_mul (c[i], s[n + 1 - i]);
+    }
+    if (d == 0) {
+      m++;
+    }
+    else {
+      k = gf_mul (d, gf_inv (db));
+
+      memcpy (tmp, c, sizeof(c));
+
+      for (i = 0; (i + m) <= 2*t; i++) {
+        c[i + m] ^= gf_mul (k, b[i]);
+      }
+
+      if ((2 * l) <= n) {
+        l  = n + 1 - l;
+        memcpy (b, tmp, sizeof(b));
+        db = d;
+        m  = 1;
+      }
+      else {
+        m++;
+      }
+    }
+  }
+
+  deg = l;
+  if ((deg > t) || (c[deg] == 0)) {
+    /* Too many errors */
+    return INVALID;
+  }
+
+  /* Chien search: evaluate locator at a^(-pos) for each codeword bit */
+  len = ((__SZ_SECT + spLen) << 3) + nb;
+  nr  = 0;
+
+  for (pos = 0; pos < len; pos++) {
+    sum = c[0];
+    for (i = 1; i <= deg; i++) {
+      sum ^= c[i];
+    }
+
+    if (sum == 0) {
+      /* Error at bit of degree pos */
+      tmp[nr++] = pos;
+
+      if (nr == deg) {
+        break;
+      }
+    }
+
+    /* Multiply term i by a^(-i) */
+    for (i = 1; i <= deg; i++) {
+      for (j = 0; j < i; j++) {
+        if (c[i] & 1) {
+          c[i] = (c[i] ^ BCH_POLY) >> 1;
+        }
+        else {
+          c[i] >>= 1;
+        }
+      }
+    }
+  }
+
+  if (nr != deg) {
+    /* Locator roots do not match the number of errors */
+    return INVALID;
+  }
+
+  for (i = 0; i < nr; i++) {
+    if (tmp[i] >= nb) {
+      /* Data or spare bit, reverse of the bit order in LFSR */
+      k = (len - 1) - tmp[i];
+      if ((k >> 3) < __SZ_SECT) {
+        dataBuf[k >> 3] ^= (uint8_t)(0x80 >> (k & 7));
+      }
+      else {
+        spBuf[(k >> 3) - __SZ_SECT] ^= (uint8_t)(0x80 >> (k & 7));
+      }
+    }
+    /* else: error in ECC bytes, data is valid */
+  }
+  return nr;
+}
+
 /*-----------------------------------------------------------------------------
  *     Encode Error Correction Code
  *
@@ -3812,8 +5475,15 @@ static void EncodeECC (NAND_FTL_DEV *ftl, uint8_t *pgBuf) {
   sp = dp + ftl->PgLay.spare_ofs;
 
   for (sec = 0; sec < ftl->PageSectors; sec++) {
-    ecc_len = ecc_Hamming512 (dp, sp + ftl->PgLay.spare.ofs_ecc);
-    ecc_Hamming8 (sp, sp + ftl->PgLay.spare.ofs_ecc + ecc_len);
+    if (pDev->sw_ecc == 1) {
+      /* Hamming: 3 bytes for data, 2 bytes for spare */
+      ecc_len = ecc_Hamming512 (dp, sp + ftl->PgLay.spare.ofs_ecc);
+      ecc_Hamming8 (sp, sp + ftl->PgLay.spare.ofs_ecc + ecc_len);
+    }
+    else {
+      /* BCH: data and spare bytes preceding ECC */
+      ecc_Bch (dp, sp, ftl->PgLay.spare.ofs_ecc, sp + ftl->PgLay.spare.ofs_ecc, BCH_T(pDev->sw_ecc));
+    }
 
     /* Point to data and spare of the next sector */
     dp += ftl->PgLay.sector_inc;
@@ -3832,7 +5502,7 @@ static void EncodeECC (NAND_FTL_DEV *ftl, uint8_t *pgBuf) {
  *            FTL_ERROR_ECC_FAIL - ECC was not able to correct the data
  *----------------------------------------------------------------------------*/
 static uint32_t DecodeECC (NAND_FTL_DEV *ftl, uint8_t *pgBuf) {
-  uint32_t sec, ecc, err_s, err_d;
+  uint32_t sec, ecc, err_s, err_d, t;
   uint8_t *dp, *sp, *ep;
 
   dp = pgBuf;
@@ -3842,25 +5512,41 @@ static uint32_t DecodeECC (NAND_FTL_DEV *ftl, uint8_t *pgBuf) {
   for (sec = 0; sec < ftl->PageSectors; sec++) {
     /* Set ECC position pointer */
     ep = sp + ftl->PgLay.spare.ofs_ecc;
-    /* Detect empty page */
-    if ((ep[3] & 0xC0) == 0xC0) {
-      /* This is an empty page */
-      ep[0] = 0; ep[1] = 0; ep[2] = 0; ep[3] = 0; ep[4] = 0;
+
+    if (pDev->sw_ecc == 1) {
+      /* Detect empty page */
+      if ((ep[3] & 0xC0) == 0xC0) {
+        /* This is an empty page */
+        ep[0] = 0; ep[1] = 0; ep[2] = 0; ep[3] = 0; ep[4] = 0;
+      }
+      /* Verify data using ECC */
+      err_s = ecc_Hamming8Verify   (sp, ep + 3);
+      err_d = ecc_Hamming512Verify (dp, ep);
+
+      if ((err_s == ECC_SINGLEBITERR) || (err_d == ECC_SINGLEBITERR)) {
+        ecc |= ECC_CORRECTED;
+      }
+      else if ((err_s == ECC_MULTIBITERR) || (err_d == ECC_MULTIBITERR)) {
+        ecc |= ECC_UNCORRECTED;
+      }
+    }
+    else {
+      /* Verify data and spare using BCH, empty page is a valid codeword */
+      t     = BCH_T(pDev->sw_ecc);
+      err_d = ecc_BchVerify (dp, sp, ftl->PgLay.spare.ofs_ecc, ep, t);
+
+      if (err_d == INVALID) {
+        ecc |= ECC_UNCORRECTED;
+      }
+      else if (err_d >= BCH_REFRESH(t)) {
+        /* Data corrected, but close to the correction limit */
+        ecc |= ECC_CORRECTED;
+      }
     }
-    /* Verify data using ECC */
-    err_s = ecc_Hamming8Verify   (sp, ep + 3);
-    err_d = ecc_Hamming512Verify (dp, ep);
 
     /* Point to data and spare of the next sector */
     dp += ftl->PgLay.sector_inc;
     sp += ftl->PgLay.spare_inc;
-
-    if ((err_s == ECC_SINGLEBITERR) || (err_d == ECC_SINGLEBITERR)) {
-      ecc |= ECC_CORRECTED;
-    }
-    else if ((err_s == ECC_MULTIBITERR) || (err_d == ECC_MULTIBITERR)) {
-      ecc |= ECC_UNCORRECTED;
-    }
   }
   if (ecc & ECC_UNCORRECTED) {
     return FTL_ERROR_ECC_FAIL;
@@ -19,6 +19,8 @@
 /* Definitions */
 #define __MIN_IN_QUEUE  3               /* Min number of blocks in queue      */
 #define __MAX_RETRY     5               /* Max number of retries on errors    */
+#define __MAX_GC_SCAN   4               /* Max number of blocks scanned in    */
+                                        /*  one background reclaim step       */
 #define __SZ_SP_USED    10              /* Num spare bytes used by FTL        */
 #define __SZ_SPARE      16              /* Spare Area Size (scaled to Sector) */
 #define __SZ_SECT       512             /* Sector Size */
@@ -42,6 +44,15 @@
 #define ECC_CORRECTED   1               /* ECC failed, data was corrected     */
 #define ECC_UNCORRECTED 2               /* ECC failed, data was not corrected */
 
+/* Software BCH ECC, GF(2^13) */
+#define BCH_M           13              /* Galois field order                 */
+#define BCH_POLY        0x201BU         /* Primitive polynomial               */
+#define BCH_T_MAX       8               /* Max number of correctable bits     */
+
+#define BCH_T(alg)      (((alg) == 4U) ? 4U : 8U)     /* Correctable bits     */
+#define BCH_ECC_LEN(t)  ((BCH_M * (t) + 7U) / 8U)     /* ECC bytes per sector */
+#define BCH_REFRESH(t)  (((t) * 3U) / 4U)             /* Block refresh limit  */
+
 #define TYP_REPL        0
 #define TYP_PRIM        1
 
@@ -59,6 +70,9 @@
 #define pDev            (ftl->Media->dev)
 #define pCfg            (ftl->Cfg)
 
+/* ECC is encoded and decoded by FTL (Hamming or BCH) */
+#define SW_ECC          ((pDev->sw_ecc == 1U) || (pDev->sw_ecc >= 4U))
+
 /* Default page layout definition */
 #define DL_POS_LSN      0               /* NAND: 0, OneNAND: 2 */
 #define DL_POS_COR      4               /* NAND: 4, OneNAND: 1 */
@@ -571,6 +571,19 @@ fsStatus nor_DevCtrl (fsDevCtrlCode code, void *p, NOR_MEDIA *nor) {
       }
       break;
 
+    /* Retrieve optimal programming page size        */
+    case fsDevCtrlCodePageSize:
+      if (p != NULL) {
+        inf = nor->Driver->GetInfo();
+
+        if (inf != NULL) {
+          *(uint32_t *)p = inf->page_size;
+
+          status = fsOK;
+        }
+      }
+      break;
+
     case fsDevCtrlCodeControlMedia:
     case fsDevCtrlCodeGetCID:
     case fsDevCtrlCodeSerial:
@@ -139,6 +139,51 @@
   #endif
 #endif
 
+#if defined (FS_RTOS_RTX5) && (FAT_MAX_OPEN_FILES > 0)
+  /* CMSIS RTOS2 RTX5, FAT file handle mutexes */
+  static osRtxMutex_t  fs_fh_mtx_cb[FAT_MAX_OPEN_FILES]  __attribute__((section(".bss.os.mutex.cb")));
+#endif
+
+#if (FAT_IO_WORKER_ENABLE)
+
+  #ifndef FAT_IO_WORKER_STACK_SIZE
+    #define FAT_IO_WORKER_STACK_SIZE  2048
+  #endif
+  #ifndef FAT_IO_WORKER_PRIORITY
+    #define FAT_IO_WORKER_PRIORITY    osPriorityBelowNormal
+  #endif
+
+  #if defined (FS_RTOS_RTX5)
+  /* CMSIS RTOS2 RTX5 */
+  static osRtxThread_t fs_io_thread_cb  __attribute__((section(".bss.os.thread.cb")));
+  static uint64_t      fs_io_stack[FAT_IO_WORKER_STACK_SIZE/8];
+  static
+  const osThreadAttr_t fs_io_thread_at = { "fsIO_Thread", osThreadDetached, &fs_io_thread_cb, sizeof(osRtxThread_t),
+                                           &fs_io_stack, sizeof(fs_io_stack), FAT_IO_WORKER_PRIORITY, 0, 0 };
+  #else
+  /* CMSIS RTOS2 (dynamic memory allocation) */
+  static
+  const osThreadAttr_t fs_io_thread_at = { "fsIO_Thread", osThreadDetached, NULL, 0,
+                                           NULL, FAT_IO_WORKER_STACK_SIZE, FAT_IO_WORKER_PRIORITY, 0, 0 };
+  #endif
+
+  static osThreadId_t fs_io_thread_id;
+
+/*
+  Background I/O worker thread
+*/
+static void fs_io_thread (void *arg) {
+  (void)arg;
+
+  for (;;) {
+    /* Wait for I/O request */
+    osThreadFlagsWait (1U, osFlagsWaitAny, osWaitForever);
+
+    fat_io_run ();
+  }
+}
+#endif
+
 /*
   Create and initialize a mutex object
 */
@@ -239,6 +284,51 @@ uint32_t fs_mutex_delete (FS_MUTEX mutex) {
   }
   return (status);
 }
+/*
+  Create and initialize a file handle mutex object
+*/
+FS_MUTEX fs_fh_mutex_new (uint32_t idx) {
+  osMutexAttr_t attr = { NULL, osMutexPrioInherit, NULL, 0 };
+
+#if defined (FS_RTOS_RTX5) && (FAT_MAX_OPEN_FILES > 0)
+  if (idx >= FAT_MAX_OPEN_FILES) {
+    return (NULL);
+  }
+  attr.attr_bits |= osMutexRobust;
+  attr.cb_mem     = &fs_fh_mtx_cb[idx];
+  attr.cb_size    = sizeof(osRtxMutex_t);
+#else
+  (void)idx;
+#endif
+  return ((FS_MUTEX)osMutexNew (&attr));
+}
+/*
+  Create background I/O worker thread.
+*/
+uint32_t fs_io_thread_new (void) {
+  uint32_t status = 0U;
+
+#if (FAT_IO_WORKER_ENABLE)
+  if (fs_io_thread_id == NULL) {
+    fs_io_thread_id = osThreadNew (&fs_io_thread, NULL, &fs_io_thread_at);
+
+    if (fs_io_thread_id == NULL) {
+      status = 1U;
+    }
+  }
+#endif
+  return (status);
+}
+/*
+  Signal background I/O worker thread.
+*/
+void fs_io_thread_signal (void) {
+#if (FAT_IO_WORKER_ENABLE)
+  if (fs_io_thread_id != NULL) {
+    osThreadFlagsSet (fs_io_thread_id, 1U);
+  }
+#endif
+}
 /*
   Get the RTOS kernel tick frequency
 */
@@ -24,6 +24,8 @@ static int32_t fs_read  (int32_t handle, void *buf, uint32_t cnt);
 static int32_t fs_flush (int32_t handle);
 static int64_t fs_seek  (int32_t handle, int64_t offset, int32_t whence);
 static int64_t fs_size  (int32_t handle);
+static int32_t fs_alloc (int32_t handle, int64_t size, uint32_t flags);
+static int32_t fs_xfer  (int32_t handle, const uint8_t *wbuf, uint8_t *rbuf, uint32_t cnt, FS_MUTEX fh_mutex);
 
 /**
   Retarget of the _sys_open(...) function.
@@ -396,6 +398,28 @@ int64_t fs_fsize (int32_t handle) {
   return (rval);
 }
 
+/**
+  Preallocate file space.
+
+  This function reserves contiguous space for an opened file, so that the
+  following writes fill the reserved space without allocating clusters.
+  File size is not changed. Parameter flags can have the following values:
+  - FS_FALLOC_KEEP: keep preallocated space when the file is closed
+  - FS_FALLOC_RELEASE: release unused preallocated space when the file is closed
+
+  \param[in]     handle  file handle of an opened file
+  \param[in]     size    number of bytes to reserve from the start of the file
+  \param[in]     flags   integer bitmap specifying the allocate flags
+  \return        zero on success,
+                 or negative \ref fsStatus return code on failure
+*/
+int32_t fs_fallocate (int32_t handle, int64_t size, uint32_t flags) {
+
+  EvrFsCore_fs_fallocate (handle, size, flags);
+
+  return fs_alloc (handle, size, flags);
+}
+
 
 /**
   Open a file, see fs_fopen for details.
@@ -435,6 +459,10 @@ static int32_t fs_open (const char *path, int32_t mode) {
       stat = fat_open (fh, path, mode);
 
       if (stat == fsOK) {
+        if ((fs_fat_xfer_chunk != 0U) && (fs_fat_fh_mtx[fh] == NULL)) {
+          /* Create file handle mutex used for chunked transfers */
+          fs_fat_fh_mtx[fh] = fs_fh_mutex_new ((uint32_t)fh);
+        }
         /* Set "FAT handle" flag */
         fh |= SYS_HANDLE_FAT;
       }
@@ -492,11 +520,29 @@ static int32_t fs_close (int32_t handle) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
+    /* Lock FAT file handle and volume */
+    HANDLE_LOCK (handle);
     VOLUME_LOCK (fs_fat_fh[handle].vol);
 
     /* Close a file opened on FAT drive */
     stat = fat_close (handle);
+
+    if ((handle_mutex != NULL) && !(fs_fat_fh[handle].flags & FAT_HANDLE_OPEN)) {
+      /* File is closed, keep handle reserved until mutex waiters are released */
+      fs_fat_fh[handle].flags |= FAT_HANDLE_CLOSE;
+      fs_fat_fh_mtx[handle]    = NULL;
+      fs_mutex_release (volume_mutex);
+
+      /* Waiters acquire the mutex in turn, find the file closed and return */
+      fs_mutex_release (handle_mutex);
+      fs_mutex_acquire (handle_mutex);
+      fs_mutex_release (handle_mutex);
+      fs_mutex_delete  (handle_mutex);
+      handle_mutex = NULL;
+
+      fs_mutex_acquire (volume_mutex);
+      fs_fat_fh[handle].flags &= ~FAT_HANDLE_CLOSE;
+    }
   }
   else if (handle & SYS_HANDLE_EFS) {
     handle &= ~SYS_HANDLE_EFS;
@@ -541,11 +587,11 @@ static int32_t fs_write (int32_t handle, const void *buf, uint32_t cnt) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
-    VOLUME_LOCK (fs_fat_fh[handle].vol);
+    /* Lock FAT file handle */
+    HANDLE_LOCK (handle);
 
-    /* Write data to FAT drive. */
-    rval = fat_write (handle, buf, cnt);
+    /* Write data to FAT drive, volume is locked by fs_xfer */
+    rval = fs_xfer (handle, buf, NULL, cnt, handle_mutex);
   }
   else if (handle & SYS_HANDLE_EFS) {
     handle &= ~SYS_HANDLE_EFS;
@@ -585,11 +631,11 @@ static int32_t fs_read (int32_t handle, void *buf, uint32_t cnt) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
-    VOLUME_LOCK (fs_fat_fh[handle].vol);
+    /* Lock FAT file handle */
+    HANDLE_LOCK (handle);
 
-    /* Read data from FAT drive */
-    rval = fat_read (handle, buf, cnt);
+    /* Read data from FAT drive, volume is locked by fs_xfer */
+    rval = fs_xfer (handle, NULL, buf, cnt, handle_mutex);
   }
   else if (handle & SYS_HANDLE_EFS) {
     handle &= ~SYS_HANDLE_EFS;
@@ -628,7 +674,8 @@ static int32_t fs_flush (int32_t handle) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
+    /* Lock FAT file handle and volume */
+    HANDLE_LOCK (handle);
     VOLUME_LOCK (fs_fat_fh[handle].vol);
 
     /* Flush buffers on FAT drive. */
@@ -677,7 +724,8 @@ static int64_t fs_seek (int32_t handle, int64_t offset, int32_t whence) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
+    /* Lock FAT file handle and volume */
+    HANDLE_LOCK (handle);
     VOLUME_LOCK (fs_fat_fh[handle].vol);
 
     /* Set fpos on FAT drive */
@@ -721,7 +769,8 @@ static int64_t fs_size (int32_t handle) {
 
   if (handle & SYS_HANDLE_FAT) {
     handle &= ~SYS_HANDLE_FAT;
-    /* Lock FAT volume */
+    /* Lock FAT file handle and volume */
+    HANDLE_LOCK (handle);
     VOLUME_LOCK (fs_fat_fh[handle].vol);
 
     /* FAT drive */
@@ -748,3 +797,143 @@ static int64_t fs_size (int32_t handle) {
   RETURN (rval);
   END_LOCK;
 }
+
+/**
+  Preallocate file space, see fs_fallocate for details.
+
+  \param[in]     handle  file handle of an opened file
+  \param[in]     size    number of bytes to reserve from the start of the file
+  \param[in]     flags   integer bitmap specifying the allocate flags
+  \return        zero on success,
+                 or negative \ref fsStatus return code on failure
+*/
+static int32_t fs_alloc (int32_t handle, int64_t size, uint32_t flags) {
+  fsStatus stat;
+  int32_t rval;
+
+  START_LOCK (int32_t);
+
+  if ((size < 0) || (size > 0xFFFFFFFE)) {
+    /* Size out of range */
+    stat = fsInvalidParameter;
+  }
+  else if (handle & SYS_HANDLE_FAT) {
+    handle &= ~SYS_HANDLE_FAT;
+    /* Lock FAT file handle and volume */
+    HANDLE_LOCK (handle);
+    VOLUME_LOCK (fs_fat_fh[handle].vol);
+
+    /* Reserve clusters on FAT drive */
+    stat = fat_allocate (handle, (uint32_t)size, flags);
+  }
+  else if (handle & SYS_HANDLE_EFS) {
+    /* EFS allocates space on write */
+    stat = fsUnsupported;
+  }
+  else {
+    /* Invalid file handle */
+    stat = fsInvalidParameter;
+  }
+
+  if (stat == fsOK) {
+    rval = 0;
+  }
+  else {
+    /* Set errno to last known status code */
+    errno = (int)stat;
+
+    rval = -(int32_t)stat;
+  }
+
+  RETURN(rval);
+  END_LOCK;
+}
+
+/**
+  Transfer data to or from a file on FAT drive.
+
+  Volume is locked for one chunk of FAT_TRANSFER_CHUNK clusters at a time,
+  so that other files on the same drive can be accessed between the chunks.
+  Order of chunks on the same file is kept by the file handle mutex, which
+  must be held by the caller. Without file handle mutex the whole transfer
+  is done under volume lock.
+
+  While chunks remain, the handle is marked with FAT_HANDLE_XFER so that
+  unmount, format and uninitialize of the volume are refused until the
+  transfer completes.
+
+  \param[in]     handle    FAT file handle
+  \param[in]     wbuf      data to write or NULL when reading
+  \param[out]    rbuf      buffer to store read data or NULL when writing
+  \param[in]     cnt       number of bytes to transfer
+  \param[in]     fh_mutex  file handle mutex held by the caller or NULL
+  \return        number of bytes transferred,
+                 or negative \ref fsStatus return code on failure
+*/
+static int32_t fs_xfer (int32_t handle, const uint8_t *wbuf, uint8_t *rbuf, uint32_t cnt, FS_MUTEX fh_mutex) {
+  fsFAT_Volume *vol;
+  uint32_t n, chunk;
+  int32_t  num, rval;
+  bool     done;
+
+  if ((handle < 0) || (handle >= (int32_t)fs_fat_fh_cnt) || (fs_fat_fh[handle].vol == NULL)) {
+    return (-(int32_t)fsInvalidParameter);
+  }
+  vol = fs_fat_fh[handle].vol;
+  num = 0;
+
+  for (;;) {
+    if (vol->Mutex) {
+      fs_mutex_acquire (vol->Mutex);
+    }
+
+    n = cnt - (uint32_t)num;
+
+    if (fh_mutex != NULL) {
+      /* Limit transfer size to one chunk */
+      chunk = fs_fat_xfer_chunk * vol->cfg.ClusSize;
+
+      if ((chunk != 0U) && (n > chunk)) {
+        n = chunk;
+      }
+    }
+
+    if (wbuf != NULL) {
+      rval = fat_write (handle, &wbuf[num], n);
+    } else {
+      rval = fat_read  (handle, &rbuf[num], n);
+    }
+
+    if (rval < 0) {
+      if (num == 0) {
+        /* Nothing transferred, return error code */
+        num = rval;
+      }
+      done = true;
+    }
+    else {
+      num += rval;
+      /* End of file, drive full or transfer complete */
+      done = ((uint32_t)rval < n) || ((uint32_t)num == cnt);
+    }
+
+    if (fh_mutex != NULL) {
+      /* Mark transfer in progress while volume is unlocked */
+      if (done) {
+        fs_fat_fh[handle].flags &= ~FAT_HANDLE_XFER;
+      } else {
+        fs_fat_fh[handle].flags |=  FAT_HANDLE_XFER;
+      }
+    }
+
+    if (vol->Mutex) {
+      fs_mutex_release (vol->Mutex);
+    }
+
+    if (done) {
+      break;
+    }
+  }
+
+  return (num);
+}
@@ -13,18 +13,27 @@
 
 /* Mutex lock macros. */
 #define START_LOCK(x)   x return_value;                                 \
-                        FS_MUTEX volume_mutex = NULL
+                        FS_MUTEX volume_mutex = NULL;                   \
+                        FS_MUTEX handle_mutex = NULL
 
 #define VOLUME_LOCK(x)  volume_mutex = (x)->Mutex;                      \
                         if (volume_mutex)                               \
                           fs_mutex_acquire (volume_mutex)
 
+#define HANDLE_LOCK(x)  if ((x) < (int32_t)fs_fat_fh_cnt)               \
+                          handle_mutex = fs_fat_fh_mtx[x];              \
+                        if (handle_mutex)                               \
+                          if (fs_mutex_acquire (handle_mutex) != 0U)    \
+                            handle_mutex = NULL
+
 #define RETURN(x)       return_value = (x);                             \
                         goto end_of_func
 
 #define END_LOCK        end_of_func:                                    \
                         if (volume_mutex)                               \
                           fs_mutex_release (volume_mutex);              \
+                        if (handle_mutex)                               \
+                          fs_mutex_release (handle_mutex);              \
                         return (return_value)
 
 /* File Handle Bit Masks */
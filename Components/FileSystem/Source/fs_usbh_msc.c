@@ -140,6 +140,21 @@ fsStatus usbh_msc_DevCtrl (fsDevCtrlCode code, void *p, uint32_t instance) {
     }
     status = fsOK;
   }
+  else if (code == fsDevCtrlCodeDiscard) {
+    /* Unmap a range of unused blocks */
+    usb_status = USBH_MSC_Unmap (instance, ((fsDiscardRange *)p)->sect, ((fsDiscardRange *)p)->cnt);
+
+    if (usb_status == usbOK) {
+      status = fsOK;
+    }
+    else if (usb_status == usbClassErrorMSC) {
+      /* Device does not support unmap */
+      status = fsUnsupported;
+    }
+    else {
+      status = fsError;
+    }
+  }
   else {
     /* Unsupported */
     status = fsUnsupported;
@@ -4,7 +4,7 @@
  *------------------------------------------------------------------------------
  * Name:    Net_Config_ETH_%Instance%.h
  * Purpose: Network Configuration for ETH Interface
- * Rev.:    V7.5.0
+ * Rev.:    V7.6.0
  *----------------------------------------------------------------------------*/
 
 //-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
@@ -270,5 +270,8 @@
 //        Interface Thread Priority
 #define ETH%Instance%_THREAD_PRIORITY    osPriorityAboveNormal
 
+//        Process received frames in Interface Thread
+#define ETH%Instance%_THREAD_RX_PROC     0
+
 //   </h>
 // </h>
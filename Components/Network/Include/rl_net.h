@@ -112,12 +112,20 @@ typedef enum {
   netUDP_OptionTrafficClass,            ///< IPv6 Traffic Class; val=TrafficClass
   netUDP_OptionHopLimit,                ///< IPv6 Multi-cast Hop Limit; val=HopLimit
   netUDP_OptionInterface,               ///< Network interface to bind; val=if_id (class and number)
-  netUDP_OptionChecksum                 ///< UDP Checksum Options
+  netUDP_OptionChecksum,                ///< UDP Checksum Options
+  netUDP_OptionReceiveQueue             ///< Receive queue size; val=max. queued datagrams (0=callback mode)
 } netUDP_Option;
 
 /// UDP Event callback function.
 typedef uint32_t (*netUDP_cb_t)(int32_t socket, const NET_ADDR *addr, const uint8_t *buf, uint32_t len);
 
+/// UDP Received Message descriptor.
+typedef struct net_udp_msg {
+  NET_ADDR addr;                        ///< Remote IP address and port
+  uint8_t *buf;                         ///< Pointer to the receive buffer
+  uint32_t len;                         ///< Buffer size on input, received data length on output
+} NET_UDP_MSG;
+
 /// TCP Socket Events.
 typedef enum {
   netTCP_EventConnect         = 0,      ///< Connect request received event
@@ -417,6 +425,41 @@ typedef enum {
   netIF_VersionIP6                      ///< IP version 6
 } netIF_Version;
 
+/// Interface statistics.
+typedef struct net_if_stats {
+  uint32_t rx_packets;                  ///< Number of received packets
+  uint32_t rx_bytes;                    ///< Number of received bytes
+  uint32_t tx_packets;                  ///< Number of transmitted packets
+  uint32_t tx_bytes;                    ///< Number of transmitted bytes
+  uint32_t rx_drop_error;               ///< Received packets dropped: invalid size or driver error
+  uint32_t rx_drop_queue;               ///< Received packets dropped: receive queue full
+  uint32_t rx_drop_memory;              ///< Received packets dropped: out of memory
+  uint32_t tx_drop;                     ///< Transmit packets dropped: link down or driver error
+} NET_IF_STATS;
+
+/// Network Core thread latency histogram.
+#define NET_SYS_HIST_SIZE       8       ///< Number of histogram bins
+
+/// Network System statistics.
+typedef struct net_sys_stats {
+  uint32_t mem_used;                    ///< Currently used memory pool in bytes
+  uint32_t mem_used_max;                ///< Memory pool usage high-water mark in bytes
+  uint32_t mem_blocks_max;              ///< Allocated memory blocks high-water mark
+  uint32_t mem_limit_fail;              ///< Allocations refused: reserve limit exceeded
+  uint32_t mem_alloc_fail;              ///< Allocations failed: out of memory
+  uint32_t ip4_errors;                  ///< Invalid IPv4 packets received
+  uint32_t ip6_errors;                  ///< Invalid IPv6 packets received
+  uint32_t icmp_errors;                 ///< Invalid ICMP messages received
+  uint32_t icmp6_errors;                ///< Invalid ICMPv6 messages received
+  uint32_t udp_errors;                  ///< Invalid UDP datagrams received
+  uint32_t tcp_errors;                  ///< Invalid TCP segments received
+  uint32_t tcp_retransmits;             ///< Retransmitted TCP segments
+  uint32_t tcp_dup_acks;                ///< Duplicate TCP acknowledgments received
+  uint32_t tcp_timeouts;                ///< TCP retransmission timeouts
+  uint32_t loop_hist[NET_SYS_HIST_SIZE];///< Network Core loop time histogram:
+                                        ///< <16us, <64us, <256us, <1ms, <4ms, <16ms, <64ms, >=64ms
+} NET_SYS_STATS;
+
 /// Ethernet link speed.
 #define NET_ETH_SPEED_10M       0       ///< 10 Mbps link speed
 #define NET_ETH_SPEED_100M      1       ///< 100 Mbps link speed
@@ -772,6 +815,11 @@ extern const char *netSYS_GetHostName (void);
 /// \return      status code that indicates the execution status of the function.
 extern netStatus netSYS_SetHostName (const char *hostname);
 
+/// \brief Retrieve Network Component statistics. [\ref thread-safe]
+/// \param[out]    stats         pointer to the structure to store statistics to.
+/// \return      status code that indicates the execution status of the function.
+extern netStatus netSYS_GetStats (NET_SYS_STATS *stats);
+
 //  ==== UDP Socket API ====
 
 /// \brief Allocate a free UDP socket. [\ref thread-safe]
@@ -825,6 +873,17 @@ extern netStatus netUDP_SetOption (int32_t socket, netUDP_Option option, uint32_
 ///                - 0           = socket invalid or in invalid state.
 extern uint16_t  netUDP_GetLocalPort (int32_t socket);
 
+/// \brief Receive multiple queued datagrams from UDP socket. [\ref thread-safe]
+/// \param[in]     socket        socket handle obtained with \ref netUDP_GetSocket.
+/// \param[in,out] msg           array of message descriptors.
+/// \param[in]     num           number of message descriptors in array.
+/// \param[in]     timeout       time to wait for first datagram in milliseconds.
+///                              - 0 = do not wait.
+/// \return      number of datagrams received or execution status:
+///              - value >= 0:   number of datagrams received.
+///              - value < 0:    error occurred, -value is execution status as defined with \ref netStatus.
+extern int32_t   netUDP_ReceiveBatch (int32_t socket, NET_UDP_MSG *msg, uint32_t num, uint32_t timeout);
+
 //  ==== TCP Socket API ====
 
 /// \brief Allocate a free TCP socket. [\ref thread-safe]
@@ -1345,6 +1404,12 @@ extern netStatus netIF_SetOption (uint32_t if_id, netIF_Option option, const uin
 /// \return      status code that indicates the execution status of the function.
 extern netStatus netIF_SetDefault (uint32_t if_id, netIF_Version ip_version);
 
+/// \brief Retrieve Interface statistics. [\ref thread-safe]
+/// \param[in]     if_id         Interface identification (class and number).
+/// \param[out]    stats         pointer to the structure to store statistics to.
+/// \return      status code that indicates the execution status of the function.
+extern netStatus netIF_GetStats (uint32_t if_id, NET_IF_STATS *stats);
+
 /// \brief Enable or disable ICMP Echo response. [\ref thread-safe]
 /// \param[in]     if_id         Interface identification (class and number).
 /// \param[in]     no_echo       new state of NoEcho attribute:
@@ -1890,6 +1955,11 @@ extern int32_t   netFTPs_ffind (const char *mask, char *fname, uint32_t *fsize,
 /// \return      status code that indicates the execution status of the function.
 extern netStatus netFTPc_Connect (const NET_ADDR *addr, netFTP_Command command);
 
+/// \brief Queue next file operation for running FTP client session. [\ref thread-safe]
+/// \param[in]     command       FTP command to perform.
+/// \return      status code that indicates the execution status of the function.
+extern netStatus netFTPc_Queue (netFTP_Command command);
+
 //  ==== FTP Client User Callbacks ====
 
 /// \brief Request parameters for FTP client session. [\ref user-provided]
@@ -110,6 +110,12 @@
 #if (TELNET_SERVER_ENABLE && defined(TELNET_SERVER_NUM_SESSISONS))
   #define TELNET_SERVER_NUM_SESSIONS TELNET_SERVER_NUM_SESSISONS
 #endif
+#if (ETH0_ENABLE && !defined(ETH0_THREAD_RX_PROC))
+  #define ETH0_THREAD_RX_PROC       0
+#endif
+#if (ETH1_ENABLE && !defined(ETH1_THREAD_RX_PROC))
+  #define ETH1_THREAD_RX_PROC       0
+#endif
 
 /* Check configuration integrity */
 #if (ETH0_ENABLE && !defined(ETH0_THREAD_STACK_SIZE))
@@ -254,6 +260,15 @@
   #error "::Network:Interface: No interface enabled in configuration"
 #endif
 
+/* Check interface thread stack for frame processing */
+#if (ETH0_ENABLE && ETH0_THREAD_RX_PROC && (ETH0_THREAD_STACK_SIZE < NET_THREAD_STACK_SIZE))
+  #error "::Network:Interface:ETH0: Interface Thread Stack Size too small"
+#endif
+
+#if (ETH1_ENABLE && ETH1_THREAD_RX_PROC && (ETH1_THREAD_STACK_SIZE < NET_THREAD_STACK_SIZE))
+  #error "::Network:Interface:ETH1: Interface Thread Stack Size too small"
+#endif
+
 /* Check interface drivers */
 #if (ETH1_ENABLE && ETH0_ENABLE && (ETH1_DRIVER == ETH0_DRIVER))
   #error "::Network:Interface:ETH1: Driver conflict with ETH0 interface"
@@ -590,6 +605,7 @@ NET_SYS_CFG net_sys_config = {
 
   /* ETH0: Interface configuration */
   static NET_IF_STATE eth0_state;
+  static NET_IF_STATS eth0_stats;
   NET_IF_CFG net_eth0_if_config = {
     &eth0_state,
     NET_IF_CLASS_ETH+0,
@@ -608,7 +624,8 @@ NET_SYS_CFG net_sys_config = {
     NULL, NULL,
    #endif
     net_eth_send_frame,
-    net_eth_output
+    net_eth_output,
+    &eth0_stats
   };
 
   /* ETH0: low layer configuration */
@@ -632,6 +649,7 @@ NET_SYS_CFG net_sys_config = {
     0,
   #endif
     0,
+    ETH0_THREAD_RX_PROC,
     eth0_callback
   };
 #endif
@@ -805,6 +823,7 @@ NET_SYS_CFG net_sys_config = {
 
   /* ETH1: Interface configuration */
   static NET_IF_STATE eth1_state;
+  static NET_IF_STATS eth1_stats;
   NET_IF_CFG net_eth1_if_config = {
     &eth1_state,
     NET_IF_CLASS_ETH+1,
@@ -823,7 +842,8 @@ NET_SYS_CFG net_sys_config = {
     NULL, NULL,
    #endif
     net_eth_send_frame,
-    net_eth_output
+    net_eth_output,
+    &eth1_stats
   };
 
   /* ETH1: low layer configuration */
@@ -843,6 +863,7 @@ NET_SYS_CFG net_sys_config = {
     ETH1_MAC_ADDR,
     ETH1_VLAN_ID * ETH1_VLAN_ENABLE,
     1,
+    ETH1_THREAD_RX_PROC,
     eth1_callback
   };
 #endif
@@ -1016,6 +1037,7 @@ NET_SYS_CFG net_sys_config = {
 
   /* WIFI0: Interface configuration */
   static NET_IF_STATE wifi0_state;
+  static NET_IF_STATS wifi0_stats;
   NET_IF_CFG net_wifi0_if_config = {
     &wifi0_state,
     NET_IF_CLASS_WIFI+0,
@@ -1034,7 +1056,8 @@ NET_SYS_CFG net_sys_config = {
     NULL, NULL,
    #endif
     net_wifi_send_frame,
-    net_wifi_output
+    net_wifi_output,
+    &wifi0_stats
   };
 
   /* WIFI0: low layer configuration */
@@ -1225,6 +1248,7 @@ NET_SYS_CFG net_sys_config = {
 
   /* WIFI1: Interface configuration */
   static NET_IF_STATE wifi1_state;
+  static NET_IF_STATS wifi1_stats;
   NET_IF_CFG net_wifi1_if_config = {
     &wifi1_state,
     NET_IF_CLASS_WIFI+1,
@@ -1243,7 +1267,8 @@ NET_SYS_CFG net_sys_config = {
     NULL, NULL,
    #endif
     net_wifi_send_frame,
-    net_wifi_output
+    net_wifi_output,
+    &wifi1_stats
   };
 
   /* WIFI1: low layer configuration */
@@ -1299,6 +1324,7 @@ NET_SYS_CFG net_sys_config = {
   };
 
   /* PPP: Interface configuration */
+  static NET_IF_STATS ppp0_stats;
   NET_IF_CFG net_ppp0_if_config = {
     NULL,
     NET_IF_CLASS_PPP,
@@ -1309,7 +1335,8 @@ NET_SYS_CFG net_sys_config = {
     NULL,
     NULL,
     net_ppp_send_frame,
-    NULL
+    NULL,
+    &ppp0_stats
   };
 
   /* PPP: Communication device */
@@ -1403,6 +1430,7 @@ NET_SYS_CFG net_sys_config = {
   };
 
   /* SLIP: Interface configuration */
+  static NET_IF_STATS slip0_stats;
   NET_IF_CFG net_slip0_if_config = {
     NULL,
     NET_IF_CLASS_SLIP,
@@ -1413,7 +1441,8 @@ NET_SYS_CFG net_sys_config = {
     NULL,
     NULL,
     net_slip_send_frame,
-    NULL
+    NULL,
+    &slip0_stats
   };
 
   /* SLIP: Communication device */
@@ -67,6 +67,8 @@ static void eth_config_mcast (uint32_t if_num);
 static void eth_receive (NET_ETH_CFG *h);
 static void eth_check_link (NET_ETH_CFG *h);
 static void eth_iface_run (NET_ETH_CFG *h);
+static void eth_thread_rx (NET_ETH_CFG *h);
+static void eth_process_frame (NET_ETH_CFG *h);
 static bool eth_vlan_accept (NET_ETH_CFG *h, NET_FRAME *frame);
 static bool eth_is_ucast4 (const uint8_t *mac_addr);
 static NET_ETH_CFG *eth_if_map (uint32_t if_num);
@@ -400,6 +402,10 @@ __NO_RETURN void netETH_Thread (void *arg) {
       eth_check_link (h);
     }
     eth_unlock (h);
+    if (h->ThreadRx) {
+      /* Process received frames in this thread */
+      eth_thread_rx (h);
+    }
   }
 }
 
@@ -812,6 +818,7 @@ static void eth_receive (NET_ETH_CFG *h) {
         else                eth_test.err_emac++;
       }
 #endif
+      h->If->Stats->rx_drop_error++;
       drv_mac->ReadFrame (NULL, 0);
       continue;
     }
@@ -820,6 +827,7 @@ static void eth_receive (NET_ETH_CFG *h) {
 #ifdef ACHILLES_TEST
       if (h->IfNum == 0) eth_test.err_queue++;
 #endif
+      h->If->Stats->rx_drop_queue++;
       drv_mac->ReadFrame (NULL, 0);
       continue;
     }
@@ -830,6 +838,7 @@ static void eth_receive (NET_ETH_CFG *h) {
 #ifdef ACHILLES_TEST
       if (h->IfNum == 0) eth_test.err_mem++;
 #endif
+      h->If->Stats->rx_drop_memory++;
       drv_mac->ReadFrame (NULL, 0);
       continue;
     }
@@ -837,6 +846,8 @@ static void eth_receive (NET_ETH_CFG *h) {
     drv_mac->ReadFrame (&frame->data[0], size);
     ctrl->rx_q[ctrl->q_head & (ETH_QSIZE-1)] = frame;
     ctrl->RxCount += size;
+    h->If->Stats->rx_packets++;
+    h->If->Stats->rx_bytes += size;
     ctrl->q_head++;
   }
   if (ctrl->q_head == ctrl->q_tail) {
@@ -845,7 +856,9 @@ static void eth_receive (NET_ETH_CFG *h) {
   if (ctrl->Flags & ETH_FLAG_POLLING) {
     ctrl->th.osDelay = 2;
   }
-  net_sys_wakeup ();
+  if (!h->ThreadRx) {
+    net_sys_wakeup ();
+  }
 }
 
 /**
@@ -923,6 +936,7 @@ bool net_eth_send_frame (uint32_t if_num, NET_FRAME *frame, uint8_t ip_ver) {
     /* Discard frame, the link is down */
     ERRORF (ETH,"Send %d, Link down\n",h->IfNum);
     EvrNetETH_LinkDownError(h->IfNum);
+    h->If->Stats->tx_drop++;
     return (false);
   }
   if (frame->length > (PHY_HEADER_LEN + ETH_MTU)) {
@@ -1071,6 +1085,8 @@ netStatus netETH_SendRaw (uint32_t if_num, const uint8_t *buf, uint32_t len) {
     if (rc == ARM_DRIVER_OK) {
       /* Success, frame transmit started */
       ctrl->TxCount += len;
+      h->If->Stats->tx_packets++;
+      h->If->Stats->tx_bytes += len;
       eth_unlock (h);
       RETURN (netOK);
     }
@@ -1149,9 +1165,12 @@ bool net_eth_output (uint32_t if_num, NET_FRAME *frame) {
     }
     /* Success, frame transmit started */
     ctrl->TxCount += frame->length;
+    h->If->Stats->tx_packets++;
+    h->If->Stats->tx_bytes += frame->length;
     eth_unlock (h);
     return (true);
   }
+  h->If->Stats->tx_drop++;
   eth_unlock (h);
   return (false);
 }
@@ -1172,7 +1191,6 @@ void net_eth_iface_run (void) {
   \param[in]   h  ethernet interface handle.
 */
 static void eth_iface_run (NET_ETH_CFG *h) {
-  NET_FRAME *frame;
 
   if (sys->Flags & SYS_FLAG_SEC2) {
     /* Sync timings for ETH thread */
@@ -1204,11 +1222,49 @@ static void eth_iface_run (NET_ETH_CFG *h) {
     }
     ctrl->th.ChangeSt = false;
   }
+  if (h->ThreadRx) {
+    /* Received frames processed in ETH thread */
+    return;
+  }
   /* Check if a frame has been received */
   if (ctrl->q_head == ctrl->q_tail) {
     return;
   }
   sys->Busy = true;
+  eth_process_frame (h);
+}
+
+/**
+  \brief       Process received frames in ethernet interface thread.
+  \param[in]   h  ethernet interface handle.
+  \details     Called from ETH thread!
+*/
+static void eth_thread_rx (NET_ETH_CFG *h) {
+  uint32_t cnt;
+
+  while (ctrl->q_head != ctrl->q_tail) {
+    net_sys_lock ();
+    /* Limit the burst size to allow core thread to run */
+    for (cnt = 0; cnt < ETH_RX_BURST; cnt++) {
+      if (ctrl->q_head == ctrl->q_tail) {
+        break;
+      }
+      eth_process_frame (h);
+      /* Clear link-layer address flags */
+      sys->Flags = 0x00;
+    }
+    net_sys_unlock ();
+  }
+}
+
+/**
+  \brief       Process one frame from ethernet receive queue.
+  \param[in]   h  ethernet interface handle.
+  \note        This function is called from a protected function.
+*/
+static void eth_process_frame (NET_ETH_CFG *h) {
+  NET_FRAME *frame;
+
 #ifdef ACHILLES_TEST
   if (h->IfNum == 0) eth_test.n_proc++;
 #endif
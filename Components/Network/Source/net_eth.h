@@ -14,6 +14,7 @@
 /* ETH Definitions */
 #define ETH_MTU             1500        // Ethernet maximum transmission unit
 #define ETH_QSIZE           32          // Receive queue size (must be 2^n)
+#define ETH_RX_BURST        8           // Max. frames processed in thread per lock
 
 /* ETH Protocol type */
 #define ETH_PROT_ARP        0x0806      // Protocol type ARP, RARP
@@ -8860,7 +8860,8 @@ typedef struct evr_addr {
 #define EvtNetUDP_SetOptionTclass           EventID (EventLevelDetail,EvtNetUDP, 19)
 #define EvtNetUDP_SetOptionHopLimit         EventID (EventLevelDetail,EvtNetUDP, 20)
 #define EvtNetUDP_SetOptionChecksum         EventID (EventLevelDetail,EvtNetUDP, 21)
-#define EvtNetUDP_SetOptionInterface        EventID (EventLevelDetail,EvtNetUDP, 42) // End
+#define EvtNetUDP_SetOptionInterface        EventID (EventLevelDetail,EvtNetUDP, 42)
+#define EvtNetUDP_SetOptionReceiveQueue     EventID (EventLevelDetail,EvtNetUDP, 43)
 #define EvtNetUDP_SetOptionWrongOption      EventID (EventLevelError, EvtNetUDP, 22)
 #define EvtNetUDP_SetOptionWrongValue       EventID (EventLevelError, EvtNetUDP, 23)
 #define EvtNetUDP_GetBufferFailed           EventID (EventLevelError, EvtNetUDP, 24)
@@ -8880,6 +8881,11 @@ typedef struct evr_addr {
 #define EvtNetUDP_FrameNotMapped            EventID (EventLevelOp,    EvtNetUDP, 37)
 #define EvtNetUDP_LinkLayerAddressed        EventID (EventLevelError, EvtNetUDP, 38)
 #define EvtNetUDP_ChecksumFailed            EventID (EventLevelError, EvtNetUDP, 39)
+#define EvtNetUDP_ReceiveQueueAdd           EventID (EventLevelOp,    EvtNetUDP, 44)
+#define EvtNetUDP_ReceiveQueueDump          EventID (EventLevelError, EvtNetUDP, 45)
+#define EvtNetUDP_ReceiveBatch              EventID (EventLevelOp,    EvtNetUDP, 46)
+#define EvtNetUDP_ReceiveBatchNotValid      EventID (EventLevelError, EvtNetUDP, 47)
+#define EvtNetUDP_ReceiveBatchWrongState    EventID (EventLevelError, EvtNetUDP, 48) // End
 #define EvtNetUDP_UninitSockets             EventID (EventLevelOp,    EvtNetUDP, 40)
 #endif
 
@@ -9176,6 +9182,19 @@ typedef struct evr_addr {
   #define EvrNetUDP_SetOptionInterface(socket, if_id)
 #endif
 
+/**
+  \brief  Event on UDP set socket option receive queue size (Detail)
+  \param  socket        socket handle
+  \param  size          max. number of queued datagrams
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_SetOptionReceiveQueue(int32_t socket, uint32_t size) {
+    EventRecord2 (EvtNetUDP_SetOptionReceiveQueue, (uint32_t)socket, size);
+  }
+#else
+  #define EvrNetUDP_SetOptionReceiveQueue(socket, size)
+#endif
+
 /**
   \brief  Event on UDP wrong set socket option (Error)
   \param  socket        socket handle
@@ -9416,6 +9435,70 @@ typedef struct evr_addr {
   #define EvrNetUDP_ChecksumFailed(socket)
 #endif
 
+/**
+  \brief  Event on UDP datagram added to socket receive queue (Op)
+  \param  socket        socket handle
+  \param  length        length of queued data
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_ReceiveQueueAdd(int32_t socket, uint32_t length) {
+    EventRecord2 (EvtNetUDP_ReceiveQueueAdd, (uint32_t)socket, length);
+  }
+#else
+  #define EvrNetUDP_ReceiveQueueAdd(socket, length)
+#endif
+
+/**
+  \brief  Event on UDP datagram dumped, receive queue full or out of memory (Error)
+  \param  socket        socket handle
+  \param  length        length of dumped data
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_ReceiveQueueDump(int32_t socket, uint32_t length) {
+    EventRecord2 (EvtNetUDP_ReceiveQueueDump, (uint32_t)socket, length);
+  }
+#else
+  #define EvrNetUDP_ReceiveQueueDump(socket, length)
+#endif
+
+/**
+  \brief  Event on UDP receive batch of queued datagrams (Op)
+  \param  socket        socket handle
+  \param  num_msg       number of datagrams received
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_ReceiveBatch(int32_t socket, uint32_t num_msg) {
+    EventRecord2 (EvtNetUDP_ReceiveBatch, (uint32_t)socket, num_msg);
+  }
+#else
+  #define EvrNetUDP_ReceiveBatch(socket, num_msg)
+#endif
+
+/**
+  \brief  Event on UDP receive batch failed, invalid parameter (Error)
+  \param  socket        socket handle
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_ReceiveBatchNotValid(int32_t socket) {
+    EventRecord2 (EvtNetUDP_ReceiveBatchNotValid, (uint32_t)socket, 0);
+  }
+#else
+  #define EvrNetUDP_ReceiveBatchNotValid(socket)
+#endif
+
+/**
+  \brief  Event on UDP receive batch failed, socket not open or queue not enabled (Error)
+  \param  socket        socket handle
+  \param  state         socket state
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetUDP_ReceiveBatchWrongState(int32_t socket, uint8_t state) {
+    EventRecord2 (EvtNetUDP_ReceiveBatchWrongState, (uint32_t)socket, state);
+  }
+#else
+  #define EvrNetUDP_ReceiveBatchWrongState(socket, state)
+#endif
+
 /**
   \brief  Event on UDP de-initialize available sockets (Op)
  */
@@ -14758,6 +14841,11 @@ typedef struct evr_addr {
 #define EvtNetFTPc_ClientDone               EventID (EventLevelOp,    EvtNetFTPc, 50)
 #define EvtNetFTPc_CloseLocalFile           EventID (EventLevelOp,    EvtNetFTPc, 51)
 #define EvtNetFTPc_UninitClient             EventID (EventLevelOp,    EvtNetFTPc, 52)
+#define EvtNetFTPc_QueueCommand             EventID (EventLevelAPI,   EvtNetFTPc, 53)
+#define EvtNetFTPc_QueueInvalidParameter    EventID (EventLevelError, EvtNetFTPc, 54)
+#define EvtNetFTPc_QueueWrongState          EventID (EventLevelError, EvtNetFTPc, 55)
+#define EvtNetFTPc_QueueFull                EventID (EventLevelError, EvtNetFTPc, 56)
+#define EvtNetFTPc_CommandDone              EventID (EventLevelOp,    EvtNetFTPc, 57)
 #endif
 
 /**
@@ -15383,6 +15471,66 @@ typedef struct evr_addr {
   #define EvrNetFTPc_UninitClient()
 #endif
 
+/**
+  \brief  Event on \ref netFTPc_Queue (API)
+  \param  command       queued FTP command
+  \param  que_cnt       number of commands already queued
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetFTPc_QueueCommand(uint8_t command, uint32_t que_cnt) {
+    EventRecord2 (EvtNetFTPc_QueueCommand, command, que_cnt);
+  }
+#else
+  #define EvrNetFTPc_QueueCommand(command, que_cnt)
+#endif
+
+/**
+  \brief  Event on \ref netFTPc_Queue invalid parameter (Error)
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetFTPc_QueueInvalidParameter(void) {
+    EventRecord2 (EvtNetFTPc_QueueInvalidParameter, 0, 0);
+  }
+#else
+  #define EvrNetFTPc_QueueInvalidParameter()
+#endif
+
+/**
+  \brief  Event on \ref netFTPc_Queue failed, session not active (Error)
+  \param  state         FTP client state
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetFTPc_QueueWrongState(uint8_t state) {
+    EventRecord2 (EvtNetFTPc_QueueWrongState, state, 0);
+  }
+#else
+  #define EvrNetFTPc_QueueWrongState(state)
+#endif
+
+/**
+  \brief  Event on \ref netFTPc_Queue failed, command queue full (Error)
+  \param  que_size      size of command queue
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetFTPc_QueueFull(uint32_t que_size) {
+    EventRecord2 (EvtNetFTPc_QueueFull, que_size, 0);
+  }
+#else
+  #define EvrNetFTPc_QueueFull(que_size)
+#endif
+
+/**
+  \brief  Event on FTP client command done, start next queued command (Op)
+  \param  cb_event      user callback event for completed command
+ */
+#ifdef Network_Debug_EVR
+  __STATIC_INLINE void EvrNetFTPc_CommandDone(uint8_t cb_event) {
+    EventRecord2 (EvtNetFTPc_CommandDone, cb_event, 0);
+  }
+#else
+  #define EvrNetFTPc_CommandDone(cb_event)
+#endif
+
 
 // NetTeln event identifiers ---------------------------------------------------
 #ifdef Network_Debug_EVR
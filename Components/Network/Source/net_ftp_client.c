@@ -29,6 +29,8 @@ static netStatus ftpc_dopen_req (void);
 static uint16_t ftpc_scan_dport (const char *buf);
 static void ftpc_close_file (void);
 static void ftpc_transit (uint8_t state);
+static void ftpc_exec_cmd (void);
+static void ftpc_next_cmd (void);
 static void ftpc_stop (netFTPc_Event event);
 static bool ftpc_proc_resp (const char *buf, const char *end);
 static uint8_t get_resp (const char *buf);
@@ -114,12 +116,50 @@ netStatus netFTPc_Connect (const NET_ADDR *addr, netFTP_Command command) {
   ftpc_s->File     = NULL;
   ftpc_s->cb_event = netFTPc_EventSuccess;
   ftpc_s->Flags    = ftpc->PasvMode ? FTPC_FLAG_PASSIVE : 0;
+  ftpc_s->QueCnt   = 0;
   ftpc_transit (FTPC_STATE_CONNRQ);
   RETURN (netOK);
 
   END_LOCK;
 }
 
+/**
+  \brief       Queue a file operation for running FTP client session.
+  \param[in]   command  file command to perform as defined with netFTP_Command.
+  \return      status code as defined with netStatus.
+*/
+netStatus netFTPc_Queue (netFTP_Command command) {
+
+  START_LOCK (netStatus);
+
+  DEBUGF (FTPC,"Queue %s command\n",cmd_ascii(command));
+  EvrNetFTPc_QueueCommand (command, ftpc_s->QueCnt);
+  if ((uint32_t)command > netFTP_CommandNLIST) {
+    ERRORF (FTPC,"Queue, Invalid parameter\n");
+    EvrNetFTPc_QueueInvalidParameter ();
+    RETURN (netInvalidParameter);
+  }
+  switch (ftpc_s->State) {
+    case FTPC_STATE_IDLE:
+    case FTPC_STATE_QUIT:
+    case FTPC_STATE_STOP:
+    case FTPC_STATE_TWAIT:
+      /* Session not started or already closing */
+      ERRORF (FTPC,"Queue, Wrong client state\n");
+      EvrNetFTPc_QueueWrongState (ftpc_s->State);
+      RETURN (netWrongState);
+  }
+  if (ftpc_s->QueCnt >= FTPC_QUE_SIZE) {
+    ERRORF (FTPC,"Queue, Queue full\n");
+    EvrNetFTPc_QueueFull (FTPC_QUE_SIZE);
+    RETURN (netBusy);
+  }
+  ftpc_s->CmdQue[ftpc_s->QueCnt++] = command & 0xFF;
+  RETURN (netOK);
+
+  END_LOCK;
+}
+
 /**
   \brief       Socket event callback notification.
   \param[in]   socket  socket handle.
@@ -247,30 +287,7 @@ loggedin: DEBUGF (FTPC," User logged in\n");
           }
           DEBUGF (FTPC," Working directory set\n");
           /* Execute a user command now */
-          DEBUGF (FTPC,"Executing %s command\n",cmd_ascii(ftpc_s->Command));
-          EvrNetFTPc_ExecuteUserCommand (ftpc_s->Command);
-          switch (ftpc_s->Command) {
-            case netFTP_CommandPUT:
-            case netFTP_CommandGET:
-            case netFTP_CommandAPPEND:
-              ftpc_transit (FTPC_STATE_TYPE_I);
-              break;
-            case netFTP_CommandLIST:
-            case netFTP_CommandNLIST: 
-              goto dopen;
-            case netFTP_CommandDELETE:
-              ftpc_transit (FTPC_STATE_DELE);
-              break;
-            case netFTP_CommandRENAME:
-              ftpc_transit (FTPC_STATE_RNFR);
-              break;
-            case netFTP_CommandMKDIR:
-              ftpc_transit (FTPC_STATE_MKD);
-              break;
-            case netFTP_CommandRMDIR:
-              ftpc_transit (FTPC_STATE_RMD);
-              break;
-          }
+          ftpc_exec_cmd ();
           return (true);
 
         case FTPC_STATE_TYPE_I:
@@ -280,7 +297,7 @@ loggedin: DEBUGF (FTPC," User logged in\n");
           }
           DEBUGF (FTPC," Binary mode enabled\n");
           EvrNetFTPc_BinaryModeEnabled ();
-dopen:    ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
+          ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
                         FTPC_STATE_XPASV : FTPC_STATE_XPORT);
           return (true);
 
@@ -334,7 +351,7 @@ dopen:    ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
             }
             net_tcp_close (ftpc_s->DSocket);
             ftpc_close_file ();
-            ftpc_transit (FTPC_STATE_QUIT);
+            ftpc_next_cmd ();
             return (true);
           }
           if (ftpc_s->Resp == FTPC_RESP_FSTATOK) {
@@ -415,7 +432,7 @@ dopen:    ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
           }
           DEBUGF (FTPC," File deleted\n");
           EvrNetFTPc_FileDeleted ();
-          ftpc_transit (FTPC_STATE_QUIT);
+          ftpc_next_cmd ();
           return (true);
 
         case FTPC_STATE_RNFR:
@@ -441,7 +458,7 @@ dopen:    ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
           }
           DEBUGF (FTPC," File/directory renamed\n");
           EvrNetFTPc_FileOrDirectoryRenamed ();
-          ftpc_transit (FTPC_STATE_QUIT);
+          ftpc_next_cmd ();
           return (true);
 
         case FTPC_STATE_MKD:
@@ -454,7 +471,7 @@ dopen:    ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
           }
           DEBUGF (FTPC," Directory created\n");
           EvrNetFTPc_DirectoryCreated ();
-          ftpc_transit (FTPC_STATE_QUIT);
+          ftpc_next_cmd ();
           return (true);
 
         case FTPC_STATE_RMD:
@@ -470,7 +487,7 @@ noaccess:   if (is_not_found ((const char *)buf, (int32_t)len)) {
               EvrNetFTPc_OperationNotAllowed ();
               ftpc_s->cb_event = netFTPc_EventAccessDenied;
             }
-            ftpc_transit (FTPC_STATE_QUIT);
+            ftpc_next_cmd ();
             return (true);
           }
           if (ftpc_s->Resp != FTPC_RESP_FCMDOK) {
@@ -478,7 +495,7 @@ noaccess:   if (is_not_found ((const char *)buf, (int32_t)len)) {
           }
           DEBUGF (FTPC," Directory removed\n");
           EvrNetFTPc_DirectoryRemoved ();
-          ftpc_transit (FTPC_STATE_QUIT);
+          ftpc_next_cmd ();
           return (true);
 
         case FTPC_STATE_QUIT:
@@ -760,7 +777,7 @@ void net_ftp_client_run (void) {
             EvrNetFTPc_LocalFileNotFound ();
           }
           ftpc_s->cb_event = netFTPc_EventLocalFileError;
-          ftpc_transit (FTPC_STATE_QUIT);
+          ftpc_next_cmd ();
           break;
         }
       }
@@ -769,6 +786,20 @@ void net_ftp_client_run (void) {
 
     case FTPC_STATE_CMDSEND:
       /* Send a command to server and open data connection */
+      switch (net_tcp_get_state (ftpc_s->DSocket)) {
+        case netTCP_StateCLOSED:
+          break;
+        case netTCP_StateTIME_WAIT:
+          /* Both FINs acknowledged, data connection is complete. A new */
+          /* data port is used for the next transfer, no need to wait 2MSL */
+          net_tcp_abort (ftpc_s->DSocket);
+          break;
+        default:
+          /* Wait, previous data connection still closing */
+          return;
+      }
+      ftpc_s->Flags &= ~(FTPC_FLAG_DACK | FTPC_FLAG_DOPEN | FTPC_FLAG_DCLOSED |
+                         FTPC_FLAG_CDONE | FTPC_FLAG_ABORT);
       if (ftpc_dopen_req () != netOK) {
         /* Failed to open a data connection */
         ERRORF (FTPC,"Open data connection failed\n");
@@ -821,7 +852,14 @@ get_mask: cblen = netFTPc_Process (netFTPc_RequestListMask, (char *)sendbuf+len,
       sendbuf = NULL;
       if (net_mem_avail_tx()) {
         max_dsize = net_tcp_get_mss (ftpc_s->DSocket);
-        sendbuf   = net_tcp_get_buf (max_dsize | 0x80000000);
+        /* Try to send several segments at once to fill the window */
+        sendbuf   = net_tcp_get_buf ((max_dsize * FTPC_SEND_SEGS) | 0x80000000);
+        if (sendbuf != NULL) {
+          max_dsize *= FTPC_SEND_SEGS;
+        }
+        else {
+          sendbuf = net_tcp_get_buf (max_dsize | 0x80000000);
+        }
       }
       if (sendbuf == NULL) {
         /* Wait, no memory available */
@@ -857,9 +895,9 @@ get_mask: cblen = netFTPc_Process (netFTPc_RequestListMask, (char *)sendbuf+len,
       /* Store or append command finished */
       if ((ftpc_s->Flags & FTPC_FLAG_CDONE) && 
           (ftpc_s->Flags & FTPC_FLAG_DCLOSED)) {
-        /* Response received and data socket closed, send QUIT */
+        /* Response received and data socket closed, next command */
         ftpc_close_file ();
-        ftpc_transit (FTPC_STATE_QUIT);
+        ftpc_next_cmd ();
       }
       break;
 
@@ -903,8 +941,21 @@ get_mask: cblen = netFTPc_Process (netFTPc_RequestListMask, (char *)sendbuf+len,
       len    += no_path ((char *)sendbuf+len, (int32_t)cblen);
       goto cr_send;
 
+    case FTPC_STATE_NEXT:
+      /* Notify the user and start next queued command */
+      DEBUGF (FTPC,"Command done, event %s\n",evt_ascii(ftpc_s->cb_event));
+      EvrNetFTPc_CommandDone (ftpc_s->cb_event);
+      netFTPc_Notify (ftpc_s->cb_event);
+      ftpc_s->Command  = (netFTP_Command)ftpc_s->CmdQue[0];
+      ftpc_s->QueCnt--;
+      memmove (&ftpc_s->CmdQue[0], &ftpc_s->CmdQue[1], ftpc_s->QueCnt);
+      ftpc_s->cb_event = netFTPc_EventSuccess;
+      ftpc_exec_cmd ();
+      break;
+
     case FTPC_STATE_QUIT:
-      /* Send QUIT command */
+      /* Send QUIT command, discard queued commands */
+      ftpc_s->QueCnt = 0;
       sendbuf = net_tcp_get_buf (10);
       len     = net_strcpy ((char *)sendbuf, "QUIT");
 cr_send:
@@ -1014,6 +1065,46 @@ static void ftpc_transit (uint8_t state) {
   sys->Busy     = true;
 }
 
+/**
+  \brief       Execute current user command.
+*/
+static void ftpc_exec_cmd (void) {
+  DEBUGF (FTPC,"Executing %s command\n",cmd_ascii(ftpc_s->Command));
+  EvrNetFTPc_ExecuteUserCommand (ftpc_s->Command);
+  switch (ftpc_s->Command) {
+    case netFTP_CommandPUT:
+    case netFTP_CommandGET:
+    case netFTP_CommandAPPEND:
+      ftpc_transit (FTPC_STATE_TYPE_I);
+      break;
+    case netFTP_CommandLIST:
+    case netFTP_CommandNLIST:
+      ftpc_transit ((ftpc_s->Flags & FTPC_FLAG_PASSIVE) ?
+                    FTPC_STATE_XPASV : FTPC_STATE_XPORT);
+      break;
+    case netFTP_CommandDELETE:
+      ftpc_transit (FTPC_STATE_DELE);
+      break;
+    case netFTP_CommandRENAME:
+      ftpc_transit (FTPC_STATE_RNFR);
+      break;
+    case netFTP_CommandMKDIR:
+      ftpc_transit (FTPC_STATE_MKD);
+      break;
+    case netFTP_CommandRMDIR:
+      ftpc_transit (FTPC_STATE_RMD);
+      break;
+  }
+}
+
+/**
+  \brief       Complete current command, continue with queued commands.
+  \note        The control connection is closed when the queue is empty.
+*/
+static void ftpc_next_cmd (void) {
+  ftpc_transit ((ftpc_s->QueCnt != 0) ? FTPC_STATE_NEXT : FTPC_STATE_QUIT);
+}
+
 /**
   \brief       Stop FTP client.
   \param[in]   event  user notification event.
@@ -1026,6 +1117,7 @@ static void ftpc_stop (netFTPc_Event event) {
       break;
     default:
       ftpc_s->cb_event = event;
+      ftpc_s->QueCnt = 0;
       ftpc_s->Flags &= ~FTPC_FLAG_RESP;
       ftpc_s->Timer  = 0;
       ftpc_s->State  = FTPC_STATE_STOP;
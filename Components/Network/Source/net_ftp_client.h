@@ -13,6 +13,8 @@
 
 #define FTPC_SERVER_PORT    21          // FTP Server standard port
 #define FTPC_MAX_PATH       120         // Max. Path size
+#define FTPC_QUE_SIZE       8           // Command queue size
+#define FTPC_SEND_SEGS      4           // Max. number of TCP segments per data send
 
 /* FTP Client States */
 #define FTPC_STATE_IDLE     0           // FTP Client is idle
@@ -38,6 +40,7 @@
 #define FTPC_STATE_QUIT     20          // Send QUIT command
 #define FTPC_STATE_STOP     21          // Stop FTP Client, close local file
 #define FTPC_STATE_TWAIT    22          // Wait for sockets to be closed
+#define FTPC_STATE_NEXT     23          // Start next queued command
 
 /* FTP Client Flags */
 #define FTPC_FLAG_RESP      0x01        // Wait for FTP Server response
@@ -82,6 +85,8 @@ typedef struct net_ftpc_info {
   uint8_t  Resp;                        // Response received
   netFTPc_Event cb_event;               // Return value for callback
   void     *File;                       // File handle pointer
+  uint8_t  QueCnt;                      // Number of queued commands
+  uint8_t  CmdQue[FTPC_QUE_SIZE];       // Queued commands
 } NET_FTPC_INFO;
 
 /* Variables */
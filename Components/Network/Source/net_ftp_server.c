@@ -31,6 +31,7 @@ static uint32_t ftp_data_cb  (int32_t socket, netTCP_Event event, const NET_ADDR
                                               const uint8_t *buf, uint32_t len);
 static void ftp_parse_cmd (const char *name);
 static netStatus ftp_dopen_req (NET_FTP_INFO *ftp_s);
+static uint8_t *ftp_get_dbuf (NET_FTP_INFO *ftp_s, uint32_t *max_dsize);
 static NET_FTP_INFO *ftp_map_session (int32_t socket);
 static void ftp_kill_session (NET_FTP_INFO *ftp_s);
 static bool parse_port_param (NET_FTP_INFO *ftp_s, char *buf, uint8_t type);
@@ -1290,11 +1291,7 @@ static void ftp_server_run (void) {
         }
 
         /* Allocate transmit frame buffer */
-        sendbuf = NULL;
-        if (net_mem_avail_tx()) {
-          max_dsize = net_tcp_get_mss (ftp_s->DSocket);
-          sendbuf   = net_tcp_get_buf (max_dsize | 0x80000000);
-        }
+        sendbuf = ftp_get_dbuf (ftp_s, &max_dsize);
         if (sendbuf == NULL) {
           /* Wait, no memory available */
           break;
@@ -1358,11 +1355,7 @@ static void ftp_server_run (void) {
         }
 
         /* Allocate transmit frame buffer */
-        sendbuf = NULL;
-        if (net_mem_avail_tx()) {
-          max_dsize = net_tcp_get_mss (ftp_s->DSocket);
-          sendbuf   = net_tcp_get_buf (max_dsize | 0x80000000);
-        }
+        sendbuf = ftp_get_dbuf (ftp_s, &max_dsize);
         if (sendbuf == NULL) {
           /* Wait, no memory available */
           break;
@@ -1576,6 +1569,30 @@ static netStatus ftp_dopen_req (NET_FTP_INFO *ftp_s) {
   return (netOK);
 }
 
+/**
+  \brief       Allocate transmit buffer for FTP data connection.
+  \param[in]   ftp_s      session descriptor.
+  \param[out]  max_dsize  size of allocated buffer.
+  \return      pointer to allocated buffer or NULL if out of memory.
+  \note        Several segments are sent in one go when memory allows.
+*/
+static uint8_t *ftp_get_dbuf (NET_FTP_INFO *ftp_s, uint32_t *max_dsize) {
+  uint8_t *buf;
+  uint32_t mss;
+
+  if (!net_mem_avail_tx()) {
+    return (NULL);
+  }
+  mss = net_tcp_get_mss (ftp_s->DSocket);
+  buf = net_tcp_get_buf ((mss * FTP_SEND_SEGS) | 0x80000000);
+  if (buf != NULL) {
+    *max_dsize = mss * FTP_SEND_SEGS;
+    return (buf);
+  }
+  *max_dsize = mss;
+  return (net_tcp_get_buf (mss | 0x80000000));
+}
+
 /**
   \brief       Kill active FTP server session.
   \param[in]   ftp_s  session descriptor.
@@ -14,6 +14,7 @@
 #define FTP_SERVER_PORT     21          // FTP Server standard port
 #define FTP_DEF_DPORT       20          // Default FTP data port
 #define FTP_MAX_PATH        120         // Max. Path size
+#define FTP_SEND_SEGS       4           // Max. number of TCP segments per data send
 
 /* FTP States */
 #define FTP_STATE_IDLE      0           // FTP Server is idle
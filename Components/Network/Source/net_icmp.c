@@ -80,6 +80,7 @@ bool net_icmp_process (NET_IF_CFG *net_if, NET_FRAME *frame) {
   if (frame->length < ICMP_HEADER_LEN) {
     ERRORF (ICMP,"Process %s, Frame too short\n",net_if->Name);
     EvrNetICMP_FrameTooShort (net_if->Id, frame->length, ICMP_HEADER_LEN);
+    net_sys_stats.icmp_errors++;
     return (false);
   }
   /* Check checksum for received frame */
@@ -87,6 +88,7 @@ bool net_icmp_process (NET_IF_CFG *net_if, NET_FRAME *frame) {
        net_ip4_chksum_buf (ICMP_FRAME(frame), frame->length) != 0) {
     ERRORF (ICMP,"Process %s, Checksum failed\n",net_if->Name);
     EvrNetICMP_ChecksumFailed (net_if->Id, frame->length);
+    net_sys_stats.icmp_errors++;
     return (false);
   }
   DEBUG_INFO (frame);
@@ -87,6 +87,7 @@ bool net_icmp6_process (NET_IF_CFG *net_if, NET_FRAME *frame) {
   if (frame->length < ICMP_HEADER_LEN) {
     ERRORF (ICMP6,"Process %s, Frame too short\n",net_if->Name);
     EvrNetICMP6_FrameTooShort (net_if->Id, frame->length, ICMP_HEADER_LEN);
+    net_sys_stats.icmp6_errors++;
     return (false);
   }
 
@@ -96,6 +97,7 @@ bool net_icmp6_process (NET_IF_CFG *net_if, NET_FRAME *frame) {
                        ICMP6_FRAME(frame), IP6_PROT_ICMP, frame->length) != 0) {
     ERRORF (ICMP6,"Process %s, Checksum failed\n",net_if->Name);
     EvrNetICMP6_ChecksumFailed (net_if->Id, frame->length);
+    net_sys_stats.icmp6_errors++;
     return (false);
   }
 
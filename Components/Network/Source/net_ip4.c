@@ -79,12 +79,14 @@ bool net_ip4_chk_frame (NET_IF_CFG *net_if, NET_FRAME *frame) {
     /* Frame too short, at least 1 byte of IP-payload is required */
     ERRORF (IP4,"Process %s, Frame too short\n",net_if->Name);
     EvrNetIP4_FrameTooShort (net_if->Id, frame->length, (PHY_HEADER_LEN + dlen));
+    net_sys_stats.ip4_errors++;
     return (false);
   }
   /* Check IP Header Information if it is IPv4 */
   if ((IP4_FRAME(frame)->VerHLen >> 4) != 4) {
     ERRORF (IP4,"Process %s, Not IPv4\n",net_if->Name);
     EvrNetIP4_InvalidIpVersion (net_if->Id, IP4_FRAME(frame)->VerHLen >> 4);
+    net_sys_stats.ip4_errors++;
     return (false);
   }
 
@@ -115,6 +117,7 @@ bool net_ip4_chk_frame (NET_IF_CFG *net_if, NET_FRAME *frame) {
       ip4_is_subcast (net_if, IP4_FRAME(frame)->SrcAddr)) {
     ERRORF (IP4,"Process %s, SrcAddr invalid\n",net_if->Name);
     EvrNetIP4_SourceIpAddressInvalid (net_if->Id, IP4_FRAME(frame)->SrcAddr);
+    net_sys_stats.ip4_errors++;
     return (false);
   }
 
@@ -182,6 +185,7 @@ dst_valid:
        (ip4_get_chksum (IP4_FRAME(frame)) != 0)) {
     ERRORF (IP4,"Process %s, Checksum failed\n",net_if->Name);
     EvrNetIP4_ChecksumFailed (net_if->Id, (IP4_FRAME(frame)->VerHLen & 0x0F) * 4);
+    net_sys_stats.ip4_errors++;
     return (false);
   }
 
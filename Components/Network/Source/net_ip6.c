@@ -87,12 +87,14 @@ bool net_ip6_chk_frame (NET_IF_CFG *net_if, NET_FRAME *frame) {
     ERRORF (IP6,"Process %s, Frame too short\n",net_if->Name);
     EvrNetIP6_FrameTooShort (net_if->Id, frame->length,
                              (PHY_HEADER_LEN + IP6_HEADER_LEN + ip_len));
+    net_sys_stats.ip6_errors++;
     return (false);
   }
   /* Check IP Header Information */
   if ((IP6_FRAME(frame)->VerClass >> 4) != 6) {
     ERRORF (IP6,"Process %s, Not IPv6\n",net_if->Name);
     EvrNetIP6_InvalidIpVersion (net_if->Id, IP6_FRAME(frame)->VerClass >> 4);
+    net_sys_stats.ip6_errors++;
     return (false);
   }
   DEBUG_INFO (IP6_FRAME(frame));
@@ -219,6 +219,11 @@ typedef struct net_udp_info {
   uint8_t  HopLimit;                    ///< Multicast hop limit for IPv6
   const struct net_if_cfg *net_if;      ///< Bound network interface
   netUDP_cb_t cb_func;                  ///< Event callback function
+  NET_BUFFER *rx_list;                  ///< Receive queue buffer list
+  NETOS_ID Thread;                      ///< Receive queue owner thread
+  uint8_t  HashNext;                    ///< Next socket in port hash chain
+  uint8_t  RxQueMax;                    ///< Receive queue size (0=callback mode)
+  uint8_t  RxQueCnt;                    ///< Number of queued datagrams
 } NET_UDP_INFO;
 
 /// TCP Socket info
@@ -241,6 +246,7 @@ typedef struct net_tcp_info {
   uint8_t  DupAcks;                     ///< Number of duplicate acks (fast recovery)
   uint32_t SendUna;                     ///< Send sequence number unacknowledged
   uint32_t SendNext;                    ///< Next send sequence number
+  uint32_t SendMax;                     ///< Next sequence number not sent yet (large send)
   uint32_t SendChk;                     ///< Check sequence number for dupacks
   uint32_t SendWl1;                     ///< Sequence number of last window update
   uint32_t SendWl2;                     ///< Acknowledge number of last window update
@@ -560,6 +566,7 @@ typedef struct net_if_cfg {
     uint32_t,NET_FRAME*,uint8_t);
   bool (*output_lan)(                   ///< Low level output for LAN (Eth, WiFi)
     uint32_t,NET_FRAME*);
+  NET_IF_STATS *Stats;                  ///< Interface statistics
 } const NET_IF_CFG;
 
 /// Ethernet Interface descriptor
@@ -572,6 +579,7 @@ typedef struct net_eth_cfg {
   const char  *MacCfg;                  ///< Configured MAC address
   uint16_t     VlanTag;                 ///< Vlan tag identifier
   uint8_t      IfNum;                   ///< Interface number (0,1)
+  uint8_t      ThreadRx;                ///< Process received frames in interface thread
   void (*cb_event)(uint32_t);           ///< Driver event notification callback
 } const NET_ETH_CFG;
 
@@ -984,6 +992,15 @@ extern void netos_flag_set (NETOS_ID thread, uint32_t flag);
 /// \param[in]     flag          event flag to wait for.
 extern void netos_flag_clear (NETOS_ID thread, uint32_t flag);
 
+/// \brief Get high-resolution system timer count.
+/// \return      system timer count.
+extern uint32_t netos_time_get (void);
+
+/// \brief Convert system timer count to microseconds.
+/// \param[in]     ticks         system timer count interval.
+/// \return      time interval in microseconds.
+extern uint32_t netos_time_us (uint32_t ticks);
+
 /// \brief Create network interface thread and protection semaphore.
 /// \param[in]     if_id         Network interface identification.
 /// \param[out]    semaphore     pointer to semaphore identifier.
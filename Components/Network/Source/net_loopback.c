@@ -38,6 +38,7 @@ NET_IF_CFG net_loop_if_config = {
   NULL,
   NULL,
   net_loop_send_frame,
+  NULL,
   NULL
 };
 
@@ -34,6 +34,10 @@ void net_mem_init (void) {
   init_ptr->len  = 0;
   mem->load      = 0;
   mem->count     = 0;
+  mem->max_load  = 0;
+  mem->max_count = 0;
+  mem->err_limit = 0;
+  mem->err_alloc = 0;
   mem->mutex     = netos_mutex_create (1);
   if (mem->mutex == NULL) {
     ERRORF (MEM,"Init, Mutex create failed\n");
@@ -99,6 +103,7 @@ NET_FRAME *net_mem_alloc (uint32_t byte_size) {
     if ((mem->load + req_size) > mem->limit[0]) {
       DEBUGF (MEM," Failed, limit_0 exceeded\n");
       EvrNetMEM_AllocLimitExceeded (req_size, mem->load, mem->count);
+      mem->err_limit++;
       mem_unlock ();
       return (NULL);
     }
@@ -118,6 +123,7 @@ NET_FRAME *net_mem_alloc (uint32_t byte_size) {
       /* Failed, we are at the end of the list */
       ERRORF (MEM,"Alloc, No memory (used=%d, blocks=%d)\n",mem->load,mem->count);
       EvrNetMEM_AllocOutOfMemory (req_size, mem->load, mem->count);
+      mem->err_alloc++;
       mem_unlock ();
       /* Check if the ErrorHandler call was prevented (Ethernet, BSD socket) */
       if (!(byte_size & 0xC0000000)) {
@@ -142,6 +148,12 @@ NET_FRAME *net_mem_alloc (uint32_t byte_size) {
   }
   mem->load += req_size;
   mem->count++;
+  if (mem->load > mem->max_load) {
+    mem->max_load = mem->load;
+  }
+  if (mem->count > mem->max_count) {
+    mem->max_count = mem->count;
+  }
   DEBUGF (MEM," 0x%X (used=%d, blocks=%d)\n",(uint32_t)__MEMP(frame),mem->load,mem->count);
   EvrNetMEM_AllocMemory (__MEMP(frame), req_size, mem->load, mem->count);
 
@@ -257,6 +269,20 @@ bool net_mem_avail (int32_t level) {
   return (false);
 }
 
+/**
+  \brief       Retrieve memory pool statistics.
+  \param[out]  stats  pointer to system statistics structure.
+*/
+void net_mem_get_stats (NET_SYS_STATS *stats) {
+  mem_lock ();
+  stats->mem_used       = mem->load;
+  stats->mem_used_max   = mem->max_load;
+  stats->mem_blocks_max = mem->max_count;
+  stats->mem_limit_fail = mem->err_limit;
+  stats->mem_alloc_fail = mem->err_alloc;
+  mem_unlock ();
+}
+
 /**
   \brief       Acquire memory protection mutex.
 */
@@ -26,6 +26,10 @@ typedef struct net_mem_ctrl {
   uint32_t limit[2];                    // Limits for non critical allocations
   NETOS_ID mutex;                       // Memory manager lock mutex
   uint32_t count;                       // Number of allocated blocks
+  uint32_t max_load;                    // Memory pool load high-water mark
+  uint32_t max_count;                   // Allocated blocks high-water mark
+  uint32_t err_limit;                   // Allocations refused at limit_0
+  uint32_t err_alloc;                   // Allocations failed, out of memory
 } NET_MEM_CTRL;
 
 #define __MEMP(frame)       ((NET_MEMP *)((uint32_t)(frame) - MEM_HEADER_LEN))
@@ -37,6 +41,7 @@ extern NET_FRAME *net_mem_alloc (uint32_t byte_size);
 extern void       net_mem_shrink (NET_FRAME *mem_ptr, uint32_t new_size);
 extern void       net_mem_free (NET_FRAME *mem_ptr);
 extern bool       net_mem_avail (int32_t level);
+extern void       net_mem_get_stats (NET_SYS_STATS *stats);
 #define net_mem_avail_rx()  net_mem_avail(0)
 #define net_mem_avail_tx()  net_mem_avail(1)
 
@@ -467,6 +467,8 @@ static void ppp_receive (NET_PPP_CFG *h) {
         net_mem_shrink (ctrl->th.Frame, ctrl->th.Frame->index + 2);
         ctrl->th.Frame->length = ctrl->th.Frame->index;
         ctrl->RxCount += ctrl->th.Frame->length;
+        h->If->Stats->rx_packets++;
+        h->If->Stats->rx_bytes += ctrl->th.Frame->length;
         que_add_tail (&ctrl->rx_list, ctrl->th.Frame);
         ctrl->th.Frame = NULL;
         net_sys_wakeup ();
@@ -514,6 +516,7 @@ static void ppp_transmit (NET_PPP_CFG *h) {
   frame = ctrl->tx_list;
   if ((ctrl->th.Flags & PPP_TFLAG_ONLINE) == 0) {
     /* When modem is offline, discard TX frames */
+    h->If->Stats->tx_drop++;
     goto exit;
   }
   /* Short osDelay while transmitting */
@@ -541,6 +544,8 @@ flag: ch = PPP_CH_FLAG;
     if (idx == (PPP_FCS_OFFS+3)) {
       net_com_flush_buf (h->ComCfg);
       ctrl->TxCount += frame->length;
+      h->If->Stats->tx_packets++;
+      h->If->Stats->tx_bytes += frame->length;
       /* Remove frame from top of the list */
 exit: que_get_first (&ctrl->tx_list);
       net_mem_free (frame);
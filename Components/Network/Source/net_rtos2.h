@@ -259,6 +259,7 @@ static const osThreadAttr_t slip0_thread_attr = {
 #endif
 
 static uint32_t k_mul;
+static uint32_t us_freq;
 
 /* Convert timeout to system ticks */
 static uint32_t ms2tick (uint32_t ms) {
@@ -276,7 +277,11 @@ static uint32_t ms2tick (uint32_t ms) {
 
 /* Initialize OS abstraction layer */
 void netos_init (void) {
-  k_mul = (osKernelGetTickFreq () << 10) / 1000;
+  k_mul  = (osKernelGetTickFreq () << 10) / 1000;
+  us_freq = osKernelGetSysTimerFreq ();
+  if (us_freq == 0) {
+    us_freq = 1;
+  }
 }
 
 /* Create network core thread */
@@ -353,6 +358,16 @@ void netos_flag_clear (NETOS_ID thread, uint32_t flag) {
   osThreadFlagsClear (flag);
 }
 
+/* Get high-resolution system timer count */
+uint32_t netos_time_get (void) {
+  return (osKernelGetSysTimerCount ());
+}
+
+/* Convert system timer count to microseconds */
+uint32_t netos_time_us (uint32_t ticks) {
+  return ((uint32_t)(((uint64_t)ticks * 1000000) / us_freq));
+}
+
 /* Delay thread execution */
 void netos_delay (uint32_t ms) {
   osDelay (ms2tick(ms));
@@ -444,6 +444,8 @@ static void slip_receive (NET_SLIP_CFG *h) {
         /* Resize the frame and store it to rx queue */
         net_mem_shrink (ctrl->th.Frame, ctrl->th.Frame->index);
         ctrl->RxCount += ctrl->th.Frame->length;
+        h->If->Stats->rx_packets++;
+        h->If->Stats->rx_bytes += ctrl->th.Frame->length;
         que_add_tail (&ctrl->rx_list, ctrl->th.Frame);
         ctrl->th.Frame = NULL;
         net_sys_wakeup ();
@@ -491,6 +493,7 @@ static void slip_transmit (NET_SLIP_CFG *h) {
   frame = ctrl->tx_list;
   if ((ctrl->th.Flags & SLIP_TFLAG_ONLINE) == 0) {
     /* When modem is offline, discard TX frames */
+    h->If->Stats->tx_drop++;
     goto exit;
   }
   /* Short osDelay while transmitting */
@@ -518,6 +521,8 @@ flag: ch = SLIP_CH_END;
     if (idx == 1) {
       net_com_flush_buf (h->ComCfg);
       ctrl->TxCount += frame->length;
+      h->If->Stats->tx_packets++;
+      h->If->Stats->tx_bytes += frame->length;
       /* Remove frame from top of the list */
 exit: que_get_first (&ctrl->tx_list);
       net_mem_free (frame);
@@ -20,6 +20,7 @@
 
 /* Global variables */
 NET_SYS_CTRL net_sys_control;
+NET_SYS_STATS net_sys_stats;
 #ifdef Network_Debug_EVR
  uint32_t net_dbg_buf[9];
 #endif
@@ -37,6 +38,7 @@ static struct {
 
 /* Local functions */
 static void sys_proc_tick (void);
+static void sys_upd_hist (uint32_t ticks);
 static NET_IF_CFG *sys_map_if (uint32_t if_id, NET_IF_CFG *const *if_list);
 #ifdef Network_Debug_STDIO
  static const char *opt_ascii (netIF_Option opt);
@@ -48,6 +50,7 @@ static NET_IF_CFG *sys_map_if (uint32_t if_id, NET_IF_CFG *const *if_list);
 */
 netStatus netInitialize (void) {
   const net_sys_fn_t *fn_init;
+  NET_IF_CFG *const *p;
 
   /* Init OS layer */
   netos_init ();
@@ -70,6 +73,14 @@ netStatus netInitialize (void) {
   net_mem_init ();
   memset (sys, 0, sizeof (*sys));
 
+  /* Clear statistics counters */
+  memset (&net_sys_stats, 0, sizeof (net_sys_stats));
+  for (p = net_if_list_all; *p; p++) {
+    if ((*p)->Stats != NULL) {
+      memset ((*p)->Stats, 0, sizeof (NET_IF_STATS));
+    }
+  }
+
   sys->RndState = net_lib_version;
   sys->HostName = sysc->HostName;
   sys->Ticks    = 1;
@@ -150,6 +161,7 @@ netStatus netUninitialize (void) {
 */
 __NO_RETURN void netCore_Thread (void *arg) {
   const net_sys_fn_t *fn_run;
+  uint32_t t_start,t_loop;
   (void)arg;
 
   /* Wait until netInitialize complete and start tick timer */
@@ -161,17 +173,22 @@ __NO_RETURN void netCore_Thread (void *arg) {
   while (1) {
     netos_flag_wait (0x0001, NETOS_WAIT_FOREVER);
     while (1) {
+      /* System flags are modified only when locked, because */
+      /* interface threads may also process received frames  */
+      net_sys_lock ();
+      t_start = netos_time_get ();
       sys_proc_tick ();
       /* Clear signal for USB Host workaround */
       netos_flag_clear (os_id.thread, 0x0001);
-      net_sys_lock ();
       /* Run network protocols and interfaces */
       for (fn_run = sysc->fn_run; *fn_run != NULL; fn_run++) {
         /* Call "fn_run()" functions from the table */
         (*fn_run)();
       }
-      net_sys_unlock ();
       sys->Flags = 0x00;
+      t_loop = netos_time_get () - t_start;
+      net_sys_unlock ();
+      sys_upd_hist (t_loop);
       if (!sys->Busy) {
         /* Wait for next wakeup event */
         break;
@@ -181,6 +198,21 @@ __NO_RETURN void netCore_Thread (void *arg) {
   }
 }
 
+/**
+  \brief       Update Network Core loop time histogram.
+  \param[in]   ticks  loop execution time in system timer ticks.
+  \note        Bin limits are powers of 4: 16us, 64us, 256us, ... 64ms.
+*/
+static void sys_upd_hist (uint32_t ticks) {
+  uint32_t i,val;
+
+  val = netos_time_us (ticks) >> 4;
+  for (i = 0; (val != 0) && (i < (NET_SYS_HIST_SIZE - 1)); i++) {
+    val >>= 2;
+  }
+  net_sys_stats.loop_hist[i]++;
+}
+
 /**
   \brief       Process timer tick event.
 */
@@ -353,6 +385,26 @@ netStatus netIF_SetDefault (uint32_t if_id, netIF_Version ip_version) {
   END_LOCK;
 }
 
+/**
+  \brief       Retrieve statistics of an Interface.
+  \param[in]   if_id  interface identifier.
+  \param[out]  stats  pointer to the structure to store statistics to.
+  \return      status code as defined with netStatus.
+*/
+netStatus netIF_GetStats (uint32_t if_id, NET_IF_STATS *stats) {
+  NET_IF_CFG *net_if = net_if_map_all (if_id);
+
+  START_LOCK (netStatus);
+
+  if ((net_if == NULL) || (net_if->Stats == NULL) || (stats == NULL)) {
+    RETURN (netInvalidParameter);
+  }
+  memcpy (stats, net_if->Stats, sizeof (*stats));
+  RETURN (netOK);
+
+  END_LOCK;
+}
+
 /**
   \brief       Retrieve local host name.
   \return      pointer to local host name.
@@ -385,6 +437,25 @@ netStatus netSYS_SetHostName (const char *hostname) {
   END_LOCK;
 }
 
+/**
+  \brief       Retrieve Network Component statistics.
+  \param[out]  stats  pointer to the structure to store statistics to.
+  \return      status code as defined with netStatus.
+*/
+netStatus netSYS_GetStats (NET_SYS_STATS *stats) {
+
+  START_LOCK (netStatus);
+
+  if (stats == NULL) {
+    RETURN (netInvalidParameter);
+  }
+  memcpy (stats, &net_sys_stats, sizeof (*stats));
+  net_mem_get_stats (stats);
+  RETURN (netOK);
+
+  END_LOCK;
+}
+
 /**
   \brief       Get a 32-bit random number.
   \return      random number.
@@ -95,6 +95,7 @@ typedef struct net_sys_ctrl {
 /* Variables */
 extern NET_SYS_CTRL net_sys_control;
 #define sys       (&net_sys_control)
+extern NET_SYS_STATS net_sys_stats;
 extern NET_SYS_CFG  net_sys_config;
 #define sysc      (&net_sys_config)
 extern NETIF_SETOPT_FUNC netif_setopt_func;
@@ -34,6 +34,10 @@ static void tcp_que_add (NET_TCP_INFO *tcp_s, NET_FRAME *frame, uint32_t dlen);
 static void tcp_que_init (NET_TCP_INFO *tcp_s);
 static uint32_t tcp_que_una (NET_TCP_INFO *tcp_s);
 static void tcp_que_resend (NET_TCP_INFO *tcp_s);
+static void tcp_que_send (NET_TCP_INFO *tcp_s);
+static uint32_t tcp_que_next (NET_TCP_INFO *tcp_s);
+static bool tcp_que_trim (NET_TCP_INFO *tcp_s, uint32_t size);
+static NET_FRAME *tcp_que_split (NET_TCP_INFO *tcp_s, NET_FRAME *frame, uint32_t len);
 static void tcp_que_free (NET_TCP_INFO *tcp_s);
 static NET_TCP_INFO *tcp_map_socket (NET_IF_CFG *net_if, NET_FRAME *frame,
                                      NET_TCP_HEADER *tcp_hdr, uint8_t ip_ver);
@@ -400,6 +404,12 @@ uint8_t *net_tcp_get_buf (uint32_t size) {
   NET_FRAME *frame;
   uint32_t sz = size & 0xFFFF;
 
+  if ((size & 0x7FFFFFFF) > (0xFFFF - TCP_DATA_OFFS)) {
+    /* Frame length is limited to 64K */
+    ERRORF (TCP,"GetBuffer, Size %d too large\n",size & 0x7FFFFFFF);
+    EvrNetTCP_GetBufferFailed (sz);
+    return (NULL);
+  }
   if (size & 0x80000000) {
     /* No sys_error() call, when out of memory */
     sz |= 0x40000000;
@@ -422,10 +432,12 @@ uint8_t *net_tcp_get_buf (uint32_t size) {
   \param[in]   buf     buffer containing the data.
   \param[in]   len     length of data in bytes.
   \return      status code as defined with netStatus.
+  \note        Data larger than MSS is split into MSS-sized segments,
+               which are sent from net_tcp_socket_run().
 */
 netStatus net_tcp_send (int32_t socket, uint8_t *buf, uint32_t len) {
   NET_TCP_INFO *tcp_s;
-  NET_FRAME *frame;
+  NET_FRAME *frame,*seg_list,*next;
   netStatus retv;
 
   DEBUGF (TCP,"Send Socket %d, %d bytes\n",socket,len);
@@ -472,9 +484,9 @@ netStatus net_tcp_send (int32_t socket, uint8_t *buf, uint32_t len) {
     retv = netBusy;
     goto retf;
   }
-  if (len > tcp_s->MaxSegSize) {
-    ERRORF (TCP,"Send, Socket %d MSS exceeded\n",tcp_s->Id);
-    EvrNetTCP_SendMssExceeded (tcp_s->Id);
+  if (len > (uint32_t)(frame->length - TCP_DATA_OFFS)) {
+    ERRORF (TCP,"Send, Socket %d buffer size exceeded\n",tcp_s->Id);
+    EvrNetTCP_SendBufferInvalid (tcp_s->Id);
     retv = netInvalidParameter;
     goto retf;
   }
@@ -488,14 +500,32 @@ retf:
     return (retv);
   }
 
+  seg_list = NULL;
+  if (len > tcp_s->MaxSegSize) {
+    /* Large send, split the data into segments */
+    seg_list = tcp_que_split (tcp_s, frame, len);
+    if (seg_list == NULL) {
+      ERRORF (TCP,"Send, Socket %d out of memory\n",tcp_s->Id);
+      EvrNetTCP_GetBufferFailed (len - tcp_s->MaxSegSize);
+      retv = netError;
+      goto retf;
+    }
+    DEBUGF (TCP," Large send, %d bytes\n",len);
+    len = tcp_s->MaxSegSize;
+  }
+
   net_mem_shrink (frame, TCP_DATA_OFFS + len);
   tcp_s->Flags |= TCP_IFLAG_DACK;
   /* Check queue retransmit status */
   if (!(tcp_s->Flags & TCP_IFLAG_RESEND)) {
     /* Not active, send a frame now */
-    tcp_s->Flags     |=  TCP_IFLAG_PUSH;
+    if (seg_list == NULL) {
+      /* Push only the last segment of data */
+      tcp_s->Flags   |=  TCP_IFLAG_PUSH;
+    }
     tcp_s->Flags     &= ~TCP_IFLAG_KALIVE;
     tcp_send_data (tcp_s, frame, len);
+    tcp_s->SendMax    = tcp_s->SendNext;
     /* Check timeout recovery status */
     if (!(tcp_s->Flags & TCP_IFLAG_TIMEOUT)) {
       /* Inactive, set retry timer and counter */
@@ -507,11 +537,23 @@ retf:
   else {
     /* Add this packet to the queue and let net_tcp_socket_run()*/
     /* handle it and send it in a retransmission process.       */
+    tcp_s->SendMax   = tcp_s->SendNext;
     tcp_s->SendNext += len;
   }
   /* The queue control variables overlap the ethernet header,*/
   /* so the frame must be added to the queue after sending.  */
   tcp_que_add (tcp_s, frame, len);
+  if (seg_list != NULL) {
+    /* Queue remaining segments, they are sent later. SendNext covers */
+    /* the queued data, SendMax follows the data actually sent.      */
+    tcp_s->Flags |= TCP_IFLAG_LSEND;
+    for ( ; seg_list; seg_list = next) {
+      next = TCP_QUE(seg_list)->next;
+      len  = TCP_QUE(seg_list)->dlen;
+      tcp_s->SendNext += len;
+      tcp_que_add (tcp_s, seg_list, len);
+    }
+  }
   return (netOK);
 }
 
@@ -569,9 +611,9 @@ netStatus net_tcp_close (int32_t socket) {
         DEBUGF (TCP," Pended, %d bytes unacked\n",tcp_s->SendNext-tcp_s->SendUna);
         EvrNetTCP_CloseDataUnacked (tcp_s->Id, tcp_s->SendNext-tcp_s->SendUna);
         tcp_s->Flags |= TCP_IFLAG_CLOSING;
-        if (tcp_s->Flags & TCP_IFLAG_RESEND) {
+        if (tcp_s->Flags & (TCP_IFLAG_RESEND | TCP_IFLAG_LSEND)) {
           /* Socket is currently retransmitting, send FIN after  */
-          /* last data packet from the queue is retransmitted.   */
+          /* last data packet from the queue is (re)transmitted. */
           /* SendNext must reflect the last sequence to be acked.*/
           /* That is count of data bytes + FIN in this case.     */
           tcp_s->SendNext++;
@@ -1157,6 +1199,13 @@ void net_tcp_socket_run (void) {
         if (tcp_s->Flags & TCP_IFLAG_RESEND) {
           uint32_t una = tcp_que_una (tcp_s);
           uint32_t win = MIN(tcp_s->CWnd, tcp_s->SendWin);
+          if ((tcp_s->Flags & TCP_IFLAG_LSEND) &&
+              !SEQ_LT (tcp_s->SendUna + una, tcp_s->SendMax)) {
+            /* All sent data is retransmitted, the rest of the */
+            /* queue is sent as large send segments.           */
+            tcp_s->Flags &= ~TCP_IFLAG_RESEND;
+            return;
+          }
           if (una + tcp_s->MaxSegSize <= win) {
             /* Resend saved frames from the queue only if the */
             /* sliding window allows to send additional data. */
@@ -1164,6 +1213,24 @@ void net_tcp_socket_run (void) {
             return;
           }
         }
+        /* Are large send segments pending? */
+        else if (tcp_s->Flags & TCP_IFLAG_LSEND) {
+          uint32_t una = tcp_que_una (tcp_s);
+          uint32_t win = MIN(tcp_s->CWnd, tcp_s->SendWin);
+          if (una + tcp_que_next (tcp_s) <= win) {
+            /* Send next segment from the queue */
+            tcp_que_send (tcp_s);
+            return;
+          }
+          if ((una < win) && ((una == 0) || ((win - una) >= (tcp_s->MaxSegSize >> 1)))) {
+            /* Segment does not fit, send the part that fits into the window. */
+            /* Small parts are sent only if no data is in flight (SWS).       */
+            if (tcp_que_trim (tcp_s, win - una)) {
+              tcp_que_send (tcp_s);
+              return;
+            }
+          }
+        }
         /* Is the socket sending data? */
         else if (tcp_s->Flags & TCP_IFLAG_DACK) {
           uint32_t una = tcp_s->SendNext - tcp_s->SendUna;
@@ -1190,9 +1257,33 @@ void net_tcp_socket_run (void) {
           break;
         }
 
+        /* Is large send data queued, but nothing in flight? */
+        if ((tcp_s->Flags & TCP_IFLAG_LSEND) && (tcp_s->SendUna == tcp_s->SendMax)) {
+          /* The peer window is too small for the queued data. Send */
+          /* a window probe instead of retransmitting. The retries  */
+          /* are restarted whenever the peer responds to a probe.   */
+          if ((tcp_s->Flags & TCP_IFLAG_KALIVE) == 0) {
+            tcp_s->Retries = tcp->MaxRetry;
+          }
+          if (tcp_s->Retries != 0) {
+            DEBUGF (TCP,"Socket %d, Sending window probe\n",tcp_s->Id);
+            tcp_s->Retries--;
+            tcp_s->Flags     |= (TCP_IFLAG_KALIVE | TCP_IFLAG_KSEG);
+            tcp_s->RetryTimer = tcp->RetryTout;
+            tcp_s->AliveTimer = tcp_s->ConnTout;
+            tcp_send_ctrl (tcp_s, TCP_FLAG_ACK);
+            return;
+          }
+          /* No response from the peer, reset the connection */
+          tcp_que_free (tcp_s);
+          tcp_s->Flags |= TCP_IFLAG_CBACK;
+          goto no_retries;
+        }
+
         DEBUGF (TCP,"Socket %d, Timeout retransmit %d bytes\n",tcp_s->Id,
                                 tcp_s->SendNext-tcp_s->SendUna);
         EvrNetTCP_ResendOnTimeout (tcp_s->Id, tcp_s->SendNext-tcp_s->SendUna);
+        net_sys_stats.tcp_timeouts++;
         /* Check if any retries left? */
         if (tcp_s->Retries != 0) {
           /* Retry again and restart the retry timer */
@@ -1231,6 +1322,7 @@ void net_tcp_socket_run (void) {
 
         DEBUGF (TCP,"Socket %d, SYN_SENT timeout\n",tcp_s->Id);
         EvrNetTCP_TimeoutInState (tcp_s->Id, netTCP_StateSYN_SENT);
+        net_sys_stats.tcp_timeouts++;
         tcp_s->SendNext = tcp_s->SendUna;
         /* Timeout expired, any retries left? */
         if (tcp_s->Retries != 0) {
@@ -1252,6 +1344,7 @@ void net_tcp_socket_run (void) {
 
         DEBUGF (TCP,"Socket %d, SYN_REC timeout\n",tcp_s->Id);
         EvrNetTCP_TimeoutInState (tcp_s->Id, netTCP_StateSYN_RECEIVED);
+        net_sys_stats.tcp_timeouts++;
         tcp_s->SendNext = tcp_s->SendUna;
         /* Timeout expired, any retries left? */
         if (tcp_s->Retries != 0) {
@@ -1288,6 +1381,7 @@ void net_tcp_socket_run (void) {
 
         DEBUGF (TCP,"Socket %d, Timeout\n",tcp_s->Id);
         EvrNetTCP_ClosingTimeout (tcp_s->Id);
+        net_sys_stats.tcp_timeouts++;
         /* Timeout expired, any retries left? */
         tcp_s->SendNext = tcp_s->SendUna;
         if (tcp_s->Retries != 0) {
@@ -1349,6 +1443,7 @@ void net_tcp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
     /* Frame too short */
     ERRORF (TCP,"Process, Frame too short\n");
     EvrNetTCP_FrameTooShort (frame->length, TCP_HEADER_LEN);
+    net_sys_stats.tcp_errors++;
     return;
   }
   /* Update index to start of TCP data */
@@ -1380,6 +1475,7 @@ void net_tcp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
       /* IPv4 Checksum check failed */
       ERRORF (TCP,"Socket %d, Receive checksum failed\n",tcp_s->Id);
       EvrNetTCP_ChecksumFailed (tcp_s->Id);
+      net_sys_stats.tcp_errors++;
       return;
     }
   }
@@ -1391,6 +1487,7 @@ void net_tcp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
       /* IPv6 Checksum check failed */
       ERRORF (TCP,"Socket %d, Receive checksum failed\n",tcp_s->Id);
       EvrNetTCP_ChecksumFailed (tcp_s->Id);
+      net_sys_stats.tcp_errors++;
       return;
     }
 #else
@@ -1454,6 +1551,14 @@ void net_tcp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
         return;
       }
 
+      /* Check for ACK of queued large send data not sent yet */
+      if ((tcp_s->Flags & TCP_IFLAG_LSEND) && SEQ_GT (acknr, tcp_s->SendMax)) {
+        /* Invalid ack, send an ack and drop the frame (RFC793 - page 72) */
+        DEBUGF (TCP," Ack for data not sent\n");
+        tcp_send_ctrl (tcp_s, TCP_FLAG_ACK);
+        return;
+      }
+
       win_delta = 0;
       /* Check if send window should be updated? */
       if (SEQ_GE (acknr, tcp_s->SendUna) &&
@@ -1482,19 +1587,22 @@ void net_tcp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
       if (tcp_s->SendUna != tcp_s->SendNext) {
         /* Check for duplicate acks!    (RFC 5681 - page 3) */
         /* An acknowledge is considered a duplicate when:   */
-        /*   a) there is outstanding unacked data           */
+        /*   a) there is outstanding unacked data, that is  */
+        /*      data sent and not only queued for sending   */
         /*   b) the ack packet carries no data (dlen is 0)  */
         /*   c) the SYN and FIN flags are off               */
         /*   d) the ack number is equal to SendUna          */
         /*   e) the advertised window is the same as last   */
         /*      advertised window received                  */
         if (SEQ_LE (acknr, tcp_s->SendChk) && (dlen == 0)  &&
-            !(tcp_hdr->Flags & TCP_FLAG_FIN) && (win_delta == 0)) {
+            !(tcp_hdr->Flags & TCP_FLAG_FIN) && (win_delta == 0) &&
+            !((tcp_s->Flags & TCP_IFLAG_LSEND) && (tcp_s->SendUna == tcp_s->SendMax))) {
           /* Yes, this is a duplicate ack */
           if (tcp_s->DupAcks < 255) {
             /* Safety prevent overflows */
             tcp_s->DupAcks++;
           }
+          net_sys_stats.tcp_dup_acks++;
           tcp_proc_dupack (tcp_s);
         }
         else if (SEQ_GT (acknr, tcp_s->SendChk)) {
@@ -2197,6 +2305,10 @@ static void tcp_send_ctrl (NET_TCP_INFO *tcp_s, uint8_t flags) {
   if (tcp_s->Flags & TCP_IFLAG_KSEG) {
     /* Send Keep-alive segment, ack the last byte sent */
     tcp_s->Flags &= ~TCP_IFLAG_KSEG;
+    if (tcp_s->Flags & TCP_IFLAG_LSEND) {
+      /* Window probe, queued large send data is not sent yet */
+      TCP_WI(frame)->seqnr = tcp_s->SendMax;
+    }
     TCP_WI(frame)->seqnr--;
   }
   if (flags & (TCP_FLAG_SYN | TCP_FLAG_FIN)) {
@@ -2592,7 +2704,7 @@ static void tcp_que_resend (NET_TCP_INFO *tcp_s) {
       tcp_s->SendNext = sseq;
       tcp_send_ctrl (tcp_s, TCP_FLAG_ACK | TCP_FLAG_FIN);
     }
-    tcp_s->Flags &= ~TCP_IFLAG_RESEND;
+    tcp_s->Flags &= ~(TCP_IFLAG_RESEND | TCP_IFLAG_LSEND);
     return;
   }
 
@@ -2613,7 +2725,7 @@ static void tcp_que_resend (NET_TCP_INFO *tcp_s) {
   next = TCP_QUE(frame)->next;
   if ((next == NULL) && !(tcp_s->Flags & TCP_IFLAG_CLOSING)) {
     /* This is the last frame in the queue */
-    tcp_s->Flags &= ~TCP_IFLAG_RESEND;
+    tcp_s->Flags &= ~(TCP_IFLAG_RESEND | TCP_IFLAG_LSEND);
   }
   dlen = TCP_QUE(frame)->dlen;
   /* A hack to provide send sequence for tcp_write() */
@@ -2621,6 +2733,7 @@ static void tcp_que_resend (NET_TCP_INFO *tcp_s) {
   DEBUGF (TCP,"Resend Socket %d, %d bytes\n",tcp_s->Id,dlen);
   DEBUGF (TCP," Retry tout %dms\n",tcp_s->RetryTimer*SYS_TICK_INTERVAL);
   EvrNetTCP_ResendData (tcp_s->Id, dlen, tcp_s->RetryTimer);
+  net_sys_stats.tcp_retransmits++;
   /* Warning! TCP_QUE data is lost in tcp_send_data()! */
   tcp_send_data (tcp_s, frame, dlen | 0x80000000);
   /* Warning! The overlaid data needs to be preserved! */
@@ -2631,6 +2744,159 @@ static void tcp_que_resend (NET_TCP_INFO *tcp_s) {
   TCP_QUE(frame)->ticks = 0;
 }
 
+/**
+  \brief       Send next pending large send segment from the queue.
+  \param[in]   tcp_s  socket descriptor.
+  \note        Search for the segment not sent yet (with delta == 0).
+*/
+static void tcp_que_send (NET_TCP_INFO *tcp_s) {
+  NET_FRAME *frame,*next;
+  uint32_t sseq,dlen;
+
+  sseq = tcp_s->SendUna;
+  /* Scan the queue and find a segment to send */
+  for (frame = tcp_s->unack_list; frame; frame = TCP_QUE(frame)->next) {
+    if (TCP_QUE(frame)->delta == 0) {
+      /* Send sequence number found */
+      break;
+    }
+    sseq += TCP_QUE(frame)->dlen;
+  }
+  if (frame == NULL) {
+    /* All segments sent, check if the socket is closing */
+    if (tcp_s->Flags & TCP_IFLAG_CLOSING) {
+      tcp_s->SendNext = sseq;
+      tcp_send_ctrl (tcp_s, TCP_FLAG_ACK | TCP_FLAG_FIN);
+    }
+    tcp_s->Flags &= ~TCP_IFLAG_LSEND;
+    return;
+  }
+
+  next = TCP_QUE(frame)->next;
+  if (next == NULL) {
+    /* This is the last segment, push the data */
+    tcp_s->Flags |= TCP_IFLAG_PUSH;
+    if (!(tcp_s->Flags & TCP_IFLAG_CLOSING)) {
+      tcp_s->Flags &= ~TCP_IFLAG_LSEND;
+    }
+  }
+  dlen = TCP_QUE(frame)->dlen;
+  /* Provide send sequence for tcp_write() */
+  TCP_WI(frame)->seqnr  = sseq;
+  tcp_s->SendMax        = sseq + dlen;
+  DEBUGF (TCP,"Send Socket %d, segment %d bytes\n",tcp_s->Id,dlen);
+  /* Warning! TCP_QUE data is lost in tcp_send_data()! */
+  tcp_send_data (tcp_s, frame, dlen | 0x80000000);
+  /* Warning! The overlaid data needs to be preserved! */
+  TCP_QUE(frame)->next  = next;
+  TCP_QUE(frame)->dlen  = dlen & 0xFFFF;
+  TCP_QUE(frame)->delta = dlen & 0xFFFF;
+  /* Current tick count for RTT estimation */
+  TCP_QUE(frame)->ticks = sys->Ticks;
+
+  /* Check timeout recovery status */
+  if (!(tcp_s->Flags & TCP_IFLAG_TIMEOUT)) {
+    /* Inactive, set retry timer and counter */
+    tcp_s->RetryTimer = (uint16_t)((tcp_s->RttSa >> 3) + tcp_s->RttSv);
+    tcp_s->Retries    = tcp->MaxRetry;
+  }
+  tcp_s->AliveTimer = tcp_s->ConnTout;
+}
+
+/**
+  \brief       Get the length of next pending large send segment.
+  \param[in]   tcp_s  socket descriptor.
+  \return      segment data length or 0 if all segments are sent.
+*/
+static uint32_t tcp_que_next (NET_TCP_INFO *tcp_s) {
+  NET_FRAME *frame;
+
+  for (frame = tcp_s->unack_list; frame; frame = TCP_QUE(frame)->next) {
+    if (TCP_QUE(frame)->delta == 0) {
+      return (TCP_QUE(frame)->dlen);
+    }
+  }
+  return (0);
+}
+
+/**
+  \brief       Trim next pending large send segment to a size.
+  \param[in]   tcp_s  socket descriptor.
+  \param[in]   size   new segment data length.
+  \return      true if segment is not larger than size,
+               false if out of memory.
+  \note        Data beyond size is moved into a new segment,
+               which is inserted into the queue after the trimmed one.
+*/
+static bool tcp_que_trim (NET_TCP_INFO *tcp_s, uint32_t size) {
+  NET_FRAME *frame,*seg;
+  uint32_t dlen;
+
+  for (frame = tcp_s->unack_list; frame; frame = TCP_QUE(frame)->next) {
+    if (TCP_QUE(frame)->delta == 0) {
+      break;
+    }
+  }
+  if ((frame == NULL) || (TCP_QUE(frame)->dlen <= size)) {
+    return (true);
+  }
+  dlen = TCP_QUE(frame)->dlen - size;
+  /* Do not call sys_error() if out of memory */
+  seg = net_mem_alloc ((TCP_DATA_OFFS + dlen) | 0x80000000);
+  if (seg == NULL) {
+    return (false);
+  }
+  memcpy (&seg->data[TCP_DATA_OFFS], &frame->data[TCP_DATA_OFFS+size], dlen);
+  net_mem_shrink (frame, TCP_DATA_OFFS + size);
+  TCP_QUE(seg)->next   = TCP_QUE(frame)->next;
+  TCP_QUE(seg)->dlen   = dlen & 0xFFFF;
+  TCP_QUE(seg)->delta  = 0;
+  TCP_QUE(seg)->ticks  = 0;
+  TCP_QUE(frame)->next = seg;
+  TCP_QUE(frame)->dlen = size & 0xFFFF;
+  return (true);
+}
+
+/**
+  \brief       Split large send data into MSS-sized segments.
+  \param[in]   tcp_s  socket descriptor.
+  \param[in]   frame  network frame with data.
+  \param[in]   len    data length, larger than MSS.
+  \return      list of segments following the first segment or
+               NULL if out of memory.
+  \note        The data is split from the tail, so that the memory
+               released by shrinking the frame is reused at once.
+*/
+static NET_FRAME *tcp_que_split (NET_TCP_INFO *tcp_s, NET_FRAME *frame, uint32_t len) {
+  NET_FRAME *seg,*list = NULL;
+  uint32_t dlen;
+
+  while (len > tcp_s->MaxSegSize) {
+    /* Last segment may be shorter than MSS */
+    dlen = len % tcp_s->MaxSegSize;
+    if (dlen == 0) {
+      dlen = tcp_s->MaxSegSize;
+    }
+    /* Do not call sys_error() if out of memory */
+    seg = net_mem_alloc ((TCP_DATA_OFFS + dlen) | 0x80000000);
+    if (seg == NULL) {
+      /* Release already created segments */
+      for ( ; list; list = seg) {
+        seg = TCP_QUE(list)->next;
+        net_mem_free (list);
+      }
+      return (NULL);
+    }
+    len -= dlen;
+    memcpy (&seg->data[TCP_DATA_OFFS], &frame->data[TCP_DATA_OFFS+len], dlen);
+    net_mem_shrink (frame, TCP_DATA_OFFS + len);
+    TCP_QUE(seg)->next = list;
+    TCP_QUE(seg)->dlen = dlen & 0xFFFF;
+    list = seg;
+  }
+  return (list);
+}
+
 /**
   \brief       Add frame to outgoing buffer queue.
   \param[in]   tcp_s  socket descriptor.
@@ -2647,12 +2913,14 @@ static void tcp_que_add (NET_TCP_INFO *tcp_s, NET_FRAME *frame, uint32_t dlen) {
 
   TCP_QUE(frame)->next  = NULL;
   TCP_QUE(frame)->dlen  = dlen & 0xFFFF;
-  TCP_QUE(frame)->delta = 0;
+  TCP_QUE(frame)->delta = dlen & 0xFFFF;
 
   /* Current tick count for RTT estimation */
   TCP_QUE(frame)->ticks = sys->Ticks;
-  if (tcp_s->Flags & TCP_IFLAG_RESEND) {
+  if (tcp_s->Flags & (TCP_IFLAG_RESEND | TCP_IFLAG_LSEND)) {
+    /* Frame not sent yet, send it from the queue */
     TCP_QUE(frame)->ticks = 0;
+    TCP_QUE(frame)->delta = 0;
   }
   if (tcp_s->unack_list == NULL) {
     /* First frame added to unacked queue */
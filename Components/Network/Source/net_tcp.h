@@ -53,6 +53,7 @@
 #define TCP_IFLAG_KSEG      0x0040      // Send Keep Alive segment
 #define TCP_IFLAG_PUSH      0x0080      // Push the data (set PSH flag)
 #define TCP_IFLAG_TIMEOUT   0x0100      // Timeout Recovery active
+#define TCP_IFLAG_LSEND     0x0200      // Large send segments pending
 
 /* TCP Socket Types */
 #define TCP_TYPE_DELAY_ACK  0x01        // Delayed Acknowledge enabled
@@ -22,9 +22,19 @@
 /* Code shortening macros */
 #define udp       (&net_udp_config)
 
+/* Local variables */
+static uint8_t udp_hash[UDP_HASH_SIZE];
+
 /* Local Functions */
 static uint16_t udp_alloc_port (void);
 static bool udp_port_in_use (uint16_t port);
+static NET_UDP_INFO *udp_map_port (uint16_t port);
+static void udp_hash_add (int32_t socket);
+static void udp_hash_remove (int32_t socket);
+static void udp_que_add (NET_UDP_INFO *udp_s, int32_t socket,
+                         const NET_ADDR *addr, const uint8_t *buf, uint32_t len);
+static uint32_t udp_que_get (NET_UDP_INFO *udp_s, NET_UDP_MSG *msg, uint32_t num);
+static void udp_que_free (NET_UDP_INFO *udp_s);
 #ifdef Network_Debug_STDIO
  static void debug_info (const NET_UDP_HEADER *udp_hdr);
 #endif
@@ -70,6 +80,12 @@ netStatus netUDP_SetOption (int32_t socket, netUDP_Option option, uint32_t val)
 uint16_t netUDP_GetLocalPort (int32_t socket) {
   return (net_udp_get_local_port (socket));
 }
+int32_t netUDP_ReceiveBatch (int32_t socket,
+                             NET_UDP_MSG *msg, uint32_t num, uint32_t timeout) {
+  START_LOCK (int32_t);
+  RETURN (net_udp_receive_batch (socket, msg, num, timeout));
+  END_LOCK;
+}
 
 /* ==== Internal UDP Socket functions ==== */
 
@@ -82,17 +98,26 @@ void net_udp_socket_init (void) {
 
   /* Clear SCB for all sockets */
   memset (udp->Scb, 0, sizeof (*udp->Scb) * udp->NumSocks);
+  memset (udp_hash, 0, sizeof (udp_hash));
 }
 
 /**
   \brief       De-initialize UDP sockets.
 */
 void net_udp_socket_uninit (void) {
+  NET_UDP_INFO *udp_s;
+  int32_t i;
+
   DEBUGF (UDP,"Uninit Sockets\n");
   EvrNetUDP_UninitSockets ();
 
+  /* Release queued receive buffers */
+  for (i = 0, udp_s = &udp->Scb[0]; i < udp->NumSocks; udp_s++, i++) {
+    udp_que_free (udp_s);
+  }
   /* Clear SCB for all sockets */
   memset (udp->Scb, 0, sizeof (*udp->Scb) * udp->NumSocks);
+  memset (udp_hash, 0, sizeof (udp_hash));
 }
 
 /**
@@ -124,6 +149,11 @@ int32_t net_udp_get_socket (netUDP_cb_t cb_func) {
       udp_s->HopLimit= 1;
       udp_s->net_if  = NULL;
       udp_s->cb_func = cb_func;
+      udp_s->rx_list = NULL;
+      udp_s->Thread  = NULL;
+      udp_s->HashNext= 0;
+      udp_s->RxQueMax= 0;
+      udp_s->RxQueCnt= 0;
       /* Return socket handle */
       return (i);
     }
@@ -199,6 +229,7 @@ netStatus net_udp_open (int32_t socket, uint16_t port) {
   }
   udp_s->LocPort = port;
   udp_s->State   = UDP_STATE_OPENED;
+  udp_hash_add (socket);
   return (netOK);
 }
 
@@ -218,6 +249,12 @@ netStatus net_udp_close (int32_t socket) {
     return (netInvalidParameter);
   }
   udp_s = &udp->Scb[socket-1];
+  if (udp_s->State == UDP_STATE_OPENED) {
+    udp_hash_remove (socket);
+    /* Discard queued datagrams and resume blocked receiver */
+    udp_que_free (udp_s);
+    net_sys_resume (&udp_s->Thread);
+  }
   udp_s->State = UDP_STATE_CLOSED;
   return (netOK);
 }
@@ -293,6 +330,17 @@ netStatus net_udp_set_option (int32_t socket, netUDP_Option option, uint32_t val
       udp_s->Flags |=  val;
       return (netOK);
 
+    case netUDP_OptionReceiveQueue:
+      if (val > 255) break;
+      DEBUGF (UDP," RxQueue=%d\n",val);
+      EvrNetUDP_SetOptionReceiveQueue (socket, val);
+      udp_s->RxQueMax = val & 0xFF;
+      if (val == 0) {
+        /* Callback mode, discard queued datagrams */
+        udp_que_free (udp_s);
+      }
+      return (netOK);
+
     default:
       ERRORF (UDP,"SetOption, Socket %d wrong option\n",socket);
       EvrNetUDP_SetOptionWrongOption (socket, option);
@@ -344,6 +392,9 @@ uint32_t net_udp_get_option (int32_t socket, netUDP_Option option) {
     case netUDP_OptionChecksum:
       return (udp_s->Flags & UDP_FLAG_CKS_MASK);
 
+    case netUDP_OptionReceiveQueue:
+      return (udp_s->RxQueMax);
+
     default:
       break;
   }
@@ -369,6 +420,50 @@ uint16_t net_udp_get_local_port (int32_t socket) {
   return (udp_s->LocPort);
 }
 
+/**
+  \brief       Receive multiple queued datagrams.
+  \param[in]   socket   socket handle.
+  \param[in,out] msg    array of message descriptors.
+  \param[in]   num      number of message descriptors.
+  \param[in]   timeout  time to wait for the first datagram in ms.
+  \return      number of datagrams received or execution status when < 0
+  \note        Datagrams larger than the provided buffer are truncated.
+*/
+int32_t net_udp_receive_batch (int32_t socket, NET_UDP_MSG *msg,
+                                               uint32_t num, uint32_t timeout) {
+  NET_UDP_INFO *udp_s;
+  uint32_t n;
+
+  if ((socket <= 0) || (socket > udp->NumSocks) || (msg == NULL) || (num == 0)) {
+    ERRORF (UDP,"ReceiveBatch, Socket %d invalid parameter\n",socket);
+    EvrNetUDP_ReceiveBatchNotValid (socket);
+    return (-netInvalidParameter);
+  }
+  udp_s = &udp->Scb[socket-1];
+  if ((udp_s->State != UDP_STATE_OPENED) || (udp_s->RxQueMax == 0) || udp_s->Thread) {
+    ERRORF (UDP,"ReceiveBatch, Socket %d wrong state\n",socket);
+    EvrNetUDP_ReceiveBatchWrongState (socket, udp_s->State);
+    return (-netWrongState);
+  }
+  n = udp_que_get (udp_s, msg, num);
+  if ((n == 0) && (timeout != 0)) {
+    /* Queue empty, wait for the first datagram */
+    udp_s->Thread = netos_thread_id ();
+    net_sys_wait (timeout);
+    udp_s->Thread = NULL;
+    if (udp_s->State != UDP_STATE_OPENED) {
+      /* Socket closed while waiting */
+      ERRORF (UDP,"ReceiveBatch, Socket %d closed\n",socket);
+      EvrNetUDP_ReceiveBatchWrongState (socket, udp_s->State);
+      return (-netWrongState);
+    }
+    n = udp_que_get (udp_s, msg, num);
+  }
+  DEBUGF (UDP,"ReceiveBatch Socket %d, %d datagrams\n",socket,n);
+  EvrNetUDP_ReceiveBatch (socket, n);
+  return ((int32_t)n);
+}
+
 /**
   \brief       Allocate memory for UDP send buffer.
   \param[in]   size  number of bytes to allocate.
@@ -660,7 +755,6 @@ void net_udp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
   NET_UDP_HEADER *udp_hdr;
   uint16_t dlen,port;
   uint8_t socket;
-  int32_t i;
 
   DEBUGF (UDP,"*** Process_frame ***\n");
   udp_hdr = __ALIGN_CAST(NET_UDP_HEADER *)&frame->data[frame->index];
@@ -673,6 +767,7 @@ void net_udp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
     /* Frame too short */
     ERRORF (UDP,"Process, Frame too short\n");
     EvrNetUDP_FrameTooShort (frame->length, UDP_HEADER_LEN);
+    net_sys_stats.udp_errors++;
     return;
   }
 
@@ -688,23 +783,17 @@ void net_udp_process (NET_IF_CFG *net_if, NET_FRAME *frame, uint8_t ip_ver) {
   }
 
   /* Map to UDP socket */
-  socket = 0;
-  for (i = 1, udp_s = &udp->Scb[0]; i <= udp->NumSocks; udp_s++, i++) {
-    if ((udp_s->State == UDP_STATE_OPENED) && (udp_s->LocPort == port)) {
-      /* Open socket found */
-      socket = i & 0xFF;
-      DEBUGF (UDP," Mapped to Socket %d\n",i);
-      EvrNetUDP_MapFrameToSocket (i);
-      break;
-    }
-  }
-  if (socket == 0) {
+  udp_s = udp_map_port (port);
+  if (udp_s == NULL) {
 not_mapped:
     /* We should send back an ICMP frame here to report non existing socket */
     DEBUGF (UDP," Discarded, Frame not mapped\n");
     EvrNetUDP_FrameNotMapped (frame->length);
     return;
   }
+  socket = (udp_s - &udp->Scb[0] + 1) & 0xFF;
+  DEBUGF (UDP," Mapped to Socket %d\n",socket);
+  EvrNetUDP_MapFrameToSocket (socket);
   /* Check the interface binding */
   if (udp_s->net_if && (net_if != udp_s->net_if)) {
     /* Bound but receiving interface wrong */
@@ -730,6 +819,7 @@ not_mapped:
         /* IPv4 Checksum check failed */
         ERRORF (UDP,"Socket %d, Receive checksum failed\n",socket);
         EvrNetUDP_ChecksumFailed (socket);
+        net_sys_stats.udp_errors++;
         return;
       }
     }
@@ -741,6 +831,7 @@ not_mapped:
         /* IPv6 Checksum check failed */
         ERRORF (UDP,"Socket %d, Receive checksum failed\n",socket);
         EvrNetUDP_ChecksumFailed (socket);
+        net_sys_stats.udp_errors++;
         return;
       }
 #else
@@ -766,6 +857,13 @@ not_mapped:
 #endif
   }
 
+  if (udp_s->RxQueMax != 0) {
+    /* Queue the datagram for netUDP_ReceiveBatch() */
+    udp_que_add (udp_s, socket, (NET_ADDR *)&addr,
+                 udp_hdr->Data, frame->length - UDP_HEADER_LEN);
+    return;
+  }
+
   /* Generate data event, call callback event function */
   udp_s->cb_func (socket, (NET_ADDR *)&addr,
                            udp_hdr->Data, frame->length - UDP_HEADER_LEN);
@@ -803,16 +901,145 @@ static uint16_t udp_alloc_port (void) {
                - false = port free.
 */
 static bool udp_port_in_use (uint16_t port) {
+  return ((udp_map_port (port) != NULL) ? true : false);
+}
+
+/**
+  \brief       Map local port to an open UDP socket.
+  \param[in]   port  local UDP port.
+  \return      pointer to socket control block or NULL if not found.
+*/
+static NET_UDP_INFO *udp_map_port (uint16_t port) {
   NET_UDP_INFO *udp_s;
-  int32_t i;
+  uint32_t i;
 
-  for (i = 0, udp_s = &udp->Scb[0]; i < udp->NumSocks; udp_s++, i++) {
-    if ((port == udp_s->LocPort) && (udp_s->State > UDP_STATE_CLOSED)) {
-      /* This port is in use */
-      return (true);
+  for (i = udp_hash[UDP_HASH(port)]; i != 0; i = udp_s->HashNext) {
+    udp_s = &udp->Scb[i-1];
+    if (udp_s->LocPort == port) {
+      return (udp_s);
     }
   }
-  return (false);
+  return (NULL);
+}
+
+/**
+  \brief       Add opened socket to local port hash table.
+  \param[in]   socket  socket handle.
+*/
+static void udp_hash_add (int32_t socket) {
+  NET_UDP_INFO *udp_s = &udp->Scb[socket-1];
+  uint32_t idx = UDP_HASH(udp_s->LocPort);
+
+  udp_s->HashNext = udp_hash[idx];
+  udp_hash[idx]   = socket & 0xFF;
+}
+
+/**
+  \brief       Remove socket from local port hash table.
+  \param[in]   socket  socket handle.
+*/
+static void udp_hash_remove (int32_t socket) {
+  NET_UDP_INFO *udp_s = &udp->Scb[socket-1];
+  uint8_t *link;
+
+  for (link = &udp_hash[UDP_HASH(udp_s->LocPort)]; *link; ) {
+    if (*link == socket) {
+      *link = udp_s->HashNext;
+      break;
+    }
+    link = &udp->Scb[*link-1].HashNext;
+  }
+  udp_s->HashNext = 0;
+}
+
+/**
+  \brief       Add received datagram to socket receive queue.
+  \param[in]   udp_s   socket control block.
+  \param[in]   socket  socket handle.
+  \param[in]   addr    structure containing remote IP address and port.
+  \param[in]   buf     pointer to a buffer containing the data.
+  \param[in]   len     length of the data.
+*/
+static void udp_que_add (NET_UDP_INFO *udp_s, int32_t socket,
+                         const NET_ADDR *addr, const uint8_t *buf, uint32_t len) {
+  NET_BUFFER *netbuf, *next;
+
+  netbuf = NULL;
+  if (udp_s->RxQueCnt < udp_s->RxQueMax) {
+    /* Keep 25% of memory pool free, no sys_error() call */
+    netbuf = __BUFFER(net_mem_alloc ((UDP_RXQ_HLEN + len) | 0x40000000));
+  }
+  if (netbuf == NULL) {
+    /* Queue full or out of memory, dump the datagram */
+    ERRORF (UDP,"Que_add, Socket %d dumped %d bytes\n",socket,len);
+    EvrNetUDP_ReceiveQueueDump (socket, len);
+    return;
+  }
+  DEBUGF (UDP,"Que_add %d bytes, Socket %d\n",len,socket);
+  EvrNetUDP_ReceiveQueueAdd (socket, len);
+  net_addr_copy (__ALIGN_CAST(__ADDR *)netbuf->data, (const __ADDR *)addr);
+  memcpy (&netbuf->data[sizeof(NET_ADDR)], buf, len);
+  netbuf->length = len & 0xFFFF;
+  netbuf->index  = 0;
+  netbuf->next   = NULL;
+
+  /* Append the buffer to the queue */
+  if (udp_s->rx_list == NULL) {
+    udp_s->rx_list = netbuf;
+  }
+  else {
+    for (next = udp_s->rx_list; next->next; next = next->next);
+    next->next = netbuf;
+  }
+  udp_s->RxQueCnt++;
+
+  /* Resume blocked receiver thread */
+  net_sys_resume (&udp_s->Thread);
+}
+
+/**
+  \brief       Copy queued datagrams to user message descriptors.
+  \param[in]   udp_s   socket control block.
+  \param[in,out] msg   array of message descriptors.
+  \param[in]   num     number of message descriptors.
+  \return      number of datagrams copied.
+*/
+static uint32_t udp_que_get (NET_UDP_INFO *udp_s, NET_UDP_MSG *msg, uint32_t num) {
+  NET_BUFFER *netbuf;
+  uint32_t n, len;
+
+  for (n = 0; (n < num) && udp_s->rx_list; msg++, n++) {
+    netbuf = udp_s->rx_list;
+    len    = netbuf->length;
+    if (len > msg->len) {
+      /* Truncate the data to buffer size */
+      len = msg->len;
+    }
+    net_addr_copy ((__ADDR *)&msg->addr, __ALIGN_CAST(__ADDR *)netbuf->data);
+    if (len != 0) {
+      memcpy (msg->buf, &netbuf->data[sizeof(NET_ADDR)], len);
+    }
+    msg->len = len;
+    udp_s->rx_list = netbuf->next;
+    udp_s->RxQueCnt--;
+    net_mem_free (__FRAME(netbuf));
+  }
+  return (n);
+}
+
+/**
+  \brief       Release all queued datagrams of UDP socket.
+  \param[in]   udp_s  socket control block.
+*/
+static void udp_que_free (NET_UDP_INFO *udp_s) {
+  NET_BUFFER *netbuf, *next;
+
+  for (netbuf = udp_s->rx_list; netbuf; netbuf = next) {
+    next = netbuf->next;
+    net_mem_free (__FRAME(netbuf));
+  }
+  udp_s->rx_list  = NULL;
+  udp_s->RxQueCnt = 0;
 }
 
 #ifdef Network_Debug_STDIO
@@ -22,6 +22,12 @@
 #define UDP_TOS_NORMAL      0           // UDP Type of Service for IPv4
 #define UDP_TCLASS_NORMAL   0           // UDP Traffic class for IPv6
 
+#define UDP_HASH_SIZE       8           // Number of local port hash buckets (power of 2)
+#define UDP_HASH(port)      (((port) ^ ((port) >> 3) ^ ((port) >> 8)) & (UDP_HASH_SIZE - 1))
+
+/* Receive queue buffer: NET_BUFFER header, source address and data */
+#define UDP_RXQ_HLEN        (uint32_t)(sizeof(NET_BUFFER) - NET_HEADER_LEN + sizeof(NET_ADDR))
+
 /* UDP Flags */
 #define UDP_FLAG_CKS_MASK   0x03U       // Mask for checking checksum options
 #define UDP_FLAG_KEEP       0x04        // Keep the packet (no auto-free)
@@ -70,6 +76,8 @@ extern netStatus net_udp_send_if (NET_IF_CFG *net_if, int32_t socket,
 extern netStatus net_udp_set_option (int32_t socket, netUDP_Option option, uint32_t val);
 extern uint32_t  net_udp_get_option (int32_t socket, netUDP_Option option);
 extern uint16_t  net_udp_get_local_port (int32_t socket);
+extern int32_t   net_udp_receive_batch (int32_t socket, NET_UDP_MSG *msg,
+                                        uint32_t num, uint32_t timeout);
 extern bool      net_udp_keep_buf (int32_t socket, uint8_t *buf);
 extern void      net_udp_enable_lla (int32_t socket);
 extern void      net_udp_free_buf (uint8_t *buf);
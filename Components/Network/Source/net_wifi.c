@@ -900,11 +900,13 @@ static void wifi_receive (NET_WIFI_CFG *h) {
   while ((size = drv_wifi->EthGetRxFrameSize (WIFI_IF_STA)) != 0) {
     if ((size < PHY_HEADER_LEN) || (size > ctrl->Mtu)) {
       /* Frame error, release it */
+      h->If->Stats->rx_drop_error++;
       drv_wifi->EthReadFrame (WIFI_IF_STA, NULL, 0);
       continue;
     }
     if (((ctrl->q_head - ctrl->q_tail) & 0xFF) >= WIFI_QSIZE) {
       /* Queue overflow, dump this frame */
+      h->If->Stats->rx_drop_queue++;
       drv_wifi->EthReadFrame (WIFI_IF_STA, NULL, 0);
       continue;
     }
@@ -912,6 +914,7 @@ static void wifi_receive (NET_WIFI_CFG *h) {
     frame = net_mem_alloc (size | 0x80000000);
     if (frame == NULL) {
       /* Out of memory, dump this frame */
+      h->If->Stats->rx_drop_memory++;
       drv_wifi->EthReadFrame (WIFI_IF_STA, NULL, 0);
       continue;
     }
@@ -919,6 +922,8 @@ static void wifi_receive (NET_WIFI_CFG *h) {
     drv_wifi->EthReadFrame (WIFI_IF_STA, &frame->data[0], size);
     ctrl->rx_q[ctrl->q_head & (WIFI_QSIZE-1)] = frame;
     ctrl->RxCount += size;
+    h->If->Stats->rx_packets++;
+    h->If->Stats->rx_bytes += size;
     ctrl->q_head++;
   }
   if (ctrl->q_head == ctrl->q_tail) {
@@ -947,6 +952,7 @@ static void wifi_transmit (NET_WIFI_CFG *h) {
   ctrl->x_tail++;
   if (ctrl->th.LinkState == 0) {
     /* When not connected, discard TX frames */
+    h->If->Stats->tx_drop++;
     net_mem_free (frame);
     return;
   }
@@ -961,6 +967,11 @@ static void wifi_transmit (NET_WIFI_CFG *h) {
     }
     if (rc == ARM_DRIVER_OK){
       ctrl->TxCount += frame->length;
+      h->If->Stats->tx_packets++;
+      h->If->Stats->tx_bytes += frame->length;
+    }
+    else {
+      h->If->Stats->tx_drop++;
     }
     break;
   }
@@ -1144,6 +1155,7 @@ bool net_wifi_output (uint32_t if_num, NET_FRAME *frame) {
     /* Queue overflow, dump this frame */
     ERRORF (WIFI,"Output %d, TxQueue overflow\n",h->IfNum);
     EvrNetWiFi_TxQueueOverflow (h->IfNum);
+    h->If->Stats->tx_drop++;
     return (false);
   }
   if (!(net_mem_avail (0))) {
@@ -1291,6 +1291,13 @@ extern usbStatus USBH_MSC_Read (uint8_t instance, uint32_t lba, uint32_t cnt, ui
 /// \return                             status code that indicates the execution status of the function as defined with \ref usbStatus.
 extern usbStatus USBH_MSC_Write (uint8_t instance, uint32_t lba, uint32_t cnt, const uint8_t *buf);
 
+/// \brief Unmap requested number of blocks on Mass Storage Device
+/// \param[in]     instance             instance of MSC Device.
+/// \param[in]     lba                  logical address of first block to unmap.
+/// \param[in]     cnt                  number of contiguous blocks to unmap.
+/// \return                             status code that indicates the execution status of the function as defined with \ref usbStatus.
+extern usbStatus USBH_MSC_Unmap (uint8_t instance, uint32_t lba, uint32_t cnt);
+
 /// \brief Read capacity of Mass Storage Device
 /// \param[in]     instance             instance of MSC Device.
 /// \param[out]    block_count          pointer to where total number of blocks available will be read.
@@ -82,6 +82,7 @@ typedef __PACKED_STRUCT {
 #define SCSI_WRITE10                    0x2AU
 #define SCSI_VERIFY10                   0x2FU
 #define SCSI_SYNC_CACHE10               0x35U
+#define SCSI_UNMAP                      0x42U
 #define SCSI_READ12                     0xA8U
 #define SCSI_WRITE12                    0xAAU
 #define SCSI_MODE_SELECT10              0x55U
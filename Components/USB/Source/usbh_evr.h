@@ -263,6 +263,11 @@
 #define EvtMsgNo_USBH_MSC_ScsiWrite10Failed                         0x26U
 #define EvtMsgNo_USBH_MSC_Recover                                   0x27U
 #define EvtMsgNo_USBH_MSC_RecoverFailed                             0x28U
+#define EvtMsgNo_USBH_MSC_Unmap                                     0x29U
+#define EvtMsgNo_USBH_MSC_UnmapFailed                               0x2AU
+#define EvtMsgNo_USBH_MSC_UnmapDone                                 0x2BU
+#define EvtMsgNo_USBH_MSC_ScsiUnmap                                 0x2CU
+#define EvtMsgNo_USBH_MSC_ScsiUnmapFailed                           0x2DU
 
 
 // Pack parameter in byte
@@ -503,6 +508,11 @@
 #define EvtUSBH_MSC_ScsiWrite10Failed                               EventID(EventLevelError,  EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_ScsiWrite10Failed)
 #define EvtUSBH_MSC_Recover                                         EventID(EventLevelOp,     EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_Recover)
 #define EvtUSBH_MSC_RecoverFailed                                   EventID(EventLevelError,  EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_RecoverFailed)
+#define EvtUSBH_MSC_Unmap                                           EventID(EventLevelAPI,    EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_Unmap)
+#define EvtUSBH_MSC_UnmapFailed                                     EventID(EventLevelError,  EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_UnmapFailed)
+#define EvtUSBH_MSC_UnmapDone                                       EventID(EventLevelDetail, EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_UnmapDone)
+#define EvtUSBH_MSC_ScsiUnmap                                       EventID(EventLevelOp,     EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_ScsiUnmap)
+#define EvtUSBH_MSC_ScsiUnmapFailed                                 EventID(EventLevelError,  EvtCompNo_USBH_MSC,     EvtMsgNo_USBH_MSC_ScsiUnmapFailed)
 
 #endif // (USBH_EVR_USED == 1)
 
@@ -3779,4 +3789,81 @@
   #define              EvrUSBH_MSC_RecoverFailed(...)
 #endif
 
+
+/**
+  \brief  Event on \ref USBH_MSC_Unmap start (API)
+  \param  instance     instance of MSC device
+  \param  lba          logical block address of first block to unmap
+  \param  cnt          number of contiguous blocks to unmap
+ */
+#ifdef                 EvtUSBH_MSC_Unmap
+  __STATIC_INLINE void EvrUSBH_MSC_Unmap(  uint8_t instance,  uint32_t lba, uint32_t cnt) {
+    EventRecord4(      EvtUSBH_MSC_Unmap, TO_BYTE0(instance),          lba,          cnt, 0U);
+  }
+#else
+  #define              EvrUSBH_MSC_Unmap(...)
+#endif
+
+
+/**
+  \brief  Event on \ref USBH_MSC_Unmap failed (Error)
+  \param  instance     instance of MSC device
+  \param  lba          logical block address of first block to unmap
+  \param  cnt          number of contiguous blocks to unmap
+  \param  error        error code \ref usbStatus
+ */
+#ifdef                 EvtUSBH_MSC_UnmapFailed
+  __STATIC_INLINE void EvrUSBH_MSC_UnmapFailed(  uint8_t instance,  uint32_t lba, uint32_t cnt, usbStatus error) {
+    EventRecord4(      EvtUSBH_MSC_UnmapFailed, TO_BYTE0(instance),          lba,          cnt, (uint32_t)error);
+  }
+#else
+  #define              EvrUSBH_MSC_UnmapFailed(...)
+#endif
+
+
+/**
+  \brief  Event on \ref USBH_MSC_Unmap finished successfully (Detail)
+  \param  instance     instance of MSC device
+  \param  lba          logical block address of first block to unmap
+  \param  cnt          number of contiguous blocks to unmap
+ */
+#ifdef                 EvtUSBH_MSC_UnmapDone
+  __STATIC_INLINE void EvrUSBH_MSC_UnmapDone(  uint8_t instance,  uint32_t lba, uint32_t cnt) {
+    EventRecord4(      EvtUSBH_MSC_UnmapDone, TO_BYTE0(instance),          lba,          cnt, 0U);
+  }
+#else
+  #define              EvrUSBH_MSC_UnmapDone(...)
+#endif
+
+
+/**
+  \brief  Event on internal operation SCSI Unmap start (Operation)
+  \param  instance     instance of MSC device
+  \param  block_addr   address of first block to be unmapped
+  \param  block_num    number of blocks to be unmapped
+ */
+#ifdef                 EvtUSBH_MSC_ScsiUnmap
+  __STATIC_INLINE void EvrUSBH_MSC_ScsiUnmap(  uint8_t instance,  uint32_t block_addr, uint32_t block_num) {
+    EventRecord4(      EvtUSBH_MSC_ScsiUnmap, TO_BYTE0(instance),          block_addr,          block_num, 0U);
+  }
+#else
+  #define              EvrUSBH_MSC_ScsiUnmap(...)
+#endif
+
+
+/**
+  \brief  Event on internal operation SCSI Unmap failed (Error)
+  \param  instance     instance of MSC device
+  \param  block_addr   address of first block to be unmapped
+  \param  block_num    number of blocks to be unmapped
+  \param  error        error code \ref usbStatus
+ */
+#ifdef                 EvtUSBH_MSC_ScsiUnmapFailed
+  __STATIC_INLINE void EvrUSBH_MSC_ScsiUnmapFailed(  uint8_t instance,  uint32_t block_addr, uint32_t block_num, usbStatus error) {
+    EventRecord4(      EvtUSBH_MSC_ScsiUnmapFailed, TO_BYTE0(instance),          block_addr,          block_num, (uint32_t)error);
+  }
+#else
+  #define              EvrUSBH_MSC_ScsiUnmapFailed(...)
+#endif
+
 #endif  // USBH_EVR_H_
@@ -31,6 +31,7 @@ static   usbStatus USBH_MSC_SCSI_Inquiry              (uint8_t instance, uint8_t
 static   usbStatus USBH_MSC_SCSI_ReadCapacity         (uint8_t instance, uint32_t lba, uint8_t *ptr_data, uint32_t *ptr_stat);
 static   usbStatus USBH_MSC_SCSI_Read10               (uint8_t instance, uint32_t block_addr, uint32_t block_num, uint8_t *ptr_data, uint32_t *ptr_stat);
 static   usbStatus USBH_MSC_SCSI_Write10              (uint8_t instance, uint32_t block_addr, uint32_t block_num, const uint8_t *ptr_data, uint32_t *ptr_stat);
+static   usbStatus USBH_MSC_SCSI_Unmap                (uint8_t instance, uint32_t block_addr, uint32_t block_num, uint32_t *ptr_stat);
 static   usbStatus USBH_MSC_Recover                   (uint8_t instance);
 
 
@@ -194,6 +195,41 @@ usbStatus USBH_MSC_Write (uint8_t instance, uint32_t lba, uint32_t cnt, const ui
   return status;
 }
 
+/// \brief Unmap requested number of blocks on Mass Storage Device
+/// \param[in]     instance             instance of MSC Device.
+/// \param[in]     lba                  logical address of first block to unmap.
+/// \param[in]     cnt                  number of contiguous blocks to unmap.
+/// \return                             status code that indicates the execution status of the function as defined with \ref usbStatus.
+usbStatus USBH_MSC_Unmap (uint8_t instance, uint32_t lba, uint32_t cnt) {
+  uint32_t  stat;
+  usbStatus status;
+
+  EvrUSBH_MSC_Unmap(instance, lba, cnt);
+
+  status = CheckInstance (instance);
+  if (status == usbOK) {
+    status = USBH_MSC_SCSI_Unmap        (instance, lba, cnt, &stat);
+    if (status == usbTransferError) {
+      // Recover device so that data transfers can continue
+      if (USBH_RecoverDevice            (usbh_msc[instance].ptr_dev) == usbOK) {
+        (void)USBH_MSC_Recover          (instance);
+      }
+    } else if ((status == usbOK) && (stat != 0U)) {
+      // Command failed, device does not support unmap
+      status = usbClassErrorMSC;
+    }
+  }
+
+#if (defined(USBH_DEBUG) && (USBH_DEBUG == 1))
+  if (status != usbOK) {
+    EvrUSBH_MSC_UnmapFailed(instance, lba, cnt, status);
+  } else {
+    EvrUSBH_MSC_UnmapDone(instance, lba, cnt);
+  }
+#endif
+  return status;
+}
+
 /// \brief Read capacity of Mass Storage Device
 /// \param[in]     instance             instance of MSC Device.
 /// \param[out]    block_count          pointer to where total number of blocks available will be read.
@@ -1382,6 +1418,117 @@ exit:
   return status;
 }
 
+/// \brief USB Mass Storage Class - SCSI - Unmap
+/// \param[in]     instance             index of MSC instance.
+/// \param[in]     block_addr           address of first block to be unmapped.
+/// \param[in]     block_num            number of blocks to be unmapped.
+/// \param[out]    ptr_stat             pointer to command status response.
+/// \return                             status code that indicates the execution status of the function as defined with \ref usbStatus.
+static usbStatus USBH_MSC_SCSI_Unmap (uint8_t instance, uint32_t block_addr, uint32_t block_num, uint32_t *ptr_stat) {
+  USBH_MSC         *ptr_msc;
+  MSC_CBW          *ptr_cbw;
+  MSC_CSW          *ptr_csw;
+  uint8_t          *ptr_mem;
+  uint8_t          *ptr_par;
+  USBH_PIPE_HANDLE  bulk_out_pipe_hndl;
+  USBH_PIPE_HANDLE  bulk_in_pipe_hndl;
+  uint8_t           ctrl;
+  usbStatus         status;
+  usbStatus         mstatus;
+
+  EvrUSBH_MSC_ScsiUnmap(instance, block_addr, block_num);
+
+  if (ptr_stat == NULL) {
+    status = usbInvalidParameter;
+    goto exit;
+  }
+  status = CheckInstance (instance);
+  if (status != usbOK) {
+    goto exit;
+  }
+
+  ptr_msc            = &usbh_msc[instance];
+  ctrl               =  ptr_msc->ptr_dev->ctrl;
+  bulk_out_pipe_hndl =  ptr_msc->bulk_out_pipe_hndl;
+  bulk_in_pipe_hndl  =  ptr_msc->bulk_in_pipe_hndl;
+
+  // Send CBW
+  mstatus = USBH_MemoryAllocate         (ctrl,                      (uint8_t **)&ptr_mem, 31U); ptr_cbw = (MSC_CBW *)ptr_mem;
+  if (mstatus != usbOK) {
+    status = mstatus;
+    goto exit;
+  }
+  ptr_msc->tag++;
+  PREPARE_MSC_CBW                       (ptr_cbw, MSC_CBW_Signature, ptr_msc->tag, 24U, 0U, 0U, 10U, SCSI_UNMAP, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 24U, 0U, 0U, 0U, 0U, 0U, 0U, 0U)
+  status  = USBH_PipeSend               (bulk_out_pipe_hndl,        (uint8_t  *) ptr_cbw, 31U);
+  mstatus = USBH_MemoryFree             (ctrl,                      (uint8_t  *) ptr_cbw);
+  if ((status == usbOK) && (mstatus != usbOK)) {
+    status = mstatus;
+  }
+  if (status != usbOK) {
+    goto exit;
+  }
+
+  // Send Parameter List (header and one block descriptor, big-endian)
+  mstatus = USBH_MemoryAllocate         (ctrl,                      (uint8_t **)&ptr_par, 24U);
+  if (mstatus != usbOK) {
+    status = mstatus;
+    goto exit;
+  }
+  memset (ptr_par, 0, 24U);
+  ptr_par[1]  = 22U;                    // UNMAP data length
+  ptr_par[3]  = 16U;                    // UNMAP block descriptor data length
+  ptr_par[12] = (uint8_t)(block_addr >> 24);
+  ptr_par[13] = (uint8_t)(block_addr >> 16);
+  ptr_par[14] = (uint8_t)(block_addr >>  8);
+  ptr_par[15] = (uint8_t)(block_addr);
+  ptr_par[16] = (uint8_t)(block_num  >> 24);
+  ptr_par[17] = (uint8_t)(block_num  >> 16);
+  ptr_par[18] = (uint8_t)(block_num  >>  8);
+  ptr_par[19] = (uint8_t)(block_num);
+  status  = USBH_PipeSend               (bulk_out_pipe_hndl,         ptr_par, 24U);
+  mstatus = USBH_MemoryFree             (ctrl,                       ptr_par);
+  if ((status == usbOK) && (mstatus != usbOK)) {
+    status = mstatus;
+  }
+  if (status != usbOK) {
+    goto exit;
+  }
+
+  // Receive CSW
+  mstatus = USBH_MemoryAllocate         (ctrl,                      (uint8_t **)&ptr_mem, 13U); ptr_csw = (MSC_CSW *)ptr_mem;
+  if (mstatus != usbOK) {
+    status = mstatus;
+    goto exit;
+  }
+  status = USBH_PipeReceive             (bulk_in_pipe_hndl,         (uint8_t  *) ptr_csw, 13U);
+  if (status == usbOK) {
+    if (U32_LE(ptr_csw->dSignature) != MSC_CSW_Signature) {
+      status = usbClassErrorMSC;
+      goto mem_free_and_exit;
+    }
+    if (U32_LE(ptr_csw->dTag) != ptr_msc->tag) {
+      status = usbClassErrorMSC;
+      goto mem_free_and_exit;
+    }
+    *ptr_stat = ptr_csw->bStatus;
+  }
+
+mem_free_and_exit:
+  mstatus = USBH_MemoryFree             (ctrl,                      (uint8_t  *) ptr_csw);
+  if ((status == usbOK) && (mstatus != usbOK)) {
+    status = mstatus;
+  }
+
+exit:
+#if (defined(USBH_DEBUG) && (USBH_DEBUG == 1))
+  if (status != usbOK) {
+    EvrUSBH_MSC_ScsiUnmapFailed(instance, block_addr, block_num, status);
+  }
+#endif
+  return status;
+}
+
 /// \brief Recover Mass Storage Device instance
 /// \param[in]     instance             index of MSC instance.
 /// \return                             status code that indicates the execution status of the function as defined with \ref usbStatus.
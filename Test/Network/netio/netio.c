@@ -19,6 +19,11 @@
 #define NETIO_PORT      18767
 #define NETIO_AUXPORT   18768
 
+// Number of TCP server instances
+// Instance n listens on port NETIO_PORT + 2*n, run netio client with option -p
+// Use 2 instances to measure aggregate throughput over two interfaces
+#define TCP_SERVER_NUM  1
+
 // netio commands
 #define CMD_QUIT        0           // Quit the test
 #define CMD_C2S         1           // Client to server test
@@ -51,8 +56,24 @@ struct {
   int32_t      err_bsd;             // BSD error code
 } io;
 
+// TCP server instance structure
+typedef struct {
+  uint16_t     port;                // Server port
+  osTimerId_t  timer;               // Timer id
+  uint8_t     *buf;                 // Test buffer
+  SOCKADDR_IN  client;              // Client address
+  uint32_t     pkt_size;            // Packet size for the test
+  uint32_t     pkt_count;           // Number of packets transmitted/received
+  uint32_t     start;               // Test start time in kernel ticks
+  volatile bool timeover;           // Test timeout flag (6 seconds elapsed)
+} TCP_INST;
+
+static TCP_INST tcp_inst[TCP_SERVER_NUM];
+
 // Functions
 static void cb_timer (void *arg);
+static void cb_tcp_timer (void *arg);
+static void print_rate (uint32_t port, uint32_t bytes, uint32_t start);
 static uint32_t rand32 (void);
 static void init_buffer (uint8_t *buf, int32_t size);
 static int32_t recv_data (int32_t sock, void *buf, int32_t size);
@@ -68,6 +89,21 @@ static void cb_timer (void *arg) {
   io.timeover = true;
 }
 
+// TCP server instance timer callback function
+static void cb_tcp_timer (void *arg) {
+  ((TCP_INST *)arg)->timeover = true;
+}
+
+// Print data rate of a TCP server instance
+static void print_rate (uint32_t port, uint32_t bytes, uint32_t start) {
+  uint32_t ticks, rate;
+
+  ticks = osKernelGetTickCount() - start;
+  if (ticks == 0) ticks = 1;
+  rate  = (uint32_t)(((uint64_t)bytes * osKernelGetTickFreq()) / ticks / 1024);
+  printf (" Port %u: %u KB/s\n", port, rate);
+}
+
 // LCG pseudo random generator
 static uint32_t rand32 (void) {
   static uint32_t rnd_state;
@@ -285,10 +321,11 @@ exit:   closesocket (io.udp_sock);
  
 // TCP control thread
 static void TCP_Server (void *argument) {
+  TCP_INST *inst = (TCP_INST *)argument;
   SOCKADDR_IN sa;
   CONTROL ctl;
   int32_t sock,csock,rc;
-  int32_t sa_len,nb;
+  int32_t sa_len,nb,cmd;
   struct timeval tv;
   fd_set fds;
 
@@ -297,7 +334,7 @@ static void TCP_Server (void *argument) {
   if (sock < 0) __THREAD_EXIT (sock);
 
   sa.sin_family      = AF_INET;
-  sa.sin_port        = htons (NETIO_PORT);
+  sa.sin_port        = htons (inst->port);
   sa.sin_addr.s_addr = INADDR_ANY;
   rc = bind (sock, (SOCKADDR *)&sa, sizeof(sa));
   if (rc < 0) __THREAD_EXIT (rc);
@@ -305,7 +342,7 @@ static void TCP_Server (void *argument) {
   rc = listen (sock, 1);
   if (rc < 0) __THREAD_EXIT (rc);
 
-  printf (" TCP Server listening\n");
+  printf (" TCP Server listening on port %d\n", inst->port);
 
   for (;;) {
     FD_ZERO(&fds);
@@ -321,79 +358,79 @@ static void TCP_Server (void *argument) {
       continue;
     }
 
-    sa_len = sizeof (*io.client);
-    csock = accept (sock, (SOCKADDR *)io.client, &sa_len);
+    sa_len = sizeof (inst->client);
+    csock = accept (sock, (SOCKADDR *)&inst->client, &sa_len);
     if (csock < 0) {
       continue;
     }
 
     // Client is now connected
-    printf ("\nTCP Client connected\n");
+    printf ("\nTCP Client connected to port %d\n", inst->port);
 
     for (;;) {
       rc = recv_data (csock, &ctl, sizeof (ctl));
       if (rc < 0) __THREAD_EXIT (rc);
 
       // Convert a command to host endian format
-      io.command = ntohl (ctl.cmd);
+      cmd = ntohl (ctl.cmd);
 
-      if (io.command == CMD_C2S) {
+      if (cmd == CMD_C2S) {
         // Client to Server (starts the test)
-        io.pkt_size = ntohl (ctl.data);
-        io.pkt_count= 0;
-        io.rx_bytes = 0;
+        inst->pkt_size = ntohl (ctl.data);
+        inst->pkt_count= 0;
 
-        printf (" Address %s, packet size %d bytes\n",
-                inet_ntoa (io.client->sin_addr), io.pkt_size);
+        printf (" Address %s, packet size %u bytes\n",
+                inet_ntoa (inst->client.sin_addr), inst->pkt_size);
 
-        if (io.pkt_size > io.buf_size) __THREAD_EXIT (BSD_EMSGSIZE);
+        if (inst->pkt_size > BUF_SIZE) __THREAD_EXIT (BSD_EMSGSIZE);
 
         printf (" Receiving ...\n");
 
+        inst->start = osKernelGetTickCount();
         do {
-          for (nb = 0; nb < io.pkt_size; ) {
-            rc = recv (csock, (char *)&io.buf[nb], io.pkt_size - nb, 0);
+          for (nb = 0; nb < inst->pkt_size; ) {
+            rc = recv (csock, (char *)&inst->buf[nb], inst->pkt_size - nb, 0);
             if (rc < 0) {
               break;
             }
             nb += rc;
           }
-          io.rx_bytes += io.pkt_size;
-          io.pkt_count++;
-        } while (io.buf[0] == 0 && rc > 0);
+          inst->pkt_count++;
+        } while (inst->buf[0] == 0 && rc > 0);
 
-        printf (" Done %d packets\n", io.pkt_count);
+        printf (" Done %u packets\n", inst->pkt_count);
+        print_rate (inst->port, inst->pkt_count * inst->pkt_size, inst->start);
       }
-      else if (io.command == CMD_S2C) {
+      else if (cmd == CMD_S2C) {
         // Server to Client
-        io.pkt_size = ntohl (ctl.data);
-        io.pkt_count= 0;
-        io.tx_bytes = 0;
-        if (io.pkt_size > io.buf_size) __THREAD_EXIT (BSD_EMSGSIZE);
+        inst->pkt_size = ntohl (ctl.data);
+        inst->pkt_count= 0;
+        if (inst->pkt_size > BUF_SIZE) __THREAD_EXIT (BSD_EMSGSIZE);
 
         printf (" Sending ...\n");
 
-        init_buffer (io.buf, io.buf_size);
-        io.timeover  = false;
-        osTimerStart (io.timer, 6000);
+        init_buffer (inst->buf, BUF_SIZE);
+        inst->timeover = false;
+        inst->start    = osKernelGetTickCount();
+        osTimerStart (inst->timer, 6000);
 
-        io.buf[0] = 0;
-        while (!io.timeover) {
-          for (nb = 0; nb < io.pkt_size; ) {
-            rc = send (csock, (char *)&io.buf[nb], io.pkt_size - nb, 0);
+        inst->buf[0] = 0;
+        while (!inst->timeover) {
+          for (nb = 0; nb < inst->pkt_size; ) {
+            rc = send (csock, (char *)&inst->buf[nb], inst->pkt_size - nb, 0);
             if (rc < 0) {
               break;
             }
             nb += rc;
           }
-          io.tx_bytes += io.pkt_size;
-          io.pkt_count++;
+          inst->pkt_count++;
         }
-        io.buf[0] = 1;
-        rc = send_data (csock, io.buf, io.pkt_size);
+        inst->buf[0] = 1;
+        rc = send_data (csock, inst->buf, inst->pkt_size);
         if (rc < 0) __THREAD_EXIT (rc);
 
-        printf (" Done %d packets\n", io.pkt_count);
+        printf (" Done %u packets\n", inst->pkt_count);
+        print_rate (inst->port, inst->pkt_count * inst->pkt_size, inst->start);
       }
       else {
         // Quit
@@ -408,7 +445,11 @@ static void TCP_Server (void *argument) {
 // Application main thread
 static void app_main_thread (void *argument) {
   static uint8_t io_buf[BUF_SIZE];
+#if (TCP_SERVER_NUM > 1)
+  static uint8_t tcp_buf[TCP_SERVER_NUM-1][BUF_SIZE];
+#endif
   static SOCKADDR_IN sa_client;
+  uint32_t i;
 
   printf ("NETIO Benchmark test\n");
 
@@ -420,8 +461,20 @@ static void app_main_thread (void *argument) {
   io.timer    = osTimerNew (cb_timer, osTimerOnce, NULL, NULL);
   io.udp_sock = -1;
 
+  for (i = 0; i < TCP_SERVER_NUM; i++) {
+    tcp_inst[i].port  = (uint16_t)(NETIO_PORT + 2*i);
+    // First instance shares the test buffer, as the single TCP server did
+    tcp_inst[i].buf   = &io_buf[0];
+#if (TCP_SERVER_NUM > 1)
+    if (i > 0) tcp_inst[i].buf = &tcp_buf[i-1][0];
+#endif
+    tcp_inst[i].timer = osTimerNew (cb_tcp_timer, osTimerOnce, &tcp_inst[i], NULL);
+  }
+
   osDelay (500);
-  osThreadNew (TCP_Server, NULL, NULL);
+  for (i = 0; i < TCP_SERVER_NUM; i++) {
+    osThreadNew (TCP_Server, &tcp_inst[i], NULL);
+  }
   osThreadNew (UDP_Server, NULL, NULL);
 
   osThreadExit ();
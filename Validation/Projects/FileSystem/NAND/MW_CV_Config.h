@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component Validation
+ * Copyright (c) 2018-2025 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    MW_CV_Config.h
+ * Purpose: MDK Middleware - Component Validation - configuration definitions
+ *----------------------------------------------------------------------------*/
+
+#ifndef MW_CV_CONFIG_H_
+#define MW_CV_CONFIG_H_
+
+//-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
+//------ With VS Code: Open Preview for Configuration Wizard -------------------
+
+// <h> File System
+//   <i> File System Component Validation Settings
+//   <e0.0> NAND Flash drive
+//     <i> Enable/disable NAND Flash drive validation on emulated NAND Flash devices
+//     <q1> ECC correction
+//       <i> Enable/disable software ECC bit error correction validation
+//     <q2> ECC performance
+//       <i> Enable/disable software ECC read and write speed measurement
+//     <q3> Power loss
+//       <i> Enable/disable power loss recovery validation of drive N0: (requires FAT journal)
+//   </e>
+#define MW_CV_FS_NAND                       1
+#define MW_CV_FS_NAND_ECC                   1
+#define MW_CV_FS_NAND_ECC_PERFORMANCE       1
+#define MW_CV_FS_NAND_POWER_LOSS            1
+
+//   <o> Number of power loss cycles <1-10000>
+//     <i> Number of times power is lost during the power loss validation
+#define MW_CV_FS_NAND_POWER_LOSS_CYCLES     100
+
+//   <o> Size of test file (in KB) <1-1024>
+//     <i> Size of test file used for ECC correction and performance tests
+#define MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB  64
+
+//   <e> Place emulated NAND Flash memory into section
+//     <i> Enable to place emulated NAND Flash memory arrays into a dedicated linker section
+//     <s> Section name
+//       <i> Linker script shall have this section defined.
+//   </e>
+#define MW_CV_FS_NAND_EMUL_RELOC            0
+#define MW_CV_FS_NAND_EMUL_SECTION          ".mw_cv.nand"
+// </h>
+
+// <h> Network
+//   <i> Network Component Validation Settings
+//   <e0.0> BSD Socket
+//     <i> Enable/disable BSD socket validation
+//     <q1> Socket API
+//       <i> Enable/disable BSD socket API interface validation
+//     <q2> Socket operation
+//       <i> Enable/disable BSD sockets operation validation
+//   </e>
+#define MW_CV_NET                      0
+#define MW_CV_NET_BSD_API              0
+#define MW_CV_NET_BSD_OPERATION        0
+
+//   <s.15> SockServer address
+//     <i> Static IPv4 Address of SockServer in text representation
+#define MW_CV_NET_SOCKSERVER_IP        "192.168.0.100"
+// </h>
+
+// <h> USB
+//   <i> USB Components Validation Settings
+//   <e0.0> USB Device
+//     <i> Enable/disable USB Device validation
+//     <q1> Core
+//       <i> Enable/disable USB Device Core validation
+//     <q2> Communication Device Class - Abstract Control Model (CDC ACM)
+//       <i> Enable/disable USB Device Communication Device Class - Abstract Control Model validation
+//     <q3> Human Interface Device (HID)
+//       <i> Enable/disable USB Device Human Interface Device validation
+//     <q4> Mass Storage Class (MSC)
+//       <i> Enable/disable USB Device Mass Storage Class validation
+//   </e>
+#define MW_CV_USBD                      0
+#define MW_CV_USBD_CORE                 0
+#define MW_CV_USBD_CDC_ACM              0
+#define MW_CV_USBD_HID                  0
+#define MW_CV_USBD_MSC                  0
+
+//   <e0.0> USB Host
+//     <i> Enable/disable USB Host validation
+//     <q1> Core
+//       <i> Enable/disable USB Host Core validation
+//     <q2> Communication Device Class - Abstract Control Model (CDC ACM)
+//       <i> Enable/disable USB Host Communication Device Class - Abstract Control Model validation
+//     <q3> Human Interface Device (HID) class
+//       <i> Enable/disable USB Host Human Interface Device validation
+//     <q4> Mass Storage Class (MSC)
+//       <i> Enable/disable USB Host Mass Storage Class validation
+//     <q5> Mass Storage Class (MSC) Performance
+//       <i> Enable/disable USB Host Mass Storage Class performance measurement
+//   </e>
+#define MW_CV_USBH                      0
+#define MW_CV_USBH_CORE                 0
+#define MW_CV_USBH_CDC_ACM              0
+#define MW_CV_USBH_HID                  0
+#define MW_CV_USBH_MSC                  0
+#define MW_CV_USBH_MSC_PERFORMANCE      0
+
+// Time available for user operation of connect/disconnect (in seconds)
+#define MW_CV_USB_TIMEOUT_IN_SEC        30
+
+// Size of test file used for validation and performance tests (in MB)
+#define MW_CV_USB_TEST_FILE_SIZE_IN_MB  10
+
+#endif // MW_CV_CONFIG_H_
@@ -0,0 +1,127 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component ::File System
+ * Copyright (c) 2004-2024 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    FS_Config.h
+ * Purpose: File System Configuration
+ * Rev.:    V8.11.0
+ *----------------------------------------------------------------------------*/
+
+//-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
+//------ With VS Code: Open Preview for Configuration Wizard -------------------
+
+// <h>FAT File System
+// <i>Define FAT File System parameters
+
+//   <o>Number of open files <1-16>
+//   <i>Define number of files that can be opened at the same time.
+//   <i>Default: 4
+#define FAT_MAX_OPEN_FILES      4
+
+//   <o>Maximum Sector Size <512=>512 bytes <1024=>1024 bytes <2048=>2048 bytes <4096=>4096 bytes
+//   <i>Define the largest logical sector size of FAT drives.
+//   <i>Sector buffers of all FAT drives are sized for this value, so that
+//   <i>media with 4 KB native sectors can be mounted and formatted.
+//   <i>Default: 512 bytes
+#define FAT_MAX_SECTOR_SIZE     512
+
+//   <o>FAT Table Cache Size <1-16>
+//   <i>Define number of FAT table sectors cached for each FAT drive.
+//   <i>Cached sectors are replaced using LRU policy and written back on flush.
+//   <i>One sector of RAM is required for each additional cached sector.
+//   <i>Default: 1
+#define FAT_TABLE_CACHE_SIZE    1
+
+//   <o>Free Cluster Map Size [bytes] <0-65536:4>
+//   <i>Define size of the map that tracks fully allocated cluster groups
+//   <i>on each FAT drive. Map speeds-up free cluster search on large volumes.
+//   <i>Value 0 disables the map.
+//   <i>Default: 0
+#define FAT_FREE_MAP_SIZE       0
+
+//   <o>Directory Index Size [bytes] <0-65536:4>
+//   <i>Define size of the hashed index of directory entries for each FAT drive.
+//   <i>Index is built on first access to a directory and speeds-up name lookup,
+//   <i>numeric tail generation and entry allocation in large directories.
+//   <i>One index entry requires 24 bytes. Value 0 disables the index.
+//   <i>Default: 0
+#define FAT_DIR_INDEX_SIZE      0
+
+//   <o>Journal Group Size [sectors] <0-32>
+//   <i>Define maximum number of sectors committed by a single journal
+//   <i>transaction on drives with FAT journal enabled. Sectors changed by
+//   <i>one file operation are collected and committed together.
+//   <i>Value 0 commits each sector in its own transaction.
+//   <i>Default: 0
+#define FAT_JOURNAL_GROUP       8
+
+//   <o>File Transfer Chunk Size [clusters] <0-64>
+//   <i>Define maximum number of clusters transferred while the drive is locked.
+//   <i>Drive is released between chunks so that other files on the same drive
+//   <i>can be accessed while a large read or write is in progress.
+//   <i>Value 0 locks the drive for the whole transfer.
+//   <i>Default: 8
+#define FAT_TRANSFER_CHUNK      8
+
+//   <q>Discard Freed Clusters
+//   <i>Inform the media driver about clusters released by file delete,
+//   <i>truncate and format so that flash based media can erase them in
+//   <i>advance. Discard is issued after the allocation table is written.
+//   <i>Default: 0
+#define FAT_DISCARD_ENABLE      0
+
+//   <e>Background I/O Worker
+//   <i>Enable worker thread which reads ahead data of sequentially read files
+//   <i>and writes buffered file data to the media in the background.
+#define FAT_IO_WORKER_ENABLE    0
+
+//     <o>Write-behind Watermark [%] <10-100>
+//     <i>Define fill level of the data cache at which the buffered
+//     <i>file data is written to the media by the worker thread.
+//     <i>Default: 50
+#define FAT_IO_WORKER_WMARK     50
+
+//     <o>Worker Thread Stack Size <1024-65535:8>
+//     <i>The worker calls the media driver, so the stack must also hold
+//     <i>the deepest driver path (NAND FTL with BCH ECC, memory card)
+//     <i>and the CMSIS driver below it. Increase for custom drivers.
+//     <i>Default: 2048 bytes
+#define FAT_IO_WORKER_STACK_SIZE 2048
+
+//        Worker Thread Priority
+#define FAT_IO_WORKER_PRIORITY  osPriorityBelowNormal
+
+//   </e>
+
+// </h>
+
+// <h>Embedded File System
+// <i>Define Embedded File System parameters
+
+//   <o>Number of open files <1-16>
+//   <i>Define number of files that can be opened at the same time.
+//   <i>Default: 4
+#define EFS_MAX_OPEN_FILES      4
+
+//   <o>File Index Size [bytes] <0-65536:4>
+//   <i>Define size of the in-memory index of file allocation records for each
+//   <i>EFS drive. Index is built when the drive is mounted and speeds-up file
+//   <i>lookup, file size calculation and seeking without scanning the flash.
+//   <i>One index entry requires 28 bytes. Value 0 disables the index.
+//   <i>Default: 0
+#define EFS_FILE_INDEX_SIZE     0
+
+//   <o>Write Buffer Size [bytes] <0-4096:4>
+//   <i>Define size of the write combining buffer for each EFS drive.
+//   <i>Small writes are collected in RAM and programmed to flash in pages
+//   <i>of the size reported by the flash driver. Value 0 disables buffering.
+//   <i>Default: 0
+#define EFS_WRITE_BUFFER_SIZE   0
+
+//   <o>Reclaim Reserve Blocks <1-16>
+//   <i>Define number of erased blocks that function freclaim keeps ready.
+//   <i>Each call reclaims at most one block with invalidated data.
+//   <i>Default: 2
+#define EFS_RECLAIM_RESERVE     2
+
+// </h>
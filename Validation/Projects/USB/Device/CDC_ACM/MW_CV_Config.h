@@ -12,6 +12,39 @@
 //-------- <<< Use Configuration Wizard in Context Menu >>> --------------------
 //------ With VS Code: Open Preview for Configuration Wizard -------------------
 
+// <h> File System
+//   <i> File System Component Validation Settings
+//   <e0.0> NAND Flash drive
+//     <i> Enable/disable NAND Flash drive validation on emulated NAND Flash devices
+//     <q1> ECC correction
+//       <i> Enable/disable software ECC bit error correction validation
+//     <q2> ECC performance
+//       <i> Enable/disable software ECC read and write speed measurement
+//     <q3> Power loss
+//       <i> Enable/disable power loss recovery validation of drive N0: (requires FAT journal)
+//   </e>
+#define MW_CV_FS_NAND                       0
+#define MW_CV_FS_NAND_ECC                   0
+#define MW_CV_FS_NAND_ECC_PERFORMANCE       0
+#define MW_CV_FS_NAND_POWER_LOSS            0
+
+//   <o> Number of power loss cycles <1-10000>
+//     <i> Number of times power is lost during the power loss validation
+#define MW_CV_FS_NAND_POWER_LOSS_CYCLES     100
+
+//   <o> Size of test file (in KB) <1-1024>
+//     <i> Size of test file used for ECC correction and performance tests
+#define MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB  64
+
+//   <e> Place emulated NAND Flash memory into section
+//     <i> Enable to place emulated NAND Flash memory arrays into a dedicated linker section
+//     <s> Section name
+//       <i> Linker script shall have this section defined.
+//   </e>
+#define MW_CV_FS_NAND_EMUL_RELOC            0
+#define MW_CV_FS_NAND_EMUL_SECTION          ".mw_cv.nand"
+// </h>
+
 // <h> Network
 //   <i> Network Component Validation Settings
 //   <e0.0> BSD Socket
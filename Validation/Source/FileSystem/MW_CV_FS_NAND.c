@@ -0,0 +1,637 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component Validation - File System
+ * Copyright (c) 2025 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    MW_CV_FS_NAND.c
+ * Purpose: MDK Middleware - Component Validation - File System -
+ *          NAND Flash drive tests module
+ *----------------------------------------------------------------------------*/
+
+#include "MW_CV_Config.h"
+#if     (MW_CV_FS_NAND != 0U)
+
+#include "MW_CV_FS_NAND.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "RTE_Components.h"
+
+#include "MW_CV_TestReport.h"
+#include "MW_CV_Timer.h"
+#include "MW_CV_FS_NAND_Emul.h"
+
+#include "rl_fs.h"
+
+#if defined(RTE_FileSystem_Drive_NAND_0)
+#include "FS_Config_NAND_0.h"
+#endif
+#if defined(RTE_FileSystem_Drive_NAND_1)
+#include "FS_Config_NAND_1.h"
+#endif
+
+/* Software ECC algorithms (NANDx_SW_ECC) */
+#define SW_ECC_HAMMING          1U
+#define SW_ECC_BCH4             4U
+#define SW_ECC_BCH8             5U
+
+/* Power loss test file size and number of tracked files */
+#define PL_FILE_SIZE            2048U
+#define PL_FILE_NUM             8U
+
+/* Power loss test file state */
+#define PL_NONE                 0U      // File does not exist
+#define PL_CREATED              1U      // File exists under its original name
+#define PL_RENAMED              2U      // File exists under its new name
+
+/* Power loss test operations */
+#define PL_OP_NONE              0U
+#define PL_OP_CREATE            1U
+#define PL_OP_RENAME            2U
+#define PL_OP_DELETE            3U
+
+/* File verification result */
+#define VERIFY_OK               0U      // Content is correct
+#define VERIFY_ERROR            1U      // Open or read failed
+#define VERIFY_MISMATCH         2U      // Content is not correct
+
+/* NAND drive under test */
+typedef struct {
+  const char *drive;                    // Drive letter
+  uint32_t    dev_num;                  // Device number
+  uint32_t    sw_ecc;                   // Software ECC algorithm
+} NAND_DRIVE;
+
+static const NAND_DRIVE nand_drive[] = {
+#if defined(RTE_FileSystem_Drive_NAND_0)
+  { "N0:", NAND0_DEV_NUM, NAND0_SW_ECC },
+#endif
+#if defined(RTE_FileSystem_Drive_NAND_1)
+  { "N1:", NAND1_DEV_NUM, NAND1_SW_ECC },
+#endif
+};
+
+#define NAND_DRIVE_NUM          (sizeof(nand_drive) / sizeof(nand_drive[0]))
+
+// Local variables used for testing
+static uint8_t test_data_buf[512] __ALIGNED(4);
+static uint8_t cmp_buf[512];
+static uint8_t pl_state[PL_FILE_NUM];
+
+
+/* Get number of bit errors per sector corrected by the software ECC */
+static uint32_t EccCorrectable (uint32_t sw_ecc) {
+  switch (sw_ecc) {
+    case SW_ECC_HAMMING: return (1U);
+    case SW_ECC_BCH4:    return (4U);
+    case SW_ECC_BCH8:    return (8U);
+    default:             return (0U);
+  }
+}
+
+/* Get name of the software ECC algorithm */
+static const char *EccName (uint32_t sw_ecc) {
+  switch (sw_ecc) {
+    case SW_ECC_HAMMING: return ("Hamming 1-bit");
+    case SW_ECC_BCH4:    return ("BCH 4-bit");
+    case SW_ECC_BCH8:    return ("BCH 8-bit");
+    default:             return ("None");
+  }
+}
+
+/* Fill buffer with the test pattern of a file */
+static void PatternFill (uint8_t *buf, uint32_t len, uint32_t seed, uint32_t ofs) {
+  uint32_t i;
+
+  for (i = 0U; i < len; i++) {
+    buf[i] = (uint8_t)(((ofs + i) * 31U) ^ (seed * 101U) ^ ((ofs + i) >> 8));
+  }
+}
+
+/* Create a file with the test pattern */
+static bool FileWrite (const char *path, uint32_t size, uint32_t seed) {
+  FILE    *f;
+  uint32_t ofs, len;
+  bool     ok;
+
+  f = fopen (path, "wb");
+  if (f == NULL) {
+    return (false);
+  }
+  ok = true;
+  for (ofs = 0U; ofs < size; ofs += len) {
+    len = size - ofs;
+    if (len > sizeof(test_data_buf)) {
+      len = sizeof(test_data_buf);
+    }
+    PatternFill (test_data_buf, len, seed, ofs);
+    if (fwrite (test_data_buf, 1U, len, f) != len) {
+      ok = false;
+      break;
+    }
+  }
+  if (fclose (f) != 0) {
+    ok = false;
+  }
+  return (ok);
+}
+
+/* Read back a file and compare it with the test pattern */
+static uint32_t FileVerify (const char *path, uint32_t size, uint32_t seed) {
+  FILE    *f;
+  uint32_t ofs, len;
+  uint32_t rval;
+
+  f = fopen (path, "rb");
+  if (f == NULL) {
+    return (VERIFY_ERROR);
+  }
+  rval = VERIFY_OK;
+  for (ofs = 0U; ofs < size; ofs += len) {
+    len = size - ofs;
+    if (len > sizeof(test_data_buf)) {
+      len = sizeof(test_data_buf);
+    }
+    if (fread (test_data_buf, 1U, len, f) != len) {
+      rval = VERIFY_ERROR;
+      break;
+    }
+    PatternFill (cmp_buf, len, seed, ofs);
+    if (memcmp (test_data_buf, cmp_buf, len) != 0) {
+      rval = VERIFY_MISMATCH;
+      break;
+    }
+  }
+  if ((rval == VERIFY_OK) && (fgetc (f) != EOF)) {
+    /* File is longer than expected */
+    rval = VERIFY_MISMATCH;
+  }
+  fclose (f);
+  return (rval);
+}
+
+/* Check if a file exists */
+static bool FileExists (const char *path) {
+  fsFileInfo info;
+
+  info.fileID = 0U;
+  return (ffind (path, &info) == fsOK);
+}
+
+/* Remount drive so that following reads are served from the flash device */
+static bool DriveRemount (const char *drive) {
+  if (funmount (drive) != fsOK) {
+    return (false);
+  }
+  return (fmount (drive) == fsOK);
+}
+
+/* Initialize drive and low level format it */
+static bool DriveFormat (const char *drive) {
+  if (finit (drive) != fsOK) {
+    return (false);
+  }
+  (void)fmount (drive);
+  if (fformat (drive, "/LL") != fsOK) {
+    return (false);
+  }
+  return (true);
+}
+
+
+/*=======0=========1=========2=========3=========4=========5=========6=========7=========8=========9=========0=========1====*/
+/**
+\defgroup mw_cv_fs_nand_test_funcs MDK Middleware - Component Validation - File System - NAND Flash drive
+\brief File System NAND Flash drive validation test functions
+\details
+The MDK Middleware Component Validation for File System NAND Flash drive checks error correction and
+power loss recovery of the NAND Flash Translation Layer and the FAT journal.
+
+The drives are located on an emulated NAND Flash device (Driver_NAND0) that keeps its content in RAM and
+can inject bit errors on read and cut power at a selected program or erase operation.
+@{
+*/
+
+/*=======0=========1=========2=========3=========4=========5=========6=========7=========8=========9=========0=========1====*/
+/**
+\brief  Get File System component version
+\return version in decimal representation (major * 10000000 + minor * 10000 + build)
+*/
+uint32_t MW_CV_FS_GetVersion (void) {
+  uint32_t ver, major, minor, build;
+
+  ver   = fversion ();
+  major = ((ver >> 28) & 0xFU) * 10U + ((ver >> 24) & 0xFU);
+  minor = ((ver >> 20) & 0xFU) * 10U + ((ver >> 16) & 0xFU);
+  build = ((ver >> 12) & 0xFU) * 1000U + ((ver >> 8) & 0xFU) * 100U +
+          ((ver >>  4) & 0xFU) *   10U +  (ver       & 0xFU);
+
+  return (major * 10000000U + minor * 10000U + build);
+}
+
+/*=======0=========1=========2=========3=========4=========5=========6=========7=========8=========9=========0=========1====*/
+/**
+\brief  Test: MW_CV_FS_NAND_PowerLoss
+\details
+The MW_CV_FS_NAND_PowerLoss test function tests \b power \b loss \b recovery of the NAND drive N0: with the FAT journal.
+
+Each cycle arms a power loss after a different number of program and erase operations and runs a workload that
+creates, renames and deletes files until power is lost. The drive is then uninitialized, power is restored and the
+drive is initialized and mounted again. The test verifies that:
+ - the drive mounts after every power loss,
+ - every operation that completed before power was lost is present with correct content,
+ - a rename or delete that was interrupted is either completed or not started, never both,
+ - a file whose creation was interrupted can be read and deleted,
+ - the drive stays writable.
+*/
+void MW_CV_FS_NAND_PowerLoss (void) {
+#if defined(RTE_FileSystem_Drive_NAND_0)
+  FILE    *f;
+  char     name[16], name_new[16];
+  uint32_t cycle, idx, step, cut;
+  uint32_t op, op_idx, i, k;
+  bool     f_exist, r_exist;
+  fsStatus stat;
+
+  if (!DriveFormat ("N0:")) {
+    ASSERT_TRUE(false, "Drive N0: format failed");
+    funinit ("N0:");
+    return;
+  }
+
+  memset (pl_state, PL_NONE, sizeof(pl_state));
+  idx = 0U;
+
+  for (cycle = 0U; cycle < MW_CV_FS_NAND_POWER_LOSS_CYCLES; cycle++) {
+    /* Lose power at a different operation in each cycle */
+    cut = 1U + ((cycle * 7919U) % 241U);
+    MW_CV_NAND_Emul_PowerCut (NAND0_DEV_NUM, cut);
+
+    op     = PL_OP_NONE;
+    op_idx = 0U;
+    for (step = 0U; step < 1000U; step++, idx++) {
+      /* Create file F<idx> */
+      sprintf (name, "N0:F%04u.BIN", idx);
+      op     = PL_OP_CREATE;
+      op_idx = idx;
+      f_exist = FileWrite (name, PL_FILE_SIZE, idx);
+      if (MW_CV_NAND_Emul_PowerLost (NAND0_DEV_NUM)) { break; }
+      if (!f_exist) {
+        ASSERT_TRUE(false, "Cycle %u: file %s write failed", cycle, name);
+        goto exit;
+      }
+      pl_state[idx % PL_FILE_NUM] = PL_CREATED;
+      op = PL_OP_NONE;
+
+      for (i = (idx >= PL_FILE_NUM) ? (idx - PL_FILE_NUM + 1U) : 0U; (i + 2U) <= idx; i++) {
+        k = i % PL_FILE_NUM;
+        sprintf (name,     "N0:F%04u.BIN", i);
+        sprintf (name_new, "N0:R%04u.BIN", i);
+        if (pl_state[k] == PL_CREATED) {
+          /* Rename file F<i> to R<i> two steps after it was created */
+          op     = PL_OP_RENAME;
+          op_idx = i;
+          f_exist = (frename (name, &name_new[3]) == fsOK);
+          if (MW_CV_NAND_Emul_PowerLost (NAND0_DEV_NUM)) { break; }
+          if (!f_exist) {
+            ASSERT_TRUE(false, "Cycle %u: file %s rename failed", cycle, name);
+            goto exit;
+          }
+          pl_state[k] = PL_RENAMED;
+        }
+        if ((pl_state[k] == PL_RENAMED) && ((i + 4U) <= idx)) {
+          /* Delete file R<i> four steps after it was created */
+          op     = PL_OP_DELETE;
+          op_idx = i;
+          f_exist = (fdelete (name_new, NULL) == fsOK);
+          if (MW_CV_NAND_Emul_PowerLost (NAND0_DEV_NUM)) { break; }
+          if (!f_exist) {
+            ASSERT_TRUE(false, "Cycle %u: file %s delete failed", cycle, name_new);
+            goto exit;
+          }
+          pl_state[k] = PL_NONE;
+        }
+        op = PL_OP_NONE;
+      }
+      if (MW_CV_NAND_Emul_PowerLost (NAND0_DEV_NUM)) { break; }
+    }
+    if (!MW_CV_NAND_Emul_PowerLost (NAND0_DEV_NUM)) {
+      ASSERT_TRUE(false, "Cycle %u: power loss after %u operations not triggered", cycle, cut);
+      goto exit;
+    }
+    /* Next cycle continues with the next file */
+    idx++;
+
+    /* Restart drive */
+    funmount ("N0:");
+    funinit  ("N0:");
+    MW_CV_NAND_Emul_PowerRestore (NAND0_DEV_NUM);
+
+    if (finit ("N0:") != fsOK) {
+      ASSERT_TRUE(false, "Cycle %u: finit(\"N0:\") != fsOK", cycle);
+      return;
+    }
+    stat = fmount ("N0:");
+    if (stat != fsOK) {
+      ASSERT_TRUE(false, "Cycle %u: fmount(\"N0:\") = %d after power loss", cycle, stat);
+      goto exit;
+    }
+
+    /* Resolve the interrupted operation */
+    sprintf (name,     "N0:F%04u.BIN", op_idx);
+    sprintf (name_new, "N0:R%04u.BIN", op_idx);
+    f_exist = FileExists (name);
+    r_exist = FileExists (name_new);
+    k = op_idx % PL_FILE_NUM;
+
+    switch (op) {
+      case PL_OP_CREATE:
+        pl_state[k] = PL_NONE;
+        if (f_exist) {
+          /* Creation may have been completed, otherwise file must be readable */
+          if (FileVerify (name, PL_FILE_SIZE, op_idx) == VERIFY_OK) {
+            pl_state[k] = PL_CREATED;
+          } else {
+            f = fopen (name, "rb");
+            if (f == NULL) {
+              ASSERT_TRUE(false, "Cycle %u: interrupted create: file %s not readable", cycle, name);
+              goto exit;
+            }
+            while (fread (test_data_buf, 1U, sizeof(test_data_buf), f) == sizeof(test_data_buf));
+            fclose (f);
+            if (fdelete (name, NULL) != fsOK) {
+              ASSERT_TRUE(false, "Cycle %u: interrupted create: file %s not deletable", cycle, name);
+              goto exit;
+            }
+          }
+        }
+        break;
+
+      case PL_OP_RENAME:
+        if (f_exist == r_exist) {
+          ASSERT_TRUE(false, "Cycle %u: interrupted rename of %s is not atomic (%s)", cycle, name, f_exist ? "both names exist" : "file lost");
+          goto exit;
+        }
+        pl_state[k] = f_exist ? PL_CREATED : PL_RENAMED;
+        break;
+
+      case PL_OP_DELETE:
+        if (f_exist) {
+          ASSERT_TRUE(false, "Cycle %u: interrupted delete: unexpected file %s", cycle, name);
+          goto exit;
+        }
+        pl_state[k] = r_exist ? PL_RENAMED : PL_NONE;
+        break;
+
+      default:
+        break;
+    }
+
+    /* Verify all tracked files */
+    for (i = (idx > PL_FILE_NUM) ? (idx - PL_FILE_NUM) : 0U; i < idx; i++) {
+      sprintf (name,     "N0:F%04u.BIN", i);
+      sprintf (name_new, "N0:R%04u.BIN", i);
+      f_exist = FileExists (name);
+      r_exist = FileExists (name_new);
+
+      switch (pl_state[i % PL_FILE_NUM]) {
+        case PL_CREATED:
+          if (r_exist || (FileVerify (name, PL_FILE_SIZE, i) != VERIFY_OK)) {
+            ASSERT_TRUE(false, "Cycle %u: file %s lost or corrupted", cycle, name);
+            goto exit;
+          }
+          break;
+        case PL_RENAMED:
+          if (f_exist || (FileVerify (name_new, PL_FILE_SIZE, i) != VERIFY_OK)) {
+            ASSERT_TRUE(false, "Cycle %u: file %s lost or corrupted", cycle, name_new);
+            goto exit;
+          }
+          break;
+        default:
+          if (f_exist || r_exist) {
+            ASSERT_TRUE(false, "Cycle %u: deleted file %u present", cycle, i);
+            goto exit;
+          }
+          break;
+      }
+    }
+  }
+
+  /* Drive must be writable after the last power loss */
+  if (!FileWrite ("N0:FINAL.BIN", PL_FILE_SIZE, 0U) || (FileVerify ("N0:FINAL.BIN", PL_FILE_SIZE, 0U) != VERIFY_OK)) {
+    ASSERT_TRUE(false, "Drive N0: not writable after power loss");
+    goto exit;
+  }
+  DETAIL_INFO("Drive N0: recovered from %u power losses, %u files created", cycle, idx);
+  ASSERT_TRUE(true, "");                        // Test passed
+
+exit:
+  MW_CV_NAND_Emul_PowerRestore (NAND0_DEV_NUM);
+  funinit ("N0:");
+#else
+  DETAIL_INFO("NAND drive N0: not available, test skipped");
+#endif
+}
+
+/*=======0=========1=========2=========3=========4=========5=========6=========7=========8=========9=========0=========1====*/
+/**
+\brief  Test: MW_CV_FS_NAND_ECC_Correction
+\details
+The MW_CV_FS_NAND_ECC_Correction test function tests \b software \b error \b correction on all NAND drives.
+
+A file with a specific pattern is written to the drive. It is then read back while the emulated device flips
+1 up to the correction capability of the selected algorithm distinct bits in every sector that is loaded
+from the flash array, and the content must be correct each time. For the Hamming code it also injects two
+bit errors per sector, which are beyond its correction capability, and verifies that the drive remains usable.
+Note that the FTL returns the content of uncorrectable pages as read successfully and only marks it as corrupted
+on flash, hence the file content is then not checked.
+*/
+void MW_CV_FS_NAND_ECC_Correction (void) {
+  const NAND_DRIVE *d;
+  uint32_t i, bits, t, rval, size;
+  char     path[16];
+
+  size = MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB * 1024U;
+
+  for (i = 0U; i < NAND_DRIVE_NUM; i++) {
+    d = &nand_drive[i];
+    t = EccCorrectable (d->sw_ecc);
+    if (t == 0U) {
+      DETAIL_INFO("Drive %s does not use software ECC, skipped", d->drive);
+      continue;
+    }
+    sprintf (path, "%sECC.BIN", d->drive);
+
+    if (!DriveFormat (d->drive)) {
+      ASSERT_TRUE(false, "Drive %s format failed", d->drive);
+      funinit (d->drive);
+      return;
+    }
+    if (!FileWrite (path, size, i)) {
+      ASSERT_TRUE(false, "Drive %s file write failed", d->drive);
+      goto exit;
+    }
+
+    for (bits = 1U; bits <= t; bits++) {
+      if (!DriveRemount (d->drive)) {
+        ASSERT_TRUE(false, "Drive %s remount failed", d->drive);
+        goto exit;
+      }
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, bits);
+      rval = FileVerify (path, size, i);
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, 0U);
+      if (rval != VERIFY_OK) {
+        ASSERT_TRUE(false, "Drive %s %s: %u bit errors per sector not corrected", d->drive, EccName (d->sw_ecc), bits);
+        goto exit;
+      }
+    }
+
+    /* Content on flash must be intact */
+    if (!DriveRemount (d->drive) || (FileVerify (path, size, i) != VERIFY_OK)) {
+      ASSERT_TRUE(false, "Drive %s file corrupted after bit error test", d->drive);
+      goto exit;
+    }
+
+    if (d->sw_ecc == SW_ECC_HAMMING) {
+      /* Double bit errors are not correctable: FTL relocates the pages and */
+      /* marks the data as corrupted, but the drive must remain usable     */
+      if (!DriveRemount (d->drive)) {
+        ASSERT_TRUE(false, "Drive %s remount failed", d->drive);
+        goto exit;
+      }
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, 2U);
+      rval = FileVerify (path, size, i);
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, 0U);
+      if (rval == VERIFY_OK) {
+        ASSERT_TRUE(false, "Drive %s %s: 2 bit errors per sector were not injected", d->drive, EccName (d->sw_ecc));
+        goto exit;
+      }
+      if (!DriveRemount (d->drive) || (fdelete (path, NULL) != fsOK) ||
+          !FileWrite (path, size, i) || (FileVerify (path, size, i) != VERIFY_OK)) {
+        ASSERT_TRUE(false, "Drive %s not usable after uncorrectable bit errors", d->drive);
+        goto exit;
+      }
+    }
+    DETAIL_INFO("Drive %s %s corrected up to %u bit errors per sector", d->drive, EccName (d->sw_ecc), t);
+    funinit (d->drive);
+  }
+
+  ASSERT_TRUE(true, "");                        // Test passed
+  return;
+
+exit:
+  MW_CV_NAND_Emul_BitErrors (d->dev_num, 0U);
+  funinit (d->drive);
+}
+
+/*=======0=========1=========2=========3=========4=========5=========6=========7=========8=========9=========0=========1====*/
+/**
+\brief  Test: MW_CV_FS_NAND_ECC_Performance
+\details
+The MW_CV_FS_NAND_ECC_Performance test function measures the \b performance of the software ECC on all NAND drives.
+
+A file with a specific pattern is written to the drive and read back without bit errors and with as many
+bit errors per sector as the selected algorithm corrects. The write and read speed of each drive are reported,
+which compares the cost of the Hamming and BCH algorithms on the same emulated device.
+Read speed with bit errors includes the block refresh which the FTL performs after correcting a page.
+*/
+void MW_CV_FS_NAND_ECC_Performance (void) {
+  const NAND_DRIVE *d;
+  FILE    *f;
+  double   wr_speed, rd_speed, rd_err_speed;
+  uint32_t i, j, k, t, n, size;
+  char     path[16];
+
+  size = MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB * 1024U;
+
+  for (i = 0U; i < NAND_DRIVE_NUM; i++) {
+    d = &nand_drive[i];
+    t = EccCorrectable (d->sw_ecc);
+    sprintf (path, "%sPERF.BIN", d->drive);
+
+    if (!DriveFormat (d->drive)) {
+      ASSERT_TRUE(false, "Drive %s format failed", d->drive);
+      funinit (d->drive);
+      return;
+    }
+
+    // Write test data to file
+    f = fopen (path, "wb");
+    if (f == NULL) {
+      ASSERT_TRUE(false, "fopen(\"%s\", \"wb\") == NULL", path);
+      goto exit;
+    }
+    MW_CV_TimerReset();
+    for (j = 0U; j < size; j += sizeof(test_data_buf)) {
+      PatternFill (test_data_buf, sizeof(test_data_buf), i, j);
+      MW_CV_TimerStart();
+      fwrite (test_data_buf, sizeof(test_data_buf), 1, f);
+      MW_CV_TimerStop();
+    }
+    MW_CV_TimerStart();
+    if (fclose (f) != 0) {
+      ASSERT_TRUE(false, "fclose(f) != 0");
+      goto exit;
+    }
+    MW_CV_TimerStop();
+    wr_speed = (((double)MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB)*1000000)/((double)(MW_CV_TimerGetTime()));
+
+    // Read file content without and with bit errors
+    rd_speed     = 0.0;
+    rd_err_speed = 0.0;
+    for (j = 0U; j < 2U; j++) {
+      if (!DriveRemount (d->drive)) {
+        ASSERT_TRUE(false, "Drive %s remount failed", d->drive);
+        goto exit;
+      }
+      if ((j != 0U) && (t == 0U)) {
+        break;
+      }
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, (j == 0U) ? 0U : t);
+      f = fopen (path, "rb");
+      if (f == NULL) {
+        ASSERT_TRUE(false, "fopen(\"%s\", \"rb\") == NULL", path);
+        goto exit;
+      }
+      MW_CV_TimerReset();
+      for (k = 0U; k < size; k += sizeof(test_data_buf)) {
+        MW_CV_TimerStart();
+        n = fread (test_data_buf, sizeof(test_data_buf), 1, f);
+        MW_CV_TimerStop();
+        PatternFill (cmp_buf, sizeof(cmp_buf), i, k);
+        if ((n != 1U) || (memcmp (test_data_buf, cmp_buf, sizeof(cmp_buf)) != 0)) {
+          break;
+        }
+      }
+      fclose (f);
+      MW_CV_NAND_Emul_BitErrors (d->dev_num, 0U);
+      if (k < size) {
+        ASSERT_TRUE(false, "Drive %s file verification failed", d->drive);
+        goto exit;
+      }
+      if (j == 0U) {
+        rd_speed     = (((double)MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB)*1000000)/((double)(MW_CV_TimerGetTime()));
+      } else {
+        rd_err_speed = (((double)MW_CV_FS_NAND_TEST_FILE_SIZE_IN_KB)*1000000)/((double)(MW_CV_TimerGetTime()));
+      }
+    }
+
+    DETAIL_INFO("Drive %s ECC: %s, Write speed: %.2f KB/s, Read speed: %.2f KB/s, Read speed with %u bit errors per sector: %.2f KB/s",
+                 d->drive, EccName (d->sw_ecc), wr_speed, rd_speed, t, rd_err_speed);
+    funinit (d->drive);
+  }
+
+  ASSERT_TRUE(true, "");                        // Test passed
+  return;
+
+exit:
+  MW_CV_NAND_Emul_BitErrors (d->dev_num, 0U);
+  funinit (d->drive);
+}
+
+/**
+@}
+*/
+
+#endif
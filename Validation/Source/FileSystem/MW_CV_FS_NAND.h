@@ -0,0 +1,21 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component Validation - File System
+ * Copyright (c) 2025 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    MW_CV_FS_NAND.h
+ * Purpose: MDK Middleware - Component Validation - File System -
+ *          NAND Flash drive tests header
+ *----------------------------------------------------------------------------*/
+
+#ifndef MW_CV_FS_NAND_H_
+#define MW_CV_FS_NAND_H_
+
+#include <stdint.h>
+
+extern uint32_t MW_CV_FS_GetVersion           (void);
+
+extern void     MW_CV_FS_NAND_PowerLoss       (void);
+extern void     MW_CV_FS_NAND_ECC_Correction  (void);
+extern void     MW_CV_FS_NAND_ECC_Performance (void);
+
+#endif // MW_CV_FS_NAND_H_
@@ -0,0 +1,670 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component Validation - File System
+ * Copyright (c) 2025 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    MW_CV_FS_NAND_Emul.c
+ * Purpose: MDK Middleware - Component Validation - File System -
+ *          Emulated NAND Flash device module
+ *----------------------------------------------------------------------------*/
+
+#include "MW_CV_Config.h"
+#if     (MW_CV_FS_NAND != 0U)
+
+#include "MW_CV_FS_NAND_Emul.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "RTE_Components.h"
+
+#include "Driver_NAND.h"
+
+#if defined(RTE_FileSystem_Drive_NAND_0)
+#include "FS_Config_NAND_0.h"
+#if (NAND0_DRIVER != 0)
+#error "File System validation: NAND drive N0: must use emulated driver Driver_NAND0!"
+#endif
+#endif
+
+#if defined(RTE_FileSystem_Drive_NAND_1)
+#include "FS_Config_NAND_1.h"
+#if (NAND1_DRIVER != 0)
+#error "File System validation: NAND drive N1: must use emulated driver Driver_NAND0!"
+#endif
+#endif
+
+#if (defined(RTE_FileSystem_Drive_NAND_0) && defined(RTE_FileSystem_Drive_NAND_1))
+#if (NAND0_DEV_NUM == NAND1_DEV_NUM)
+#error "File System validation: NAND drives N0: and N1: must use different device numbers!"
+#endif
+#endif
+
+/* Emulated memory placement */
+#if (MW_CV_FS_NAND_EMUL_RELOC != 0)
+#define __EMUL_MEM              __attribute__((section(MW_CV_FS_NAND_EMUL_SECTION)))
+#else
+#define __EMUL_MEM
+#endif
+
+/* NAND commands */
+#define CMD_READ_1ST            0x00U
+#define CMD_PROGRAM_2ND         0x10U
+#define CMD_READ_2ND            0x30U
+#define CMD_ERASE_1ST           0x60U
+#define CMD_STATUS              0x70U
+#define CMD_PROGRAM_1ST         0x80U
+#define CMD_READ_ID             0x90U
+#define CMD_ERASE_2ND           0xD0U
+#define CMD_READ_PARAM_PAGE     0xECU
+#define CMD_GET_FEATURES        0xEEU
+#define CMD_SET_FEATURES        0xEFU
+#define CMD_RESET               0xFFU
+
+/* NAND status register */
+#define STAT_ARDY               0x20U
+#define STAT_RDY                0x40U
+#define STAT_WP                 0x80U
+
+/* Data output selection */
+#define OUT_NONE                0U
+#define OUT_PAGE                1U
+#define OUT_STATUS              2U
+#define OUT_ZERO                3U
+
+/* Size of a sector with its spare area in the default page layout */
+#define SECT_SIZE               512U
+#define SECT_SPARE_SIZE         528U
+
+/* Emulated NAND device */
+typedef struct {
+  uint8_t  *mem;                        // Flash array
+  uint8_t  *reg;                        // Page (data) register
+  uint32_t *read;                       // Pages read since bit errors were set (bitmap)
+  uint32_t  page_size;                  // Page size (main + spare)
+  uint32_t  page_count;                 // Pages per block
+  uint32_t  block_count;                // Number of blocks
+  uint8_t   col_cycles;                 // Column address cycles
+  uint8_t   row_cycles;                 // Row address cycles
+  uint8_t   erased;                     // Flash array erased after reset
+  uint8_t   lost;                       // Power lost, program and erase are dropped
+  uint8_t   cmd;                        // Last command
+  uint8_t   addr_cnt;                   // Received address cycles
+  uint8_t   out;                        // Data output selection
+  uint8_t   prev_out;                   // Data output selection before status read
+  uint8_t   status;                     // Status register
+  uint32_t  col;                        // Column address
+  uint32_t  row;                        // Row address
+  uint32_t  cut;                        // Program/erase operations until power loss
+  uint32_t  bits;                       // Bit errors injected per sector on read
+  uint32_t  flips;                      // Number of injected bit errors
+} NAND_EMUL;
+
+#if defined(RTE_FileSystem_Drive_NAND_0)
+static uint8_t nand0_mem[NAND0_BLOCK_COUNT * NAND0_PAGE_COUNT * NAND0_PAGE_SIZE] __EMUL_MEM;
+static uint8_t nand0_reg[NAND0_PAGE_SIZE];
+static uint32_t nand0_read[(NAND0_BLOCK_COUNT * NAND0_PAGE_COUNT + 31U) / 32U];
+
+static NAND_EMUL nand0_emul = {
+  nand0_mem,
+  nand0_reg,
+  nand0_read,
+  NAND0_PAGE_SIZE,
+  NAND0_PAGE_COUNT,
+  NAND0_BLOCK_COUNT,
+  (NAND0_PAGE_SIZE > 528U) ? 2U : 1U,
+  ((NAND0_BLOCK_COUNT * NAND0_PAGE_COUNT) > 65536U) ? 3U : 2U,
+  0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U
+};
+#endif
+
+#if defined(RTE_FileSystem_Drive_NAND_1)
+static uint8_t nand1_mem[NAND1_BLOCK_COUNT * NAND1_PAGE_COUNT * NAND1_PAGE_SIZE] __EMUL_MEM;
+static uint8_t nand1_reg[NAND1_PAGE_SIZE];
+static uint32_t nand1_read[(NAND1_BLOCK_COUNT * NAND1_PAGE_COUNT + 31U) / 32U];
+
+static NAND_EMUL nand1_emul = {
+  nand1_mem,
+  nand1_reg,
+  nand1_read,
+  NAND1_PAGE_SIZE,
+  NAND1_PAGE_COUNT,
+  NAND1_BLOCK_COUNT,
+  (NAND1_PAGE_SIZE > 528U) ? 2U : 1U,
+  ((NAND1_BLOCK_COUNT * NAND1_PAGE_COUNT) > 65536U) ? 3U : 2U,
+  0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U
+};
+#endif
+
+static ARM_NAND_SignalEvent_t cb_event;
+static uint32_t               rnd_seed = 0x2545F491U;
+
+/* Driver version */
+static const ARM_DRIVER_VERSION DriverVersion = {
+  ARM_NAND_API_VERSION,
+  ARM_DRIVER_VERSION_MAJOR_MINOR(1, 0)
+};
+
+/* Driver capabilities: bus interface only, no hardware ECC */
+static const ARM_NAND_CAPABILITIES DriverCapabilities = {
+  0U,  /* Signal Device Ready event (R/Bn rising edge) */
+  0U,  /* Supports re-entrant operation (SendCommand/Address, Read/WriteData) */
+  0U,  /* Supports Sequence operation (ExecuteSequence, AbortSequence) */
+  0U,  /* Supports VCC Power Supply Control */
+  0U,  /* Supports 1.8 VCC Power Supply */
+  0U,  /* Supports VCCQ I/O Power Supply Control */
+  0U,  /* Supports 1.8 VCCQ I/O Power Supply */
+  0U,  /* Supports VPP High Voltage Power Supply Control */
+  0U,  /* Supports WPn (Write Protect) Control */
+  0U,  /* Number of CEn (Chip Enable) lines: ce_lines + 1 */
+  0U,  /* Supports manual CEn (Chip Enable) Control */
+  0U,  /* Supports R/Bn (Ready/Busy) Monitoring */
+  0U,  /* Supports 16-bit data */
+  0U,  /* Supports NV-DDR  Data Interface (ONFI) */
+  0U,  /* Supports NV-DDR2 Data Interface (ONFI) */
+  0U,  /* Fastest (highest) SDR     Timing Mode supported (ONFI) */
+  0U,  /* Fastest (highest) NV_DDR  Timing Mode supported (ONFI) */
+  0U,  /* Fastest (highest) NV_DDR2 Timing Mode supported (ONFI) */
+  0U,  /* Supports Driver Strength 2.0x = 18 Ohms */
+  0U,  /* Supports Driver Strength 1.4x = 25 Ohms */
+  0U,  /* Supports Driver Strength 0.7x = 50 Ohms */
+  0U   /* Reserved (must be zero) */
+};
+
+
+/* Get emulated device for device number */
+static NAND_EMUL *GetDevice (uint32_t dev_num) {
+#if defined(RTE_FileSystem_Drive_NAND_0)
+  if (dev_num == NAND0_DEV_NUM) { return (&nand0_emul); }
+#endif
+#if defined(RTE_FileSystem_Drive_NAND_1)
+  if (dev_num == NAND1_DEV_NUM) { return (&nand1_emul); }
+#endif
+  return (NULL);
+}
+
+/* Pseudo random number generator (xorshift32) */
+static uint32_t Random (void) {
+  rnd_seed ^= rnd_seed << 13;
+  rnd_seed ^= rnd_seed >> 17;
+  rnd_seed ^= rnd_seed <<  5;
+  return (rnd_seed);
+}
+
+/* Check if power loss occurs at this program or erase operation */
+static bool PowerLoss (NAND_EMUL *n) {
+  if (n->cut != 0U) {
+    n->cut--;
+    if (n->cut == 0U) {
+      n->lost = 1U;
+    }
+  }
+  return (n->lost != 0U);
+}
+
+/* Flip distinct random bits in the data of each programmed sector of the page register */
+static void InjectBitErrors (NAND_EMUL *n) {
+  uint32_t ofs, i, k, bit;
+  uint32_t pos[32];
+  uint8_t *sect;
+
+  for (ofs = 0U; (ofs + SECT_SPARE_SIZE) <= n->page_size; ofs += SECT_SPARE_SIZE) {
+    sect = &n->reg[ofs];
+
+    /* Erased sectors stay erased */
+    for (i = 0U; i < SECT_SIZE; i++) {
+      if (sect[i] != 0xFFU) { break; }
+    }
+    if (i == SECT_SIZE) { continue; }
+
+    for (i = 0U; (i < n->bits) && (i < 32U); i++) {
+      do {
+        bit = Random() % (SECT_SIZE * 8U);
+        for (k = 0U; k < i; k++) {
+          if (pos[k] == bit) { break; }
+        }
+      } while (k < i);
+      pos[i] = bit;
+
+      sect[bit >> 3] ^= (uint8_t)(1U << (bit & 7U));
+      n->flips++;
+    }
+  }
+}
+
+/* Execute command that completes the address phase */
+static void ExecuteCommand (NAND_EMUL *n, uint8_t cmd) {
+  uint8_t *page;
+  uint32_t i, row;
+
+  switch (cmd) {
+    case CMD_READ_2ND:
+      /* Load page into data register */
+      row = n->row % (n->block_count * n->page_count);
+      memcpy (n->reg, &n->mem[row * n->page_size], n->page_size);
+      if ((n->bits != 0U) && ((n->read[row >> 5] & (1U << (row & 31U))) == 0U)) {
+        /* Errors appear on the first read of each page only */
+        n->read[row >> 5] |= 1U << (row & 31U);
+        InjectBitErrors (n);
+      }
+      n->out = OUT_PAGE;
+      break;
+
+    case CMD_PROGRAM_2ND:
+      /* Program data register into page */
+      if (PowerLoss (n)) {
+        break;
+      }
+      row  = n->row % (n->block_count * n->page_count);
+      page = &n->mem[row * n->page_size];
+      for (i = 0U; i < n->page_size; i++) {
+        page[i] &= n->reg[i];
+      }
+      break;
+
+    case CMD_ERASE_2ND:
+      /* Erase block */
+      if (PowerLoss (n)) {
+        break;
+      }
+      row = (n->row % (n->block_count * n->page_count)) & ~(n->page_count - 1U);
+      memset (&n->mem[row * n->page_size], 0xFF, n->page_count * n->page_size);
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+/* Driver functions */
+
+static ARM_DRIVER_VERSION GetVersion (void) {
+  return DriverVersion;
+}
+
+static ARM_NAND_CAPABILITIES GetCapabilities (void) {
+  return DriverCapabilities;
+}
+
+static int32_t Initialize (ARM_NAND_SignalEvent_t cb) {
+  NAND_EMUL *n;
+  uint32_t   dev;
+
+  cb_event = cb;
+
+  for (dev = 0U; dev < 256U; dev++) {
+    n = GetDevice (dev);
+    if (n != NULL) {
+      if (n->erased == 0U) {
+        /* Flash array content is retained until the next reset of the target */
+        memset (n->mem, 0xFF, n->block_count * n->page_count * n->page_size);
+        n->erased = 1U;
+      }
+      n->status = STAT_RDY | STAT_ARDY | STAT_WP;
+      n->out    = OUT_NONE;
+    }
+  }
+  return ARM_DRIVER_OK;
+}
+
+static int32_t Uninitialize (void) {
+  cb_event = NULL;
+  return ARM_DRIVER_OK;
+}
+
+static int32_t PowerControl (ARM_POWER_STATE state) {
+  switch (state) {
+    case ARM_POWER_OFF:
+    case ARM_POWER_FULL:
+      break;
+    case ARM_POWER_LOW:
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+  return ARM_DRIVER_OK;
+}
+
+static int32_t DevicePower (uint32_t voltage) {
+  (void)voltage;
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t WriteProtect (uint32_t dev_num, bool enable) {
+  (void)dev_num;
+  (void)enable;
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t ChipEnable (uint32_t dev_num, bool enable) {
+  (void)dev_num;
+  (void)enable;
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t GetDeviceBusy (uint32_t dev_num) {
+  if (GetDevice (dev_num) == NULL) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+  return 0;
+}
+
+static int32_t SendCommand (uint32_t dev_num, uint8_t cmd) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n == NULL) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  switch (cmd) {
+    case CMD_READ_1ST:
+      if (n->out == OUT_STATUS) {
+        /* Switch back to data output after status read */
+        n->out = n->prev_out;
+      }
+      break;
+
+    case CMD_PROGRAM_1ST:
+      memset (n->reg, 0xFF, n->page_size);
+      n->out = OUT_NONE;
+      break;
+
+    case CMD_ERASE_1ST:
+      n->out = OUT_NONE;
+      break;
+
+    case CMD_STATUS:
+      if (n->out != OUT_STATUS) {
+        n->prev_out = n->out;
+      }
+      n->out = OUT_STATUS;
+      break;
+
+    case CMD_RESET:
+      n->status = STAT_RDY | STAT_ARDY | STAT_WP;
+      n->out    = OUT_NONE;
+      break;
+
+    case CMD_READ_ID:
+    case CMD_READ_PARAM_PAGE:
+    case CMD_GET_FEATURES:
+      /* Device is not ONFI compliant and has no features */
+      n->out = OUT_ZERO;
+      break;
+
+    case CMD_READ_2ND:
+    case CMD_PROGRAM_2ND:
+    case CMD_ERASE_2ND:
+      ExecuteCommand (n, cmd);
+      break;
+
+    default:
+      break;
+  }
+
+  if (cmd != CMD_STATUS) {
+    n->cmd      = cmd;
+    n->addr_cnt = 0U;
+  }
+  return ARM_DRIVER_OK;
+}
+
+static int32_t SendAddress (uint32_t dev_num, uint8_t addr) {
+  NAND_EMUL *n = GetDevice (dev_num);
+  uint32_t   cyc;
+
+  if (n == NULL) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if (n->addr_cnt == 0U) {
+    /* Address phase starts */
+    n->col = 0U;
+    n->row = 0U;
+  }
+  cyc = n->addr_cnt++;
+
+  switch (n->cmd) {
+    case CMD_READ_1ST:
+    case CMD_PROGRAM_1ST:
+      if (cyc < n->col_cycles) {
+        n->col |= (uint32_t)addr << (8U * cyc);
+      } else {
+        n->row |= (uint32_t)addr << (8U * (cyc - n->col_cycles));
+      }
+      break;
+
+    case CMD_ERASE_1ST:
+      n->row |= (uint32_t)addr << (8U * cyc);
+      break;
+
+    default:
+      break;
+  }
+  return ARM_DRIVER_OK;
+}
+
+static int32_t ReadData (uint32_t dev_num, void *data, uint32_t cnt, uint32_t mode) {
+  NAND_EMUL *n = GetDevice (dev_num);
+  uint8_t   *buf = (uint8_t *)data;
+  uint32_t   num;
+
+  if ((n == NULL) || (data == NULL) || (cnt == 0U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  switch (n->out) {
+    case OUT_PAGE:
+      num = 0U;
+      if (n->col < n->page_size) {
+        num = n->page_size - n->col;
+        if (num > cnt) { num = cnt; }
+        memcpy (buf, &n->reg[n->col], num);
+        n->col += num;
+      }
+      if (num < cnt) {
+        memset (&buf[num], 0xFF, cnt - num);
+      }
+      break;
+
+    case OUT_STATUS:
+      memset (buf, n->status, cnt);
+      break;
+
+    default:
+      memset (buf, 0x00, cnt);
+      break;
+  }
+
+  if ((mode & ARM_NAND_DRIVER_DONE_EVENT) && (cb_event != NULL)) {
+    cb_event (dev_num, ARM_NAND_EVENT_DRIVER_DONE);
+  }
+  return (int32_t)cnt;
+}
+
+static int32_t WriteData (uint32_t dev_num, const void *data, uint32_t cnt, uint32_t mode) {
+  NAND_EMUL     *n = GetDevice (dev_num);
+  const uint8_t *buf = (const uint8_t *)data;
+  uint32_t       num;
+
+  if ((n == NULL) || (data == NULL) || (cnt == 0U)) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  if ((n->cmd == CMD_PROGRAM_1ST) && (n->col < n->page_size)) {
+    num = n->page_size - n->col;
+    if (num > cnt) { num = cnt; }
+    memcpy (&n->reg[n->col], buf, num);
+    n->col += num;
+  }
+
+  if ((mode & ARM_NAND_DRIVER_DONE_EVENT) && (cb_event != NULL)) {
+    cb_event (dev_num, ARM_NAND_EVENT_DRIVER_DONE);
+  }
+  return (int32_t)cnt;
+}
+
+static int32_t ExecuteSequence (uint32_t dev_num, uint32_t code, uint32_t cmd,
+                                uint32_t addr_col, uint32_t addr_row,
+                                void *data, uint32_t data_cnt,
+                                uint8_t *status, uint32_t *count) {
+  (void)dev_num;  (void)code;     (void)cmd;
+  (void)addr_col; (void)addr_row; (void)data;
+  (void)data_cnt; (void)status;   (void)count;
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t AbortSequence (uint32_t dev_num) {
+  (void)dev_num;
+  return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static int32_t Control (uint32_t dev_num, uint32_t control, uint32_t arg) {
+  if (GetDevice (dev_num) == NULL) {
+    return ARM_DRIVER_ERROR_PARAMETER;
+  }
+
+  switch (control) {
+    case ARM_NAND_BUS_MODE:
+      return ARM_DRIVER_OK;
+
+    case ARM_NAND_BUS_DATA_WIDTH:
+      if (arg != ARM_NAND_BUS_DATA_WIDTH_8) {
+        return ARM_DRIVER_ERROR_UNSUPPORTED;
+      }
+      return ARM_DRIVER_OK;
+
+    default:
+      return ARM_DRIVER_ERROR_UNSUPPORTED;
+  }
+}
+
+static ARM_NAND_STATUS GetStatus (uint32_t dev_num) {
+  ARM_NAND_STATUS stat;
+
+  (void)dev_num;
+
+  memset (&stat, 0, sizeof(stat));
+  return stat;
+}
+
+static int32_t InquireECC (int32_t index, ARM_NAND_ECC_INFO *info) {
+  (void)index;
+  (void)info;
+  return ARM_DRIVER_ERROR;
+}
+
+/* NAND Driver Control Block */
+extern
+ARM_DRIVER_NAND Driver_NAND0;
+ARM_DRIVER_NAND Driver_NAND0 = {
+  GetVersion,
+  GetCapabilities,
+  Initialize,
+  Uninitialize,
+  PowerControl,
+  DevicePower,
+  WriteProtect,
+  ChipEnable,
+  GetDeviceBusy,
+  SendCommand,
+  SendAddress,
+  ReadData,
+  WriteData,
+  ExecuteSequence,
+  AbortSequence,
+  Control,
+  GetStatus,
+  InquireECC
+};
+
+
+/* Fault injection */
+
+/**
+  Inject bit errors on read.
+
+  The first time a page is loaded from the flash array after this call, the
+  specified number of distinct random bits is flipped in the data of each
+  programmed sector. Following reads of the same page return the data
+  without errors, as after a read retry. The flash array itself is not
+  changed.
+
+  \param[in]  dev_num  Device number
+  \param[in]  bits     Number of bit errors per sector (0 = disabled)
+*/
+void MW_CV_NAND_Emul_BitErrors (uint32_t dev_num, uint32_t bits) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n != NULL) {
+    n->bits  = bits;
+    n->flips = 0U;
+    memset (n->read, 0, ((n->block_count * n->page_count + 31U) / 32U) * 4U);
+  }
+}
+
+/**
+  Arm power loss.
+
+  Power is lost at the specified program or erase operation. That and all
+  following program and erase operations are silently dropped until power
+  is restored, so the flash array keeps the content it had at the moment
+  of power loss. Interrupted operations do not leave partially programmed
+  pages or partially erased blocks.
+
+  \param[in]  dev_num  Device number
+  \param[in]  ops      Number of program and erase operations until power loss (0 = disarm)
+*/
+void MW_CV_NAND_Emul_PowerCut (uint32_t dev_num, uint32_t ops) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n != NULL) {
+    n->cut = ops;
+  }
+}
+
+/**
+  Check if power was lost.
+
+  \param[in]  dev_num  Device number
+  \return     1 when power was lost, 0 otherwise
+*/
+uint32_t MW_CV_NAND_Emul_PowerLost (uint32_t dev_num) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n != NULL) {
+    return (n->lost);
+  }
+  return (0U);
+}
+
+/**
+  Restore power.
+
+  \param[in]  dev_num  Device number
+*/
+void MW_CV_NAND_Emul_PowerRestore (uint32_t dev_num) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n != NULL) {
+    n->cut    = 0U;
+    n->lost   = 0U;
+    n->status = STAT_RDY | STAT_ARDY | STAT_WP;
+  }
+}
+
+/**
+  Get number of bit errors injected since the last call of MW_CV_NAND_Emul_BitErrors.
+
+  \param[in]  dev_num  Device number
+  \return     number of flipped bits
+*/
+uint32_t MW_CV_NAND_Emul_GetFlips (uint32_t dev_num) {
+  NAND_EMUL *n = GetDevice (dev_num);
+
+  if (n != NULL) {
+    return (n->flips);
+  }
+  return (0U);
+}
+
+#endif
@@ -0,0 +1,21 @@
+/*------------------------------------------------------------------------------
+ * MDK Middleware - Component Validation - File System
+ * Copyright (c) 2025 Arm Limited (or its affiliates). All rights reserved.
+ *------------------------------------------------------------------------------
+ * Name:    MW_CV_FS_NAND_Emul.h
+ * Purpose: MDK Middleware - Component Validation - File System -
+ *          Emulated NAND Flash device header
+ *----------------------------------------------------------------------------*/
+
+#ifndef MW_CV_FS_NAND_EMUL_H_
+#define MW_CV_FS_NAND_EMUL_H_
+
+#include <stdint.h>
+
+extern void     MW_CV_NAND_Emul_BitErrors    (uint32_t dev_num, uint32_t bits);
+extern void     MW_CV_NAND_Emul_PowerCut     (uint32_t dev_num, uint32_t ops);
+extern uint32_t MW_CV_NAND_Emul_PowerLost    (uint32_t dev_num);
+extern void     MW_CV_NAND_Emul_PowerRestore (uint32_t dev_num);
+extern uint32_t MW_CV_NAND_Emul_GetFlips     (uint32_t dev_num);
+
+#endif // MW_CV_FS_NAND_EMUL_H_
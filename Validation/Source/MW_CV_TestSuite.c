@@ -14,6 +14,12 @@
 
 #include "MW_CV_Config.h"
 
+#if      (MW_CV_FS_NAND != 0)
+#include "RTE_Components.h"
+#include "rl_fs.h"
+#include "MW_CV_FS_NAND.h"
+#endif
+
 #if      (MW_CV_NET != 0)
 #include "MW_CV_BSD.h"
 #endif
@@ -38,6 +44,23 @@
 #include "MW_CV_USBH_MSC_Performance.h"
 #endif
 
+// Check configuration requirements for File System validation
+
+#if    ((MW_CV_FS_NAND == 1) && !defined(RTE_FileSystem_Drive_NAND_0) && !defined(RTE_FileSystem_Drive_NAND_1))
+#error File System NAND validation requires NAND Flash drive component (N0: or N1:)!
+#endif
+
+#if    ((MW_CV_FS_NAND == 1) && (MW_CV_FS_NAND_POWER_LOSS == 1))
+#if     !defined(RTE_FileSystem_Drive_NAND_0)
+#error File System NAND power loss validation requires NAND Flash drive N0:!
+#else
+#include "FS_Config_NAND_0.h"
+#if    (NAND0_FAT_JOURNAL == 0)
+#error File System NAND power loss validation requires FAT journal enabled on drive N0:!
+#endif
+#endif
+#endif
+
 // Check configuration requirements for Network validation
 
 #if    ((MW_CV_NET == 1) && !defined(CMSIS_DRIVER_ETH))
@@ -62,6 +85,20 @@
 
 static TEST_LIST_t test_list[] = {
 
+  /**************************** File System Validation ************************/
+#if (MW_CV_FS_NAND != 0)
+  TEST_UNIT_DEF ("MDK Middleware: File System - NAND"               ,       MW_CV_FS_GetVersion                                ),
+#if (MW_CV_FS_NAND_ECC != 0)
+  TEST_CASE_DEF ( MW_CV_FS_NAND_ECC_Correction                      , "NAND: ECC bit error correction"                   , true),
+#endif
+#if (MW_CV_FS_NAND_ECC_PERFORMANCE != 0)
+  TEST_CASE_DEF ( MW_CV_FS_NAND_ECC_Performance                     , "NAND: ECC Write/Read performance"                 , true),
+#endif
+#if (MW_CV_FS_NAND_POWER_LOSS != 0)
+  TEST_CASE_DEF ( MW_CV_FS_NAND_PowerLoss                           , "NAND: Power loss recovery"                        , true),
+#endif
+#endif
+
   /**************************** Network Validation ****************************/
 #if (MW_CV_NET != 0)
   TEST_UNIT_DEF ("MDK Middleware: Network"  ,  BSD_GetVersion                  ),